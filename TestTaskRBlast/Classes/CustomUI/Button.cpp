@@ -181,6 +181,7 @@ void Button::sendEvent(ButtonEventData_t data)
     event.setUserData(&data);
     
     _eventDispatcher->dispatchEvent(&event);
+    _eventDispatcher->dispatchChannel(data);
     
     if (m_callback) m_callback(this);
 }
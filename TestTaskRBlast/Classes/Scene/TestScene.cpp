@@ -14,8 +14,6 @@
 
 #include <base/CCDirector.h>
 #include <base/CCEventDispatcher.h>
-#include <base/CCEventListenerCustom.h>
-#include <base/CCEventCustom.h>
 
 #include <2d/CCSprite.h>
 #include <2d/CCLabel.h>
@@ -99,36 +97,36 @@ bool TestScene::setupUI()
         return false;
     }
     
+    return true;
+}
+
+void TestScene::onEnter()
+{
+    Scene::onEnter();
     
-    auto listiner_press = cocos2d::EventListenerCustom::create(custom_ui::press_event_name, [=](cocos2d::EventCustom* event){
-        auto event_data = static_cast<custom_ui::ButtonEventData_t*>(event->getUserData());
-        
-        if (m_eventLabel && event_data)
-            m_eventLabel->setString(event_label_text + event_data->event_name);
-    });
-    
-    auto listiner_long_press = cocos2d::EventListenerCustom::create(custom_ui::long_press_event_name, [=](cocos2d::EventCustom* event){
-        auto event_data = static_cast<custom_ui::ButtonEventData_t*>(event->getUserData());
+    m_buttonEventListener = _eventDispatcher->addChannelListener<custom_ui::ButtonEventData_t>([=](const custom_ui::ButtonEventData_t& event_data){
+        if (m_eventLabel)
+            m_eventLabel->setString(event_label_text + event_data.event_name);
         
-        if (m_eventLabel && event_data)
-            m_eventLabel->setString(event_label_text + event_data->event_name);
-        
-        if (event_data && event_data->sender)
+        if (event_data.event_name == custom_ui::long_press_event_name && event_data.sender)
         {
-            auto scale = event_data->sender->getScale();
+            auto scale = event_data.sender->getScale();
             if (scale > 1.8f)
             {
-                event_data->sender->setScale(0.6f);
+                event_data.sender->setScale(0.6f);
             }
             else
             {
-                event_data->sender->setScale(scale + 0.2f);
+                event_data.sender->setScale(scale + 0.2f);
             }
         }
     });
+}
+
+void TestScene::onExit()
+{
+    _eventDispatcher->removeChannelListener(m_buttonEventListener);
+    m_buttonEventListener = nullptr;
     
-    _eventDispatcher->addEventListenerWithSceneGraphPriority(listiner_press, this);
-    _eventDispatcher->addEventListenerWithSceneGraphPriority(listiner_long_press, this);
-    
-    return true;
+    Scene::onExit();
 }
@@ -13,6 +13,7 @@ namespace cocos2d
 {
     class Label;
     class ProgressBar;
+    class EventChannelListener;
 }
 
 namespace custom_ui
@@ -31,11 +32,15 @@ namespace test_env
         
         virtual bool init() override;
         
+        virtual void onEnter() override;
+        virtual void onExit() override;
+        
     private:
         bool setupUI();
         
     private:
         cocos2d::Label* m_eventLabel;
+        cocos2d::EventChannelListener* m_buttonEventListener = nullptr;
         
         custom_ui::Button* m_button;
         custom_ui::LongPressButton* m_longButton;
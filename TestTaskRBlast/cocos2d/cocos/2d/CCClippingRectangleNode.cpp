@@ -81,12 +81,13 @@ void ClippingRectangleNode::onBeforeVisitScissor()
                                    pos.y,
                                    _clippingRegion.size.width * scaleX,
                                    _clippingRegion.size.height * scaleY);
+        Director::getInstance()->getRenderer()->intersectScissorWithDamage();
     }
 }
 
 void ClippingRectangleNode::onAfterVisitScissor()
 {
-    if (_clippingEnabled)
+    if (_clippingEnabled && !Director::getInstance()->getRenderer()->restoreDamageScissor())
     {
         glDisable(GL_SCISSOR_TEST);
     }
@@ -105,6 +105,8 @@ DrawNode::DrawNode(GLfloat lineWidth)
 , _defaultLineWidth(lineWidth)
 {
     _blendFunc = BlendFunc::ALPHA_PREMULTIPLIED;
+    // primitives are drawn anywhere, regardless of the content size
+    _drawsOutsideContentSize = true;
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     // Need to listen the event only when not use batchnode, because it will use VBO
     auto listener = EventListenerCustom::create(EVENT_RENDERER_RECREATED, [this](EventCustom* event){
@@ -158,36 +160,132 @@ DrawNode* DrawNode::create(GLfloat defaultLineWidth)
 }
 
 void DrawNode::ensureCapacity(int count)
+{
+    reserveVertices(_buffer, _bufferCapacity, _bufferCount, _bufferState, count);
+}
+
+void DrawNode::ensureCapacityGLPoint(int count)
+{
+    reserveVertices(_bufferGLPoint, _bufferCapacityGLPoint, _bufferCountGLPoint, _bufferStateGLPoint, count);
+}
+
+void DrawNode::ensureCapacityGLLine(int count)
+{
+    reserveVertices(_bufferGLLine, _bufferCapacityGLLine, _bufferCountGLLine, _bufferStateGLLine, count);
+}
+
+void DrawNode::reserveVertices(V2F_C4B_T2F*& buffer, int& capacity, GLsizei& bufferCount, BufferState& state, int count)
 {
     CCASSERT(count>=0, "capacity must be >= 0");
+    // every primitive reserves its vertices first, new geometry damages the screen
+    markDamaged();
+    
+    if (state.ringCapacity == 0)
+    {
+        if(bufferCount + count > capacity)
+        {
+            capacity += MAX(capacity, count);
+            buffer = (V2F_C4B_T2F*)realloc(buffer, capacity*sizeof(V2F_C4B_T2F));
+        }
+    }
+    else
+    {
+        // a primitive bigger than the ring replaces it
+        if (count > state.ringCapacity)
+        {
+            state.ringCapacity = count;
+            resetBuffer(bufferCount, state);
+        }
+        if (capacity != state.ringCapacity)
+        {
+            capacity = state.ringCapacity;
+            buffer = (V2F_C4B_T2F*)realloc(buffer, capacity*sizeof(V2F_C4B_T2F));
+        }
+        
+        // the vertices of a primitive are contiguous: wrap when they don't fit at the end, and drop the oldest
+        // primitives until they fit before the older vertices
+        for (;;)
+        {
+            if (state.ringEnd == 0)
+            {
+                if (bufferCount + count <= capacity)
+                    break;
+                state.ringEnd = bufferCount;
+                bufferCount = 0;
+            }
+            if (bufferCount + count <= state.ringStart)
+                break;
+            state.ringStart += state.primitives.front();
+            state.primitives.pop_front();
+            if (state.ringStart >= state.ringEnd)
+            {
+                state.ringStart = 0;
+                state.ringEnd = 0;
+            }
+        }
+        state.primitives.push_back(count);
+    }
     
-    if(_bufferCount + count > _bufferCapacity)
+    // the primitive is written at the end of the buffer
+    if (count > 0)
     {
-        _bufferCapacity += MAX(_bufferCapacity, count);
-        _buffer = (V2F_C4B_T2F*)realloc(_buffer, _bufferCapacity*sizeof(V2F_C4B_T2F));
+        if (state.dirtyBegin >= state.dirtyEnd)
+        {
+            state.dirtyBegin = bufferCount;
+            state.dirtyEnd = bufferCount + count;
+        }
+        else
+        {
+            state.dirtyBegin = MIN(state.dirtyBegin, bufferCount);
+            state.dirtyEnd = MAX(state.dirtyEnd, bufferCount + count);
+        }
     }
 }
 
-void DrawNode::ensureCapacityGLPoint(int count)
+void DrawNode::resetBuffer(GLsizei& bufferCount, BufferState& state)
 {
-    CCASSERT(count>=0, "capacity must be >= 0");
-    
-    if(_bufferCountGLPoint + count > _bufferCapacityGLPoint)
+    bufferCount = 0;
+    state.dirtyBegin = 0;
+    state.dirtyEnd = 0;
+    state.ringStart = 0;
+    state.ringEnd = 0;
+    state.primitives.clear();
+}
+
+void DrawNode::uploadVertices(const V2F_C4B_T2F* buffer, int capacity, BufferState& state, bool& dirty)
+{
+    // the VBO follows the capacity of the buffer, which grows geometrically
+    if (dirty || state.vboCapacity != capacity)
     {
-        _bufferCapacityGLPoint += MAX(_bufferCapacityGLPoint, count);
-        _bufferGLPoint = (V2F_C4B_T2F*)realloc(_bufferGLPoint, _bufferCapacityGLPoint*sizeof(V2F_C4B_T2F));
+        glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*capacity, buffer, GL_DYNAMIC_DRAW);
+        state.vboCapacity = capacity;
+        dirty = false;
     }
+    else if (state.dirtyBegin < state.dirtyEnd)
+    {
+        glBufferSubData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*state.dirtyBegin, sizeof(V2F_C4B_T2F)*(state.dirtyEnd - state.dirtyBegin), buffer + state.dirtyBegin);
+    }
+    state.dirtyBegin = 0;
+    state.dirtyEnd = 0;
 }
 
-void DrawNode::ensureCapacityGLLine(int count)
+void DrawNode::drawVertices(GLenum mode, GLsizei bufferCount, const BufferState& state)
 {
-    CCASSERT(count>=0, "capacity must be >= 0");
-    
-    if(_bufferCountGLLine + count > _bufferCapacityGLLine)
+    // the older vertices of a ring which wrapped, then the newer ones
+    if (state.ringEnd > 0)
     {
-        _bufferCapacityGLLine += MAX(_bufferCapacityGLLine, count);
-        _bufferGLLine = (V2F_C4B_T2F*)realloc(_bufferGLLine, _bufferCapacityGLLine*sizeof(V2F_C4B_T2F));
+        glDrawArrays(mode, state.ringStart, state.ringEnd - state.ringStart);
+        glDrawArrays(mode, 0, bufferCount);
     }
+    else
+    {
+        glDrawArrays(mode, state.ringStart, bufferCount - state.ringStart);
+    }
+}
+
+GLsizei DrawNode::getVertexCount(GLsizei bufferCount, const BufferState& state)
+{
+    return state.ringEnd > 0 ? state.ringEnd - state.ringStart + bufferCount : bufferCount - state.ringStart;
 }
 
 void DrawNode::setupBuffer()
@@ -198,7 +296,7 @@ void DrawNode::setupBuffer()
         GL::bindVAO(_vao);
         glGenBuffers(1, &_vbo);
         glBindBuffer(GL_ARRAY_BUFFER, _vbo);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)* _bufferCapacity, _buffer, GL_STREAM_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)* _bufferCapacity, _buffer, GL_DYNAMIC_DRAW);
         // vertex
         glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
         glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, vertices));
@@ -213,7 +311,7 @@ void DrawNode::setupBuffer()
         GL::bindVAO(_vaoGLLine);
         glGenBuffers(1, &_vboGLLine);
         glBindBuffer(GL_ARRAY_BUFFER, _vboGLLine);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCapacityGLLine, _bufferGLLine, GL_STREAM_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCapacityGLLine, _bufferGLLine, GL_DYNAMIC_DRAW);
         // vertex
         glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
         glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, vertices));
@@ -228,7 +326,7 @@ void DrawNode::setupBuffer()
         GL::bindVAO(_vaoGLPoint);
         glGenBuffers(1, &_vboGLPoint);
         glBindBuffer(GL_ARRAY_BUFFER, _vboGLPoint);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCapacityGLPoint, _bufferGLPoint, GL_STREAM_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCapacityGLPoint, _bufferGLPoint, GL_DYNAMIC_DRAW);
         // vertex
         glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
         glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, vertices));
@@ -247,19 +345,26 @@ void DrawNode::setupBuffer()
     {
         glGenBuffers(1, &_vbo);
         glBindBuffer(GL_ARRAY_BUFFER, _vbo);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)* _bufferCapacity, _buffer, GL_STREAM_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)* _bufferCapacity, _buffer, GL_DYNAMIC_DRAW);
 
         glGenBuffers(1, &_vboGLLine);
         glBindBuffer(GL_ARRAY_BUFFER, _vboGLLine);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCapacityGLLine, _bufferGLLine, GL_STREAM_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCapacityGLLine, _bufferGLLine, GL_DYNAMIC_DRAW);
 
         glGenBuffers(1, &_vboGLPoint);
         glBindBuffer(GL_ARRAY_BUFFER, _vboGLPoint);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCapacityGLPoint, _bufferGLPoint, GL_STREAM_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCapacityGLPoint, _bufferGLPoint, GL_DYNAMIC_DRAW);
 
         glBindBuffer(GL_ARRAY_BUFFER, 0);
     }
 
+    _bufferState.vboCapacity = _bufferCapacity;
+    _bufferStateGLLine.vboCapacity = _bufferCapacityGLLine;
+    _bufferStateGLPoint.vboCapacity = _bufferCapacityGLPoint;
+    _bufferState.dirtyBegin = _bufferState.dirtyEnd = 0;
+    _bufferStateGLLine.dirtyBegin = _bufferStateGLLine.dirtyEnd = 0;
+    _bufferStateGLPoint.dirtyBegin = _bufferStateGLPoint.dirtyEnd = 0;
+
     CHECK_GL_ERROR_DEBUG();
 }
 
@@ -283,21 +388,21 @@ bool DrawNode::init()
 
 void DrawNode::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
 {
-    if(_bufferCount)
+    if(getVertexCount(_bufferCount, _bufferState))
     {
         _customCommand.init(_globalZOrder, transform, flags);
         _customCommand.func = CC_CALLBACK_0(DrawNode::onDraw, this, transform, flags);
         renderer->addCommand(&_customCommand);
     }
     
-    if(_bufferCountGLPoint)
+    if(getVertexCount(_bufferCountGLPoint, _bufferStateGLPoint))
     {
         _customCommandGLPoint.init(_globalZOrder, transform, flags);
         _customCommandGLPoint.func = CC_CALLBACK_0(DrawNode::onDrawGLPoint, this, transform, flags);
         renderer->addCommand(&_customCommandGLPoint);
     }
     
-    if(_bufferCountGLLine)
+    if(getVertexCount(_bufferCountGLLine, _bufferStateGLLine))
     {
         _customCommandGLLine.init(_globalZOrder, transform, flags);
         _customCommandGLLine.func = CC_CALLBACK_0(DrawNode::onDrawGLLine, this, transform, flags);
@@ -312,13 +417,8 @@ void DrawNode::onDraw(const Mat4 &transform, uint32_t /*flags*/)
     glProgram->setUniformLocationWith1f(glProgram->getUniformLocation("u_alpha"), _displayedOpacity / 255.0);
     GL::blendFunc(_blendFunc.src, _blendFunc.dst);
 
-    if (_dirty)
-    {
-        glBindBuffer(GL_ARRAY_BUFFER, _vbo);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCapacity, _buffer, GL_STREAM_DRAW);
-        
-        _dirty = false;
-    }
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+    uploadVertices(_buffer, _bufferCapacity, _bufferState, _dirty);
     if (Configuration::getInstance()->supportsShareableVAO())
     {
         GL::bindVAO(_vao);
@@ -336,7 +436,7 @@ void DrawNode::onDraw(const Mat4 &transform, uint32_t /*flags*/)
         glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, texCoords));
     }
 
-    glDrawArrays(GL_TRIANGLES, 0, _bufferCount);
+    drawVertices(GL_TRIANGLES, _bufferCount, _bufferState);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     
     if (Configuration::getInstance()->supportsShareableVAO())
@@ -344,7 +444,7 @@ void DrawNode::onDraw(const Mat4 &transform, uint32_t /*flags*/)
         GL::bindVAO(0);
     }
     
-    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, _bufferCount);
+    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, getVertexCount(_bufferCount, _bufferState));
     CHECK_GL_ERROR_DEBUG();
 }
 
@@ -357,12 +457,8 @@ void DrawNode::onDrawGLLine(const Mat4 &transform, uint32_t /*flags*/)
 
     GL::blendFunc(_blendFunc.src, _blendFunc.dst);
 
-    if (_dirtyGLLine)
-    {
-        glBindBuffer(GL_ARRAY_BUFFER, _vboGLLine);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCapacityGLLine, _bufferGLLine, GL_STREAM_DRAW);
-        _dirtyGLLine = false;
-    }
+    glBindBuffer(GL_ARRAY_BUFFER, _vboGLLine);
+    uploadVertices(_bufferGLLine, _bufferCapacityGLLine, _bufferStateGLLine, _dirtyGLLine);
     if (Configuration::getInstance()->supportsShareableVAO())
     {
         GL::bindVAO(_vaoGLLine);
@@ -380,7 +476,7 @@ void DrawNode::onDrawGLLine(const Mat4 &transform, uint32_t /*flags*/)
     }
 
     glLineWidth(_lineWidth);
-    glDrawArrays(GL_LINES, 0, _bufferCountGLLine);
+    drawVertices(GL_LINES, _bufferCountGLLine, _bufferStateGLLine);
     
     if (Configuration::getInstance()->supportsShareableVAO())
     {
@@ -388,7 +484,7 @@ void DrawNode::onDrawGLLine(const Mat4 &transform, uint32_t /*flags*/)
     }
     
     glBindBuffer(GL_ARRAY_BUFFER, 0);
-    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1,_bufferCountGLLine);
+    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, getVertexCount(_bufferCountGLLine, _bufferStateGLLine));
 
     CHECK_GL_ERROR_DEBUG();
 }
@@ -402,13 +498,8 @@ void DrawNode::onDrawGLPoint(const Mat4 &transform, uint32_t /*flags*/)
 
     GL::blendFunc(_blendFunc.src, _blendFunc.dst);
 
-    if (_dirtyGLPoint)
-    {
-        glBindBuffer(GL_ARRAY_BUFFER, _vboGLPoint);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCapacityGLPoint, _bufferGLPoint, GL_STREAM_DRAW);
-        
-        _dirtyGLPoint = false;
-    }
+    glBindBuffer(GL_ARRAY_BUFFER, _vboGLPoint);
+    uploadVertices(_bufferGLPoint, _bufferCapacityGLPoint, _bufferStateGLPoint, _dirtyGLPoint);
     
     if (Configuration::getInstance()->supportsShareableVAO())
     {
@@ -423,7 +514,7 @@ void DrawNode::onDrawGLPoint(const Mat4 &transform, uint32_t /*flags*/)
         glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_C4B_T2F), (GLvoid *)offsetof(V2F_C4B_T2F, texCoords));
     }
     
-    glDrawArrays(GL_POINTS, 0, _bufferCountGLPoint);
+    drawVertices(GL_POINTS, _bufferCountGLPoint, _bufferStateGLPoint);
     
     if (Configuration::getInstance()->supportsShareableVAO())
     {
@@ -432,7 +523,7 @@ void DrawNode::onDrawGLPoint(const Mat4 &transform, uint32_t /*flags*/)
     
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     
-    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1,_bufferCountGLPoint);
+    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, getVertexCount(_bufferCountGLPoint, _bufferStateGLPoint));
     CHECK_GL_ERROR_DEBUG();
 }
 
@@ -445,7 +536,6 @@ void DrawNode::drawPoint(const Vec2& position, const float pointSize, const Colo
     *point = a;
     
     _bufferCountGLPoint += 1;
-    _dirtyGLPoint = true;
 }
 
 void DrawNode::drawPoints(const Vec2 *position, unsigned int numberOfPoints, const Color4F &color)
@@ -466,7 +556,6 @@ void DrawNode::drawPoints(const Vec2 *position, unsigned int numberOfPoints, con
     }
     
     _bufferCountGLPoint += numberOfPoints;
-    _dirtyGLPoint = true;
 }
 
 void DrawNode::drawLine(const Vec2 &origin, const Vec2 &destination, const Color4F &color)
@@ -482,7 +571,6 @@ void DrawNode::drawLine(const Vec2 &origin, const Vec2 &destination, const Color
     *(point+1) = b;
     
     _bufferCountGLLine += 2;
-    _dirtyGLLine = true;
 }
 
 void DrawNode::drawRect(const Vec2 &origin, const Vec2 &destination, const Color4F &color)
@@ -666,8 +754,6 @@ void DrawNode::drawDot(const Vec2 &pos, float radius, const Color4F &color)
     triangles[1] = triangle1;
     
     _bufferCount += vertex_count;
-    
-    _dirty = true;
 }
 
 void DrawNode::drawRect(const Vec2 &p1, const Vec2 &p2, const Vec2 &p3, const Vec2& p4, const Color4F &color)
@@ -747,8 +833,6 @@ void DrawNode::drawSegment(const Vec2 &from, const Vec2 &to, float radius, const
     triangles[5] = triangles5;
     
     _bufferCount += vertex_count;
-    
-    _dirty = true;
 }
 
 void DrawNode::drawPolygon(const Vec2 *verts, int count, const Color4F &fillColor, float borderWidth, const Color4F &borderColor)
@@ -830,8 +914,6 @@ void DrawNode::drawPolygon(const Vec2 *verts, int count, const Color4F &fillColo
     }
     
     _bufferCount += vertex_count;
-    
-    _dirty = true;
 }
 
 void DrawNode::drawSolidRect(const Vec2 &origin, const Vec2 &destination, const Color4F &color)
@@ -894,7 +976,6 @@ void DrawNode::drawTriangle(const Vec2 &p1, const Vec2 &p2, const Vec2 &p3, cons
     triangles[0] = triangle;
 
     _bufferCount += vertex_count;
-    _dirty = true;
 }
 
 void DrawNode::drawQuadraticBezier(const Vec2& from, const Vec2& control, const Vec2& to, unsigned int segments, const Color4F &color)
@@ -904,13 +985,21 @@ void DrawNode::drawQuadraticBezier(const Vec2& from, const Vec2& control, const
 
 void DrawNode::clear()
 {
-    _bufferCount = 0;
-    _dirty = true;
-    _bufferCountGLLine = 0;
-    _dirtyGLLine = true;
-    _bufferCountGLPoint = 0;
-    _dirtyGLPoint = true;
+    // the vertices on the GPU are overwritten by the next primitives
+    resetBuffer(_bufferCount, _bufferState);
+    resetBuffer(_bufferCountGLLine, _bufferStateGLLine);
+    resetBuffer(_bufferCountGLPoint, _bufferStateGLPoint);
     _lineWidth = _defaultLineWidth;
+    markDamaged();
+}
+
+void DrawNode::setRingCapacity(int triangleVertices, int lineVertices, int pointVertices)
+{
+    CCASSERT(triangleVertices >= 0 && lineVertices >= 0 && pointVertices >= 0, "capacity must be >= 0");
+    clear();
+    _bufferState.ringCapacity = triangleVertices;
+    _bufferStateGLLine.ringCapacity = lineVertices;
+    _bufferStateGLPoint.ringCapacity = pointVertices;
 }
 
 const BlendFunc& DrawNode::getBlendFunc() const
@@ -32,6 +32,8 @@
 #ifndef __CCDRAWNODES_CCDRAW_NODE_H__
 #define __CCDRAWNODES_CCDRAW_NODE_H__
 
+#include <deque>
+
 #include "2d/CCNode.h"
 #include "base/ccTypes.h"
 #include "renderer/CCCustomCommand.h"
@@ -50,6 +52,7 @@ class PointArray;
 /** @class DrawNode
  * @brief Node that draws dots, segments and polygons.
  * Faster than the "drawing primitives" since they draws everything in one single batch.
+ * The vertices are kept on the GPU between frames, only the primitives drawn since the last frame are uploaded.
  * @since v2.1
  */
 class CC_DLL DrawNode : public Node
@@ -285,6 +288,18 @@ public:
     
     /** Clear the geometry in the node's buffer. */
     void clear();
+    
+    /** Keeps only the last primitives drawn, for trails: when a buffer is full, drawing a primitive drops the
+     * oldest primitives of the buffer instead of growing it, and only the new vertices are uploaded.
+     * The triangles (dots, segments, polygons, solid shapes), the lines and the points have their own buffer.
+     * Clears the geometry.
+     *
+     * @param triangleVertices The capacity of the triangles buffer in vertices, 0 for a growing buffer.
+     * @param lineVertices The capacity of the lines buffer in vertices, 0 for a growing buffer.
+     * @param pointVertices The capacity of the points buffer in vertices, 0 for a growing buffer.
+     * @since v3.17
+     */
+    void setRingCapacity(int triangleVertices, int lineVertices = 0, int pointVertices = 0);
     /** Get the color mixed mode.
     * @lua NA
     */
@@ -335,9 +350,32 @@ CC_CONSTRUCTOR_ACCESS:
     virtual bool init() override;
 
 protected:
+    /** The vertices of a buffer which are not on the GPU yet, and the primitives of a ring buffer.
+     * A ring holds the vertices [ringStart, ringEnd[ then [0, count[ once it wrapped, [ringStart, count[ otherwise.
+     */
+    struct BufferState
+    {
+        int vboCapacity = 0;
+        int dirtyBegin = 0;
+        int dirtyEnd = 0;
+        // 0 for a growing buffer
+        int ringCapacity = 0;
+        int ringStart = 0;
+        int ringEnd = 0;
+        // vertex count of the primitives of a ring, oldest first
+        std::deque<int> primitives;
+    };
+    
+    // the vertices of a primitive are written at the count of the buffer right after ensuring its capacity
     void ensureCapacity(int count);
     void ensureCapacityGLPoint(int count);
     void ensureCapacityGLLine(int count);
+    void reserveVertices(V2F_C4B_T2F*& buffer, int& capacity, GLsizei& bufferCount, BufferState& state, int count);
+    void resetBuffer(GLsizei& bufferCount, BufferState& state);
+    // uploads the vertices modified since the last upload, or the whole buffer if dirty, to the bound VBO
+    void uploadVertices(const V2F_C4B_T2F* buffer, int capacity, BufferState& state, bool& dirty);
+    void drawVertices(GLenum mode, GLsizei bufferCount, const BufferState& state);
+    static GLsizei getVertexCount(GLsizei bufferCount, const BufferState& state);
 
     void setupBuffer();
 
@@ -361,12 +399,17 @@ protected:
     int         _bufferCapacityGLLine = 0;
     GLsizei     _bufferCountGLLine = 0;
     V2F_C4B_T2F *_bufferGLLine = nullptr;
+    
+    BufferState _bufferState;
+    BufferState _bufferStateGLPoint;
+    BufferState _bufferStateGLLine;
 
     BlendFunc   _blendFunc;
     CustomCommand _customCommand;
     CustomCommand _customCommandGLPoint;
     CustomCommand _customCommandGLLine;
 
+    // the whole buffer must be uploaded, the primitives only upload their vertices
     bool        _dirty = false;
     bool        _dirtyGLPoint = false;
     bool        _dirtyGLLine = false;
@@ -0,0 +1,563 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/CCDynamicAtlas.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+#include "2d/CCSpriteFrame.h"
+#include "base/CCConfiguration.h"
+#include "base/ccMacros.h"
+#include "platform/CCImage.h"
+#include "renderer/CCTexture2D.h"
+#include "renderer/CCTextureCache.h"
+#include "renderer/ccGLStateCache.h"
+#include "renderer/ccPixelConvert.h"
+
+NS_CC_BEGIN
+
+namespace {
+
+// transparent border around the images, so that they don't bleed into each other when filtered
+const int ImagePadding = 1;
+
+struct PackRect
+{
+    int x;
+    int y;
+    int width;
+    int height;
+};
+
+bool containsRect(const PackRect& a, const PackRect& b)
+{
+    return b.x >= a.x && b.y >= a.y && b.x + b.width <= a.x + a.width && b.y + b.height <= a.y + a.height;
+}
+
+bool intersectsRect(const PackRect& a, const PackRect& b)
+{
+    return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+}
+
+// MaxRects packer: the free area is the union of the maximal free rectangles, which may overlap.
+// Positions are chosen with the best short side fit heuristic.
+bool findPosition(const std::vector<PackRect>& freeRects, int width, int height, PackRect& rect)
+{
+    int bestShortSide = INT_MAX;
+    int bestLongSide = INT_MAX;
+    for (const auto& freeRect : freeRects)
+    {
+        if (freeRect.width < width || freeRect.height < height)
+            continue;
+
+        int leftoverX = freeRect.width - width;
+        int leftoverY = freeRect.height - height;
+        int shortSide = std::min(leftoverX, leftoverY);
+        int longSide = std::max(leftoverX, leftoverY);
+        if (shortSide < bestShortSide || (shortSide == bestShortSide && longSide < bestLongSide))
+        {
+            rect = { freeRect.x, freeRect.y, width, height };
+            bestShortSide = shortSide;
+            bestLongSide = longSide;
+        }
+    }
+    return bestShortSide != INT_MAX;
+}
+
+void placeRect(std::vector<PackRect>& freeRects, const PackRect& used)
+{
+    // split the free rectangles overlapped by the used one
+    const size_t count = freeRects.size();
+    for (size_t i = 0; i < count; ++i)
+    {
+        const PackRect free = freeRects[i];
+        if (!intersectsRect(free, used))
+            continue;
+
+        if (used.x > free.x)
+            freeRects.push_back({ free.x, free.y, used.x - free.x, free.height });
+        if (used.x + used.width < free.x + free.width)
+            freeRects.push_back({ used.x + used.width, free.y, free.x + free.width - used.x - used.width, free.height });
+        if (used.y > free.y)
+            freeRects.push_back({ free.x, free.y, free.width, used.y - free.y });
+        if (used.y + used.height < free.y + free.height)
+            freeRects.push_back({ free.x, used.y + used.height, free.width, free.y + free.height - used.y - used.height });
+        freeRects[i].width = 0;
+    }
+
+    // remove the split and the contained ones
+    freeRects.erase(std::remove_if(freeRects.begin(), freeRects.end(), [](const PackRect& rect) {
+        return rect.width == 0;
+    }), freeRects.end());
+    for (size_t i = 0; i < freeRects.size(); ++i)
+    {
+        for (size_t j = i + 1; j < freeRects.size(); ++j)
+        {
+            if (containsRect(freeRects[j], freeRects[i]))
+            {
+                freeRects.erase(freeRects.begin() + i);
+                --i;
+                break;
+            }
+            if (containsRect(freeRects[i], freeRects[j]))
+            {
+                freeRects.erase(freeRects.begin() + j);
+                --j;
+            }
+        }
+    }
+}
+
+// Moves areas of a texture. They are copied to a temporary texture first since they may overlap.
+void moveTextureAreas(Texture2D* texture, const std::vector<PackRect>& from, const std::vector<PackRect>& to)
+{
+    GLint oldFBO;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &oldFBO);
+
+    GLuint fbo;
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+
+    GLuint temporary;
+    glGenTextures(1, &temporary);
+    GL::bindTexture2D(temporary);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, texture->getPixelsWide(), texture->getPixelsHigh(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture->getName(), 0);
+    for (size_t i = 0; i < from.size(); ++i)
+        glCopyTexSubImage2D(GL_TEXTURE_2D, 0, to[i].x, to[i].y, from[i].x, from[i].y, from[i].width, from[i].height);
+
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, temporary, 0);
+    GL::bindTexture2D(texture->getName());
+    for (const auto& rect : to)
+        glCopyTexSubImage2D(GL_TEXTURE_2D, 0, rect.x, rect.y, rect.x, rect.y, rect.width, rect.height);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, oldFBO);
+    glDeleteFramebuffers(1, &fbo);
+    GL::deleteTexture(temporary);
+
+    CHECK_GL_ERROR_DEBUG();
+}
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+void readPixels(const std::vector<unsigned char>& pageData, int pageSize, const PackRect& rect, unsigned char* pixels)
+{
+    for (int row = 0; row < rect.height; ++row)
+        memcpy(pixels + row * rect.width * 4, &pageData[((rect.y + row) * pageSize + rect.x) * 4], rect.width * 4);
+}
+
+void writePixels(std::vector<unsigned char>& pageData, int pageSize, const PackRect& rect, const unsigned char* pixels)
+{
+    for (int row = 0; row < rect.height; ++row)
+        memcpy(&pageData[((rect.y + row) * pageSize + rect.x) * 4], pixels + row * rect.width * 4, rect.width * 4);
+}
+#endif
+
+} // namespace
+
+struct DynamicAtlas::Entry
+{
+    Page* page;
+    // area of the image and its padding
+    PackRect rect;
+    SpriteFrame* frame;
+    bool removed;
+
+    ~Entry()
+    {
+        CC_SAFE_RELEASE(frame);
+    }
+};
+
+struct DynamicAtlas::Page
+{
+    Texture2D* texture;
+    std::vector<PackRect> freeRects;
+    std::vector<Entry*> entries;
+    int usedArea;
+    // whether it was defragmented since the last images were released
+    bool defragmented;
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    // copy of the pixels, the texture is reloaded from it when the GL context is recreated
+    std::vector<unsigned char> data;
+#endif
+
+    ~Page()
+    {
+        for (auto entry : entries)
+            delete entry;
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+        // the texture can outlive the page through the sprite frames still in use
+        VolatileTextureMgr::removeTexture(texture);
+#endif
+        CC_SAFE_RELEASE(texture);
+    }
+};
+
+static DynamicAtlas* s_sharedDynamicAtlas = nullptr;
+
+DynamicAtlas* DynamicAtlas::getInstance()
+{
+    if (!s_sharedDynamicAtlas)
+    {
+        s_sharedDynamicAtlas = new (std::nothrow) DynamicAtlas();
+        if (!s_sharedDynamicAtlas || !s_sharedDynamicAtlas->init(2048))
+        {
+            CC_SAFE_DELETE(s_sharedDynamicAtlas);
+        }
+    }
+    return s_sharedDynamicAtlas;
+}
+
+void DynamicAtlas::destroyInstance()
+{
+    CC_SAFE_RELEASE_NULL(s_sharedDynamicAtlas);
+}
+
+DynamicAtlas* DynamicAtlas::create(int pageSize)
+{
+    DynamicAtlas* atlas = new (std::nothrow) DynamicAtlas();
+    if (atlas && atlas->init(pageSize))
+    {
+        atlas->autorelease();
+        return atlas;
+    }
+    CC_SAFE_DELETE(atlas);
+    return nullptr;
+}
+
+DynamicAtlas::DynamicAtlas()
+: _pageSize(0)
+, _maxImageSize(0)
+{
+}
+
+DynamicAtlas::~DynamicAtlas()
+{
+    for (auto page : _pages)
+        delete page;
+}
+
+bool DynamicAtlas::init(int pageSize)
+{
+    _pageSize = std::min(pageSize, Configuration::getInstance()->getMaxTextureSize());
+    _maxImageSize = _pageSize / 4;
+    return _pageSize > 2 * ImagePadding;
+}
+
+Texture2D* DynamicAtlas::getPageTexture(ssize_t index) const
+{
+    CCASSERT(index >= 0 && index < (ssize_t)_pages.size(), "Invalid page index");
+    return _pages[index]->texture;
+}
+
+SpriteFrame* DynamicAtlas::getSpriteFrame(const std::string& key) const
+{
+    auto it = _entries.find(key);
+    return it != _entries.end() ? it->second->frame : nullptr;
+}
+
+SpriteFrame* DynamicAtlas::addImage(Image* image, const std::string& key)
+{
+    CCASSERT(image != nullptr, "DynamicAtlas: image MUST not be nil");
+    return addImage(image, key, image->hasPremultipliedAlpha());
+}
+
+SpriteFrame* DynamicAtlas::addImage(Image* image, const std::string& key, bool premultipliedAlpha)
+{
+    CCASSERT(image != nullptr, "DynamicAtlas: image MUST not be nil");
+
+    auto it = _entries.find(key);
+    if (it != _entries.end())
+        return it->second->frame;
+
+    const unsigned char* data = image->getData();
+    const ssize_t pixelCount = (ssize_t)image->getWidth() * image->getHeight();
+    std::vector<unsigned char> converted;
+    switch (image->getRenderFormat())
+    {
+    case Texture2D::PixelFormat::RGBA8888:
+        if (!premultipliedAlpha)
+        {
+            converted.assign(data, data + pixelCount * 4);
+            PixelConvert::premultiplyAlphaRGBA8888(converted.data(), pixelCount);
+        }
+        break;
+    case Texture2D::PixelFormat::RGB888:
+        converted.resize(pixelCount * 4);
+        PixelConvert::convertRGB888ToRGBA8888(data, pixelCount, converted.data());
+        break;
+    case Texture2D::PixelFormat::AI88:
+        converted.resize(pixelCount * 4);
+        PixelConvert::convertAI88ToRGBA8888(data, pixelCount, converted.data());
+        if (!premultipliedAlpha)
+            PixelConvert::premultiplyAlphaRGBA8888(converted.data(), pixelCount);
+        break;
+    case Texture2D::PixelFormat::I8:
+        converted.resize(pixelCount * 4);
+        PixelConvert::convertI8ToRGBA8888(data, pixelCount, converted.data());
+        break;
+    default:
+        CCLOG("cocos2d: DynamicAtlas: unsupported pixel format of image %s", key.c_str());
+        return nullptr;
+    }
+
+    return addImageData(converted.empty() ? data : converted.data(), image->getWidth(), image->getHeight(), key);
+}
+
+SpriteFrame* DynamicAtlas::addImageData(const unsigned char* data, int width, int height, const std::string& key)
+{
+    auto it = _entries.find(key);
+    if (it != _entries.end())
+        return it->second->frame;
+
+    if (width <= 0 || height <= 0 || width > _maxImageSize || height > _maxImageSize || width + 2 * ImagePadding > _pageSize || height + 2 * ImagePadding > _pageSize)
+    {
+        CCLOG("cocos2d: DynamicAtlas: image %s of %d x %d can't be added", key.c_str(), width, height);
+        return nullptr;
+    }
+
+    Entry* entry = insert(width + 2 * ImagePadding, height + 2 * ImagePadding);
+    if (!entry)
+        return nullptr;
+
+    // the padding is uploaded with the image since the area may have been used before
+    const PackRect& rect = entry->rect;
+    std::vector<unsigned char> pixels(rect.width * rect.height * 4, 0);
+    for (int row = 0; row < height; ++row)
+        memcpy(&pixels[((row + ImagePadding) * rect.width + ImagePadding) * 4], data + row * width * 4, width * 4);
+
+    Page* page = entry->page;
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    page->texture->updateWithData(pixels.data(), rect.x, rect.y, rect.width, rect.height);
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    writePixels(page->data, _pageSize, rect, pixels.data());
+#endif
+
+    entry->frame = SpriteFrame::createWithTexture(page->texture, Rect(rect.x + ImagePadding, rect.y + ImagePadding, width, height),
+                                                  false, Vec2::ZERO, Size(width, height));
+    entry->frame->retain();
+    _entries.emplace(key, entry);
+    return entry->frame;
+}
+
+DynamicAtlas::Entry* DynamicAtlas::insert(int width, int height)
+{
+    Page* page = nullptr;
+    PackRect rect;
+    auto fits = [&](Page* candidate) {
+        return findPosition(candidate->freeRects, width, height, rect);
+    };
+
+    auto found = std::find_if(_pages.begin(), _pages.end(), fits);
+    if (found == _pages.end())
+    {
+        // reuse the areas of the removed images, then compact the pages before adding one
+        collectRemovedEntries();
+        found = std::find_if(_pages.begin(), _pages.end(), fits);
+    }
+    if (found == _pages.end())
+    {
+        found = std::find_if(_pages.begin(), _pages.end(), [&](Page* candidate) {
+            return _pageSize * _pageSize - candidate->usedArea >= width * height && defragmentPage(candidate) && fits(candidate);
+        });
+    }
+
+    if (found != _pages.end())
+    {
+        page = *found;
+    }
+    else
+    {
+        page = new (std::nothrow) Page();
+        page->texture = new (std::nothrow) Texture2D();
+        page->usedArea = 0;
+        page->defragmented = false;
+
+        const ssize_t dataLen = (ssize_t)_pageSize * _pageSize * 4;
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+        page->data.resize(dataLen, 0);
+        const unsigned char* pageData = page->data.data();
+#else
+        std::vector<unsigned char> clearData(dataLen, 0);
+        const unsigned char* pageData = clearData.data();
+#endif
+        if (!page->texture->initWithData(pageData, dataLen, Texture2D::PixelFormat::RGBA8888, _pageSize, _pageSize, Size(_pageSize, _pageSize)))
+        {
+            CCLOG("cocos2d: DynamicAtlas: couldn't create a page of %d x %d", _pageSize, _pageSize);
+            delete page;
+            return nullptr;
+        }
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+        VolatileTextureMgr::addDataTexture(page->texture, page->data.data(), (int)dataLen, Texture2D::PixelFormat::RGBA8888, Size(_pageSize, _pageSize));
+#endif
+        page->texture->_hasPremultipliedAlpha = true;
+        page->freeRects.push_back({ 0, 0, _pageSize, _pageSize });
+        _pages.push_back(page);
+        fits(page);
+    }
+
+    placeRect(page->freeRects, rect);
+    page->usedArea += rect.width * rect.height;
+    // the new image changes the layout, it may be worth packing again
+    page->defragmented = false;
+
+    Entry* entry = new (std::nothrow) Entry();
+    entry->page = page;
+    entry->rect = rect;
+    entry->frame = nullptr;
+    entry->removed = false;
+    page->entries.push_back(entry);
+    return entry;
+}
+
+void DynamicAtlas::removeImage(const std::string& key)
+{
+    auto it = _entries.find(key);
+    if (it == _entries.end())
+        return;
+
+    it->second->removed = true;
+    _entries.erase(it);
+}
+
+void DynamicAtlas::removeAllImages()
+{
+    for (auto& item : _entries)
+        item.second->removed = true;
+    _entries.clear();
+
+    collectRemovedEntries();
+}
+
+void DynamicAtlas::collectRemovedEntries()
+{
+    for (auto it = _pages.begin(); it != _pages.end(); /* nothing */)
+    {
+        Page* page = *it;
+        bool released = false;
+        for (auto entryIt = page->entries.begin(); entryIt != page->entries.end(); /* nothing */)
+        {
+            Entry* entry = *entryIt;
+            if (entry->removed && entry->frame->getReferenceCount() == 1)
+            {
+                page->usedArea -= entry->rect.width * entry->rect.height;
+                delete entry;
+                entryIt = page->entries.erase(entryIt);
+                released = true;
+            }
+            else
+            {
+                ++entryIt;
+            }
+        }
+
+        if (page->entries.empty())
+        {
+            delete page;
+            it = _pages.erase(it);
+            continue;
+        }
+
+        if (released)
+        {
+            page->defragmented = false;
+            page->freeRects.assign(1, { 0, 0, _pageSize, _pageSize });
+            for (auto entry : page->entries)
+                placeRect(page->freeRects, entry->rect);
+        }
+        ++it;
+    }
+}
+
+void DynamicAtlas::defragment()
+{
+    collectRemovedEntries();
+    for (auto page : _pages)
+        defragmentPage(page);
+}
+
+bool DynamicAtlas::defragmentPage(Page* page)
+{
+    if (page->defragmented)
+        return false;
+    page->defragmented = true;
+
+    // the images used by sprites stay in place, the other ones are packed again around them from the largest
+    std::vector<Entry*> moved;
+    std::vector<PackRect> freeRects(1, { 0, 0, _pageSize, _pageSize });
+    for (auto entry : page->entries)
+    {
+        if (!entry->removed && entry->frame->getReferenceCount() == 1)
+            moved.push_back(entry);
+        else
+            placeRect(freeRects, entry->rect);
+    }
+    if (moved.empty())
+        return false;
+
+    std::sort(moved.begin(), moved.end(), [](const Entry* a, const Entry* b) {
+        return std::max(a->rect.width, a->rect.height) > std::max(b->rect.width, b->rect.height);
+    });
+
+    std::vector<PackRect> from;
+    std::vector<PackRect> to;
+    for (auto entry : moved)
+    {
+        PackRect rect;
+        if (!findPosition(freeRects, entry->rect.width, entry->rect.height, rect))
+            return false;
+        placeRect(freeRects, rect);
+        from.push_back(entry->rect);
+        to.push_back(rect);
+    }
+
+    moveTextureAreas(page->texture, from, to);
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    std::vector<std::vector<unsigned char>> pixels(moved.size());
+    for (size_t i = 0; i < moved.size(); ++i)
+    {
+        pixels[i].resize(from[i].width * from[i].height * 4);
+        readPixels(page->data, _pageSize, from[i], pixels[i].data());
+    }
+    for (size_t i = 0; i < moved.size(); ++i)
+        writePixels(page->data, _pageSize, to[i], pixels[i].data());
+#endif
+
+    for (size_t i = 0; i < moved.size(); ++i)
+    {
+        moved[i]->rect = to[i];
+        moved[i]->frame->setRectInPixels(Rect(to[i].x + ImagePadding, to[i].y + ImagePadding,
+                                              to[i].width - 2 * ImagePadding, to[i].height - 2 * ImagePadding));
+    }
+    page->freeRects.swap(freeRects);
+    return true;
+}
+
+NS_CC_END
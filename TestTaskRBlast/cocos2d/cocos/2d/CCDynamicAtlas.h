@@ -0,0 +1,156 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCDYNAMIC_ATLAS_H__
+#define __CCDYNAMIC_ATLAS_H__
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "base/CCRef.h"
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+class Image;
+class SpriteFrame;
+class Texture2D;
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/** @class DynamicAtlas
+ * @brief Packs images loaded at runtime into shared texture pages.
+
+ Every image loaded at runtime, like avatars, downloaded icons or RenderTexture snapshots
+ (through RenderTexture::newImage), is usually its own texture, so the sprites showing them
+ can't be batched together. DynamicAtlas copies the small images into RGBA8888 pages of
+ 2048x2048 pixels with a MaxRects packer and returns SpriteFrames of the pages: the sprites
+ showing images of the same page are drawn in one batch. Snapshots are added with
+ addImage(image, key, true), their pixels are already premultiplied.
+
+ The pixels are premultiplied by alpha, like the textures of PNG files.
+
+ Removing an image releases its area once its SpriteFrame isn't used any more.
+ defragment() moves the images which aren't used by any sprite to make the free areas
+ contiguous again, it is also done before creating a new page.
+ 
+ @since v3.17
+ */
+class CC_DLL DynamicAtlas : public Ref
+{
+public:
+    /** Returns the shared instance of the atlas. */
+    static DynamicAtlas* getInstance();
+
+    /** Destroys the shared instance of the atlas. */
+    static void destroyInstance();
+
+    /** Creates an atlas.
+     * @param pageSize Width and height of the pages in pixels, limited by the maximum texture size.
+     */
+    static DynamicAtlas* create(int pageSize = 2048);
+
+    /** Adds an image to the atlas.
+     * If an image was already added with the key, its SpriteFrame is returned.
+     * @param image An image with the RGBA8888, RGB888, AI88 or I8 format.
+     * @param key The key of the image, usually its file path or URL.
+     * @return The SpriteFrame of the image, nullptr if the image is too large or has a compressed format.
+     */
+    SpriteFrame* addImage(Image* image, const std::string& key);
+
+    /** Adds an image to the atlas, @see addImage.
+     * @param premultipliedAlpha Whether the pixels are already premultiplied by alpha. Pass true for
+     * RenderTexture::newImage() snapshots: framebuffer pixels are premultiplied though the Image doesn't say so.
+     */
+    SpriteFrame* addImage(Image* image, const std::string& key, bool premultipliedAlpha);
+
+    /** Adds RGBA8888 pixels premultiplied by alpha to the atlas, @see addImage.
+     * @param data The pixels, the first row is the top of the image.
+     * @param width Width in pixels.
+     * @param height Height in pixels.
+     * @param key The key of the image.
+     */
+    SpriteFrame* addImageData(const unsigned char* data, int width, int height, const std::string& key);
+
+    /** Returns the SpriteFrame of an image, nullptr if there is no image with the key. */
+    SpriteFrame* getSpriteFrame(const std::string& key) const;
+
+    /** Removes an image from the atlas.
+     * Its area is reused once its SpriteFrame is released by the sprites using it.
+     */
+    void removeImage(const std::string& key);
+
+    /** Removes all the images from the atlas. */
+    void removeAllImages();
+
+    /** Moves the images of each page which aren't used outside of the atlas so that the free areas are contiguous.
+     * The SpriteFrames of the moved images are updated.
+     */
+    void defragment();
+
+    /** Sets the maximum width and height of the images added, the larger ones aren't worth batching.
+     * Default is a quarter of the page size.
+     */
+    void setMaxImageSize(int size) { _maxImageSize = size; }
+    /** Gets the maximum width and height of the images added. */
+    int getMaxImageSize() const { return _maxImageSize; }
+
+    /** Gets the width and height of the pages in pixels. */
+    int getPageSize() const { return _pageSize; }
+    /** Gets the number of pages. */
+    ssize_t getPageCount() const { return _pages.size(); }
+    /** Gets the texture of a page. */
+    Texture2D* getPageTexture(ssize_t index) const;
+
+CC_CONSTRUCTOR_ACCESS:
+    DynamicAtlas();
+    virtual ~DynamicAtlas();
+
+    bool init(int pageSize);
+
+protected:
+    struct Page;
+    struct Entry;
+
+    Entry* insert(int width, int height);
+    // moves the unused images of a page, returns false if they don't fit
+    bool defragmentPage(Page* page);
+    // releases the areas of the removed images which aren't used any more, and the empty pages
+    void collectRemovedEntries();
+
+    int _pageSize;
+    int _maxImageSize;
+    std::vector<Page*> _pages;
+    std::unordered_map<std::string, Entry*> _entries;
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
+
+#endif // __CCDYNAMIC_ATLAS_H__
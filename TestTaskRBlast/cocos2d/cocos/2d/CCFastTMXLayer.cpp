@@ -37,6 +37,7 @@ THE SOFTWARE.
  */
 #include "2d/CCFastTMXLayer.h"
 #include "2d/CCFastTMXTiledMap.h"
+#include "2d/CCTMXBinaryMap.h"
 #include "2d/CCSprite.h"
 #include "2d/CCCamera.h"
 #include "renderer/CCTextureCache.h"
@@ -53,6 +54,13 @@ namespace experimental {
 const int TMXLayer::FAST_TMX_ORIENTATION_ORTHO = 0;
 const int TMXLayer::FAST_TMX_ORIENTATION_HEX = 1;
 const int TMXLayer::FAST_TMX_ORIENTATION_ISO = 2;
+// 32 x 32 tiles: 4096 vertices, a chunk can use 16 bit indices
+const int TMXLayer::FAST_TMX_CHUNK_SIZE = 32;
+
+// streamed layers load the chunks around the screen ahead, a few per update, and release the chunks farther than the kept ones
+static const int STREAM_PREFETCH_MARGIN = 1;
+static const int STREAM_PREFETCH_LOADS = 2;
+static const int STREAM_KEEP_MARGIN = 2;
 
 // FastTMXLayer - init & alloc & dealloc
 TMXLayer * TMXLayer::create(TMXTilesetInfo *tilesetInfo, TMXLayerInfo *layerInfo, TMXMapInfo *mapInfo)
@@ -80,6 +88,9 @@ bool TMXLayer::initWithTilesetInfo(TMXTilesetInfo *tilesetInfo, TMXLayerInfo *la
     _layerName = layerInfo->_name;
     _layerSize = layerInfo->_layerSize;
     _tiles = layerInfo->_tiles;
+    _binaryMap = layerInfo->_binaryMap;
+    CC_SAFE_RETAIN(_binaryMap);
+    _binaryLayerIndex = layerInfo->_binaryLayerIndex;
     _quadsDirty = true;
     setOpacity( layerInfo->_opacity );
     setProperties(layerInfo->getProperties());
@@ -120,10 +131,12 @@ TMXLayer::TMXLayer()
 , _vertexZvalue(0)
 , _useAutomaticVertexZ(false)
 , _quadsDirty(true)
+, _chunkColumns(0)
+, _chunkRows(0)
 , _dirty(true)
-, _vertexBuffer(nullptr)
-, _vData(nullptr)
 , _indexBuffer(nullptr)
+, _binaryMap(nullptr)
+, _binaryLayerIndex(-1)
 {
 }
 
@@ -132,15 +145,17 @@ TMXLayer::~TMXLayer()
     CC_SAFE_RELEASE(_tileSet);
     CC_SAFE_RELEASE(_texture);
     CC_SAFE_FREE(_tiles);
-    CC_SAFE_RELEASE(_vData);
-    CC_SAFE_RELEASE(_vertexBuffer);
+    for (auto& chunk : _chunks)
+    {
+        releaseChunk(chunk);
+    }
     CC_SAFE_RELEASE(_indexBuffer);
-    
+    CC_SAFE_RELEASE(_binaryMap);
 }
 
 void TMXLayer::draw(Renderer *renderer, const Mat4& transform, uint32_t flags)
 {
-    updateTotalQuads();
+    updateChunks();
 
     bool isViewProjectionUpdated = true;
     auto visitingCamera = Camera::getVisitingCamera();
@@ -149,7 +164,7 @@ void TMXLayer::draw(Renderer *renderer, const Mat4& transform, uint32_t flags)
         isViewProjectionUpdated = visitingCamera->isViewProjectionUpdated();
     }
     
-    if( flags != 0 || _dirty || _quadsDirty || isViewProjectionUpdated)
+    if( flags != 0 || _dirty || isViewProjectionUpdated)
     {
         Size s = Director::getInstance()->getVisibleSize();
         auto rect = Rect(Camera::getVisitingCamera()->getPositionX() - s.width * 0.5f,
@@ -161,25 +176,35 @@ void TMXLayer::draw(Renderer *renderer, const Mat4& transform, uint32_t flags)
         inv.inverse();
         rect = RectApplyTransform(rect, inv);
         
-        updateTiles(rect);
-        updateIndexBuffer();
-        updatePrimitives();
+        if (isStreamed())
+        {
+            updateStreamedChunks(rect);
+        }
+        else
+        {
+            updateVisibleChunks(rect);
+        }
         _dirty = false;
     }
     
-    if(_renderCommands.size() < static_cast<size_t>(_primitives.size()))
+    size_t commandCount = 0;
+    for (int index : _visibleChunks)
     {
-        _renderCommands.resize(_primitives.size());
+        commandCount += _chunks[index].batches.size();
+    }
+    if(_renderCommands.size() < commandCount)
+    {
+        _renderCommands.resize(commandCount);
     }
     
-    int index = 0;
-    for(const auto& iter : _primitives)
+    auto blendfunc = _texture->hasPremultipliedAlpha() ? BlendFunc::ALPHA_PREMULTIPLIED : BlendFunc::ALPHA_NON_PREMULTIPLIED;
+    int commandIndex = 0;
+    for (int index : _visibleChunks)
     {
-        if(iter.second->getCount() > 0)
+        for (const auto& batch : _chunks[index].batches)
         {
-            auto& cmd = _renderCommands[index++];
-            auto blendfunc = _texture->hasPremultipliedAlpha() ? BlendFunc::ALPHA_PREMULTIPLIED : BlendFunc::ALPHA_NON_PREMULTIPLIED;
-            cmd.init(iter.first, _texture->getName(), getGLProgramState(), blendfunc, iter.second, _modelViewTransform, flags);
+            auto& cmd = _renderCommands[commandIndex++];
+            cmd.init(batch.vertexZ, _texture->getName(), getGLProgramState(), blendfunc, batch.primitive, _modelViewTransform, flags);
             renderer->addCommand(&cmd);
         }
     }
@@ -197,132 +222,167 @@ void TMXLayer::onDraw(Primitive *primitive)
     CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, primitive->getCount() * 4);
 }
 
-void TMXLayer::updateTiles(const Rect& culledRect)
+void TMXLayer::updateVisibleChunks(const Rect& culledRect)
 {
-    Rect visibleTiles = Rect(culledRect.origin, culledRect.size * Director::getInstance()->getContentScaleFactor());
-    Size mapTileSize = CC_SIZE_PIXELS_TO_POINTS(_mapTileSize);
-    Size tileSize = CC_SIZE_PIXELS_TO_POINTS(_tileSet->_tileSize);
-    Mat4 nodeToTileTransform = _tileToNodeTransform.getInversed();
-    //transform to tile
-    visibleTiles = RectApplyTransform(visibleTiles, nodeToTileTransform);
-    // tile coordinate is upside-down, so we need to make the tile coordinate use top-left for the start point.
-    visibleTiles.origin.y += 1;
-    
-    // if x=0.7, width=9.5, we need to draw number 0~10 of tiles, and so is height.
-    visibleTiles.size.width = ceil(visibleTiles.origin.x + visibleTiles.size.width)  - floor(visibleTiles.origin.x);
-    visibleTiles.size.height = ceil(visibleTiles.origin.y + visibleTiles.size.height) - floor(visibleTiles.origin.y);
-    visibleTiles.origin.x = floor(visibleTiles.origin.x);
-    visibleTiles.origin.y = floor(visibleTiles.origin.y);
-
-    // for the bigger tiles.
-    int tilesOverX = 0;
-    int tilesOverY = 0;
-    // for diagonal orientation tiles
-    float tileSizeMax = std::max(tileSize.width, tileSize.height);
-    if (_layerOrientation == FAST_TMX_ORIENTATION_ORTHO)
-    {
-        tilesOverX = ceil(tileSizeMax / mapTileSize.width) - 1;
-        tilesOverY = ceil(tileSizeMax / mapTileSize.height) - 1;
-        
-        if (tilesOverX < 0) tilesOverX = 0;
-        if (tilesOverY < 0) tilesOverY = 0;
-    }
-    else if(_layerOrientation == FAST_TMX_ORIENTATION_ISO)
+    // the bounds of the chunks include the tiles bigger than the map tiles
+    _visibleChunks.clear();
+    for (int i = 0; i < (int)_chunks.size(); ++i)
     {
-        Rect overTileRect(0, 0, tileSizeMax - mapTileSize.width, tileSizeMax - mapTileSize.height);
-        if (overTileRect.size.width < 0) overTileRect.size.width = 0;
-        if (overTileRect.size.height < 0) overTileRect.size.height = 0;
-        overTileRect = RectApplyTransform(overTileRect, nodeToTileTransform);
-        
-        tilesOverX = ceil(overTileRect.origin.x + overTileRect.size.width) - floor(overTileRect.origin.x);
-        tilesOverY = ceil(overTileRect.origin.y + overTileRect.size.height) - floor(overTileRect.origin.y);
+        const auto& chunk = _chunks[i];
+        if (!chunk.batches.empty() && chunk.bounds.intersectsRect(culledRect))
+        {
+            _visibleChunks.push_back(i);
+        }
     }
-    else
+}
+
+void TMXLayer::getChunkRange(const Rect& rect, int margin, int& column, int& row, int& columnEnd, int& rowEnd) const
+{
+    // a tile is drawn from its position up to its size, which is swapped by the diagonal flag
+    Size tileSize = CC_SIZE_PIXELS_TO_POINTS(_tileSet->_tileSize);
+    float extent = std::max(tileSize.width, tileSize.height);
+    Mat4 nodeToTile = _tileToNodeTransform.getInversed();
+    
+    float minX = FLT_MAX;
+    float maxX = -FLT_MAX;
+    float minY = FLT_MAX;
+    float maxY = -FLT_MAX;
+    for (const Vec2& corner : {Vec2(rect.getMinX() - extent, rect.getMinY() - extent), Vec2(rect.getMaxX(), rect.getMinY() - extent),
+                               Vec2(rect.getMinX() - extent, rect.getMaxY()), Vec2(rect.getMaxX(), rect.getMaxY())})
     {
-        //do nothing, do not support
-        //CCASSERT(0, "TMX invalid value");
+        Vec3 tile(corner.x, corner.y, 0.0f);
+        nodeToTile.transformPoint(&tile);
+        minX = std::min(minX, tile.x);
+        maxX = std::max(maxX, tile.x);
+        minY = std::min(minY, tile.y);
+        maxY = std::max(maxY, tile.y);
     }
     
-    _indicesVertexZNumber.clear();
-    
-    for(const auto& iter : _indicesVertexZOffsets)
+    // clamped before the conversion, the camera can be far from the layer
+    auto toChunk = [](float tile, int chunkCount) {
+        return (int)floorf(clampf(tile / FAST_TMX_CHUNK_SIZE, -1.0f, (float)chunkCount));
+    };
+    column = std::max(toChunk(minX, _chunkColumns) - margin, 0);
+    row = std::max(toChunk(minY, _chunkRows) - margin, 0);
+    columnEnd = std::min(toChunk(maxX, _chunkColumns) + 1 + margin, _chunkColumns);
+    rowEnd = std::min(toChunk(maxY, _chunkRows) + 1 + margin, _chunkRows);
+}
+
+void TMXLayer::updateStreamedChunks(const Rect& culledRect)
+{
+    int column, row, columnEnd, rowEnd;
+    getChunkRange(culledRect, 0, column, row, columnEnd, rowEnd);
+    _visibleChunks.clear();
+    for (int y = row; y < rowEnd; ++y)
     {
-        _indicesVertexZNumber[iter.first] = iter.second;
+        for (int x = column; x < columnEnd; ++x)
+        {
+            int index = y * _chunkColumns + x;
+            auto& chunk = _chunks[index];
+            loadChunk(index);
+            if (chunk.dirty)
+            {
+                buildChunk(chunk, x, y);
+            }
+            if (!chunk.batches.empty())
+            {
+                _visibleChunks.push_back(index);
+            }
+        }
     }
     
-    int yBegin = std::max(0.f,visibleTiles.origin.y - tilesOverY);
-    int yEnd = std::min(_layerSize.height,visibleTiles.origin.y + visibleTiles.size.height + tilesOverY);
-    int xBegin = std::max(0.f,visibleTiles.origin.x - tilesOverX);
-    int xEnd = std::min(_layerSize.width,visibleTiles.origin.x + visibleTiles.size.width + tilesOverX);
-    
-    for (int y =  yBegin; y < yEnd; ++y)
+    // decompress the chunks around the screen before they are visible
+    getChunkRange(culledRect, STREAM_PREFETCH_MARGIN, column, row, columnEnd, rowEnd);
+    int loads = 0;
+    for (int y = row; y < rowEnd && loads < STREAM_PREFETCH_LOADS; ++y)
     {
-        for (int x = xBegin; x < xEnd; ++x)
+        for (int x = column; x < columnEnd && loads < STREAM_PREFETCH_LOADS; ++x)
         {
-            int tileIndex = getTileIndexByPos(x, y);
-            if(_tiles[tileIndex] == 0) continue;
-            
-            int vertexZ = getVertexZForPos(Vec2(x,y));
-            auto iter = _indicesVertexZNumber.find(vertexZ);
-            int offset = iter->second;
-            iter->second++;
-            
-            int quadIndex = _tileToQuadIndex[tileIndex];
-            CC_ASSERT(-1 != quadIndex);
-            _indices[6 * offset + 0] = quadIndex * 4 + 0;
-            _indices[6 * offset + 1] = quadIndex * 4 + 1;
-            _indices[6 * offset + 2] = quadIndex * 4 + 2;
-            _indices[6 * offset + 3] = quadIndex * 4 + 3;
-            _indices[6 * offset + 4] = quadIndex * 4 + 2;
-            _indices[6 * offset + 5] = quadIndex * 4 + 1;
-            
-        } // for x
-    } // for y
+            int index = y * _chunkColumns + x;
+            if (!_chunks[index].loaded)
+            {
+                loadChunk(index);
+                ++loads;
+            }
+        }
+    }
     
-    for(const auto& iter : _indicesVertexZOffsets)
+    // release the far chunks, the modified ones keep their tiles
+    getChunkRange(culledRect, STREAM_KEEP_MARGIN, column, row, columnEnd, rowEnd);
+    for (size_t i = 0; i < _loadedChunks.size();)
     {
-        _indicesVertexZNumber[iter.first] -= iter.second;
-        if(_indicesVertexZNumber[iter.first] == 0)
+        int index = _loadedChunks[i];
+        int x = index % _chunkColumns;
+        int y = index / _chunkColumns;
+        if (!_chunks[index].modified && (x < column || x >= columnEnd || y < row || y >= rowEnd))
+        {
+            unloadChunk(index);
+            _loadedChunks[i] = _loadedChunks.back();
+            _loadedChunks.pop_back();
+        }
+        else
         {
-            _indicesVertexZNumber.erase(iter.first);
+            ++i;
         }
     }
+}
+
+void TMXLayer::loadChunk(int chunkIndex)
+{
+    auto& chunk = _chunks[chunkIndex];
+    if (chunk.loaded) return;
     
+    // a corrupted chunk is read as empty
+    chunk.tiles.resize(FAST_TMX_CHUNK_SIZE * FAST_TMX_CHUNK_SIZE);
+    _binaryMap->readChunk(_binaryLayerIndex, chunkIndex % _chunkColumns, chunkIndex / _chunkColumns, chunk.tiles.data());
+    chunk.loaded = true;
+    chunk.dirty = true;
+    _loadedChunks.push_back(chunkIndex);
 }
 
-void TMXLayer::updateVertexBuffer()
+void TMXLayer::unloadChunk(int chunkIndex)
 {
-    GL::bindVAO(0);
-    if(nullptr == _vData)
-    {
-        _vertexBuffer = VertexBuffer::create(sizeof(V3F_C4B_T2F), (int)_totalQuads.size() * 4);
-        _vData = VertexData::create();
-        _vData->setStream(_vertexBuffer, VertexStreamAttribute(0, GLProgram::VERTEX_ATTRIB_POSITION, GL_FLOAT, 3));
-        _vData->setStream(_vertexBuffer, VertexStreamAttribute(offsetof(V3F_C4B_T2F, colors), GLProgram::VERTEX_ATTRIB_COLOR, GL_UNSIGNED_BYTE, 4, true));
-        _vData->setStream(_vertexBuffer, VertexStreamAttribute(offsetof(V3F_C4B_T2F, texCoords), GLProgram::VERTEX_ATTRIB_TEX_COORD, GL_FLOAT, 2));
-        CC_SAFE_RETAIN(_vData);
-        CC_SAFE_RETAIN(_vertexBuffer);
-    }
-    if(_vertexBuffer)
-    {
-        _vertexBuffer->updateVertices((void*)&_totalQuads[0], (int)_totalQuads.size() * 4, 0);
-    }
+    auto& chunk = _chunks[chunkIndex];
+    releaseChunk(chunk);
+    std::vector<uint32_t>().swap(chunk.tiles);
+    chunk.loaded = false;
+    chunk.dirty = true;
+}
+
+TMXLayer::Chunk& TMXLayer::getChunkOfTile(int index, int& tileInChunk)
+{
+    // the chunks are created by the first access
+    updateChunks();
     
+    int x = index % (int)_layerSize.width;
+    int y = index / (int)_layerSize.width;
+    int chunkIndex = (y / FAST_TMX_CHUNK_SIZE) * _chunkColumns + x / FAST_TMX_CHUNK_SIZE;
+    loadChunk(chunkIndex);
+    tileInChunk = (y % FAST_TMX_CHUNK_SIZE) * FAST_TMX_CHUNK_SIZE + x % FAST_TMX_CHUNK_SIZE;
+    return _chunks[chunkIndex];
 }
 
 void TMXLayer::updateIndexBuffer()
 {
+    // quad i of a chunk uses the vertices 4 * i to 4 * i + 3
+    int quadCount = FAST_TMX_CHUNK_SIZE * FAST_TMX_CHUNK_SIZE;
+    std::vector<GLushort> indices(6 * quadCount);
+    for (int i = 0; i < quadCount; ++i)
+    {
+        indices[6 * i + 0] = i * 4 + 0;
+        indices[6 * i + 1] = i * 4 + 1;
+        indices[6 * i + 2] = i * 4 + 2;
+        indices[6 * i + 3] = i * 4 + 3;
+        indices[6 * i + 4] = i * 4 + 2;
+        indices[6 * i + 5] = i * 4 + 1;
+    }
+    
     if(nullptr == _indexBuffer)
     {
-#ifdef CC_FAST_TILEMAP_32_BIT_INDICES
-        _indexBuffer = IndexBuffer::create(IndexBuffer::IndexType::INDEX_TYPE_UINT_32, (int)_indices.size());
-#else
-        _indexBuffer = IndexBuffer::create(IndexBuffer::IndexType::INDEX_TYPE_SHORT_16, (int)_indices.size());
-#endif
+        _indexBuffer = IndexBuffer::create(IndexBuffer::IndexType::INDEX_TYPE_SHORT_16, (int)indices.size());
         CC_SAFE_RETAIN(_indexBuffer);
     }
-    _indexBuffer->updateIndices(&_indices[0], (int)_indices.size(), 0);
-    
+    _indexBuffer->updateIndices(&indices[0], (int)indices.size(), 0);
 }
 
 // FastTMXLayer - setup Tiles
@@ -418,165 +478,261 @@ Mat4 TMXLayer::tileToNodeTransform()
     
 }
 
-void TMXLayer::updatePrimitives()
+void TMXLayer::updateChunks()
 {
-    for(const auto& iter : _indicesVertexZNumber)
+    if(_quadsDirty)
     {
-        int start = _indicesVertexZOffsets.at(iter.first);
+        for (auto& chunk : _chunks)
+        {
+            releaseChunk(chunk);
+        }
+        _chunkColumns = ((int)_layerSize.width + FAST_TMX_CHUNK_SIZE - 1) / FAST_TMX_CHUNK_SIZE;
+        _chunkRows = ((int)_layerSize.height + FAST_TMX_CHUNK_SIZE - 1) / FAST_TMX_CHUNK_SIZE;
+        _chunks.clear();
+        _chunks.resize(_chunkColumns * _chunkRows);
+        _loadedChunks.clear();
         
-        auto primitiveIter= _primitives.find(iter.first);
-        if(primitiveIter == _primitives.end())
+        if(nullptr == _indexBuffer)
         {
-            auto primitive = Primitive::create(_vData, _indexBuffer, GL_TRIANGLES);
-            primitive->setCount(iter.second * 6);
-            primitive->setStart(start * 6);
-            
-            _primitives.insert(iter.first, primitive);
+            updateIndexBuffer();
         }
-        else
+        
+        _quadsDirty = false;
+        _dirty = true;
+    }
+    
+    // the chunks of a streamed layer are built when they are visible
+    if(_dirty && !isStreamed())
+    {
+        for (int i = 0; i < (int)_chunks.size(); ++i)
         {
-            primitiveIter->second->setCount(iter.second * 6);
-            primitiveIter->second->setStart(start * 6);
+            if (_chunks[i].dirty)
+            {
+                buildChunk(_chunks[i], i % _chunkColumns, i / _chunkColumns);
+            }
         }
     }
 }
 
-void TMXLayer::updateTotalQuads()
+void TMXLayer::buildChunk(Chunk& chunk, int column, int row)
 {
-    if(_quadsDirty)
+    int xBegin = column * FAST_TMX_CHUNK_SIZE;
+    int yBegin = row * FAST_TMX_CHUNK_SIZE;
+    int xEnd = std::min(xBegin + FAST_TMX_CHUNK_SIZE, (int)_layerSize.width);
+    int yEnd = std::min(yBegin + FAST_TMX_CHUNK_SIZE, (int)_layerSize.height);
+    
+    std::vector<V3F_C4B_T2F_Quad> quads;
+    std::vector<int> vertexZs;
+    quads.reserve(FAST_TMX_CHUNK_SIZE * FAST_TMX_CHUNK_SIZE);
+    vertexZs.reserve(FAST_TMX_CHUNK_SIZE * FAST_TMX_CHUNK_SIZE);
+    // a streamed layer stores the tiles by chunk
+    const uint32_t* tiles = isStreamed() ? chunk.tiles.data() : _tiles + getTileIndexByPos(xBegin, yBegin);
+    int stride = isStreamed() ? FAST_TMX_CHUNK_SIZE : (int)_layerSize.width;
+    for (int y = yBegin; y < yEnd; ++y)
     {
-        Size tileSize = CC_SIZE_PIXELS_TO_POINTS(_tileSet->_tileSize);
-        Size texSize = _tileSet->_imageSize;
-        _tileToQuadIndex.clear();
-        _totalQuads.resize(int(_layerSize.width * _layerSize.height));
-        _indices.resize(6 * int(_layerSize.width * _layerSize.height));
-        _tileToQuadIndex.resize(int(_layerSize.width * _layerSize.height),-1);
-        _indicesVertexZOffsets.clear();
-        
-        int quadIndex = 0;
-        for(int y = 0; y < _layerSize.height; ++y)
+        for (int x = xBegin; x < xEnd; ++x)
         {
-            for(int x =0; x < _layerSize.width; ++x)
-            {
-                int tileIndex = getTileIndexByPos(x, y);
-                int tileGID = _tiles[tileIndex];
-                
-                if(tileGID == 0) continue;
-                
-                _tileToQuadIndex[tileIndex] = quadIndex;
-                
-                auto& quad = _totalQuads[quadIndex];
-                
-                Vec3 nodePos(float(x), float(y), 0);
-                _tileToNodeTransform.transformPoint(&nodePos);
-                
-                float left, right, top, bottom, z;
-                
-                z = getVertexZForPos(Vec2(x, y));
-                auto iter = _indicesVertexZOffsets.find(z);
-                if(iter == _indicesVertexZOffsets.end())
-                {
-                    _indicesVertexZOffsets[z] = 1;
-                }
-                else
-                {
-                    iter->second++;
-                }
-                // vertices
-                if (tileGID & kTMXTileDiagonalFlag)
-                {
-                    left = nodePos.x;
-                    right = nodePos.x + tileSize.height;
-                    bottom = nodePos.y + tileSize.width;
-                    top = nodePos.y;
-                }
-                else
-                {
-                    left = nodePos.x;
-                    right = nodePos.x + tileSize.width;
-                    bottom = nodePos.y + tileSize.height;
-                    top = nodePos.y;
-                }
-                
-                if(tileGID & kTMXTileVerticalFlag)
-                    std::swap(top, bottom);
-                if(tileGID & kTMXTileHorizontalFlag)
-                    std::swap(left, right);
-                
-                if(tileGID & kTMXTileDiagonalFlag)
-                {
-                    // FIXME: not working correctly
-                    quad.bl.vertices.x = left;
-                    quad.bl.vertices.y = bottom;
-                    quad.bl.vertices.z = z;
-                    quad.br.vertices.x = left;
-                    quad.br.vertices.y = top;
-                    quad.br.vertices.z = z;
-                    quad.tl.vertices.x = right;
-                    quad.tl.vertices.y = bottom;
-                    quad.tl.vertices.z = z;
-                    quad.tr.vertices.x = right;
-                    quad.tr.vertices.y = top;
-                    quad.tr.vertices.z = z;
-                }
-                else
-                {
-                    quad.bl.vertices.x = left;
-                    quad.bl.vertices.y = bottom;
-                    quad.bl.vertices.z = z;
-                    quad.br.vertices.x = right;
-                    quad.br.vertices.y = bottom;
-                    quad.br.vertices.z = z;
-                    quad.tl.vertices.x = left;
-                    quad.tl.vertices.y = top;
-                    quad.tl.vertices.z = z;
-                    quad.tr.vertices.x = right;
-                    quad.tr.vertices.y = top;
-                    quad.tr.vertices.z = z;
-                }
-                
-                // texcoords
-                Rect tileTexture = _tileSet->getRectForGID(tileGID);
-                left   = (tileTexture.origin.x / texSize.width);
-                right  = left + (tileTexture.size.width / texSize.width);
-                bottom = (tileTexture.origin.y / texSize.height);
-                top    = bottom + (tileTexture.size.height / texSize.height);
-                
-                quad.bl.texCoords.u = left;
-                quad.bl.texCoords.v = bottom;
-                quad.br.texCoords.u = right;
-                quad.br.texCoords.v = bottom;
-                quad.tl.texCoords.u = left;
-                quad.tl.texCoords.v = top;
-                quad.tr.texCoords.u = right;
-                quad.tr.texCoords.v = top;
-                
-                quad.bl.colors = Color4B::WHITE;
-                quad.br.colors = Color4B::WHITE;
-                quad.tl.colors = Color4B::WHITE;
-                quad.tr.colors = Color4B::WHITE;
-                
-                ++quadIndex;
-            }
+            uint32_t tileGID = tiles[(y - yBegin) * stride + x - xBegin];
+            if(tileGID == 0) continue;
+            
+            int z = getVertexZForPos(Vec2(x, y));
+            quads.push_back(V3F_C4B_T2F_Quad());
+            vertexZs.push_back(z);
+            setupTileQuad(quads.back(), x, y, tileGID, z);
+        }
+    }
+    
+    // one batch per vertex z: with automatic vertex z the quads are sorted by z, keeping the tile order within a z
+    if (!std::is_sorted(vertexZs.begin(), vertexZs.end()))
+    {
+        std::vector<int> order(quads.size());
+        for (int i = 0; i < (int)order.size(); ++i)
+        {
+            order[i] = i;
         }
+        std::stable_sort(order.begin(), order.end(), [&vertexZs](int a, int b){
+            return vertexZs[a] < vertexZs[b];
+        });
         
-        int offset = 0;
-        for(auto& vertexZOffset : _indicesVertexZOffsets)
+        std::vector<V3F_C4B_T2F_Quad> sortedQuads(quads.size());
+        std::vector<int> sortedZs(quads.size());
+        for (int i = 0; i < (int)order.size(); ++i)
+        {
+            sortedQuads[i] = quads[order[i]];
+            sortedZs[i] = vertexZs[order[i]];
+        }
+        quads.swap(sortedQuads);
+        vertexZs.swap(sortedZs);
+    }
+    
+    for (auto& batch : chunk.batches)
+    {
+        batch.primitive->release();
+    }
+    chunk.batches.clear();
+    chunk.dirty = false;
+    
+    if (quads.empty())
+    {
+        chunk.bounds = Rect::ZERO;
+        return;
+    }
+    
+    float minX = quads[0].bl.vertices.x;
+    float maxX = minX;
+    float minY = quads[0].bl.vertices.y;
+    float maxY = minY;
+    for (const auto& quad : quads)
+    {
+        for (const V3F_C4B_T2F* vertex : {&quad.tl, &quad.bl, &quad.tr, &quad.br})
+        {
+            minX = std::min(minX, vertex->vertices.x);
+            maxX = std::max(maxX, vertex->vertices.x);
+            minY = std::min(minY, vertex->vertices.y);
+            maxY = std::max(maxY, vertex->vertices.y);
+        }
+    }
+    chunk.bounds.setRect(minX, minY, maxX - minX, maxY - minY);
+    
+    // a static buffer, reused while the chunk keeps as many tiles or less
+    int vertexCount = (int)quads.size() * 4;
+    GL::bindVAO(0);
+    if (nullptr == chunk.vertexBuffer || chunk.vertexBuffer->getVertexNumber() < vertexCount)
+    {
+        CC_SAFE_RELEASE_NULL(chunk.vertexData);
+        CC_SAFE_RELEASE_NULL(chunk.vertexBuffer);
+        chunk.vertexBuffer = VertexBuffer::create(sizeof(V3F_C4B_T2F), vertexCount);
+        chunk.vertexData = VertexData::create();
+        chunk.vertexData->setStream(chunk.vertexBuffer, VertexStreamAttribute(0, GLProgram::VERTEX_ATTRIB_POSITION, GL_FLOAT, 3));
+        chunk.vertexData->setStream(chunk.vertexBuffer, VertexStreamAttribute(offsetof(V3F_C4B_T2F, colors), GLProgram::VERTEX_ATTRIB_COLOR, GL_UNSIGNED_BYTE, 4, true));
+        chunk.vertexData->setStream(chunk.vertexBuffer, VertexStreamAttribute(offsetof(V3F_C4B_T2F, texCoords), GLProgram::VERTEX_ATTRIB_TEX_COORD, GL_FLOAT, 2));
+        CC_SAFE_RETAIN(chunk.vertexData);
+        CC_SAFE_RETAIN(chunk.vertexBuffer);
+    }
+    chunk.vertexBuffer->updateVertices((void*)&quads[0], vertexCount, 0);
+    
+    int start = 0;
+    int count = (int)quads.size();
+    while (start < count)
+    {
+        int end = start + 1;
+        while (end < count && vertexZs[end] == vertexZs[start])
         {
-            std::swap(offset, vertexZOffset.second);
-            offset += vertexZOffset.second;
+            ++end;
         }
-        updateVertexBuffer();
         
-        _quadsDirty = false;
+        auto primitive = Primitive::create(chunk.vertexData, _indexBuffer, GL_TRIANGLES);
+        primitive->setStart(start * 6);
+        primitive->setCount((end - start) * 6);
+        primitive->retain();
+        
+        Chunk::Batch batch = { vertexZs[start], primitive };
+        chunk.batches.push_back(batch);
+        start = end;
     }
 }
 
+void TMXLayer::releaseChunk(Chunk& chunk)
+{
+    for (auto& batch : chunk.batches)
+    {
+        batch.primitive->release();
+    }
+    chunk.batches.clear();
+    CC_SAFE_RELEASE_NULL(chunk.vertexData);
+    CC_SAFE_RELEASE_NULL(chunk.vertexBuffer);
+}
+
+void TMXLayer::setupTileQuad(V3F_C4B_T2F_Quad& quad, int x, int y, uint32_t tileGID, float z)
+{
+    Size tileSize = CC_SIZE_PIXELS_TO_POINTS(_tileSet->_tileSize);
+    Size texSize = _tileSet->_imageSize;
+    
+    Vec3 nodePos(float(x), float(y), 0);
+    _tileToNodeTransform.transformPoint(&nodePos);
+    
+    float left, right, top, bottom;
+    
+    // vertices
+    if (tileGID & kTMXTileDiagonalFlag)
+    {
+        left = nodePos.x;
+        right = nodePos.x + tileSize.height;
+        bottom = nodePos.y + tileSize.width;
+        top = nodePos.y;
+    }
+    else
+    {
+        left = nodePos.x;
+        right = nodePos.x + tileSize.width;
+        bottom = nodePos.y + tileSize.height;
+        top = nodePos.y;
+    }
+    
+    if(tileGID & kTMXTileVerticalFlag)
+        std::swap(top, bottom);
+    if(tileGID & kTMXTileHorizontalFlag)
+        std::swap(left, right);
+    
+    if(tileGID & kTMXTileDiagonalFlag)
+    {
+        // FIXME: not working correctly
+        quad.bl.vertices.x = left;
+        quad.bl.vertices.y = bottom;
+        quad.bl.vertices.z = z;
+        quad.br.vertices.x = left;
+        quad.br.vertices.y = top;
+        quad.br.vertices.z = z;
+        quad.tl.vertices.x = right;
+        quad.tl.vertices.y = bottom;
+        quad.tl.vertices.z = z;
+        quad.tr.vertices.x = right;
+        quad.tr.vertices.y = top;
+        quad.tr.vertices.z = z;
+    }
+    else
+    {
+        quad.bl.vertices.x = left;
+        quad.bl.vertices.y = bottom;
+        quad.bl.vertices.z = z;
+        quad.br.vertices.x = right;
+        quad.br.vertices.y = bottom;
+        quad.br.vertices.z = z;
+        quad.tl.vertices.x = left;
+        quad.tl.vertices.y = top;
+        quad.tl.vertices.z = z;
+        quad.tr.vertices.x = right;
+        quad.tr.vertices.y = top;
+        quad.tr.vertices.z = z;
+    }
+    
+    // texcoords
+    Rect tileTexture = _tileSet->getRectForGID(tileGID);
+    left   = (tileTexture.origin.x / texSize.width);
+    right  = left + (tileTexture.size.width / texSize.width);
+    bottom = (tileTexture.origin.y / texSize.height);
+    top    = bottom + (tileTexture.size.height / texSize.height);
+    
+    quad.bl.texCoords.u = left;
+    quad.bl.texCoords.v = bottom;
+    quad.br.texCoords.u = right;
+    quad.br.texCoords.v = bottom;
+    quad.tl.texCoords.u = left;
+    quad.tl.texCoords.v = top;
+    quad.tr.texCoords.u = right;
+    quad.tr.texCoords.v = top;
+    
+    quad.bl.colors = Color4B::WHITE;
+    quad.br.colors = Color4B::WHITE;
+    quad.tl.colors = Color4B::WHITE;
+    quad.tr.colors = Color4B::WHITE;
+}
+
 // removing / getting tiles
 Sprite* TMXLayer::getTileAt(const Vec2& tileCoordinate)
 {
     CCASSERT( tileCoordinate.x < _layerSize.width && tileCoordinate.y < _layerSize.height && tileCoordinate.x >=0 && tileCoordinate.y >=0, "TMXLayer: invalid position");
-    CCASSERT( _tiles, "TMXLayer: the tiles map has been released");
+    CCASSERT( _tiles || _binaryMap, "TMXLayer: the tiles map has been released");
     
     Sprite *tile = nullptr;
     int gid = this->getTileGIDAt(tileCoordinate);
@@ -616,12 +772,12 @@ Sprite* TMXLayer::getTileAt(const Vec2& tileCoordinate)
 int TMXLayer::getTileGIDAt(const Vec2& tileCoordinate, TMXTileFlags* flags/* = nullptr*/)
 {
     CCASSERT(tileCoordinate.x < _layerSize.width && tileCoordinate.y < _layerSize.height && tileCoordinate.x >=0 && tileCoordinate.y >=0, "TMXLayer: invalid position");
-    CCASSERT(_tiles, "TMXLayer: the tiles map has been released");
+    CCASSERT(_tiles || _binaryMap, "TMXLayer: the tiles map has been released");
     
     int idx = static_cast<int>(((int) tileCoordinate.x + (int) tileCoordinate.y * _layerSize.width));
     
     // Bits on the far end of the 32-bit global tile ID are used for tile flags
-    int tile = _tiles[idx];
+    int tile = getFlaggedTileGIDByIndex(idx);
     auto it = _spriteContainer.find(idx);
     
     // converted to sprite.
@@ -698,11 +854,38 @@ void TMXLayer::removeTileAt(const Vec2& tileCoordinate)
     }
 }
 
+uint32_t TMXLayer::getFlaggedTileGIDByIndex(int index)
+{
+    if (!isStreamed()) return _tiles[index];
+    
+    int tileInChunk;
+    auto& chunk = getChunkOfTile(index, tileInChunk);
+    return chunk.tiles[tileInChunk];
+}
+
 void TMXLayer::setFlaggedTileGIDByIndex(int index, uint32_t gid)
 {
+    if (isStreamed())
+    {
+        int tileInChunk;
+        auto& chunk = getChunkOfTile(index, tileInChunk);
+        if(gid == chunk.tiles[tileInChunk]) return;
+        chunk.tiles[tileInChunk] = gid;
+        chunk.dirty = true;
+        chunk.modified = true;
+        _dirty = true;
+        return;
+    }
+    
     if(gid == _tiles[index]) return;
     _tiles[index] = gid;
-    _quadsDirty = true;
+    // only the chunk of the tile is rebuilt
+    if (!_quadsDirty)
+    {
+        int column = (index % (int)_layerSize.width) / FAST_TMX_CHUNK_SIZE;
+        int row = (index / (int)_layerSize.width) / FAST_TMX_CHUNK_SIZE;
+        _chunks[row * _chunkColumns + column].dirty = true;
+    }
     _dirty = true;
 }
 
@@ -786,7 +969,7 @@ void TMXLayer::setTileGID(int gid, const Vec2& tileCoordinate)
 void TMXLayer::setTileGID(int gid, const Vec2& tileCoordinate, TMXTileFlags flags)
 {
     CCASSERT(tileCoordinate.x < _layerSize.width && tileCoordinate.y < _layerSize.height && tileCoordinate.x >=0 && tileCoordinate.y >=0, "TMXLayer: invalid position");
-    CCASSERT(_tiles, "TMXLayer: the tiles map has been released");
+    CCASSERT(_tiles || _binaryMap, "TMXLayer: the tiles map has been released");
     CCASSERT(gid == 0 || gid >= _tileSet->_firstGid, "TMXLayer: invalid gid" );
     
     TMXTileFlags currentFlags;
@@ -40,6 +40,7 @@ NS_CC_BEGIN
 class TMXMapInfo;
 class TMXLayerInfo;
 class TMXTilesetInfo;
+class TMXBinaryMap;
 class Texture2D;
 class Sprite;
 struct _ccCArray;
@@ -70,6 +71,12 @@ namespace experimental{
  * The value 0 should work for most cases, but if you have tiles that are semi-transparent, then you might want to use a different
  * value, like 0.5.
  
+ * The tiles are drawn by chunks of FAST_TMX_CHUNK_SIZE x FAST_TMX_CHUNK_SIZE tiles, each one with its own
+ * static vertex buffer. Only the chunks on screen are drawn, and changing a tile only rebuilds its chunk.
+
+ * The layers of a binary map (.cctmb) are streamed: the tiles of a chunk are decompressed when the chunk
+ * comes near the screen, and released when it goes far from it, unless some of its tiles were modified.
+
  * For further information, please see the programming guide:
  * http://www.cocos2d-iphone.org/wiki/doku.php/prog_guide:tiled_maps
  
@@ -187,7 +194,7 @@ public:
     /** Pointer to the map of tiles.
      * @js NA
      * @lua NA
-     * @return The pointer to the map of tiles.
+     * @return The pointer to the map of tiles, nullptr for a layer streamed from a binary map.
      */
     const uint32_t* getTiles() const { return _tiles; };
     
@@ -274,7 +281,6 @@ public:
 protected:
 
     bool initWithTilesetInfo(TMXTilesetInfo *tilesetInfo, TMXLayerInfo *layerInfo, TMXMapInfo *mapInfo);
-    void updateTiles(const Rect& culledRect);
     Vec2 calculateLayerOffset(const Vec2& offset);
 
     /* The layer recognizes some special properties, like cc_vertexz */
@@ -287,16 +293,53 @@ protected:
     
     //Flip flags is packed into gid
     void setFlaggedTileGIDByIndex(int index, uint32_t gid);
+    uint32_t getFlaggedTileGIDByIndex(int index);
     
-    //
-    void updateTotalQuads();
+    /** A square of tiles with its own vertex buffer, culled and rebuilt as a unit. */
+    struct Chunk
+    {
+        /** The quads of a vertex z, drawn by one command. */
+        struct Batch
+        {
+            int vertexZ;
+            Primitive* primitive;
+        };
+        
+        VertexBuffer* vertexBuffer = nullptr;
+        VertexData* vertexData = nullptr;
+        // sorted by vertex z
+        std::vector<Batch> batches;
+        // bounding box of the quads, in node space
+        Rect bounds;
+        bool dirty = true;
+        
+        // tiles of a streamed layer, by row
+        std::vector<uint32_t> tiles;
+        bool loaded = false;
+        // a modified chunk is not released, its tiles are not in the binary map
+        bool modified = false;
+    };
+    
+    // creates the chunks when the tiles were replaced, then rebuilds the chunks of the modified tiles
+    void updateChunks();
+    void buildChunk(Chunk& chunk, int column, int row);
+    void releaseChunk(Chunk& chunk);
+    void updateVisibleChunks(const Rect& culledRect);
+    void setupTileQuad(V3F_C4B_T2F_Quad& quad, int x, int y, uint32_t gid, float vertexZ);
+    
+    bool isStreamed() const { return _tiles == nullptr && _binaryMap != nullptr; }
+    // loads the chunks on screen and around it, releases the far ones
+    void updateStreamedChunks(const Rect& culledRect);
+    // the chunks [column, columnEnd[ x [row, rowEnd[ of the tiles drawn in a node space rect, grown by margin chunks
+    void getChunkRange(const Rect& rect, int margin, int& column, int& row, int& columnEnd, int& rowEnd) const;
+    Chunk& getChunkOfTile(int index, int& tileInChunk);
+    void loadChunk(int chunkIndex);
+    void unloadChunk(int chunkIndex);
     
     void onDraw(Primitive* primitive);
     int getTileIndexByPos(int x, int y) const { return x + y * (int) _layerSize.width; }
     
-    void updateVertexBuffer();
     void updateIndexBuffer();
-    void updatePrimitives();
 protected:
     
     //! name of the layer
@@ -332,32 +375,35 @@ protected:
     /** tile coordinate to node coordinate transform */
     Mat4 _tileToNodeTransform;
     /** data for rendering */
+    // all the chunks must be created again
     bool _quadsDirty;
-    std::vector<int> _tileToQuadIndex;
-    std::vector<V3F_C4B_T2F_Quad> _totalQuads;
-#ifdef CC_FAST_TILEMAP_32_BIT_INDICES
-    std::vector<GLuint> _indices;
-#else
-    std::vector<GLushort> _indices;
-#endif
-    std::map<int/*vertexZ*/, int/*offset to _indices by quads*/> _indicesVertexZOffsets;
-    std::unordered_map<int/*vertexZ*/, int/*number to quads*/> _indicesVertexZNumber;
+    std::vector<Chunk> _chunks;
+    int _chunkColumns;
+    int _chunkRows;
+    // indices of the chunks intersecting the screen
+    std::vector<int> _visibleChunks;
     std::vector<PrimitiveCommand> _renderCommands;
+    // chunks were modified, or the visible chunks must be found again
     bool _dirty;
     
-    VertexBuffer* _vertexBuffer;
-    
-    VertexData* _vData;
-    
+    // the indices of a full chunk, shared by all the chunks
     IndexBuffer* _indexBuffer;
     
-    Map<int , Primitive*> _primitives;
+    /** binary map streaming the tiles of the layer, when _tiles is null */
+    TMXBinaryMap* _binaryMap;
+    int _binaryLayerIndex;
+    // indices of the chunks of a streamed layer with tiles
+    std::vector<int> _loadedChunks;
     
 public:
     /** Possible orientations of the TMX map */
     static const int FAST_TMX_ORIENTATION_ORTHO;
     static const int FAST_TMX_ORIENTATION_HEX;
     static const int FAST_TMX_ORIENTATION_ISO;
+    /** Width and height of the chunks, in tiles.
+     * @since v3.17
+     */
+    static const int FAST_TMX_CHUNK_SIZE;
 };
 
 // end of tilemap_parallax_nodes group
@@ -27,6 +27,7 @@ THE SOFTWARE.
 ****************************************************************************/
 #include "2d/CCFastTMXTiledMap.h"
 #include "2d/CCFastTMXLayer.h"
+#include "2d/CCTMXBinaryMap.h"
 #include "base/ccUTF8.h"
 
 NS_CC_BEGIN
@@ -64,7 +65,15 @@ bool TMXTiledMap::initWithTMXFile(const std::string& tmxFile)
     
     setContentSize(Size::ZERO);
 
-    TMXMapInfo *mapInfo = TMXMapInfo::create(tmxFile);
+    TMXMapInfo *mapInfo = nullptr;
+    if (FileUtils::getInstance()->getFileExtension(tmxFile) == ".cctmb")
+    {
+        mapInfo = TMXMapInfo::createWithBinaryFile(tmxFile);
+    }
+    else
+    {
+        mapInfo = TMXMapInfo::create(tmxFile);
+    }
 
     if (! mapInfo)
     {
@@ -105,6 +114,13 @@ TMXLayer * TMXTiledMap::parseLayer(TMXLayerInfo *layerInfo, TMXMapInfo *mapInfo)
     if (tileset == nullptr)
         return nullptr;
     
+    // the chunks of a binary map are streamed as the chunks of the layer
+    if (layerInfo->_binaryMap && layerInfo->_binaryMap->getChunkSize() != TMXLayer::FAST_TMX_CHUNK_SIZE)
+    {
+        CCLOG("cocos2d: FastTMXTiledMap: layer '%s' has chunks of %d tiles, %d are needed", layerInfo->_name.c_str(), layerInfo->_binaryMap->getChunkSize(), TMXLayer::FAST_TMX_CHUNK_SIZE);
+        return nullptr;
+    }
+    
     TMXLayer *layer = TMXLayer::create(tileset, layerInfo, mapInfo);
 
     // tell the layerinfo to release the ownership of the tiles map.
@@ -119,6 +135,22 @@ TMXTilesetInfo * TMXTiledMap::tilesetForLayer(TMXLayerInfo *layerInfo, TMXMapInf
     Size size = layerInfo->_layerSize;
     auto& tilesets = mapInfo->getTilesets();
 
+    // the tiles of a binary map are not loaded, it records the first tile of each layer
+    if (layerInfo->_tiles == nullptr && layerInfo->_binaryMap)
+    {
+        uint32_t gid = layerInfo->_binaryMap->getLayerSampleGID(layerInfo->_binaryLayerIndex) & kTMXFlippedMask;
+        for (auto iter = tilesets.crbegin(), iterCrend = tilesets.crend(); gid != 0 && iter != iterCrend; ++iter)
+        {
+            TMXTilesetInfo* tilesetInfo = *iter;
+            if (tilesetInfo && gid >= static_cast<uint32_t>(tilesetInfo->_firstGid))
+            {
+                return tilesetInfo;
+            }
+        }
+        CCLOG("cocos2d: Warning: TMX Layer '%s' has no tiles", layerInfo->_name.c_str());
+        return nullptr;
+    }
+
     for (auto iter = tilesets.crbegin(), iterCrend = tilesets.crend(); iter != iterCrend; ++iter)
     {
         TMXTilesetInfo* tilesetInfo = *iter;
@@ -94,13 +94,17 @@ class TMXLayer;
  * objectGroup->getProperty(name_of_the_property);
  * object->getProperty(name_of_the_property);
 
+ * Binary maps (.cctmb), converted from TMX files by tools/tmx-binary/tmx2cctmb.py, are loaded the same way.
+ * Their tiles are not loaded with the map: the layers decompress the chunks of tiles around the camera
+ * and release the far ones, so that huge maps load in constant time and memory.
+
  * @since v3.2
  * @js NA
  */
 class CC_DLL TMXTiledMap : public Node
 {
 public:
-    /** Creates a TMX Tiled Map with a TMX file.
+    /** Creates a TMX Tiled Map with a TMX file, or a binary map if the extension is .cctmb.
      *
      * @return An autorelease object.
      */
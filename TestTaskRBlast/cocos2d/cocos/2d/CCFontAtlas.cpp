@@ -25,6 +25,7 @@
  ****************************************************************************/
 
 #include "2d/CCFontAtlas.h"
+#include <algorithm>
 #if CC_TARGET_PLATFORM != CC_PLATFORM_WIN32 && CC_TARGET_PLATFORM != CC_PLATFORM_WINRT && CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID
 #include <iconv.h>
 #elif CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID
@@ -36,6 +37,8 @@
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventType.h"
+#include "base/CCAsyncTaskPool.h"
+#include "renderer/CCTextureCache.h"
 
 NS_CC_BEGIN
 
@@ -43,16 +46,201 @@ const int FontAtlas::CacheTextureWidth = 512;
 const int FontAtlas::CacheTextureHeight = 512;
 const char* FontAtlas::CMD_PURGE_FONTATLAS = "__cc_PURGE_FONTATLAS";
 const char* FontAtlas::CMD_RESET_FONTATLAS = "__cc_RESET_FONTATLAS";
+const char* FontAtlas::CMD_UPDATE_FONTATLAS = "__cc_UPDATE_FONTATLAS";
+
+static unsigned int s_nextLayoutCacheId = 0;
+
+std::vector<FontAtlas::GlyphPage*> FontAtlas::_openPages;
+
+struct FontAtlas::GlyphPage : public Ref
+{
+    // the top edge of the used area from x to x + width
+    struct SkylineNode
+    {
+        int x;
+        int y;
+        int width;
+    };
+
+    GlyphPage(Texture2D::PixelFormat format, bool antialias);
+    virtual ~GlyphPage();
+
+    bool insert(int width, int height, int& outX, int& outY);
+    void markDirty(int y, int height);
+    void upload();
+    void close();
+
+    Texture2D* texture;
+    Texture2D::PixelFormat pixelFormat;
+    bool antialiasEnabled;
+    bool open;
+    int bytesPerPixel;
+    unsigned char* data;
+    int dataSize;
+    // rows written since the last upload
+    int dirtyTop;
+    int dirtyBottom;
+    std::vector<SkylineNode> skyline;
+};
+
+FontAtlas::GlyphPage::GlyphPage(Texture2D::PixelFormat format, bool antialias)
+: texture(new (std::nothrow) Texture2D)
+, pixelFormat(format)
+, antialiasEnabled(antialias)
+, open(true)
+, bytesPerPixel(format == Texture2D::PixelFormat::AI88 ? 2 : 1)
+, dirtyTop(CacheTextureHeight)
+, dirtyBottom(0)
+{
+    dataSize = CacheTextureWidth * CacheTextureHeight * bytesPerPixel;
+    data = new (std::nothrow) unsigned char[dataSize];
+    memset(data, 0, dataSize);
+
+    texture->initWithData(data, dataSize, pixelFormat, CacheTextureWidth, CacheTextureHeight, Size(CacheTextureWidth, CacheTextureHeight));
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    // data always holds every glyph packed so far, the texture is rebuilt from it when the GL context is lost
+    VolatileTextureMgr::addDataTexture(texture, data, dataSize, pixelFormat, Size(CacheTextureWidth, CacheTextureHeight));
+#endif
+    // after the registration so the filtering is restored with the texture
+    if (!antialiasEnabled)
+    {
+        texture->setAliasTexParameters();
+    }
+
+    skyline.push_back({0, 0, CacheTextureWidth});
+}
+
+FontAtlas::GlyphPage::~GlyphPage()
+{
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    // a label may still hold the texture, it must not be reloaded from freed data
+    VolatileTextureMgr::removeTexture(texture);
+#endif
+    CC_SAFE_RELEASE(texture);
+    delete [] data;
+}
+
+bool FontAtlas::GlyphPage::insert(int width, int height, int& outX, int& outY)
+{
+    if (!open || width > CacheTextureWidth || height > CacheTextureHeight)
+    {
+        return false;
+    }
+
+    // bottom-left rule: the lowest position, the narrowest node on ties
+    int bestIndex = -1;
+    int bestBottom = CacheTextureHeight + 1;
+    int bestWidth = CacheTextureWidth + 1;
+    int bestY = 0;
+    for (size_t i = 0; i < skyline.size(); ++i)
+    {
+        int x = skyline[i].x;
+        if (x + width > CacheTextureWidth)
+        {
+            break;
+        }
+
+        int y = 0;
+        int widthLeft = width;
+        for (size_t j = i; widthLeft > 0; ++j)
+        {
+            y = std::max(y, skyline[j].y);
+            widthLeft -= skyline[j].width;
+        }
+        if (y + height > CacheTextureHeight)
+        {
+            continue;
+        }
+
+        if (y + height < bestBottom || (y + height == bestBottom && skyline[i].width < bestWidth))
+        {
+            bestIndex = static_cast<int>(i);
+            bestBottom = y + height;
+            bestWidth = skyline[i].width;
+            bestY = y;
+        }
+    }
+    if (bestIndex < 0)
+    {
+        return false;
+    }
+
+    outX = skyline[bestIndex].x;
+    outY = bestY;
+
+    // raise the skyline under the rect and trim the nodes it covers
+    skyline.insert(skyline.begin() + bestIndex, {outX, bestBottom, width});
+    for (size_t i = bestIndex + 1; i < skyline.size();)
+    {
+        int shrink = outX + width - skyline[i].x;
+        if (shrink <= 0)
+        {
+            break;
+        }
+        if (shrink < skyline[i].width)
+        {
+            skyline[i].x += shrink;
+            skyline[i].width -= shrink;
+            break;
+        }
+        skyline.erase(skyline.begin() + i);
+    }
+    for (size_t i = 0; i + 1 < skyline.size();)
+    {
+        if (skyline[i].y == skyline[i + 1].y)
+        {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.erase(skyline.begin() + i + 1);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+    return true;
+}
+
+void FontAtlas::GlyphPage::markDirty(int y, int height)
+{
+    dirtyTop = std::min(dirtyTop, y);
+    dirtyBottom = std::max(dirtyBottom, y + height);
+}
+
+void FontAtlas::GlyphPage::upload()
+{
+    if (dirtyTop < dirtyBottom && data)
+    {
+        texture->updateWithData(data + CacheTextureWidth * dirtyTop * bytesPerPixel, 0, dirtyTop,
+            CacheTextureWidth, dirtyBottom - dirtyTop);
+    }
+    dirtyTop = CacheTextureHeight;
+    dirtyBottom = 0;
+}
+
+void FontAtlas::GlyphPage::close()
+{
+    upload();
+    open = false;
+    skyline.clear();
+#if !CC_ENABLE_CACHE_TEXTURE_DATA
+    // nothing is packed into a closed page any more, only the texture is needed.
+    // Otherwise VolatileTextureMgr reloads the texture from this data.
+    delete [] data;
+    data = nullptr;
+#endif
+}
 
 FontAtlas::FontAtlas(Font &theFont) 
 : _font(&theFont)
 , _fontFreeType(nullptr)
 , _iconv(nullptr)
-, _currentPageData(nullptr)
 , _fontAscender(0)
 , _rendererRecreatedListener(nullptr)
 , _antialiasEnabled(true)
-, _currLineHeight(0)
+, _asyncRasterizationEnabled(false)
+, _workerFont(nullptr)
+, _generation(0)
+, _layoutCacheId(++s_nextLayoutCacheId)
 {
     _font->retain();
 
@@ -61,9 +249,6 @@ FontAtlas::FontAtlas(Font &theFont)
     {
         _lineHeight = _font->getFontMaxHeight();
         _fontAscender = _fontFreeType->getFontAscender();
-        _currentPage = 0;
-        _currentPageOrigX = 0;
-        _currentPageOrigY = 0;
         _letterEdgeExtend = 2;
         _letterPadding = 0;
 
@@ -83,32 +268,14 @@ FontAtlas::FontAtlas(Font &theFont)
 
 void FontAtlas::reinit()
 {
-    if (_currentPageData)
-    {
-        delete []_currentPageData;
-        _currentPageData = nullptr;
-    }
-    
-    auto texture = new (std::nothrow) Texture2D;
-    
-    _currentPageDataSize = CacheTextureWidth * CacheTextureHeight;
-    
     auto outlineSize = _fontFreeType->getOutlineSize();
     if(outlineSize > 0)
     {
         _lineHeight += 2 * outlineSize;
-        _currentPageDataSize *= 2;
     }
-    
-    _currentPageData = new (std::nothrow) unsigned char[_currentPageDataSize];
-    memset(_currentPageData, 0, _currentPageDataSize);
-    
-    auto  pixelFormat = outlineSize > 0 ? Texture2D::PixelFormat::AI88 : Texture2D::PixelFormat::A8;
-    texture->initWithData(_currentPageData, _currentPageDataSize,
-                          pixelFormat, CacheTextureWidth, CacheTextureHeight, Size(CacheTextureWidth,CacheTextureHeight) );
-    
-    addTexture(texture,0);
-    texture->release();
+
+    // slot 0 exists even before the first glyph, labels create their batch nodes from it
+    addPage(getOpenPage());
 }
 
 FontAtlas::~FontAtlas()
@@ -122,11 +289,10 @@ FontAtlas::~FontAtlas()
     }
 #endif
 
+    CC_SAFE_RELEASE(_workerFont);
     _font->release();
     releaseTextures();
 
-    delete []_currentPageData;
-
 #if CC_TARGET_PLATFORM != CC_PLATFORM_WIN32 && CC_TARGET_PLATFORM != CC_PLATFORM_WINRT && CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID
     if (_iconv)
     {
@@ -140,11 +306,11 @@ void FontAtlas::reset()
 {
     releaseTextures();
     
-    _currLineHeight = 0;
-    _currentPage = 0;
-    _currentPageOrigX = 0;
-    _currentPageOrigY = 0;
     _letterDefinitions.clear();
+
+    // glyphs still being rasterized belong to the old pages
+    _pendingGlyphs.clear();
+    ++_generation;
     
     reinit();
 }
@@ -156,6 +322,8 @@ void FontAtlas::releaseTextures()
         item.second->release();
     }
     _atlasTextures.clear();
+
+    releasePages();
 }
 
 void FontAtlas::purgeTexturesAtlas()
@@ -342,7 +510,7 @@ bool FontAtlas::prepareLetterDefinitions(const std::u32string& utf32Text)
         return false;
     } 
  
-    if (!_currentPageData)
+    if (_pages.empty())
         reinit();     
  
     std::unordered_map<unsigned int, unsigned int> codeMapOfNewChar;
@@ -352,89 +520,206 @@ bool FontAtlas::prepareLetterDefinitions(const std::u32string& utf32Text)
         return false;
     }
 
+    if (_asyncRasterizationEnabled)
+    {
+        rasterizeGlyphsAsync(codeMapOfNewChar, true);
+        return true;
+    }
+
+    std::vector<GlyphBitmap> glyphs;
+    glyphs.reserve(codeMapOfNewChar.size());
+    for (auto&& it : codeMapOfNewChar)
+    {
+        if (_pendingGlyphs.find(it.first) != _pendingGlyphs.end())
+        {
+            // a prewarm is already rasterizing it, rasterizing it here too would pack it twice
+            addPlaceholderDefinition(it.first, it.second);
+            continue;
+        }
+        GlyphBitmap glyph;
+        glyph.utf32Char = it.first;
+        glyph.data = _fontFreeType->rasterizeGlyph(it.second, glyph.width, glyph.height, glyph.rect, glyph.xAdvance);
+        glyphs.push_back(glyph);
+    }
+    if (!glyphs.empty())
+    {
+        addGlyphBitmaps(glyphs);
+    }
+
+    return true;
+}
+
+void FontAtlas::prewarmLetterDefinitions(const std::u32string& utf32Text)
+{
+    if (_fontFreeType == nullptr)
+    {
+        return;
+    }
+
+    std::unordered_map<unsigned int, unsigned int> codeMapOfNewChar;
+    findNewCharacters(utf32Text, codeMapOfNewChar);
+    if (!codeMapOfNewChar.empty())
+    {
+        rasterizeGlyphsAsync(codeMapOfNewChar, false);
+    }
+}
+
+void FontAtlas::addPlaceholderDefinition(char32_t utf32Char, unsigned int glyphCode)
+{
+    // laid out with its real advance but not drawn until the bitmap arrives
+    FontLetterDefinition placeholder;
+    memset(&placeholder, 0, sizeof(placeholder));
+    placeholder.xAdvance = _fontFreeType->getGlyphAdvance(glyphCode);
+    placeholder.validDefinition = placeholder.xAdvance != 0;
+    _letterDefinitions[utf32Char] = placeholder;
+}
+
+void FontAtlas::rasterizeGlyphsAsync(const std::unordered_map<unsigned int, unsigned int>& charCodeMap, bool addPlaceholders)
+{
+    if (_workerFont == nullptr)
+    {
+        _workerFont = _fontFreeType->createWorkerFont();
+        CC_SAFE_RETAIN(_workerFont);
+    }
+
+    std::vector<std::pair<char32_t, unsigned int>> codes;
+    codes.reserve(charCodeMap.size());
+    for (auto&& it : charCodeMap)
+    {
+        if (addPlaceholders)
+        {
+            addPlaceholderDefinition(it.first, it.second);
+        }
+        if (_pendingGlyphs.insert(it.first).second)
+        {
+            codes.push_back(std::make_pair(static_cast<char32_t>(it.first), it.second));
+        }
+    }
+    if (codes.empty())
+    {
+        return;
+    }
+
+    if (_workerFont == nullptr)
+    {
+        // no worker face could be created, rasterize here instead
+        std::vector<GlyphBitmap> glyphs;
+        for (auto&& code : codes)
+        {
+            GlyphBitmap glyph;
+            glyph.utf32Char = code.first;
+            glyph.data = _fontFreeType->rasterizeGlyph(code.second, glyph.width, glyph.height, glyph.rect, glyph.xAdvance);
+            glyphs.push_back(glyph);
+            _pendingGlyphs.erase(code.first);
+        }
+        if (_pages.empty())
+            reinit();
+        addGlyphBitmaps(glyphs);
+        return;
+    }
+
+    auto glyphs = std::make_shared<std::vector<GlyphBitmap>>();
+    auto workerFont = _workerFont;
+    auto generation = _generation;
+
+    // keeps the atlas and its worker font alive until the callback has run
+    retain();
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_OTHER,
+        [this, glyphs, generation](void*) {
+            if (generation == _generation)
+            {
+                for (auto&& glyph : *glyphs)
+                {
+                    _pendingGlyphs.erase(glyph.utf32Char);
+                }
+                if (_pages.empty())
+                    reinit();
+                addGlyphBitmaps(*glyphs);
+                Director::getInstance()->getEventDispatcher()->dispatchCustomEvent(CMD_UPDATE_FONTATLAS, this);
+            }
+            else
+            {
+                for (auto&& glyph : *glyphs)
+                {
+                    delete [] glyph.data;
+                }
+            }
+            release();
+        },
+        nullptr,
+        [workerFont, codes, glyphs]() {
+            glyphs->reserve(codes.size());
+            for (auto&& code : codes)
+            {
+                GlyphBitmap glyph;
+                glyph.utf32Char = code.first;
+                glyph.data = workerFont->rasterizeGlyph(code.second, glyph.width, glyph.height, glyph.rect, glyph.xAdvance);
+                glyphs->push_back(glyph);
+            }
+        });
+}
+
+void FontAtlas::addGlyphBitmaps(std::vector<GlyphBitmap>& glyphs)
+{
     int adjustForDistanceMap = _letterPadding / 2;
     int adjustForExtend = _letterEdgeExtend / 2;
-    long bitmapWidth;
-    long bitmapHeight;
     int glyphHeight;
-    Rect tempRect;
     FontLetterDefinition tempDef;
 
     auto scaleFactor = CC_CONTENT_SCALE_FACTOR();
-    auto  pixelFormat = _fontFreeType->getOutlineSize() > 0 ? Texture2D::PixelFormat::AI88 : Texture2D::PixelFormat::A8;
-
-    float startY = _currentPageOrigY;
+    int distanceMapSpread = _fontFreeType->isDistanceFieldEnabled() ? FontFreeType::DistanceMapSpread : 0;
 
-    for (auto&& it : codeMapOfNewChar)
+    for (auto&& glyph : glyphs)
     {
-        auto bitmap = _fontFreeType->getGlyphBitmap(it.second, bitmapWidth, bitmapHeight, tempRect, tempDef.xAdvance);
-        if (bitmap && bitmapWidth > 0 && bitmapHeight > 0)
+        tempDef.xAdvance = glyph.xAdvance;
+        int slot = -1;
+        int originX = 0;
+        int originY = 0;
+        if (glyph.data)
         {
-            tempDef.validDefinition = true;
+            auto& tempRect = glyph.rect;
             tempDef.width = tempRect.size.width + _letterPadding + _letterEdgeExtend;
             tempDef.height = tempRect.size.height + _letterPadding + _letterEdgeExtend;
             tempDef.offsetX = tempRect.origin.x - adjustForDistanceMap - adjustForExtend;
             tempDef.offsetY = _fontAscender + tempRect.origin.y - adjustForDistanceMap - adjustForExtend;
+            glyphHeight = static_cast<int>(glyph.height) + _letterPadding + _letterEdgeExtend;
 
-            if (_currentPageOrigX + tempDef.width > CacheTextureWidth)
+            // one texel of gap to the next glyph on the right
+            slot = allocateGlyphRect(static_cast<int>(tempDef.width) + 1, glyphHeight, originX, originY);
+            if (slot < 0)
             {
-                _currentPageOrigY += _currLineHeight;
-                _currLineHeight = 0;
-                _currentPageOrigX = 0;
-                if (_currentPageOrigY + _lineHeight + _letterPadding + _letterEdgeExtend >= CacheTextureHeight)
-                {
-                    unsigned char *data = nullptr;
-                    if (pixelFormat == Texture2D::PixelFormat::AI88)
-                    {
-                        data = _currentPageData + CacheTextureWidth * (int)startY * 2;
-                    }
-                    else
-                    {
-                        data = _currentPageData + CacheTextureWidth * (int)startY;
-                    }
-                    _atlasTextures[_currentPage]->updateWithData(data, 0, startY,
-                        CacheTextureWidth, CacheTextureHeight - startY);
-
-                    startY = 0.0f;
-
-                    _currentPageOrigY = 0;
-                    memset(_currentPageData, 0, _currentPageDataSize);
-                    _currentPage++;
-                    auto tex = new (std::nothrow) Texture2D;
-                    if (_antialiasEnabled)
-                    {
-                        tex->setAntiAliasTexParameters();
-                    }
-                    else
-                    {
-                        tex->setAliasTexParameters();
-                    }
-                    tex->initWithData(_currentPageData, _currentPageDataSize,
-                        pixelFormat, CacheTextureWidth, CacheTextureHeight, Size(CacheTextureWidth, CacheTextureHeight));
-                    addTexture(tex, _currentPage);
-                    tex->release();
-                }
+                CCLOG("FontAtlas::addGlyphBitmaps: glyph %u does not fit in a page", static_cast<unsigned int>(glyph.utf32Char));
+                delete [] glyph.data;
+                glyph.data = nullptr;
             }
-            glyphHeight = static_cast<int>(bitmapHeight) + _letterPadding + _letterEdgeExtend;
-            if (glyphHeight > _currLineHeight)
+        }
+
+        if (slot >= 0)
+        {
+            auto page = _pages[slot];
+            int bytesPerPixel = page->bytesPerPixel;
+            tempDef.validDefinition = true;
+
+            // rasterizeGlyph already produced the final texels, copy them row by row
+            long rowBytes = (glyph.width + 2 * distanceMapSpread) * bytesPerPixel;
+            long rows = glyph.height + 2 * distanceMapSpread;
+            auto dest = page->data + ((originY + adjustForExtend) * CacheTextureWidth + originX + adjustForExtend) * bytesPerPixel;
+            for (long y = 0; y < rows; ++y)
             {
-                _currLineHeight = glyphHeight;
+                memcpy(dest + y * CacheTextureWidth * bytesPerPixel, glyph.data + y * rowBytes, rowBytes);
             }
-            _fontFreeType->renderCharAt(_currentPageData, _currentPageOrigX + adjustForExtend, _currentPageOrigY + adjustForExtend, bitmap, bitmapWidth, bitmapHeight);
+            page->markDirty(originY, glyphHeight);
+            delete [] glyph.data;
+            glyph.data = nullptr;
 
-            tempDef.U = _currentPageOrigX;
-            tempDef.V = _currentPageOrigY;
-            tempDef.textureID = _currentPage;
-            _currentPageOrigX += tempDef.width + 1;
+            tempDef.textureID = slot;
             // take from pixels to points
             tempDef.width = tempDef.width / scaleFactor;
             tempDef.height = tempDef.height / scaleFactor;
-            tempDef.U = tempDef.U / scaleFactor;
-            tempDef.V = tempDef.V / scaleFactor;
+            tempDef.U = originX / scaleFactor;
+            tempDef.V = originY / scaleFactor;
         }
         else{
-            if(bitmap)
-                delete[] bitmap;
             if (tempDef.xAdvance)
                 tempDef.validDefinition = true;
             else
@@ -447,24 +732,87 @@ bool FontAtlas::prepareLetterDefinitions(const std::u32string& utf32Text)
             tempDef.offsetX = 0;
             tempDef.offsetY = 0;
             tempDef.textureID = 0;
-            _currentPageOrigX += 1;
         }
 
-        _letterDefinitions[it.first] = tempDef;
+        _letterDefinitions[glyph.utf32Char] = tempDef;
     }
 
-    unsigned char *data = nullptr;
-    if (pixelFormat == Texture2D::PixelFormat::AI88)
+    for (auto&& page : _pages)
     {
-        data = _currentPageData + CacheTextureWidth * (int)startY * 2;
+        page->upload();
     }
-    else
+}
+
+FontAtlas::GlyphPage* FontAtlas::getOpenPage()
+{
+    auto pixelFormat = _fontFreeType->getOutlineSize() > 0 ? Texture2D::PixelFormat::AI88 : Texture2D::PixelFormat::A8;
+    for (auto&& page : _openPages)
     {
-        data = _currentPageData + CacheTextureWidth * (int)startY;
+        if (page->pixelFormat == pixelFormat && page->antialiasEnabled == _antialiasEnabled)
+        {
+            return page;
+        }
     }
-    _atlasTextures[_currentPage]->updateWithData(data, 0, startY, CacheTextureWidth, _currentPageOrigY - startY + _currLineHeight);
 
-    return true;
+    // the open page list owns the reference from new
+    auto page = new (std::nothrow) GlyphPage(pixelFormat, _antialiasEnabled);
+    _openPages.push_back(page);
+    return page;
+}
+
+int FontAtlas::allocateGlyphRect(int width, int height, int& x, int& y)
+{
+    auto page = getOpenPage();
+    if (!page->insert(width, height, x, y))
+    {
+        if (width > CacheTextureWidth || height > CacheTextureHeight)
+        {
+            return -1;
+        }
+
+        // full for this rect, atlases still using it keep drawing from its texture
+        page->close();
+        _openPages.erase(std::find(_openPages.begin(), _openPages.end(), page));
+        page->release();
+
+        page = getOpenPage();
+        if (!page->insert(width, height, x, y))
+        {
+            return -1;
+        }
+    }
+    return addPage(page);
+}
+
+int FontAtlas::addPage(GlyphPage* page)
+{
+    auto it = std::find(_pages.begin(), _pages.end(), page);
+    if (it != _pages.end())
+    {
+        return static_cast<int>(it - _pages.begin());
+    }
+
+    page->retain();
+    _pages.push_back(page);
+    int slot = static_cast<int>(_pages.size()) - 1;
+    addTexture(page->texture, slot);
+    return slot;
+}
+
+void FontAtlas::releasePages()
+{
+    for (auto&& page : _pages)
+    {
+        if (page->open && page->getReferenceCount() == 2)
+        {
+            // no other atlas uses it, keeping it open would only keep its memory around
+            page->close();
+            _openPages.erase(std::find(_openPages.begin(), _openPages.end(), page));
+            page->release();
+        }
+        page->release();
+    }
+    _pages.clear();
 }
 
 void FontAtlas::addTexture(Texture2D *texture, int slot)
@@ -499,6 +847,13 @@ void FontAtlas::setAliasTexParameters()
     if (_antialiasEnabled)
     {
         _antialiasEnabled = false;
+        if (_fontFreeType)
+        {
+            // the pages are shared with other atlases, lay the glyphs out again on pages with the new filtering
+            if (!_pages.empty())
+                purgeTexturesAtlas();
+            return;
+        }
         for (const auto & tex : _atlasTextures)
         {
             tex.second->setAliasTexParameters();
@@ -511,6 +866,12 @@ void FontAtlas::setAntiAliasTexParameters()
     if (! _antialiasEnabled)
     {
         _antialiasEnabled = true;
+        if (_fontFreeType)
+        {
+            if (!_pages.empty())
+                purgeTexturesAtlas();
+            return;
+        }
         for (const auto & tex : _atlasTextures)
         {
             tex.second->setAntiAliasTexParameters();
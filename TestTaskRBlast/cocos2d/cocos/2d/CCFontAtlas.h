@@ -31,9 +31,12 @@
 
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "platform/CCPlatformMacros.h"
 #include "base/CCRef.h"
+#include "math/CCGeometry.h"
 #include "platform/CCStdC.h" // ssize_t on windows
 
 NS_CC_BEGIN
@@ -64,6 +67,7 @@ public:
     static const int CacheTextureHeight;
     static const char* CMD_PURGE_FONTATLAS;
     static const char* CMD_RESET_FONTATLAS;
+    static const char* CMD_UPDATE_FONTATLAS;
     /**
      * @js ctor
      */
@@ -79,6 +83,20 @@ public:
     
     bool prepareLetterDefinitions(const std::u32string& utf16String);
 
+    /** Rasterizes the glyphs of utf32Text that are not in the atlas yet on a worker thread,
+     so they are ready before a label shows them. It only has effect on TTF fonts.
+     @since v3.17
+     */
+    void prewarmLetterDefinitions(const std::u32string& utf32Text);
+
+    /** Enables rasterizing missing glyphs on a worker thread instead of inside prepareLetterDefinitions.
+     Until a glyph arrives it keeps its advance but is not drawn; CMD_UPDATE_FONTATLAS is dispatched
+     when new glyphs have been added so labels can lay out again. It only has effect on TTF fonts.
+     @since v3.17
+     */
+    void setAsyncRasterizationEnabled(bool enabled) { _asyncRasterizationEnabled = enabled; }
+    bool isAsyncRasterizationEnabled() const { return _asyncRasterizationEnabled; }
+
     const std::unordered_map<ssize_t, Texture2D*>& getTextures() const { return _atlasTextures; }
     void  addTexture(Texture2D *texture, int slot);
     float getLineHeight() const { return _lineHeight; }
@@ -112,6 +130,16 @@ public:
      void setAliasTexParameters();
 
 protected:
+    struct GlyphBitmap
+    {
+        char32_t utf32Char;
+        unsigned char* data;
+        long width;
+        long height;
+        Rect rect;
+        int xAdvance;
+    };
+
     void reset();
     
     void reinit();
@@ -129,6 +157,32 @@ protected:
      */
     void scaleFontLetterDefinition(float scaleFactor);
 
+    /** Lays utf32Char out with its advance until its bitmap has been rasterized in the background. */
+    void addPlaceholderDefinition(char32_t utf32Char, unsigned int glyphCode);
+
+    void rasterizeGlyphsAsync(const std::unordered_map<unsigned int, unsigned int>& charCodeMap, bool addPlaceholders);
+
+    /** Packs rasterized glyphs into the shared pages, uploads them and frees their data. */
+    void addGlyphBitmaps(std::vector<GlyphBitmap>& glyphs);
+
+    /** A 512x512 texture page whose glyphs are skyline packed. TTF atlases with the same
+     pixel format and filtering draw their glyphs into the same open page.
+     */
+    struct GlyphPage;
+
+    /** Returns the open page for the pixel format and filtering of this atlas, creating it if needed. */
+    GlyphPage* getOpenPage();
+
+    /** Finds room for a width x height rect on the open page, opening a new page when it is full.
+     Returns the slot of the page in this atlas, or -1 when the rect is larger than a page.
+     */
+    int allocateGlyphRect(int width, int height, int& x, int& y);
+
+    /** Returns the slot of page in this atlas, adding its texture if the atlas did not use it yet. */
+    int addPage(GlyphPage* page);
+
+    void releasePages();
+
     std::unordered_map<ssize_t, Texture2D*> _atlasTextures;
     std::unordered_map<char32_t, FontLetterDefinition> _letterDefinitions;
     float _lineHeight;
@@ -137,20 +191,26 @@ protected:
     void* _iconv;
 
     // Dynamic GlyphCollection related stuff
-    int _currentPage;
-    unsigned char *_currentPageData;
-    int _currentPageDataSize;
-    float _currentPageOrigX;
-    float _currentPageOrigY;
+    std::vector<GlyphPage*> _pages;
+    static std::vector<GlyphPage*> _openPages;
     int _letterPadding;
     int _letterEdgeExtend;
 
     int _fontAscender;
     EventListenerCustom* _rendererRecreatedListener;
     bool _antialiasEnabled;
-    int _currLineHeight;
+
+    // background rasterization
+    bool _asyncRasterizationEnabled;
+    FontFreeType* _workerFont;
+    std::unordered_set<char32_t> _pendingGlyphs;
+    unsigned int _generation;
+
+    // identifies the atlas in the text layouts cached by Label, the address of a deleted atlas can be reused
+    unsigned int _layoutCacheId;
 
     friend class Label;
+    friend class TextLayoutCache;
 };
 
 NS_CC_END
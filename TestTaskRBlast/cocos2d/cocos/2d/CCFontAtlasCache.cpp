@@ -32,10 +32,12 @@
 #include "2d/CCFontCharMap.h"
 #include "2d/CCLabel.h"
 #include "platform/CCFileUtils.h"
+#include "base/ccUTF8.h"
 
 NS_CC_BEGIN
 
 std::unordered_map<std::string, FontAtlas *> FontAtlasCache::_atlasMap;
+bool FontAtlasCache::_asyncGlyphRasterization = false;
 #define ATLAS_MAP_KEY_PREFIX_BUFFER_SIZE 255
 
 void FontAtlasCache::purgeCachedData()
@@ -77,6 +79,7 @@ FontAtlas* FontAtlasCache::getFontAtlasTTF(const _ttfConfig* config)
             auto tempAtlas = font->createFontAtlas();
             if (tempAtlas)
             {
+                tempAtlas->setAsyncRasterizationEnabled(_asyncGlyphRasterization);
                 _atlasMap[atlasName] = tempAtlas;
                 return _atlasMap[atlasName];
             }
@@ -261,4 +264,23 @@ void FontAtlasCache::unloadFontAtlasTTF(const std::string& fontFileName)
     }
 }
 
+void FontAtlasCache::setAsyncGlyphRasterization(bool enabled)
+{
+    _asyncGlyphRasterization = enabled;
+    for (auto&& atlas : _atlasMap)
+    {
+        atlas.second->setAsyncRasterizationEnabled(enabled);
+    }
+}
+
+void FontAtlasCache::prewarmFontAtlasTTF(const _ttfConfig* config, const std::string& utf8Text)
+{
+    auto atlas = getFontAtlasTTF(config);
+    std::u32string utf32Text;
+    if (atlas && StringUtils::UTF8ToUTF32(utf8Text, utf32Text))
+    {
+        atlas->prewarmLetterDefinitions(utf32Text);
+    }
+}
+
 NS_CC_END
@@ -67,8 +67,23 @@ public:
     */
     static void unloadFontAtlasTTF(const std::string& fontFileName);
 
+    /** Rasterizes missing TTF glyphs on a worker thread instead of during Label layout.
+     It applies to the cached TTF atlases and to the ones created afterwards.
+     @see FontAtlas::setAsyncRasterizationEnabled
+     @since v3.17
+     */
+    static void setAsyncGlyphRasterization(bool enabled);
+    static bool isAsyncGlyphRasterization() { return _asyncGlyphRasterization; }
+
+    /** Creates the TTF atlas for config if needed and rasterizes the glyphs of utf8Text in the background,
+     e.g. the character set of a chat window before it opens.
+     @since v3.17
+     */
+    static void prewarmFontAtlasTTF(const _ttfConfig* config, const std::string& utf8Text);
+
 private:
     static std::unordered_map<std::string, FontAtlas *> _atlasMap;
+    static bool _asyncGlyphRasterization;
 };
 
 NS_CC_END
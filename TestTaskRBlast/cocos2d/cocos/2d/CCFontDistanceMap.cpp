@@ -0,0 +1,138 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/CCFontDistanceMap.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+NS_CC_BEGIN
+
+// squared distance transform of one row or column in place,
+// "Distance Transforms of Sampled Functions", Felzenszwalb & Huttenlocher
+static void distanceTransform1D(float* grid, long offset, long stride, long length, float* f, long* v, float* z)
+{
+    static const float INF = 1e20f;
+
+    v[0] = 0;
+    z[0] = -INF;
+    z[1] = INF;
+    f[0] = grid[offset];
+
+    for (long q = 1, k = 0; q < length; ++q)
+    {
+        f[q] = grid[offset + q * stride];
+        float q2 = (float)(q * q);
+        float s;
+        do
+        {
+            long r = v[k];
+            s = (f[q] - f[r] + q2 - (float)(r * r)) / (float)(q - r) * 0.5f;
+        } while (s <= z[k] && --k > -1);
+
+        ++k;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = INF;
+    }
+
+    for (long q = 0, k = 0; q < length; ++q)
+    {
+        while (z[k + 1] < (float)q)
+            ++k;
+        long r = v[k];
+        float qr = (float)(q - r);
+        grid[offset + q * stride] = f[r] + qr * qr;
+    }
+}
+
+static void distanceTransform2D(float* grid, long width, long height, float* f, long* v, float* z)
+{
+    for (long x = 0; x < width; ++x)
+        distanceTransform1D(grid, x, width, height, f, v, z);
+    for (long y = 0; y < height; ++y)
+        distanceTransform1D(grid, y * width, 1, width, f, v, z);
+}
+
+unsigned char* makeDistanceMap(const unsigned char* img, long width, long height, long spread)
+{
+    static const float INF = 1e20f;
+    const long outWidth = width + 2 * spread;
+    const long outHeight = height + 2 * spread;
+    const long pixelAmount = outWidth * outHeight;
+    const long maxSide = std::max(outWidth, outHeight);
+
+    // exact euclidean transform on floats; anti-aliased edge pixels are seeded with their
+    // sub-pixel distance to the 50% coverage contour so the output stays close to edtaa3
+    std::vector<float> outside(pixelAmount, INF);
+    std::vector<float> inside(pixelAmount, 0.0f);
+    std::vector<float> f(maxSide);
+    std::vector<float> z(maxSide + 1);
+    std::vector<long> v(maxSide);
+
+    // the glyph keeps the placement edtaa3 used: padded left and right, but starting on the first row
+    for (long j = 0; j < height; ++j)
+    {
+        const unsigned char* src = img + j * width;
+        long index = j * outWidth + spread;
+        for (long i = 0; i < width; ++i, ++index)
+        {
+            unsigned char coverage = src[i];
+            if (coverage == 0)
+                continue;
+
+            if (coverage == 255)
+            {
+                outside[index] = 0.0f;
+                inside[index] = INF;
+            }
+            else
+            {
+                float d = 0.5f - coverage / 255.0f;
+                outside[index] = d > 0.0f ? d * d : 0.0f;
+                inside[index] = d < 0.0f ? d * d : 0.0f;
+            }
+        }
+    }
+
+    distanceTransform2D(outside.data(), outWidth, outHeight, f.data(), v.data(), z.data());
+    distanceTransform2D(inside.data(), outWidth, outHeight, f.data(), v.data(), z.data());
+
+    /* Single channel 8-bit output (bad precision and range, but simple) */
+    unsigned char *out = (unsigned char *) malloc( pixelAmount * sizeof(unsigned char) );
+    for (long i = 0; i < pixelAmount; ++i)
+    {
+        float dist = std::sqrt(outside[i]) - std::sqrt(inside[i]);
+        dist = 128.0f - dist * 16.0f;
+        if (dist < 0.0f) dist = 0.0f;
+        if (dist > 255.0f) dist = 255.0f;
+        out[i] = (unsigned char) dist;
+    }
+
+    return out;
+}
+
+NS_CC_END
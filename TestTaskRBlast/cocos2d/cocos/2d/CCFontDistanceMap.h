@@ -0,0 +1,48 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef _CCFontDistanceMap_h_
+#define _CCFontDistanceMap_h_
+
+/// @cond DO_NOT_SHOW
+
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/** Makes the signed distance field of a glyph bitmap for distance field labels.
+ It runs the exact euclidean distance transform of Felzenszwalb & Huttenlocher on floats, once for
+ the outside and once for the inside of the glyph. It keeps no state and can run on several threads.
+ @param img The 8-bit coverage of the glyph, width x height texels.
+ @param spread The padding added on each side, FontFreeType::DistanceMapSpread for labels.
+ @return (width + 2 * spread) x (height + 2 * spread) texels allocated with malloc, 128 on the
+ contour and 16 levels per pixel of distance.
+ @since v3.17
+ */
+CC_DLL unsigned char* makeDistanceMap(const unsigned char* img, long width, long height, long spread);
+
+NS_CC_END
+
+/// @endcond
+#endif /* defined(_CCFontDistanceMap_h_) */
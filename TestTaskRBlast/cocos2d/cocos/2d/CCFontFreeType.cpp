@@ -26,17 +26,23 @@ THE SOFTWARE.
 
 #include "2d/CCFontFreeType.h"
 #include FT_BBOX_H
-#include "edtaa3func.h"
+#include FT_ADVANCES_H
 #include "2d/CCFontAtlas.h"
+#include "2d/CCFontDistanceMap.h"
 #include "base/CCDirector.h"
 #include "base/ccUTF8.h"
 #include "platform/CCFileUtils.h"
 
+#include <cmath>
+#include <vector>
+
 NS_CC_BEGIN
 
 
 FT_Library FontFreeType::_FTlibrary;
 bool       FontFreeType::_FTInitialized = false;
+FT_Library FontFreeType::_FTWorkerLibrary = nullptr;
+std::mutex FontFreeType::_FTWorkerMutex;
 const int  FontFreeType::DistanceMapSpread = 3;
 
 const char* FontFreeType::_glyphASCII = "\"!#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~¡¢£¤¥¦§¨©ª«¬­®¯°±²³´µ¶·¸¹º»¼½¾¿ÀÁÂÃÄÅÆÇÈÉÊËÌÍÎÏÐÑÒÓÔÕÖ×ØÙÚÛÜÝÞßàáâãäåæçèéêëìíîïðñòóôõö÷øùúûüýþ ";
@@ -44,7 +50,8 @@ const char* FontFreeType::_glyphNEHE = "!\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFG
 
 typedef struct _DataRef
 {
-    Data data;
+    // mapped, FreeType reads the font in place for the lifetime of the face
+    FileView data;
     unsigned int referenceCount;
 }DataRef;
 
@@ -90,18 +97,38 @@ void FontFreeType::shutdownFreeType()
         s_cacheFontData.clear();
         _FTInitialized = false;
     }
+
+    std::lock_guard<std::mutex> lock(_FTWorkerMutex);
+    if (_FTWorkerLibrary)
+    {
+        FT_Done_FreeType(_FTWorkerLibrary);
+        _FTWorkerLibrary = nullptr;
+    }
 }
 
 FT_Library FontFreeType::getFTLibrary()
 {
+    // FreeType 2.5 renders through a raster pool owned by the library, so fonts used
+    // off the main thread get a library of their own (guarded by _FTWorkerMutex)
+    if (_workerFont)
+    {
+        if (_FTWorkerLibrary == nullptr && FT_Init_FreeType(&_FTWorkerLibrary))
+        {
+            _FTWorkerLibrary = nullptr;
+        }
+        return _FTWorkerLibrary;
+    }
+
     initFreeType();
     return _FTlibrary;
 }
 
-FontFreeType::FontFreeType(bool distanceFieldEnabled /* = false */, float outline /* = 0 */)
+FontFreeType::FontFreeType(bool distanceFieldEnabled /* = false */, float outline /* = 0 */, bool workerFont /* = false */)
 : _fontRef(nullptr)
 , _stroker(nullptr)
 , _encoding(FT_ENCODING_UNICODE)
+, _fontSize(0.0f)
+, _workerFont(workerFont)
 , _distanceFieldEnabled(distanceFieldEnabled)
 , _outlineSize(0.0f)
 , _lineHeight(0)
@@ -110,8 +137,12 @@ FontFreeType::FontFreeType(bool distanceFieldEnabled /* = false */, float outlin
 {
     if (outline > 0.0f)
     {
+        std::unique_lock<std::mutex> lock(_FTWorkerMutex, std::defer_lock);
+        if (_workerFont)
+            lock.lock();
+
         _outlineSize = outline * CC_CONTENT_SCALE_FACTOR();
-        FT_Stroker_New(FontFreeType::getFTLibrary(), &_stroker);
+        FT_Stroker_New(getFTLibrary(), &_stroker);
         FT_Stroker_Set(_stroker,
             (int)(_outlineSize * 64),
             FT_STROKER_LINECAP_ROUND,
@@ -125,6 +156,7 @@ bool FontFreeType::createFontObject(const std::string &fontName, float fontSize)
     FT_Face face;
     // save font name locally
     _fontName = fontName;
+    _fontSize = fontSize;
 
     auto it = s_cacheFontData.find(fontName);
     if (it != s_cacheFontData.end())
@@ -134,7 +166,7 @@ bool FontFreeType::createFontObject(const std::string &fontName, float fontSize)
     else
     {
         s_cacheFontData[fontName].referenceCount = 1;
-        s_cacheFontData[fontName].data = FileUtils::getInstance()->getDataFromFile(fontName);    
+        s_cacheFontData[fontName].data = FileUtils::getInstance()->mapFile(fontName);
 
         if (s_cacheFontData[fontName].data.isNull())
         {
@@ -142,7 +174,12 @@ bool FontFreeType::createFontObject(const std::string &fontName, float fontSize)
         }
     }
 
-    if (FT_New_Memory_Face(getFTLibrary(), s_cacheFontData[fontName].data.getBytes(), s_cacheFontData[fontName].data.getSize(), 0, &face ))
+    std::unique_lock<std::mutex> lock(_FTWorkerMutex, std::defer_lock);
+    if (_workerFont)
+        lock.lock();
+
+    auto library = getFTLibrary();
+    if (library == nullptr || FT_New_Memory_Face(library, s_cacheFontData[fontName].data.getBytes(), s_cacheFontData[fontName].data.getSize(), 0, &face ))
         return false;
 
     if (FT_Select_Charmap(face, FT_ENCODING_UNICODE))
@@ -185,7 +222,11 @@ bool FontFreeType::createFontObject(const std::string &fontName, float fontSize)
 
 FontFreeType::~FontFreeType()
 {
-    if (_FTInitialized)
+    std::unique_lock<std::mutex> lock(_FTWorkerMutex, std::defer_lock);
+    if (_workerFont)
+        lock.lock();
+
+    if (_workerFont ? _FTWorkerLibrary != nullptr : _FTInitialized)
     {
         if (_stroker)
         {
@@ -448,7 +489,7 @@ unsigned char * FontFreeType::getGlyphBitmapWithOutline(uint64_t theChar, FT_BBo
                     params.target = &bmp;
                     params.flags = FT_RASTER_FLAG_AA;
                     FT_Outline_Translate(outline,-bbox.xMin,-bbox.yMin);
-                    FT_Outline_Render(_FTlibrary, outline, &params);
+                    FT_Outline_Render(getFTLibrary(), outline, &params);
 
                     ret = bmp.buffer;
                 }
@@ -460,87 +501,6 @@ unsigned char * FontFreeType::getGlyphBitmapWithOutline(uint64_t theChar, FT_BBo
     return ret;
 }
 
-unsigned char * makeDistanceMap( unsigned char *img, long width, long height)
-{
-    long pixelAmount = (width + 2 * FontFreeType::DistanceMapSpread) * (height + 2 * FontFreeType::DistanceMapSpread);
-
-    short * xdist = (short *)  malloc( pixelAmount * sizeof(short) );
-    short * ydist = (short *)  malloc( pixelAmount * sizeof(short) );
-    double * gx   = (double *) calloc( pixelAmount, sizeof(double) );
-    double * gy      = (double *) calloc( pixelAmount, sizeof(double) );
-    double * data    = (double *) calloc( pixelAmount, sizeof(double) );
-    double * outside = (double *) calloc( pixelAmount, sizeof(double) );
-    double * inside  = (double *) calloc( pixelAmount, sizeof(double) );
-    long i,j;
-
-    // Convert img into double (data) rescale image levels between 0 and 1
-    long outWidth = width + 2 * FontFreeType::DistanceMapSpread;
-    for (i = 0; i < width; ++i)
-    {
-        for (j = 0; j < height; ++j)
-        {
-            data[j * outWidth + FontFreeType::DistanceMapSpread + i] = img[j * width + i] / 255.0;
-        }
-    }
-
-    width += 2 * FontFreeType::DistanceMapSpread;
-    height += 2 * FontFreeType::DistanceMapSpread;
-
-    // Transform background (outside contour, in areas of 0's)   
-    computegradient( data, (int)width, (int)height, gx, gy);
-    edtaa3(data, gx, gy, (int)width, (int)height, xdist, ydist, outside);
-    for( i=0; i< pixelAmount; i++)
-        if( outside[i] < 0.0 )
-            outside[i] = 0.0;
-
-    // Transform foreground (inside contour, in areas of 1's)   
-    for( i=0; i< pixelAmount; i++)
-        data[i] = 1 - data[i];
-    computegradient( data, (int)width, (int)height, gx, gy);
-    edtaa3(data, gx, gy, (int)width, (int)height, xdist, ydist, inside);
-    for( i=0; i< pixelAmount; i++)
-        if( inside[i] < 0.0 )
-            inside[i] = 0.0;
-
-    // The bipolar distance field is now outside-inside
-    double dist;
-    /* Single channel 8-bit output (bad precision and range, but simple) */    
-    unsigned char *out = (unsigned char *) malloc( pixelAmount * sizeof(unsigned char) );
-    for( i=0; i < pixelAmount; i++)
-    {
-        dist = outside[i] - inside[i];
-        dist = 128.0 - dist*16;
-        if( dist < 0 ) dist = 0;
-        if( dist > 255 ) dist = 255;
-        out[i] = (unsigned char) dist;
-    }
-    /* Dual channel 16-bit output (more complicated, but good precision and range) */
-    /*unsigned char *out = (unsigned char *) malloc( pixelAmount * 3 * sizeof(unsigned char) ); 
-    for( i=0; i< pixelAmount; i++)
-    {
-        dist = outside[i] - inside[i];
-        dist = 128.0 - dist*16;
-        if( dist < 0.0 ) dist = 0.0;
-        if( dist >= 256.0 ) dist = 255.999;
-        // R channel is a copy of the original grayscale image
-        out[3*i] = img[i];
-        // G channel is fraction
-        out[3*i + 1] = (unsigned char) ( 256 - (dist - floor(dist)* 256.0 ));
-        // B channel is truncated integer part
-        out[3*i + 2] = (unsigned char)dist; 
-    }*/
-    
-    free( xdist );
-    free( ydist );
-    free( gx );
-    free( gy );
-    free( data );
-    free( outside );
-    free( inside );
-
-    return out;
-}
-
 void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned char* bitmap,long bitmapWidth,long bitmapHeight)
 {
     int iX = posX;
@@ -548,7 +508,7 @@ void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned
 
     if (_distanceFieldEnabled)
     {
-        auto distanceMap = makeDistanceMap(bitmap,bitmapWidth,bitmapHeight);
+        auto distanceMap = makeDistanceMap(bitmap, bitmapWidth, bitmapHeight, DistanceMapSpread);
 
         bitmapWidth += 2 * DistanceMapSpread;
         bitmapHeight += 2 * DistanceMapSpread;
@@ -621,6 +581,76 @@ void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned
     } 
 }
 
+unsigned char* FontFreeType::rasterizeGlyph(uint64_t theChar, long &outWidth, long &outHeight, Rect &outRect, int &xAdvance)
+{
+    std::unique_lock<std::mutex> lock(_FTWorkerMutex, std::defer_lock);
+    if (_workerFont)
+        lock.lock();
+
+    auto bitmap = getGlyphBitmap(theChar, outWidth, outHeight, outRect, xAdvance);
+    if (bitmap == nullptr || outWidth <= 0 || outHeight <= 0)
+    {
+        // only the blended outline image is allocated by getGlyphBitmap
+        if (bitmap && _outlineSize > 0)
+            delete [] bitmap;
+        return nullptr;
+    }
+
+    unsigned char* ret = nullptr;
+    if (_distanceFieldEnabled)
+    {
+        auto distanceMap = makeDistanceMap(bitmap, outWidth, outHeight, DistanceMapSpread);
+        auto size = (outWidth + 2 * DistanceMapSpread) * (outHeight + 2 * DistanceMapSpread);
+        ret = new (std::nothrow) unsigned char[size];
+        if (ret)
+            memcpy(ret, distanceMap, size);
+        free(distanceMap);
+    }
+    else if (_outlineSize > 0)
+    {
+        ret = bitmap;
+    }
+    else
+    {
+        // the glyph slot buffer is reused by the next FT_Load_Char
+        ret = new (std::nothrow) unsigned char[outWidth * outHeight];
+        if (ret)
+            memcpy(ret, bitmap, outWidth * outHeight);
+    }
+
+    return ret;
+}
+
+int FontFreeType::getGlyphAdvance(uint64_t theChar) const
+{
+    if (_fontRef == nullptr)
+        return 0;
+
+    FT_Fixed advance = 0;
+    auto glyphIndex = FT_Get_Char_Index(_fontRef, static_cast<FT_ULong>(theChar));
+    if (FT_Get_Advance(_fontRef, glyphIndex, _distanceFieldEnabled ? FT_LOAD_NO_HINTING | FT_LOAD_NO_AUTOHINT : FT_LOAD_NO_AUTOHINT, &advance))
+        return 0;
+
+    // 16.16 fixed point when the font is scaled
+    return static_cast<int>(advance >> 16);
+}
+
+FontFreeType* FontFreeType::createWorkerFont() const
+{
+    auto font = new (std::nothrow) FontFreeType(_distanceFieldEnabled, _outlineSize / CC_CONTENT_SCALE_FACTOR(), true);
+    if (!font)
+        return nullptr;
+
+    font->setGlyphCollection(GlyphCollection::DYNAMIC);
+    if (!font->createFontObject(_fontName, _fontSize))
+    {
+        delete font;
+        return nullptr;
+    }
+    font->autorelease();
+    return font;
+}
+
 void FontFreeType::setGlyphCollection(GlyphCollection glyphs, const char* customGlyphs /* = nullptr */)
 {
     _usedGlyphs = glyphs;
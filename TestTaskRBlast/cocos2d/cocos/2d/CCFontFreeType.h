@@ -32,6 +32,7 @@
 #include "2d/CCFont.h"
 
 #include <string>
+#include <mutex>
 #include "ft2build.h"
 
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
@@ -70,6 +71,26 @@ public:
     int* getHorizontalKerningForTextUTF32(const std::u32string& text, int &outNumLetters) const override;
     
     unsigned char* getGlyphBitmap(uint64_t theChar, long &outWidth, long &outHeight, Rect &outRect,int &xAdvance);
+
+    /** Rasterizes a glyph into a buffer owned by the caller (delete[]), already converted the way
+     * renderCharAt would write it: a distance map of (outWidth + 2 * DistanceMapSpread) x
+     * (outHeight + 2 * DistanceMapSpread) bytes, outline/glyph byte pairs, or plain coverage.
+     * Returns nullptr for empty glyphs, in which case only xAdvance is meaningful.
+     * @since v3.17
+     */
+    unsigned char* rasterizeGlyph(uint64_t theChar, long &outWidth, long &outHeight, Rect &outRect, int &xAdvance);
+
+    /** Returns the horizontal advance of a glyph without rasterizing it.
+     * @since v3.17
+     */
+    int getGlyphAdvance(uint64_t theChar) const;
+
+    /** Creates a copy of this font with its own FT_Face on a FreeType library reserved for worker
+     * threads, so its glyphs can be rasterized while the main thread keeps using this one.
+     * Only one thread may use the returned font at a time; create and release it on the main thread.
+     * @since v3.17
+     */
+    FontFreeType* createWorkerFont() const;
     
     int getFontAscender() const;
     const char* getFontFamily() const;
@@ -85,8 +106,10 @@ private:
     static const char* _glyphNEHE;
     static FT_Library _FTlibrary;
     static bool _FTInitialized;
+    static FT_Library _FTWorkerLibrary;
+    static std::mutex _FTWorkerMutex;
 
-    FontFreeType(bool distanceFieldEnabled = false, float outline = 0);
+    FontFreeType(bool distanceFieldEnabled = false, float outline = 0, bool workerFont = false);
     virtual ~FontFreeType();
 
     bool createFontObject(const std::string &fontName, float fontSize);
@@ -105,6 +128,8 @@ private:
     FT_Encoding _encoding;
 
     std::string _fontName;
+    float _fontSize;
+    bool _workerFont;
     bool _distanceFieldEnabled;
     float _outlineSize;
     int _lineHeight;
@@ -27,6 +27,7 @@
 #include "2d/CCLabel.h"
 
 #include <algorithm>
+#include <list>
 
 #include "2d/CCFont.h"
 #include "2d/CCFontAtlasCache.h"
@@ -172,6 +173,234 @@ private:
     bool _letterVisible;
 };
 
+/**
+ * LRU cache of the line breaking and alignment of the texts of the labels, shared by all the labels.
+ */
+class TextLayoutCache
+{
+public:
+    struct Key
+    {
+        std::u32string utf32Text;
+        // the font atlas stands for the TTF config, the FNT file or the char map
+        unsigned int fontAtlasId;
+        float bmFontSize;
+        float contentScaleFactor;
+        float lineHeight;
+        float lineSpacing;
+        float additionalKerning;
+        float maxLineWidth;
+        float labelWidth;
+        float labelHeight;
+        bool enableWrap;
+        bool lineBreakWithoutSpaces;
+        TextHAlignment hAlignment;
+        TextVAlignment vAlignment;
+        Label::Overflow overflow;
+
+        bool operator==(const Key& other) const
+        {
+            return fontAtlasId == other.fontAtlasId && bmFontSize == other.bmFontSize
+                && contentScaleFactor == other.contentScaleFactor && lineHeight == other.lineHeight
+                && lineSpacing == other.lineSpacing && additionalKerning == other.additionalKerning
+                && maxLineWidth == other.maxLineWidth && labelWidth == other.labelWidth
+                && labelHeight == other.labelHeight && enableWrap == other.enableWrap
+                && lineBreakWithoutSpaces == other.lineBreakWithoutSpaces && hAlignment == other.hAlignment
+                && vAlignment == other.vAlignment && overflow == other.overflow && utf32Text == other.utf32Text;
+        }
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const
+        {
+            size_t hash = std::hash<std::u32string>()(key.utf32Text);
+            combine(hash, key.fontAtlasId);
+            combine(hash, std::hash<float>()(key.bmFontSize));
+            combine(hash, std::hash<float>()(key.lineHeight));
+            combine(hash, std::hash<float>()(key.maxLineWidth));
+            combine(hash, std::hash<float>()(key.labelWidth));
+            combine(hash, std::hash<float>()(key.labelHeight));
+            combine(hash, static_cast<size_t>(key.hAlignment) | static_cast<size_t>(key.vAlignment) << 4 | static_cast<size_t>(key.overflow) << 8);
+            return hash;
+        }
+
+        static void combine(size_t& hash, size_t value)
+        {
+            hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        }
+    };
+
+    TextLayoutCache()
+    : _capacity(64)
+    , _hits(0)
+    , _misses(0)
+    {
+    }
+
+    /** Builds the key of the current text of label, returns false when its layout can't be cached. */
+    bool makeKey(const Label* label, Key& key) const
+    {
+        // shrinking scales the letter definitions of the atlas while laying out
+        if (_capacity == 0 || label->_overflow == Label::Overflow::SHRINK)
+        {
+            return false;
+        }
+
+        key.utf32Text = label->_utf32Text;
+        key.fontAtlasId = label->_fontAtlas->_layoutCacheId;
+        key.bmFontSize = label->_currentLabelType == Label::LabelType::BMFONT ? label->_bmFontSize : 0.f;
+        key.contentScaleFactor = CC_CONTENT_SCALE_FACTOR();
+        key.lineHeight = label->_lineHeight;
+        key.lineSpacing = label->_lineSpacing;
+        key.additionalKerning = label->_additionalKerning;
+        key.maxLineWidth = label->_maxLineWidth;
+        key.labelWidth = label->_labelWidth;
+        key.labelHeight = label->_labelHeight;
+        key.enableWrap = label->_enableWrap;
+        key.lineBreakWithoutSpaces = label->_lineBreakWithoutSpaces;
+        key.hAlignment = label->_hAlignment;
+        key.vAlignment = label->_vAlignment;
+        key.overflow = label->_overflow;
+        return true;
+    }
+
+    /** Restores the layout of key in label, returns false when it is not cached. */
+    bool restore(Label* label, const Key& key)
+    {
+        auto it = _layouts.find(key);
+        if (it == _layouts.end())
+        {
+            ++_misses;
+            return false;
+        }
+        ++_hits;
+        _lru.splice(_lru.begin(), _lru, it->second.lruPosition);
+
+        const Layout& layout = it->second;
+        label->updateBMFontScale();
+        label->_lengthOfString = static_cast<int>(layout.lettersInfo.size());
+        label->_lettersInfo = layout.lettersInfo;
+        label->_linesWidth = layout.linesWidth;
+        label->_linesOffsetX = layout.linesOffsetX;
+        label->_numberOfLines = layout.numberOfLines;
+        label->_textDesiredHeight = layout.textDesiredHeight;
+        label->_letterOffsetY = layout.letterOffsetY;
+        label->_tailoredTopY = layout.tailoredTopY;
+        label->_tailoredBottomY = layout.tailoredBottomY;
+        label->setContentSize(layout.contentSize);
+        return true;
+    }
+
+    /** Stores the layout label has just computed for key. */
+    void store(const Label* label, Key&& key)
+    {
+        // the placeholders of the glyphs being rasterized have no size nor offset
+        if (!label->_fontAtlas->_pendingGlyphs.empty())
+        {
+            return;
+        }
+
+        auto result = _layouts.emplace(std::move(key), Layout());
+        if (!result.second)
+        {
+            return;
+        }
+        _lru.push_front(&result.first->first);
+
+        Layout& layout = result.first->second;
+        layout.lruPosition = _lru.begin();
+        auto letterCount = std::min(label->_lettersInfo.size(), static_cast<size_t>(label->_lengthOfString));
+        layout.lettersInfo.assign(label->_lettersInfo.begin(), label->_lettersInfo.begin() + letterCount);
+        layout.linesWidth = label->_linesWidth;
+        layout.linesOffsetX = label->_linesOffsetX;
+        layout.numberOfLines = label->_numberOfLines;
+        layout.textDesiredHeight = label->_textDesiredHeight;
+        layout.letterOffsetY = label->_letterOffsetY;
+        layout.tailoredTopY = label->_tailoredTopY;
+        layout.tailoredBottomY = label->_tailoredBottomY;
+        layout.contentSize = label->_contentSize;
+
+        trim();
+    }
+
+    void setCapacity(size_t capacity)
+    {
+        _capacity = capacity;
+        trim();
+    }
+
+    size_t getCapacity() const { return _capacity; }
+
+    void purge()
+    {
+        _layouts.clear();
+        _lru.clear();
+    }
+
+    unsigned int getHits() const { return _hits; }
+    unsigned int getMisses() const { return _misses; }
+
+private:
+    struct Layout
+    {
+        std::list<const Key*>::iterator lruPosition;
+        std::vector<Label::LetterInfo> lettersInfo;
+        std::vector<float> linesWidth;
+        std::vector<float> linesOffsetX;
+        int numberOfLines;
+        float textDesiredHeight;
+        float letterOffsetY;
+        float tailoredTopY;
+        float tailoredBottomY;
+        Size contentSize;
+    };
+
+    void trim()
+    {
+        while (_layouts.size() > _capacity)
+        {
+            auto oldest = _layouts.find(*_lru.back());
+            _lru.pop_back();
+            _layouts.erase(oldest);
+        }
+    }
+
+    std::unordered_map<Key, Layout, KeyHash> _layouts;
+    // keys of _layouts, the most recently used first
+    std::list<const Key*> _lru;
+    size_t _capacity;
+    unsigned int _hits;
+    unsigned int _misses;
+};
+
+static TextLayoutCache s_textLayoutCache;
+
+void Label::setTextLayoutCacheCapacity(size_t capacity)
+{
+    s_textLayoutCache.setCapacity(capacity);
+}
+
+size_t Label::getTextLayoutCacheCapacity()
+{
+    return s_textLayoutCache.getCapacity();
+}
+
+void Label::purgeTextLayoutCache()
+{
+    s_textLayoutCache.purge();
+}
+
+unsigned int Label::getTextLayoutCacheHits()
+{
+    return s_textLayoutCache.getHits();
+}
+
+unsigned int Label::getTextLayoutCacheMisses()
+{
+    return s_textLayoutCache.getMisses();
+}
+
 Label* Label::create()
 {
     auto ret = new (std::nothrow) Label;
@@ -385,7 +614,6 @@ Label::Label(TextHAlignment hAlignment /* = TextHAlignment::LEFT */,
 : _textSprite(nullptr)
 , _shadowNode(nullptr)
 , _fontAtlas(nullptr)
-, _reusedLetter(nullptr)
 , _horizontalKernings(nullptr)
 , _boldEnabled(false)
 , _underlineNode(nullptr)
@@ -435,6 +663,15 @@ Label::Label(TextHAlignment hAlignment /* = TextHAlignment::LEFT */,
         }
     });
     _eventDispatcher->addEventListenerWithFixedPriority(_resetTextureListener, 2);
+
+    _updateTextureListener = EventListenerCustom::create(FontAtlas::CMD_UPDATE_FONTATLAS, [this](EventCustom* event){
+        // glyphs rasterized in the background replace their placeholders
+        if (_fontAtlas && event->getUserData() == _fontAtlas)
+        {
+            _contentDirty = true;
+        }
+    });
+    _eventDispatcher->addEventListenerWithFixedPriority(_updateTextureListener, 3);
 }
 
 Label::~Label()
@@ -444,12 +681,12 @@ Label::~Label()
     if (_fontAtlas)
     {
         Node::removeAllChildrenWithCleanup(true);
-        CC_SAFE_RELEASE_NULL(_reusedLetter);
         _batchNodes.clear();
         FontAtlasCache::releaseFontAtlas(_fontAtlas);
     }
     _eventDispatcher->removeEventListener(_purgeTextureListener);
     _eventDispatcher->removeEventListener(_resetTextureListener);
+    _eventDispatcher->removeEventListener(_updateTextureListener);
 
     CC_SAFE_RELEASE_NULL(_textSprite);
     CC_SAFE_RELEASE_NULL(_shadowNode);
@@ -460,7 +697,6 @@ void Label::reset()
     CC_SAFE_RELEASE_NULL(_textSprite);
     CC_SAFE_RELEASE_NULL(_shadowNode);
     Node::removeAllChildrenWithCleanup(true);
-    CC_SAFE_RELEASE_NULL(_reusedLetter);
     _letters.clear();
     _batchNodes.clear();
     _lettersInfo.clear();
@@ -561,8 +797,6 @@ void Label::updateShaderProgram()
             setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL));
         else if (_useA8Shader)
             setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_LABEL_NORMAL));
-        else if (_shadowEnabled)
-            setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR, _getTexture(this)));
         else
             setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP, _getTexture(this)));
 
@@ -603,14 +837,6 @@ void Label::setFontAtlas(FontAtlas* atlas,bool distanceFieldEnabled /* = false *
         FontAtlasCache::releaseFontAtlas(_fontAtlas);
     }
     _fontAtlas = atlas;
-    
-    if (_reusedLetter == nullptr)
-    {
-        _reusedLetter = Sprite::create();
-        _reusedLetter->setOpacityModifyRGB(_isOpacityModifyRGB);            
-        _reusedLetter->retain();
-        _reusedLetter->setAnchorPoint(Vec2::ANCHOR_TOP_LEFT);
-    }
 
     if (_fontAtlas)
     {
@@ -848,20 +1074,29 @@ bool Label::alignText()
         if (_batchNodes.size()==1)
             _batchNodes.at(0)->reserveCapacity(_utf32Text.size());
 
-        _reusedLetter->setBatchNode(_batchNodes.at(0));
-        
         _lengthOfString = 0;
         _textDesiredHeight = 0.f;
         _linesWidth.clear();
-        if (_maxLineWidth > 0.f && !_lineBreakWithoutSpaces)
-        {
-            multilineTextWrapByWord();
-        }
-        else
+        TextLayoutCache::Key layoutKey;
+        bool layoutCacheable = s_textLayoutCache.makeKey(this, layoutKey);
+        if (!layoutCacheable || !s_textLayoutCache.restore(this, layoutKey))
         {
-            multilineTextWrapByChar();
+            computeHorizontalKernings(_utf32Text);
+            if (_maxLineWidth > 0.f && !_lineBreakWithoutSpaces)
+            {
+                multilineTextWrapByWord();
+            }
+            else
+            {
+                multilineTextWrapByChar();
+            }
+            computeAlignmentOffset();
+
+            if (layoutCacheable)
+            {
+                s_textLayoutCache.store(this, std::move(layoutKey));
+            }
         }
-        computeAlignmentOffset();
 
         if(_overflow == Overflow::SHRINK){
             float fontSize = this->getRenderingFontSize();
@@ -918,34 +1153,39 @@ bool Label::isHorizontalClamped(float letterPositionX, int lineIndex)
 bool Label::updateQuads()
 {
     bool ret = true;
-    for (auto&& batchNode : _batchNodes)
-    {
-        batchNode->getTextureAtlas()->removeAllQuads();
-    }
-    
+
+    // Glyph quads are written straight into the batch node atlases. A slot is
+    // only rewritten when its contents change, so relaying out an unchanged
+    // prefix (e.g. a score counter) leaves the vertex buffer clean.
+    std::vector<ssize_t> quadCounts(_batchNodes.size(), 0);
+    Color4B color4 = getQuadColor();
+    float letterScale = getLetterScale();
+    Rect letterRect;
+    V3F_C4B_T2F_Quad quad;
+
     for (int ctr = 0; ctr < _lengthOfString; ++ctr)
     {
         if (_lettersInfo[ctr].valid)
         {
             auto& letterDef = _fontAtlas->_letterDefinitions[_lettersInfo[ctr].utf32Char];
             
-            _reusedRect.size.height = letterDef.height;
-            _reusedRect.size.width  = letterDef.width;
-            _reusedRect.origin.x    = letterDef.U;
-            _reusedRect.origin.y    = letterDef.V;
+            letterRect.size.height = letterDef.height;
+            letterRect.size.width  = letterDef.width;
+            letterRect.origin.x    = letterDef.U;
+            letterRect.origin.y    = letterDef.V;
 
             auto py = _lettersInfo[ctr].positionY + _letterOffsetY;
             if (_labelHeight > 0.f) {
                 if (py > _tailoredTopY)
                 {
                     auto clipTop = py - _tailoredTopY;
-                    _reusedRect.origin.y += clipTop;
-                    _reusedRect.size.height -= clipTop;
+                    letterRect.origin.y += clipTop;
+                    letterRect.size.height -= clipTop;
                     py -= clipTop;
                 }
                 if (py - letterDef.height * _bmfontScale < _tailoredBottomY)
                 {
-                    _reusedRect.size.height = (py < _tailoredBottomY) ? 0.f : (py - _tailoredBottomY);
+                    letterRect.size.height = (py < _tailoredBottomY) ? 0.f : (py - _tailoredBottomY);
                 }
             }
 
@@ -955,13 +1195,13 @@ bool Label::updateQuads()
             if(_labelWidth > 0.f){
                 if (this->isHorizontalClamped(px, lineIndex)) {
                     if(_overflow == Overflow::CLAMP){
-                        _reusedRect.size.width = 0;
+                        letterRect.size.width = 0;
                     }else if(_overflow == Overflow::SHRINK){
                         if (_contentSize.width > letterDef.width) {
                             ret = false;
                             break;
                         }else{
-                            _reusedRect.size.width = 0;
+                            letterRect.size.width = 0;
                         }
 
                     }
@@ -969,25 +1209,89 @@ bool Label::updateQuads()
             }
 
 
-            if (_reusedRect.size.height > 0.f && _reusedRect.size.width > 0.f)
+            if (letterRect.size.height > 0.f && letterRect.size.width > 0.f)
             {
-                _reusedLetter->setTextureRect(_reusedRect, false, _reusedRect.size);
-                float letterPositionX = _lettersInfo[ctr].positionX + _linesOffsetX[_lettersInfo[ctr].lineIndex];
-                _reusedLetter->setPosition(letterPositionX, py);
-                auto index = static_cast<int>(_batchNodes.at(letterDef.textureID)->getTextureAtlas()->getTotalQuads());
-                _lettersInfo[ctr].atlasIndex = index;
+                auto batchNode = _batchNodes.at(letterDef.textureID);
+                auto textureAtlas = batchNode->getTextureAtlas();
+                auto& index = quadCounts[letterDef.textureID];
+                while (index >= textureAtlas->getCapacity())
+                {
+                    batchNode->increaseAtlasCapacity();
+                }
 
-                this->updateLetterSpriteScale(_reusedLetter);
+                float letterPositionX = _lettersInfo[ctr].positionX + _linesOffsetX[_lettersInfo[ctr].lineIndex];
+                setLetterQuad(&quad, letterRect, letterPositionX, py, letterScale, textureAtlas->getTexture(), color4);
+                _lettersInfo[ctr].atlasIndex = static_cast<int>(index);
 
-                _batchNodes.at(letterDef.textureID)->insertQuadFromSprite(_reusedLetter, index);
+                if (index >= textureAtlas->getTotalQuads() ||
+                    memcmp(&textureAtlas->getQuads()[index], &quad, sizeof(quad)) != 0)
+                {
+                    textureAtlas->updateQuad(&quad, index);
+                }
+                ++index;
             }
         }     
     }
 
+    // drop the quads left over from a longer previous string
+    for (size_t i = 0; i < quadCounts.size(); ++i)
+    {
+        auto textureAtlas = _batchNodes.at(i)->getTextureAtlas();
+        auto totalQuads = textureAtlas->getTotalQuads();
+        if (totalQuads > quadCounts[i])
+        {
+            textureAtlas->removeQuadsAtIndex(quadCounts[i], totalQuads - quadCounts[i]);
+        }
+    }
 
     return ret;
 }
 
+void Label::setLetterQuad(V3F_C4B_T2F_Quad* quad, const Rect& rectInPoints, float x, float y, float scale,
+                          Texture2D* texture, const Color4B& color) const
+{
+    // same geometry as a Sprite anchored at its top left corner, see Sprite::updateTransform
+    float left = x;
+    float right = x + rectInPoints.size.width * scale;
+    float top = y;
+    float bottom = y - rectInPoints.size.height * scale;
+
+    quad->bl.vertices.set(SPRITE_RENDER_IN_SUBPIXEL(left), SPRITE_RENDER_IN_SUBPIXEL(bottom), 0.f);
+    quad->br.vertices.set(SPRITE_RENDER_IN_SUBPIXEL(right), SPRITE_RENDER_IN_SUBPIXEL(bottom), 0.f);
+    quad->tl.vertices.set(SPRITE_RENDER_IN_SUBPIXEL(left), SPRITE_RENDER_IN_SUBPIXEL(top), 0.f);
+    quad->tr.vertices.set(SPRITE_RENDER_IN_SUBPIXEL(right), SPRITE_RENDER_IN_SUBPIXEL(top), 0.f);
+
+    // same texture coordinates as Sprite::setTextureCoords for an unrotated, unflipped rect
+    const auto rectInPixels = CC_RECT_POINTS_TO_PIXELS(rectInPoints);
+    const float atlasWidth = (float)texture->getPixelsWide();
+    const float atlasHeight = (float)texture->getPixelsHigh();
+#if CC_FIX_ARTIFACTS_BY_STRECHING_TEXEL
+    float u0 = (2*rectInPixels.origin.x+1) / (2*atlasWidth);
+    float u1 = u0+(rectInPixels.size.width*2-2) / (2*atlasWidth);
+    float v0 = (2*rectInPixels.origin.y+1) / (2*atlasHeight);
+    float v1 = v0+(rectInPixels.size.height*2-2) / (2*atlasHeight);
+#else
+    float u0 = rectInPixels.origin.x / atlasWidth;
+    float u1 = (rectInPixels.origin.x + rectInPixels.size.width) / atlasWidth;
+    float v0 = rectInPixels.origin.y / atlasHeight;
+    float v1 = (rectInPixels.origin.y + rectInPixels.size.height) / atlasHeight;
+#endif // CC_FIX_ARTIFACTS_BY_STRECHING_TEXEL
+
+    quad->bl.texCoords.u = u0;
+    quad->bl.texCoords.v = v1;
+    quad->br.texCoords.u = u1;
+    quad->br.texCoords.v = v1;
+    quad->tl.texCoords.u = u0;
+    quad->tl.texCoords.v = v0;
+    quad->tr.texCoords.u = u1;
+    quad->tr.texCoords.v = v0;
+
+    quad->bl.colors = color;
+    quad->br.colors = color;
+    quad->tl.colors = color;
+    quad->tr.colors = color;
+}
+
 bool Label::setTTFConfigInternal(const TTFConfig& ttfConfig)
 {
     FontAtlas *newAtlas = FontAtlasCache::getFontAtlasTTF(&ttfConfig);
@@ -1072,6 +1376,7 @@ void Label::enableGlow(const Color4B& glowColor)
             _contentDirty = true;
         }
         _currLabelEffect = LabelEffect::GLOW;
+        _drawsOutsideContentSize = true;
         _effectColorF.r = glowColor.r / 255.0f;
         _effectColorF.g = glowColor.g / 255.0f;
         _effectColorF.b = glowColor.b / 255.0f;
@@ -1109,6 +1414,8 @@ void Label::enableOutline(const Color4B& outlineColor,int outlineSize /* = -1 */
             _contentDirty = true;
         }
         _outlineSize = outlineSize;
+        // the outline grows the glyphs past the content size
+        _drawsOutsideContentSize = true;
     }
 }
 
@@ -1118,6 +1425,8 @@ void Label::enableShadow(const Color4B& shadowColor /* = Color4B::BLACK */,
 {
     _shadowEnabled = true;
     _shadowDirty = true;
+    // the shadow offset moves it out of the content size
+    _drawsOutsideContentSize = true;
 
     _shadowOffset.width = offset.width;
     _shadowOffset.height = offset.height;
@@ -1154,11 +1463,6 @@ void Label::enableShadow(const Color4B& shadowColor /* = Color4B::BLACK */,
     _shadowColor4F.g = shadowColor.g / 255.0f;
     _shadowColor4F.b = shadowColor.b / 255.0f;
     _shadowColor4F.a = shadowColor.a / 255.0f;
-
-    if (_currentLabelType == LabelType::BMFONT || _currentLabelType == LabelType::CHARMAP)
-    {
-        setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(_shadowEnabled ? GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR : GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP, _getTexture(this)));
-    }
 }
 
 void Label::enableItalics()
@@ -1387,12 +1691,13 @@ void Label::setFontDefinition(const FontDefinition& textDefinition)
 
 void Label::updateContent()
 {
+    markDamaged();
+
     if (_systemFontDirty)
     {
         if (_fontAtlas)
         {
             _batchNodes.clear();
-            CC_SAFE_RELEASE_NULL(_reusedLetter);
             FontAtlasCache::releaseFontAtlas(_fontAtlas);
             _fontAtlas = nullptr;
         }
@@ -1412,7 +1717,6 @@ void Label::updateContent()
             _utf32Text = utf32String;
         }
 
-        computeHorizontalKernings(_utf32Text);
         updateFinished = alignText();
     }
     else
@@ -1494,51 +1798,83 @@ float Label::getBMFontSize()const
 
 void Label::onDrawShadow(GLProgram* glProgram, const Color4F& shadowColor)
 {
-    if (_currentLabelType == LabelType::TTF)
+    // only used by TTF labels, the shadow of BMFONT and CHARMAP labels is drawn by their QuadCommands
+    if (_currLabelEffect == LabelEffect::OUTLINE)
+    {
+        glProgram->setUniformLocationWith1i(_uniformEffectType, 2); // 2: shadow
+        glProgram->setUniformLocationWith4f(_uniformEffectColor, shadowColor.r, shadowColor.g, shadowColor.b, shadowColor.a);
+    }
+    else
     {
-        if (_currLabelEffect == LabelEffect::OUTLINE)
+        glProgram->setUniformLocationWith4f(_uniformTextColor, shadowColor.r, shadowColor.g, shadowColor.b, shadowColor.a);
+        if (_currLabelEffect == LabelEffect::GLOW)
         {
-            glProgram->setUniformLocationWith1i(_uniformEffectType, 2); // 2: shadow
             glProgram->setUniformLocationWith4f(_uniformEffectColor, shadowColor.r, shadowColor.g, shadowColor.b, shadowColor.a);
         }
-        else
-        {
-            glProgram->setUniformLocationWith4f(_uniformTextColor, shadowColor.r, shadowColor.g, shadowColor.b, shadowColor.a);
-            if (_currLabelEffect == LabelEffect::GLOW)
-            {
-                glProgram->setUniformLocationWith4f(_uniformEffectColor, shadowColor.r, shadowColor.g, shadowColor.b, shadowColor.a);
-            }
-        }
+    }
 
-        glProgram->setUniformsForBuiltins(_shadowTransform);
-        for (auto&& it : _letters)
-        {
-            it.second->updateTransform();
-        }
-        for (auto&& batchNode : _batchNodes)
-        {
-            batchNode->getTextureAtlas()->drawQuads();
-        }
+    glProgram->setUniformsForBuiltins(_shadowTransform);
+    for (auto&& it : _letters)
+    {
+        it.second->updateTransform();
     }
-    else
+    for (auto&& batchNode : _batchNodes)
+    {
+        batchNode->getTextureAtlas()->drawQuads();
+    }
+}
+
+void Label::updateShadowQuads()
+{
+    // the shadow is a copy of the quads of the text with the color of the shadow, moved by the offset
+    // of the shadow, followed by the quads of the text. The colors are the ones the letters had when
+    // the shadow was drawn with setColor() and a second draw call.
+    const Color4F& shadowColor = _boldEnabled ? _textColorF : _shadowColor4F;
+    Color3B parentColor = Color3B::WHITE;
+    if (_parent && _parent->isCascadeColorEnabled())
+    {
+        parentColor = _parent->getDisplayedColor();
+    }
+    GLubyte opacity = shadowColor.a * _displayedOpacity;
+    Color4B color4(shadowColor.r * parentColor.r, shadowColor.g * parentColor.g, shadowColor.b * parentColor.b, opacity);
+    if (_isOpacityModifyRGB)
+    {
+        color4.r *= opacity/255.0f;
+        color4.g *= opacity/255.0f;
+        color4.b *= opacity/255.0f;
+    }
+
+    ssize_t totalQuads = 0;
+    for (auto&& batchNode : _batchNodes)
+    {
+        totalQuads += batchNode->getTextureAtlas()->getTotalQuads();
+    }
+    _shadowQuads.resize(totalQuads * 2);
+
+    auto shadowQuad = _shadowQuads.data();
+    for (auto&& batchNode : _batchNodes)
     {
-        Color3B oldColor = _realColor;
-        GLubyte oldOPacity = _displayedOpacity;
-        _displayedOpacity = shadowColor.a * (oldOPacity / 255.0f) * 255;
-        setColor(Color3B(shadowColor));
+        auto textureAtlas = batchNode->getTextureAtlas();
+        auto quads = textureAtlas->getQuads();
+        auto count = textureAtlas->getTotalQuads();
 
-        glProgram->setUniformsForBuiltins(_shadowTransform);
-        for (auto&& it : _letters)
+        for (ssize_t index = 0; index < count; ++index, ++shadowQuad)
         {
-            it.second->updateTransform();
+            *shadowQuad = quads[index];
+            shadowQuad->bl.vertices += _shadowOffsetInNode;
+            shadowQuad->br.vertices += _shadowOffsetInNode;
+            shadowQuad->tl.vertices += _shadowOffsetInNode;
+            shadowQuad->tr.vertices += _shadowOffsetInNode;
+            shadowQuad->bl.colors = color4;
+            shadowQuad->br.colors = color4;
+            shadowQuad->tl.colors = color4;
+            shadowQuad->tr.colors = color4;
         }
-        for (auto&& batchNode : _batchNodes)
+        if (count > 0)
         {
-            batchNode->getTextureAtlas()->drawQuads();
+            memcpy(shadowQuad, quads, sizeof(V3F_C4B_T2F_Quad) * count);
+            shadowQuad += count;
         }
-
-        _displayedOpacity = oldOPacity;
-        setColor(oldColor);
     }
 }
 
@@ -1619,18 +1955,51 @@ void Label::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
     if (_insideBounds)
 #endif
     {
-        if (!_shadowEnabled && (_currentLabelType == LabelType::BMFONT || _currentLabelType == LabelType::CHARMAP))
+        if (_currentLabelType == LabelType::BMFONT || _currentLabelType == LabelType::CHARMAP)
         {
             for (auto&& it : _letters)
             {
                 it.second->updateTransform();
             }
-            // ETC1 ALPHA supports for BMFONT & CHARMAP
-            auto textureAtlas = _batchNodes.at(0)->getTextureAtlas();
-            auto texture = textureAtlas->getTexture();
-            _quadCommand.init(_globalZOrder, texture, getGLProgramState(), 
-                _blendFunc, textureAtlas->getQuads(), textureAtlas->getTotalQuads(), transform, flags);
-            renderer->addCommand(&_quadCommand);
+            if (_shadowEnabled)
+            {
+                updateShadowQuads();
+            }
+
+            // One QuadCommand per page of the font, the shadow being drawn by the same command as the text.
+            // All the BMFONT and CHARMAP labels share the same GLProgramState, so the labels of an atlas
+            // with the same blend function are batched, with or without shadow.
+            size_t page = 0;
+            V3F_C4B_T2F_Quad* shadowQuads = _shadowQuads.data();
+            for (auto&& batchNode : _batchNodes)
+            {
+                auto textureAtlas = batchNode->getTextureAtlas();
+                auto totalQuads = textureAtlas->getTotalQuads();
+                if (totalQuads == 0)
+                {
+                    continue;
+                }
+
+                if (page == _quadCommands.size())
+                {
+                    _quadCommands.emplace_back();
+                }
+                auto& quadCommand = _quadCommands[page++];
+                // ETC1 ALPHA supports for BMFONT & CHARMAP
+                auto texture = textureAtlas->getTexture();
+                if (_shadowEnabled)
+                {
+                    quadCommand.init(_globalZOrder, texture, getGLProgramState(),
+                        _blendFunc, shadowQuads, totalQuads * 2, transform, flags);
+                    shadowQuads += totalQuads * 2;
+                }
+                else
+                {
+                    quadCommand.init(_globalZOrder, texture, getGLProgramState(),
+                        _blendFunc, textureAtlas->getQuads(), totalQuads, transform, flags);
+                }
+                renderer->addCommand(&quadCommand);
+            }
         }
         else
         {
@@ -1668,6 +2037,10 @@ void Label::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t pare
         _position.y -= _shadowOffset.height;
         _transformDirty = _inverseDirty = true;
 
+        // the offset in the parent, in the space of the label
+        _shadowOffsetInNode.set(_shadowOffset.width, _shadowOffset.height, 0.0f);
+        getParentToNodeTransform().transformVector(&_shadowOffsetInNode);
+
         _shadowDirty = false;
     }
 
@@ -1993,13 +2366,8 @@ void Label::setTextColor(const Color4B &color)
     _textColorF.a = _textColor.a / 255.0f;
 }
 
-void Label::updateColor()
+Color4B Label::getQuadColor() const
 {
-    if (_batchNodes.empty())
-    {
-        return;
-    }
-
     Color4B color4( _displayedColor.r, _displayedColor.g, _displayedColor.b, _displayedOpacity );
 
     // special opacity for premultiplied textures
@@ -2010,6 +2378,18 @@ void Label::updateColor()
         color4.b *= _displayedOpacity/255.0f;
     }
 
+    return color4;
+}
+
+void Label::updateColor()
+{
+    if (_batchNodes.empty())
+    {
+        return;
+    }
+
+    Color4B color4 = getQuadColor();
+
     cocos2d::TextureAtlas* textureAtlas;
     V3F_C4B_T2F_Quad *quads;
     for (auto&& batchNode:_batchNodes)
@@ -2020,6 +2400,11 @@ void Label::updateColor()
 
         for (int index = 0; index < count; ++index)
         {
+            if (quads[index].bl.colors == color4 && quads[index].br.colors == color4 &&
+                quads[index].tl.colors == color4 && quads[index].tr.colors == color4)
+            {
+                continue;
+            }
             quads[index].bl.colors = color4;
             quads[index].br.colors = color4;
             quads[index].tl.colors = color4;
@@ -2217,23 +2602,18 @@ Label::Overflow Label::getOverflow()const
     return _overflow;
 }
 
-void Label::updateLetterSpriteScale(Sprite* sprite)
+float Label::getLetterScale() const
 {
     if (_currentLabelType == LabelType::BMFONT && _bmFontSize > 0)
     {
-        sprite->setScale(_bmfontScale);
-    }
-    else
-    {
-        if (std::abs(_bmFontSize) < FLT_EPSILON)
-        {
-            sprite->setScale(0);
-        }
-        else
-        {
-            sprite->setScale(1.0);
-        }
+        return _bmfontScale;
     }
+    return std::abs(_bmFontSize) < FLT_EPSILON ? 0.f : 1.f;
+}
+
+void Label::updateLetterSpriteScale(Sprite* sprite)
+{
+    sprite->setScale(getLetterScale());
 }
 
 NS_CC_END
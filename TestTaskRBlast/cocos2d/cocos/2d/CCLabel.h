@@ -27,6 +27,8 @@
 #ifndef _COCOS2D_CCLABEL_H_
 #define _COCOS2D_CCLABEL_H_
 
+#include <deque>
+
 #include "2d/CCNode.h"
 #include "renderer/CCCustomCommand.h"
 #include "renderer/CCQuadCommand.h"
@@ -340,6 +342,9 @@ public:
     /**
      * Enable shadow effect to Label.
      *
+     * The shadow of a BMFont or CharMap label is drawn with its text by one QuadCommand, so it doesn't
+     * break the batching of the labels sharing its texture and its blend function.
+     *
      * @todo Support blur for shadow effect.
      */
     virtual void enableShadow(const Color4B& shadowColor = Color4B::BLACK,const Size &offset = Size(2,-2), int blurRadius = 0);
@@ -527,6 +532,27 @@ public:
     /** Update content immediately.*/
     virtual void updateContent();
 
+    /**
+     * Sets how many text layouts are cached for the TTF, BMFont and CharMap labels.
+     *
+     * A label showing a text again with the same font, dimensions, alignment, overflow, line height and
+     * spacing reuses the cached line breaking and glyph positions, without kerning queries, e.g. a toggled
+     * caption or a recycled list cell. The layouts of the labels with Overflow::SHRINK are not cached.
+     *
+     * @param capacity Number of layouts shared by all the labels, 0 disables the cache. The default is 64.
+     * @since v3.17
+     */
+    static void setTextLayoutCacheCapacity(size_t capacity);
+    static size_t getTextLayoutCacheCapacity();
+
+    /** Removes all the cached text layouts. The counters are kept. @since v3.17 */
+    static void purgeTextLayoutCache();
+
+    /** Returns how many layouts were reused from the cache. @since v3.17 */
+    static unsigned int getTextLayoutCacheHits();
+    /** Returns how many layouts were computed while the cache was enabled. @since v3.17 */
+    static unsigned int getTextLayoutCacheMisses();
+
     /**
      * Provides a way to treat each character like a Sprite.
      * @warning No support system font.
@@ -655,6 +681,7 @@ protected:
 
     void onDraw(const Mat4& transform, bool transformUpdated);
     void onDrawShadow(GLProgram* glProgram, const Color4F& shadowColor);
+    void updateShadowQuads();
     void drawSelf(bool visibleByCamera, Renderer* renderer, uint32_t flags);
 
     bool multilineTextWrapByChar();
@@ -674,6 +701,9 @@ protected:
     void recordPlaceholderInfo(int letterIndex, char32_t utf16Char);
     
     bool updateQuads();
+    void setLetterQuad(V3F_C4B_T2F_Quad* quad, const Rect& rectInPoints, float x, float y, float scale,
+                       Texture2D* texture, const Color4B& color) const;
+    Color4B getQuadColor() const;
 
     void createSpriteForSystemFont(const FontDefinition& fontDef);
     void createShadowSpriteForSystemFont(const FontDefinition& fontDef);
@@ -685,6 +715,7 @@ protected:
     void setBMFontSizeInternal(float fontSize);
     bool isHorizontalClamped(float letterPositionX, int lineIndex);
     void restoreFontSize();
+    float getLetterScale() const;
     void updateLetterSpriteScale(Sprite* sprite);
     int getFirstCharLen(const std::u32string& utf32Text, int startIndex, int textLen) const;
     int getFirstWordLen(const std::u32string& utf32Text, int startIndex, int textLen) const;
@@ -715,9 +746,6 @@ protected:
     Vector<SpriteBatchNode*> _batchNodes;
     std::vector<LetterInfo> _lettersInfo;
 
-    //! used for optimization
-    Sprite *_reusedLetter;
-    Rect _reusedRect;
     int _lengthOfString;
 
     //layout relevant properties.
@@ -745,9 +773,12 @@ protected:
     Color4B _textColor;
     Color4F _textColorF;
 
-    QuadCommand _quadCommand;
+    std::deque<QuadCommand> _quadCommands;
     CustomCommand _customCommand;
     Mat4  _shadowTransform;
+    Vec3 _shadowOffsetInNode;
+    // the shadow quads followed by the text quads of each page, for BMFONT and CHARMAP labels
+    std::vector<V3F_C4B_T2F_Quad> _shadowQuads;
     GLint _uniformEffectColor;
     GLint _uniformEffectType; // 0: None, 1: Outline, 2: Shadow; Only used when outline is enabled.
     GLint _uniformTextColor;
@@ -776,6 +807,7 @@ protected:
 
     EventListenerCustom* _purgeTextureListener;
     EventListenerCustom* _resetTextureListener;
+    EventListenerCustom* _updateTextureListener;
 
 #if CC_LABEL_DEBUG_DRAW
     DrawNode* _debugDrawNode;
@@ -793,6 +825,8 @@ protected:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Label);
+
+    friend class TextLayoutCache;
 };
 
 // end group
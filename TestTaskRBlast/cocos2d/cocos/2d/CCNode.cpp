@@ -44,6 +44,7 @@ THE SOFTWARE.
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramState.h"
 #include "renderer/CCMaterial.h"
+#include "renderer/CCRenderer.h"
 #include "math/TransformUtils.h"
 
 
@@ -98,6 +99,10 @@ Node::Node()
 , _glProgramState(nullptr)
 , _running(false)
 , _visible(true)
+, _damaged(false)
+, _hasDamageRect(false)
+, _hasFullDamage(false)
+, _drawsOutsideContentSize(false)
 , _ignoreAnchorPointForPosition(false)
 , _reorderChildDirty(false)
 , _isTransitionFinished(false)
@@ -609,6 +614,8 @@ void Node::setVisible(bool visible)
         _visible = visible;
         if(_visible)
             _transformUpdated = _transformDirty = _inverseDirty = true;
+        else if (_director->getRenderer()->isPartialRedrawEnabled())
+            reportSubtreeDamage(_director->getRenderer());
     }
 }
 
@@ -1088,9 +1095,17 @@ void Node::removeAllChildren()
 
 void Node::removeAllChildrenWithCleanup(bool cleanup)
 {
+    auto renderer = _director->getRenderer();
+    const bool partialRedraw = renderer->isPartialRedrawEnabled();
+
     // not using detachChild improves speed here
     for (const auto& child : _children)
     {
+        if (partialRedraw)
+        {
+            child->reportSubtreeDamage(renderer);
+        }
+
         // IMPORTANT:
         //  -1st do onExit
         //  -2nd cleanup
@@ -1120,6 +1135,12 @@ void Node::removeAllChildrenWithCleanup(bool cleanup)
 
 void Node::detachChild(Node *child, ssize_t childIndex, bool doCleanup)
 {
+    auto renderer = _director->getRenderer();
+    if (renderer->isPartialRedrawEnabled())
+    {
+        child->reportSubtreeDamage(renderer);
+    }
+
     // IMPORTANT:
     //  -1st do onExit
     //  -2nd cleanup
@@ -1230,6 +1251,14 @@ uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFl
 
     if(flags & FLAGS_DIRTY_MASK)
         _modelViewTransform = this->transform(parentTransform);
+
+    if ((flags & FLAGS_DIRTY_MASK) || _damaged)
+    {
+        auto renderer = _director->getRenderer();
+        if (renderer->isPartialRedrawEnabled())
+            reportDamage(renderer);
+        _damaged = false;
+    }
     
     _transformUpdated = false;
     _contentSizeDirty = false;
@@ -1237,6 +1266,79 @@ uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFl
     return flags;
 }
 
+void Node::reportDamage(Renderer* renderer)
+{
+    if (_hasDamageRect)
+    {
+        renderer->addDamage(_lastDamageRect);
+    }
+
+    // Nodes without a size (containers) draw nothing themselves, unless they draw custom content.
+    // Once they did, or when they draw outside their size, every change damages the whole screen.
+    if (_drawsOutsideContentSize || _contentSize.width <= 0 || _contentSize.height <= 0)
+    {
+        if (_drawsOutsideContentSize || _damaged || _hasFullDamage)
+        {
+            renderer->addFullDamage();
+            _hasFullDamage = true;
+        }
+        _hasDamageRect = false;
+        return;
+    }
+    _hasFullDamage = false;
+
+    const Mat4 mvp = _director->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION) * _modelViewTransform;
+    const Vec4 corners[4] = {
+        Vec4(0, 0, 0, 1),
+        Vec4(_contentSize.width, 0, 0, 1),
+        Vec4(0, _contentSize.height, 0, 1),
+        Vec4(_contentSize.width, _contentSize.height, 0, 1),
+    };
+
+    float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+    for (const auto& corner : corners)
+    {
+        Vec4 clip;
+        mvp.transformVector(corner, &clip);
+        // Behind the camera, the projected bounds are unreliable
+        if (clip.w <= 0)
+        {
+            renderer->addFullDamage();
+            _hasDamageRect = false;
+            return;
+        }
+        const float x = clip.x / clip.w;
+        const float y = clip.y / clip.w;
+        minX = std::min(minX, x);
+        minY = std::min(minY, y);
+        maxX = std::max(maxX, x);
+        maxY = std::max(maxY, y);
+    }
+
+    _lastDamageRect.setRect(minX, minY, maxX - minX, maxY - minY);
+    _hasDamageRect = true;
+    renderer->addDamage(_lastDamageRect);
+}
+
+void Node::reportSubtreeDamage(Renderer* renderer)
+{
+    if (_hasDamageRect)
+    {
+        renderer->addDamage(_lastDamageRect);
+        _hasDamageRect = false;
+    }
+    if (_hasFullDamage)
+    {
+        renderer->addFullDamage();
+        _hasFullDamage = false;
+    }
+
+    for (const auto& child : _children)
+    {
+        child->reportSubtreeDamage(renderer);
+    }
+}
+
 bool Node::isVisitableByVisitingCamera() const
 {
     auto camera = Camera::getVisitingCamera();
@@ -2012,6 +2114,7 @@ void Node::setOpacity(GLubyte opacity)
 void Node::updateDisplayedOpacity(GLubyte parentOpacity)
 {
     _displayedOpacity = _realOpacity * parentOpacity/255.0;
+    _damaged = true;
     updateColor();
     
     if (_cascadeOpacityEnabled)
@@ -2099,6 +2202,7 @@ void Node::updateDisplayedColor(const Color3B& parentColor)
     _displayedColor.r = _realColor.r * parentColor.r/255.0;
     _displayedColor.g = _realColor.g * parentColor.g/255.0;
     _displayedColor.b = _realColor.b * parentColor.b/255.0;
+    _damaged = true;
     updateColor();
     
     if (_cascadeColorEnabled)
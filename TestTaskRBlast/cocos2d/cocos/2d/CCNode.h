@@ -186,6 +186,16 @@ public:
     */
     void updateOrderOfArrival();
 
+    /**
+     * Gets the key used to sort this node among its siblings: the local Z order
+     * in the high 32 bits and the order of arrival in the low 32 bits.
+     * A sibling with a smaller key is drawn earlier.
+     *
+     * @return The local Z order and arrival order of this node.
+     * @js NA
+     */
+    std::int64_t getLocalZOrderAndArrival() const { return _localZOrder$Arrival; }
+
     /**
      * Gets the local Z order of this node.
      *
@@ -582,6 +592,18 @@ public:
      */
     virtual bool isVisible() const;
 
+    /**
+     * Marks the area covered by the node as changed, so that it is redrawn in the next frame
+     * when partial redraw is enabled.
+     *
+     * Transform, visibility, color and opacity changes are tracked automatically. Call it when
+     * the node draws new content without any of these changing. Subclasses that draw outside their
+     * content size set `_drawsOutsideContentSize`, their changes then damage the whole screen.
+     *
+     * @see `Renderer::setPartialRedrawEnabled(bool)`
+     */
+    void markDamaged() { _damaged = true; }
+
 
     /**
      * Sets the rotation (angle) of the node in degrees.
@@ -1880,6 +1902,11 @@ protected:
     Mat4 transform(const Mat4 &parentTransform);
     uint32_t processParentFlags(const Mat4& parentTransform, uint32_t parentFlags);
 
+    /// Reports the old and the new screen area of the node to the renderer, used by partial redraw.
+    void reportDamage(Renderer* renderer);
+    /// Reports the last screen area of the node and its children, when they are hidden or removed.
+    void reportSubtreeDamage(Renderer* renderer);
+
     virtual void updateCascadeOpacity();
     virtual void disableCascadeOpacity();
     virtual void updateCascadeColor();
@@ -1986,6 +2013,12 @@ protected:
 
     bool _visible;                  ///< is this node visible
 
+    bool _damaged;                  ///< whether the content changed since the last frame, used by partial redraw
+    bool _hasDamageRect;            ///< whether _lastDamageRect holds the area drawn in the last frame
+    bool _hasFullDamage;            ///< whether the last frame drew content whose screen area is unknown
+    bool _drawsOutsideContentSize;  ///< whether the node draws outside its content size, partial redraw then damages the whole screen
+    Rect _lastDamageRect;           ///< screen area of the last frame in normalized device coordinates
+
     bool _ignoreAnchorPointForPosition; ///< true if the Anchor Vec2 will be (0,0) when you position the Node, false otherwise.
                                           ///< Used by Layer and Scene.
 
@@ -0,0 +1,673 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/CCParticleKernels.h"
+
+#include <atomic>
+#include <math.h>
+
+#include "2d/CCParticleSystem.h"
+#include "base/ccMacros.h"
+#include "base/ccTypes.h"
+
+//#define INCLUDE_SSE2    : SSE2 code included
+//#define INCLUDE_NEON    : NEON code included
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define INCLUDE_SSE2
+    #include <emmintrin.h>
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__)
+    #define INCLUDE_NEON
+    #include <arm_neon.h>
+#endif
+
+NS_CC_BEGIN
+
+namespace ParticleKernels {
+
+namespace {
+
+typedef void (*RandomFillKernel)(float* out, int count, float base, float variance, float minValue, float maxValue, bool clamp, uint32_t* seed);
+typedef void (*GravityKernel)(ParticleData& data, int count, float dt, float gravityX, float gravityY, float yCoordFlipped);
+typedef void (*RadiusKernel)(ParticleData& data, int count, float dt, float yCoordFlipped);
+typedef void (*ColorSizeRotationKernel)(ParticleData& data, int count, float dt);
+typedef void (*QuadsKernel)(V3F_C4B_T2F_Quad* quads, const ParticleData& data, int count, const QuadOrigin& origin, bool opacityModifyRGB);
+
+struct Kernels
+{
+    const char* name;
+    RandomFillKernel randomFill;
+    GravityKernel updateGravity;
+    RadiusKernel updateRadius;
+    ColorSizeRotationKernel updateColorSizeRotation;
+    QuadsKernel updateQuads;
+};
+
+// the generator of RANDOM_M11 in CCParticleSystem.cpp
+const uint32_t RANDOM_MUL = 134775813;
+// four steps at once: s[n + 4] = s[n] * A^4 + (1 + A + A^2 + A^3)
+const uint32_t RANDOM_MUL4 = (RANDOM_MUL * RANDOM_MUL) * (RANDOM_MUL * RANDOM_MUL);
+const uint32_t RANDOM_INC4 = (RANDOM_MUL + 1) * (RANDOM_MUL * RANDOM_MUL + 1);
+
+inline uint32_t nextSeed(uint32_t seed)
+{
+    return seed * RANDOM_MUL + 1;
+}
+
+inline float seedToM11(uint32_t seed)
+{
+    union {
+        uint32_t d;
+        float f;
+    } u;
+    u.d = ((seed & 0x7fff) << 8) | 0x40000000;
+    return u.f - 3.0f;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// plain C, the reference for the SIMD implementations.
+// The *Range versions also handle the particles left over by the SIMD loops.
+
+void randomFill_C(float* out, int count, float base, float variance, float minValue, float maxValue, bool clamp, uint32_t* seed)
+{
+    uint32_t s = *seed;
+    for (int i = 0; i < count; ++i)
+    {
+        s = nextSeed(s);
+        float value = base + variance * seedToM11(s);
+        out[i] = clamp ? clampf(value, minValue, maxValue) : value;
+    }
+    *seed = s;
+}
+
+void updateGravityRange(ParticleData& data, int start, int count, float dt, float gravityX, float gravityY, float yCoordFlipped)
+{
+    for (int i = start; i < count; ++i)
+    {
+        float radialX = 0.0f;
+        float radialY = 0.0f;
+
+        // radial acceleration, see normalize_point in CCParticleSystem.cpp
+        float x = data.posx[i];
+        float y = data.posy[i];
+        if (x || y)
+        {
+            float n = x * x + y * y;
+            if (n != 1.0f)
+            {
+                n = sqrtf(n);
+                if (!(n < MATH_TOLERANCE))
+                {
+                    n = 1.0f / n;
+                    radialX = x * n;
+                    radialY = y * n;
+                }
+            }
+        }
+
+        // (gravity + radial + tangential) * dt
+        float tmpX = radialX * data.modeA.radialAccel[i] + radialY * -data.modeA.tangentialAccel[i] + gravityX;
+        float tmpY = radialY * data.modeA.radialAccel[i] + radialX * data.modeA.tangentialAccel[i] + gravityY;
+        data.modeA.dirX[i] += tmpX * dt;
+        data.modeA.dirY[i] += tmpY * dt;
+
+        data.posx[i] += data.modeA.dirX[i] * dt * yCoordFlipped;
+        data.posy[i] += data.modeA.dirY[i] * dt * yCoordFlipped;
+    }
+}
+
+void updateRadiusRange(ParticleData& data, int start, int count, float dt, float yCoordFlipped)
+{
+    for (int i = start; i < count; ++i)
+    {
+        data.modeB.angle[i] += data.modeB.degreesPerSecond[i] * dt;
+        data.modeB.radius[i] += data.modeB.deltaRadius[i] * dt;
+        data.posx[i] = - cosf(data.modeB.angle[i]) * data.modeB.radius[i];
+        data.posy[i] = - sinf(data.modeB.angle[i]) * data.modeB.radius[i] * yCoordFlipped;
+    }
+}
+
+void updateColorSizeRotationRange(ParticleData& data, int start, int count, float dt)
+{
+    for (int i = start; i < count; ++i)
+    {
+        data.colorR[i] += data.deltaColorR[i] * dt;
+        data.colorG[i] += data.deltaColorG[i] * dt;
+        data.colorB[i] += data.deltaColorB[i] * dt;
+        data.colorA[i] += data.deltaColorA[i] * dt;
+
+        data.size[i] += (data.deltaSize[i] * dt);
+        data.size[i] = MAX(0, data.size[i]);
+
+        data.rotation[i] += data.deltaRotation[i] * dt;
+    }
+}
+
+void updateQuadsRange(V3F_C4B_T2F_Quad* quads, const ParticleData& data, int start, int count, const QuadOrigin& origin, bool opacityModifyRGB)
+{
+    for (int i = start; i < count; ++i)
+    {
+        V3F_C4B_T2F_Quad* quad = quads + i;
+
+        // vertices, same as updatePosWithParticle used to do
+        GLfloat x = data.posx[i] + origin.m00 * data.startPosX[i] + origin.m01 * data.startPosY[i] + origin.tx;
+        GLfloat y = data.posy[i] + origin.m10 * data.startPosX[i] + origin.m11 * data.startPosY[i] + origin.ty;
+
+        GLfloat size_2 = data.size[i] * 0.5f;
+        GLfloat x1 = -size_2;
+        GLfloat y1 = -size_2;
+        GLfloat x2 = size_2;
+        GLfloat y2 = size_2;
+
+        GLfloat r = -CC_DEGREES_TO_RADIANS(data.rotation[i]);
+        GLfloat cr = cosf(r);
+        GLfloat sr = sinf(r);
+
+        quad->bl.vertices.x = x1 * cr - y1 * sr + x;
+        quad->bl.vertices.y = x1 * sr + y1 * cr + y;
+        quad->br.vertices.x = x2 * cr - y1 * sr + x;
+        quad->br.vertices.y = x2 * sr + y1 * cr + y;
+        quad->tr.vertices.x = x2 * cr - y2 * sr + x;
+        quad->tr.vertices.y = x2 * sr + y2 * cr + y;
+        quad->tl.vertices.x = x1 * cr - y2 * sr + x;
+        quad->tl.vertices.y = x1 * sr + y2 * cr + y;
+
+        // colors, truncated like the float to GLubyte conversion on x86
+        float alpha = opacityModifyRGB ? data.colorA[i] : 1.0f;
+        Color4B color((GLubyte)(int)(data.colorR[i] * alpha * 255),
+                      (GLubyte)(int)(data.colorG[i] * alpha * 255),
+                      (GLubyte)(int)(data.colorB[i] * alpha * 255),
+                      (GLubyte)(int)(data.colorA[i] * 255));
+        quad->bl.colors = color;
+        quad->br.colors = color;
+        quad->tl.colors = color;
+        quad->tr.colors = color;
+    }
+}
+
+void updateGravity_C(ParticleData& data, int count, float dt, float gravityX, float gravityY, float yCoordFlipped)
+{
+    updateGravityRange(data, 0, count, dt, gravityX, gravityY, yCoordFlipped);
+}
+
+void updateRadius_C(ParticleData& data, int count, float dt, float yCoordFlipped)
+{
+    updateRadiusRange(data, 0, count, dt, yCoordFlipped);
+}
+
+void updateColorSizeRotation_C(ParticleData& data, int count, float dt)
+{
+    updateColorSizeRotationRange(data, 0, count, dt);
+}
+
+void updateQuads_C(V3F_C4B_T2F_Quad* quads, const ParticleData& data, int count, const QuadOrigin& origin, bool opacityModifyRGB)
+{
+    updateQuadsRange(quads, data, 0, count, origin, opacityModifyRGB);
+}
+
+const Kernels s_kernelsC = {
+    "C",
+    randomFill_C,
+    updateGravity_C,
+    updateRadius_C,
+    updateColorSizeRotation_C,
+    updateQuads_C,
+};
+
+#if defined (INCLUDE_SSE2) || defined (INCLUDE_NEON)
+
+//////////////////////////////////////////////////////////////////////////
+// 4 wide helpers, the kernels below are written once against them
+
+#if defined (INCLUDE_SSE2)
+
+typedef __m128 float4;
+typedef __m128i int4;
+
+inline float4 load4(const float* p) { return _mm_loadu_ps(p); }
+inline void store4(float* p, float4 v) { _mm_storeu_ps(p, v); }
+inline float4 splat4(float f) { return _mm_set1_ps(f); }
+inline float4 add4(float4 a, float4 b) { return _mm_add_ps(a, b); }
+inline float4 sub4(float4 a, float4 b) { return _mm_sub_ps(a, b); }
+inline float4 mul4(float4 a, float4 b) { return _mm_mul_ps(a, b); }
+inline float4 div4(float4 a, float4 b) { return _mm_div_ps(a, b); }
+inline float4 sqrt4(float4 a) { return _mm_sqrt_ps(a); }
+inline float4 min4(float4 a, float4 b) { return _mm_min_ps(a, b); }
+inline float4 max4(float4 a, float4 b) { return _mm_max_ps(a, b); }
+inline float4 and4(float4 a, float4 b) { return _mm_and_ps(a, b); }
+inline float4 andnot4(float4 a, float4 b) { return _mm_andnot_ps(a, b); } // ~a & b
+inline float4 or4(float4 a, float4 b) { return _mm_or_ps(a, b); }
+inline float4 xor4(float4 a, float4 b) { return _mm_xor_ps(a, b); }
+inline float4 cmpeq4(float4 a, float4 b) { return _mm_cmpeq_ps(a, b); }
+inline float4 cmpneq4(float4 a, float4 b) { return _mm_cmpneq_ps(a, b); }
+inline float4 cmplt4(float4 a, float4 b) { return _mm_cmplt_ps(a, b); }
+
+inline int4 loadInt4(const uint32_t* p) { return _mm_loadu_si128((const __m128i*)p); }
+inline void storeInt4(uint32_t* p, int4 v) { _mm_storeu_si128((__m128i*)p, v); }
+inline int4 splatInt4(uint32_t i) { return _mm_set1_epi32((int)i); }
+inline int4 addInt4(int4 a, int4 b) { return _mm_add_epi32(a, b); }
+inline int4 subInt4(int4 a, int4 b) { return _mm_sub_epi32(a, b); }
+inline int4 andInt4(int4 a, int4 b) { return _mm_and_si128(a, b); }
+inline int4 andnotInt4(int4 a, int4 b) { return _mm_andnot_si128(a, b); } // ~a & b
+inline int4 orInt4(int4 a, int4 b) { return _mm_or_si128(a, b); }
+inline int4 cmpeqInt4(int4 a, int4 b) { return _mm_cmpeq_epi32(a, b); }
+template <int N> inline int4 shiftLeftInt4(int4 a) { return _mm_slli_epi32(a, N); }
+
+// SSE2 has no 32 bit multiply, use the even/odd 32x32->64 products
+inline int4 mulInt4(int4 a, int4 b)
+{
+    int4 even = _mm_mul_epu32(a, b);
+    int4 odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+inline int4 truncateToInt4(float4 a) { return _mm_cvttps_epi32(a); }
+inline float4 toFloat4(int4 a) { return _mm_cvtepi32_ps(a); }
+inline float4 asFloat4(int4 a) { return _mm_castsi128_ps(a); }
+
+const char* const SIMD_NAME = "SSE2";
+
+#else // INCLUDE_NEON
+
+typedef float32x4_t float4;
+typedef uint32x4_t int4;
+
+inline float4 load4(const float* p) { return vld1q_f32(p); }
+inline void store4(float* p, float4 v) { vst1q_f32(p, v); }
+inline float4 splat4(float f) { return vdupq_n_f32(f); }
+inline float4 add4(float4 a, float4 b) { return vaddq_f32(a, b); }
+inline float4 sub4(float4 a, float4 b) { return vsubq_f32(a, b); }
+inline float4 mul4(float4 a, float4 b) { return vmulq_f32(a, b); }
+#if defined (__aarch64__)
+inline float4 div4(float4 a, float4 b) { return vdivq_f32(a, b); }
+inline float4 sqrt4(float4 a) { return vsqrtq_f32(a); }
+#else
+// ARMv7 NEON has no divide nor square root, do them per lane to keep the results of the C version
+inline float4 div4(float4 a, float4 b)
+{
+    float va[4], vb[4];
+    vst1q_f32(va, a);
+    vst1q_f32(vb, b);
+    for (int i = 0; i < 4; ++i)
+        va[i] /= vb[i];
+    return vld1q_f32(va);
+}
+inline float4 sqrt4(float4 a)
+{
+    float va[4];
+    vst1q_f32(va, a);
+    for (int i = 0; i < 4; ++i)
+        va[i] = sqrtf(va[i]);
+    return vld1q_f32(va);
+}
+#endif
+inline float4 min4(float4 a, float4 b) { return vminq_f32(a, b); }
+inline float4 max4(float4 a, float4 b) { return vmaxq_f32(a, b); }
+inline float4 and4(float4 a, float4 b) { return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+inline float4 andnot4(float4 a, float4 b) { return vreinterpretq_f32_u32(vbicq_u32(vreinterpretq_u32_f32(b), vreinterpretq_u32_f32(a))); } // ~a & b
+inline float4 or4(float4 a, float4 b) { return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+inline float4 xor4(float4 a, float4 b) { return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+inline float4 cmpeq4(float4 a, float4 b) { return vreinterpretq_f32_u32(vceqq_f32(a, b)); }
+inline float4 cmpneq4(float4 a, float4 b) { return vreinterpretq_f32_u32(vmvnq_u32(vceqq_f32(a, b))); }
+inline float4 cmplt4(float4 a, float4 b) { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+
+inline int4 loadInt4(const uint32_t* p) { return vld1q_u32(p); }
+inline void storeInt4(uint32_t* p, int4 v) { vst1q_u32(p, v); }
+inline int4 splatInt4(uint32_t i) { return vdupq_n_u32(i); }
+inline int4 addInt4(int4 a, int4 b) { return vaddq_u32(a, b); }
+inline int4 subInt4(int4 a, int4 b) { return vsubq_u32(a, b); }
+inline int4 andInt4(int4 a, int4 b) { return vandq_u32(a, b); }
+inline int4 andnotInt4(int4 a, int4 b) { return vbicq_u32(b, a); } // ~a & b
+inline int4 orInt4(int4 a, int4 b) { return vorrq_u32(a, b); }
+inline int4 cmpeqInt4(int4 a, int4 b) { return vceqq_u32(a, b); }
+template <int N> inline int4 shiftLeftInt4(int4 a) { return vshlq_n_u32(a, N); }
+inline int4 mulInt4(int4 a, int4 b) { return vmulq_u32(a, b); }
+
+inline int4 truncateToInt4(float4 a) { return vreinterpretq_u32_s32(vcvtq_s32_f32(a)); }
+inline float4 toFloat4(int4 a) { return vcvtq_f32_s32(vreinterpretq_s32_u32(a)); }
+inline float4 asFloat4(int4 a) { return vreinterpretq_f32_u32(a); }
+
+const char* const SIMD_NAME = "NEON";
+
+#endif // INCLUDE_SSE2
+
+inline float4 neg4(float4 a) { return xor4(a, splat4(-0.0f)); }
+
+// sin and cos of 4 angles in radians, with the single precision polynomials of Cephes sinf/cosf
+inline void sincos4(float4 x, float4* outSin, float4* outCos)
+{
+    const float4 signMask = splat4(-0.0f);
+    float4 signSin = and4(x, signMask);
+    x = andnot4(signMask, x);
+
+    // octant, rounded up to even: j = (int)(|x| * 4 / PI + 1) & ~1
+    int4 j = truncateToInt4(mul4(x, splat4(1.27323954473516f)));
+    j = andInt4(addInt4(j, splatInt4(1)), splatInt4(~1u));
+    float4 y = toFloat4(j);
+
+    signSin = xor4(signSin, asFloat4(shiftLeftInt4<29>(andInt4(j, splatInt4(4)))));
+    float4 signCos = asFloat4(shiftLeftInt4<29>(andnotInt4(subInt4(j, splatInt4(2)), splatInt4(4))));
+    float4 sinPolyMask = asFloat4(cmpeqInt4(andInt4(j, splatInt4(2)), splatInt4(0)));
+
+    // extended precision modular arithmetic
+    x = sub4(x, mul4(y, splat4(0.78515625f)));
+    x = sub4(x, mul4(y, splat4(2.4187564849853515625e-4f)));
+    x = sub4(x, mul4(y, splat4(3.77489497744594108e-8f)));
+
+    float4 z = mul4(x, x);
+
+    float4 c = splat4(2.443315711809948e-5f);
+    c = add4(mul4(c, z), splat4(-1.388731625493765e-3f));
+    c = add4(mul4(c, z), splat4(4.166664568298827e-2f));
+    c = mul4(mul4(c, z), z);
+    c = sub4(c, mul4(z, splat4(0.5f)));
+    c = add4(c, splat4(1.0f));
+
+    float4 s = splat4(-1.9515295891e-4f);
+    s = add4(mul4(s, z), splat4(8.3321608736e-3f));
+    s = add4(mul4(s, z), splat4(-1.6666654611e-1f));
+    s = mul4(mul4(s, z), x);
+    s = add4(s, x);
+
+    float4 sinValue = or4(and4(sinPolyMask, s), andnot4(sinPolyMask, c));
+    float4 cosValue = or4(and4(sinPolyMask, c), andnot4(sinPolyMask, s));
+    *outSin = xor4(sinValue, signSin);
+    *outCos = xor4(cosValue, signCos);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SIMD kernels
+
+void randomFill_SIMD(float* out, int count, float base, float variance, float minValue, float maxValue, bool clamp, uint32_t* seed)
+{
+    int i = 0;
+    if (count >= 4)
+    {
+        // lane k produces the values k, k + 4, k + 8... of the scalar sequence
+        uint32_t lanes[4];
+        uint32_t s = *seed;
+        for (int k = 0; k < 4; ++k)
+        {
+            s = nextSeed(s);
+            lanes[k] = s;
+        }
+
+        int4 state = loadInt4(lanes);
+        int4 last = state;
+        const int4 mul = splatInt4(RANDOM_MUL4);
+        const int4 inc = splatInt4(RANDOM_INC4);
+        const int4 mantissaMask = splatInt4(0x7fff);
+        const int4 exponent = splatInt4(0x40000000);
+        const float4 three = splat4(3.0f);
+        const float4 vbase = splat4(base);
+        const float4 vvariance = splat4(variance);
+        const float4 vmin = splat4(minValue);
+        const float4 vmax = splat4(maxValue);
+
+        for (; i + 4 <= count; i += 4)
+        {
+            float4 random = sub4(asFloat4(orInt4(shiftLeftInt4<8>(andInt4(state, mantissaMask)), exponent)), three);
+            float4 value = add4(vbase, mul4(vvariance, random));
+            if (clamp)
+                value = min4(max4(value, vmin), vmax);
+            store4(out + i, value);
+
+            last = state;
+            state = addInt4(mulInt4(state, mul), inc);
+        }
+
+        storeInt4(lanes, last);
+        *seed = lanes[3];
+    }
+    randomFill_C(out + i, count - i, base, variance, minValue, maxValue, clamp, seed);
+}
+
+void updateGravity_SIMD(ParticleData& data, int count, float dt, float gravityX, float gravityY, float yCoordFlipped)
+{
+    const float4 vdt = splat4(dt);
+    const float4 vgravityX = splat4(gravityX);
+    const float4 vgravityY = splat4(gravityY);
+    const float4 vflipped = splat4(yCoordFlipped);
+    const float4 zero = splat4(0.0f);
+    const float4 one = splat4(1.0f);
+    const float4 tolerance = splat4(MATH_TOLERANCE);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        float4 x = load4(data.posx + i);
+        float4 y = load4(data.posy + i);
+
+        // normalize_point leaves the direction at zero for the origin, tiny and already normalized vectors
+        float4 n = add4(mul4(x, x), mul4(y, y));
+        float4 length = sqrt4(n);
+        float4 inverse = div4(one, length);
+        float4 valid = andnot4(or4(cmpeq4(n, one), cmplt4(length, tolerance)), or4(cmpneq4(x, zero), cmpneq4(y, zero)));
+        float4 radialX = and4(valid, mul4(x, inverse));
+        float4 radialY = and4(valid, mul4(y, inverse));
+
+        float4 radialAccel = load4(data.modeA.radialAccel + i);
+        float4 tangentialAccel = load4(data.modeA.tangentialAccel + i);
+        float4 tmpX = add4(add4(mul4(radialX, radialAccel), mul4(radialY, neg4(tangentialAccel))), vgravityX);
+        float4 tmpY = add4(add4(mul4(radialY, radialAccel), mul4(radialX, tangentialAccel)), vgravityY);
+
+        float4 dirX = add4(load4(data.modeA.dirX + i), mul4(tmpX, vdt));
+        float4 dirY = add4(load4(data.modeA.dirY + i), mul4(tmpY, vdt));
+        store4(data.modeA.dirX + i, dirX);
+        store4(data.modeA.dirY + i, dirY);
+
+        store4(data.posx + i, add4(x, mul4(mul4(dirX, vdt), vflipped)));
+        store4(data.posy + i, add4(y, mul4(mul4(dirY, vdt), vflipped)));
+    }
+    updateGravityRange(data, i, count, dt, gravityX, gravityY, yCoordFlipped);
+}
+
+void updateRadius_SIMD(ParticleData& data, int count, float dt, float yCoordFlipped)
+{
+    const float4 vdt = splat4(dt);
+    const float4 vflipped = splat4(yCoordFlipped);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        float4 angle = add4(load4(data.modeB.angle + i), mul4(load4(data.modeB.degreesPerSecond + i), vdt));
+        float4 radius = add4(load4(data.modeB.radius + i), mul4(load4(data.modeB.deltaRadius + i), vdt));
+        store4(data.modeB.angle + i, angle);
+        store4(data.modeB.radius + i, radius);
+
+        float4 sinAngle, cosAngle;
+        sincos4(angle, &sinAngle, &cosAngle);
+        store4(data.posx + i, mul4(neg4(cosAngle), radius));
+        store4(data.posy + i, mul4(mul4(neg4(sinAngle), radius), vflipped));
+    }
+    updateRadiusRange(data, i, count, dt, yCoordFlipped);
+}
+
+void updateColorSizeRotation_SIMD(ParticleData& data, int count, float dt)
+{
+    const float4 vdt = splat4(dt);
+    const float4 zero = splat4(0.0f);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        store4(data.colorR + i, add4(load4(data.colorR + i), mul4(load4(data.deltaColorR + i), vdt)));
+        store4(data.colorG + i, add4(load4(data.colorG + i), mul4(load4(data.deltaColorG + i), vdt)));
+        store4(data.colorB + i, add4(load4(data.colorB + i), mul4(load4(data.deltaColorB + i), vdt)));
+        store4(data.colorA + i, add4(load4(data.colorA + i), mul4(load4(data.deltaColorA + i), vdt)));
+
+        float4 size = add4(load4(data.size + i), mul4(load4(data.deltaSize + i), vdt));
+        store4(data.size + i, max4(size, zero));
+
+        store4(data.rotation + i, add4(load4(data.rotation + i), mul4(load4(data.deltaRotation + i), vdt)));
+    }
+    updateColorSizeRotationRange(data, i, count, dt);
+}
+
+void updateQuads_SIMD(V3F_C4B_T2F_Quad* quads, const ParticleData& data, int count, const QuadOrigin& origin, bool opacityModifyRGB)
+{
+    const float4 m00 = splat4(origin.m00);
+    const float4 m01 = splat4(origin.m01);
+    const float4 m10 = splat4(origin.m10);
+    const float4 m11 = splat4(origin.m11);
+    const float4 tx = splat4(origin.tx);
+    const float4 ty = splat4(origin.ty);
+    const float4 half = splat4(0.5f);
+    const float4 degreesToRadians = splat4(0.01745329252f);
+    const float4 scale = splat4(255.0f);
+    const int4 byteMask = splatInt4(0xFF);
+
+    float corners[8][4];
+    uint32_t colors[4];
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        float4 startX = load4(data.startPosX + i);
+        float4 startY = load4(data.startPosY + i);
+        float4 x = add4(add4(add4(load4(data.posx + i), mul4(m00, startX)), mul4(m01, startY)), tx);
+        float4 y = add4(add4(add4(load4(data.posy + i), mul4(m10, startX)), mul4(m11, startY)), ty);
+
+        float4 x2 = mul4(load4(data.size + i), half);
+        float4 x1 = neg4(x2);
+        float4 sr, cr;
+        sincos4(neg4(mul4(load4(data.rotation + i), degreesToRadians)), &sr, &cr);
+
+        float4 x1cr = mul4(x1, cr);
+        float4 x1sr = mul4(x1, sr);
+        float4 x2cr = mul4(x2, cr);
+        float4 x2sr = mul4(x2, sr);
+        // y1 == x1 and y2 == x2
+        store4(corners[0], add4(sub4(x1cr, x1sr), x));  // bl
+        store4(corners[1], add4(add4(x1sr, x1cr), y));
+        store4(corners[2], add4(sub4(x2cr, x1sr), x));  // br
+        store4(corners[3], add4(add4(x2sr, x1cr), y));
+        store4(corners[4], add4(sub4(x2cr, x2sr), x));  // tr
+        store4(corners[5], add4(add4(x2sr, x2cr), y));
+        store4(corners[6], add4(sub4(x1cr, x2sr), x));  // tl
+        store4(corners[7], add4(add4(x1sr, x2cr), y));
+
+        float4 a = load4(data.colorA + i);
+        float4 alpha = opacityModifyRGB ? a : splat4(1.0f);
+        int4 r = andInt4(truncateToInt4(mul4(mul4(load4(data.colorR + i), alpha), scale)), byteMask);
+        int4 g = andInt4(truncateToInt4(mul4(mul4(load4(data.colorG + i), alpha), scale)), byteMask);
+        int4 b = andInt4(truncateToInt4(mul4(mul4(load4(data.colorB + i), alpha), scale)), byteMask);
+        int4 aa = andInt4(truncateToInt4(mul4(a, scale)), byteMask);
+        storeInt4(colors, orInt4(orInt4(r, shiftLeftInt4<8>(g)), orInt4(shiftLeftInt4<16>(b), shiftLeftInt4<24>(aa))));
+
+        for (int k = 0; k < 4; ++k)
+        {
+            V3F_C4B_T2F_Quad* quad = quads + i + k;
+            quad->bl.vertices.x = corners[0][k];
+            quad->bl.vertices.y = corners[1][k];
+            quad->br.vertices.x = corners[2][k];
+            quad->br.vertices.y = corners[3][k];
+            quad->tr.vertices.x = corners[4][k];
+            quad->tr.vertices.y = corners[5][k];
+            quad->tl.vertices.x = corners[6][k];
+            quad->tl.vertices.y = corners[7][k];
+
+            Color4B color(colors[k] & 0xff, (colors[k] >> 8) & 0xff, (colors[k] >> 16) & 0xff, colors[k] >> 24);
+            quad->bl.colors = color;
+            quad->br.colors = color;
+            quad->tl.colors = color;
+            quad->tr.colors = color;
+        }
+    }
+    updateQuadsRange(quads, data, i, count, origin, opacityModifyRGB);
+}
+
+const Kernels s_kernelsSIMD = {
+    SIMD_NAME,
+    randomFill_SIMD,
+    updateGravity_SIMD,
+    updateRadius_SIMD,
+    updateColorSizeRotation_SIMD,
+    updateQuads_SIMD,
+};
+
+#endif // INCLUDE_SSE2 || INCLUDE_NEON
+
+const Kernels* getSIMDKernels()
+{
+#if defined (INCLUDE_SSE2) || defined (INCLUDE_NEON)
+    return &s_kernelsSIMD;
+#else
+    return &s_kernelsC;
+#endif
+}
+
+std::atomic<bool> s_simdEnabled(true);
+
+inline const Kernels* getKernels()
+{
+    return s_simdEnabled.load(std::memory_order_relaxed) ? getSIMDKernels() : &s_kernelsC;
+}
+
+} // namespace
+
+void setSIMDEnabled(bool enabled)
+{
+    s_simdEnabled = enabled;
+}
+
+const char* getSIMDName()
+{
+    return getKernels()->name;
+}
+
+void randomFill(float* out, int count, float base, float variance, uint32_t* seed)
+{
+    getKernels()->randomFill(out, count, base, variance, 0.0f, 0.0f, false, seed);
+}
+
+void randomFillClamped(float* out, int count, float base, float variance, float minValue, float maxValue, uint32_t* seed)
+{
+    getKernels()->randomFill(out, count, base, variance, minValue, maxValue, true, seed);
+}
+
+void updateGravity(ParticleData& data, int count, float dt, float gravityX, float gravityY, float yCoordFlipped)
+{
+    getKernels()->updateGravity(data, count, dt, gravityX, gravityY, yCoordFlipped);
+}
+
+void updateRadius(ParticleData& data, int count, float dt, float yCoordFlipped)
+{
+    getKernels()->updateRadius(data, count, dt, yCoordFlipped);
+}
+
+void updateColorSizeRotation(ParticleData& data, int count, float dt)
+{
+    getKernels()->updateColorSizeRotation(data, count, dt);
+}
+
+void updateQuads(V3F_C4B_T2F_Quad* quads, const ParticleData& data, int count, const QuadOrigin& origin, bool opacityModifyRGB)
+{
+    getKernels()->updateQuads(quads, data, count, origin, opacityModifyRGB);
+}
+
+} // namespace ParticleKernels
+
+NS_CC_END
@@ -0,0 +1,87 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCPARTICLE_KERNELS_H__
+#define __CCPARTICLE_KERNELS_H__
+
+#include <stdint.h>
+
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+class ParticleData;
+struct V3F_C4B_T2F_Quad;
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/**
+ * Particle simulation kernels used by ParticleSystem and ParticleSystemQuad.
+ *
+ * Each kernel runs 4 particles at a time with SSE2 or NEON when the build targets them.
+ * The plain C versions are the reference and also handle the leftover particles.
+ * The random fills and the gravity, color, size and rotation steps give the same results as C.
+ * The radius mode and the quad corners use a polynomial sin/cos, about 1e-7 away from sinf/cosf.
+ */
+namespace ParticleKernels {
+
+/** Enables or disables the SIMD implementations, mainly to compare them with the plain C ones. Enabled by default. */
+void CC_DLL setSIMDEnabled(bool enabled);
+/** Returns the name of the implementation in use: "NEON", "SSE2" or "C". */
+const char* CC_DLL getSIMDName();
+
+/** out[i] = base + variance * RANDOM_M11(seed), leaving *seed as count scalar calls would. */
+void CC_DLL randomFill(float* out, int count, float base, float variance, uint32_t* seed);
+/** randomFill with each value clamped to [minValue, maxValue]. */
+void CC_DLL randomFillClamped(float* out, int count, float base, float variance, float minValue, float maxValue, uint32_t* seed);
+
+/** Gravity mode: radial and tangential acceleration, gravity, then position. */
+void CC_DLL updateGravity(ParticleData& data, int count, float dt, float gravityX, float gravityY, float yCoordFlipped);
+/** Radius mode: angle and radius, then position. */
+void CC_DLL updateRadius(ParticleData& data, int count, float dt, float yCoordFlipped);
+/** Color, size and rotation, shared by both modes. */
+void CC_DLL updateColorSizeRotation(ParticleData& data, int count, float dt);
+
+/** Where a particle quad is centered:
+ (posx + m00 * startPosX + m01 * startPosY + tx, posy + m10 * startPosX + m11 * startPosY + ty). */
+struct QuadOrigin
+{
+    float m00, m01, m10, m11;
+    float tx, ty;
+};
+
+/** Writes the vertices and colors of count quads, colors are premultiplied when opacityModifyRGB is true. */
+void CC_DLL updateQuads(V3F_C4B_T2F_Quad* quads, const ParticleData& data, int count, const QuadOrigin& origin, bool opacityModifyRGB);
+
+} // namespace ParticleKernels
+
+// end of _2d group
+/// @}
+
+NS_CC_END
+
+#endif // __CCPARTICLE_KERNELS_H__
@@ -45,9 +45,12 @@ THE SOFTWARE.
 
 #include "2d/CCParticleSystem.h"
 
+#include <float.h>
 #include <string>
 
 #include "2d/CCParticleBatchNode.h"
+#include "2d/CCParticleKernels.h"
+#include "2d/CCParticleUpdateScheduler.h"
 #include "renderer/CCTextureAtlas.h"
 #include "base/base64.h"
 #include "base/ZipUtils.h"
@@ -79,23 +82,6 @@ NS_CC_BEGIN
 //
 
 
-inline void normalize_point(float x, float y, particle_point* out)
-{
-    float n = x * x + y * y;
-    // Already normalized.
-    if (n == 1.0f)
-        return;
-    
-    n = sqrt(n);
-    // Too close to zero.
-    if (n < MATH_TOLERANCE)
-        return;
-    
-    n = 1.0f / n;
-    out->x = x * n;
-    out->y = y * n;
-}
-
 /**
  A more effect random number getter function, get from ejoy2d.
  */
@@ -109,6 +95,15 @@ inline static float RANDOM_M11(unsigned int *seed) {
     return u.f - 3.0f;
 }
 
+// murmur3 finalizer, gives the seed of an emission from the per system counter
+inline static uint32_t nextEmissionSeed(uint32_t* seed)
+{
+    uint32_t z = (*seed += 0x9E3779B9);
+    z = (z ^ (z >> 16)) * 0x85EBCA6B;
+    z = (z ^ (z >> 13)) * 0xC2B2AE35;
+    return z ^ (z >> 16);
+}
+
 ParticleData::ParticleData()
 {
     memset(this, 0, sizeof(ParticleData));
@@ -225,7 +220,14 @@ ParticleSystem::ParticleSystem()
 , _positionType(PositionType::FREE)
 , _paused(false)
 , _sourcePositionCompatible(true) // In the furture this member's default value maybe false or be removed.
-{
+, _randomSeed(rand())
+, _pendingDelta(0)
+, _pendingEmitCount(0)
+, _autoRemovePending(false)
+, _simulationQueued(false)
+{
+    // particles leave the content size of the emitter
+    _drawsOutsideContentSize = true;
     modeA.gravity.setZero();
     modeA.speed = 0;
     modeA.speedVar = 0;
@@ -609,38 +611,45 @@ ParticleSystem::~ParticleSystem()
 }
 
 void ParticleSystem::addParticles(int count)
+{
+    emitParticles(count, getEmissionPosition());
+}
+
+Vec2 ParticleSystem::getEmissionPosition()
+{
+    if (_positionType == PositionType::FREE)
+    {
+        return this->convertToWorldSpace(Vec2::ZERO);
+    }
+    else if (_positionType == PositionType::RELATIVE)
+    {
+        return _position;
+    }
+    return Vec2::ZERO;
+}
+
+void ParticleSystem::emitParticles(int count, const Vec2& startPosition)
 {
     if (_paused)
         return;
-    uint32_t RANDSEED = rand();
+    uint32_t RANDSEED = nextEmissionSeed(&_randomSeed);
 
     int start = _particleCount;
     _particleCount += count;
     
+    // Properties drawing one random number per particle are filled by ParticleKernels,
+    // which walks the same RANDOM_M11 sequence four particles at a time.
+
     //life
-    for (int i = start; i < _particleCount ; ++i)
-    {
-        float theLife = _life + _lifeVar * RANDOM_M11(&RANDSEED);
-        _particleData.timeToLive[i] = MAX(0, theLife);
-    }
+    ParticleKernels::randomFillClamped(_particleData.timeToLive + start, count, _life, _lifeVar, 0, FLT_MAX, &RANDSEED);
     
     //position
-    for (int i = start; i < _particleCount; ++i)
-    {
-        _particleData.posx[i] = _sourcePosition.x + _posVar.x * RANDOM_M11(&RANDSEED);
-    }
-    
-    for (int i = start; i < _particleCount; ++i)
-    {
-        _particleData.posy[i] = _sourcePosition.y + _posVar.y * RANDOM_M11(&RANDSEED);
-    }
+    ParticleKernels::randomFill(_particleData.posx + start, count, _sourcePosition.x, _posVar.x, &RANDSEED);
+    ParticleKernels::randomFill(_particleData.posy + start, count, _sourcePosition.y, _posVar.y, &RANDSEED);
     
     //color
 #define SET_COLOR(c, b, v)\
-for (int i = start; i < _particleCount; ++i)\
-{\
-c[i] = clampf( b + v * RANDOM_M11(&RANDSEED) , 0 , 1 );\
-}
+ParticleKernels::randomFillClamped(c + start, count, b, v, 0, 1, &RANDSEED);
     
     SET_COLOR(_particleData.colorR, _startColor.r, _startColorVar.r);
     SET_COLOR(_particleData.colorG, _startColor.g, _startColorVar.g);
@@ -664,19 +673,14 @@ dc[i] = (dc[i] - c[i]) / _particleData.timeToLive[i];\
     SET_DELTA_COLOR(_particleData.colorA, _particleData.deltaColorA);
     
     //size
-    for (int i = start; i < _particleCount; ++i)
-    {
-        _particleData.size[i] = _startSize + _startSizeVar * RANDOM_M11(&RANDSEED);
-        _particleData.size[i] = MAX(0, _particleData.size[i]);
-    }
+    ParticleKernels::randomFillClamped(_particleData.size + start, count, _startSize, _startSizeVar, 0, FLT_MAX, &RANDSEED);
     
     if (_endSize != START_SIZE_EQUAL_TO_END_SIZE)
     {
+        ParticleKernels::randomFillClamped(_particleData.deltaSize + start, count, _endSize, _endSizeVar, 0, FLT_MAX, &RANDSEED);
         for (int i = start; i < _particleCount; ++i)
         {
-            float endSize = _endSize + _endSizeVar * RANDOM_M11(&RANDSEED);
-            endSize = MAX(0, endSize);
-            _particleData.deltaSize[i] = (endSize - _particleData.size[i]) / _particleData.timeToLive[i];
+            _particleData.deltaSize[i] = (_particleData.deltaSize[i] - _particleData.size[i]) / _particleData.timeToLive[i];
         }
     }
     else
@@ -688,33 +692,21 @@ dc[i] = (dc[i] - c[i]) / _particleData.timeToLive[i];\
     }
     
     // rotation
+    ParticleKernels::randomFill(_particleData.rotation + start, count, _startSpin, _startSpinVar, &RANDSEED);
+    ParticleKernels::randomFill(_particleData.deltaRotation + start, count, _endSpin, _endSpinVar, &RANDSEED);
     for (int i = start; i < _particleCount; ++i)
     {
-        _particleData.rotation[i] = _startSpin + _startSpinVar * RANDOM_M11(&RANDSEED);
-    }
-    for (int i = start; i < _particleCount; ++i)
-    {
-        float endA = _endSpin + _endSpinVar * RANDOM_M11(&RANDSEED);
-        _particleData.deltaRotation[i] = (endA - _particleData.rotation[i]) / _particleData.timeToLive[i];
+        _particleData.deltaRotation[i] = (_particleData.deltaRotation[i] - _particleData.rotation[i]) / _particleData.timeToLive[i];
     }
     
     // position
-    Vec2 pos;
-    if (_positionType == PositionType::FREE)
-    {
-        pos = this->convertToWorldSpace(Vec2::ZERO);
-    }
-    else if (_positionType == PositionType::RELATIVE)
-    {
-        pos = _position;
-    }
     for (int i = start; i < _particleCount; ++i)
     {
-        _particleData.startPosX[i] = pos.x;
+        _particleData.startPosX[i] = startPosition.x;
     }
     for (int i = start; i < _particleCount; ++i)
     {
-        _particleData.startPosY[i] = pos.y;
+        _particleData.startPosY[i] = startPosition.y;
     }
     
     // Mode Gravity: A
@@ -722,17 +714,12 @@ dc[i] = (dc[i] - c[i]) / _particleData.timeToLive[i];\
     {
         
         // radial accel
-        for (int i = start; i < _particleCount; ++i)
-        {
-            _particleData.modeA.radialAccel[i] = modeA.radialAccel + modeA.radialAccelVar * RANDOM_M11(&RANDSEED);
-        }
+        ParticleKernels::randomFill(_particleData.modeA.radialAccel + start, count, modeA.radialAccel, modeA.radialAccelVar, &RANDSEED);
         
         // tangential accel
-        for (int i = start; i < _particleCount; ++i)
-        {
-            _particleData.modeA.tangentialAccel[i] = modeA.tangentialAccel + modeA.tangentialAccelVar * RANDOM_M11(&RANDSEED);
-        }
+        ParticleKernels::randomFill(_particleData.modeA.tangentialAccel + start, count, modeA.tangentialAccel, modeA.tangentialAccelVar, &RANDSEED);
         
+        // angle and speed interleave their random numbers, keep them scalar
         // rotation is dir
         if( modeA.rotationIsDir )
         {
@@ -767,19 +754,18 @@ dc[i] = (dc[i] - c[i]) / _particleData.timeToLive[i];\
     {
         //Need to check by Jacky
         // Set the default diameter of the particle from the source position
-        for (int i = start; i < _particleCount; ++i)
-        {
-            _particleData.modeB.radius[i] = modeB.startRadius + modeB.startRadiusVar * RANDOM_M11(&RANDSEED);
-        }
+        ParticleKernels::randomFill(_particleData.modeB.radius + start, count, modeB.startRadius, modeB.startRadiusVar, &RANDSEED);
 
+        ParticleKernels::randomFill(_particleData.modeB.angle + start, count, _angle, _angleVar, &RANDSEED);
         for (int i = start; i < _particleCount; ++i)
         {
-            _particleData.modeB.angle[i] = CC_DEGREES_TO_RADIANS( _angle + _angleVar * RANDOM_M11(&RANDSEED));
+            _particleData.modeB.angle[i] = CC_DEGREES_TO_RADIANS(_particleData.modeB.angle[i]);
         }
         
+        ParticleKernels::randomFill(_particleData.modeB.degreesPerSecond + start, count, modeB.rotatePerSecond, modeB.rotatePerSecondVar, &RANDSEED);
         for (int i = start; i < _particleCount; ++i)
         {
-            _particleData.modeB.degreesPerSecond[i] = CC_DEGREES_TO_RADIANS(modeB.rotatePerSecond + modeB.rotatePerSecondVar * RANDOM_M11(&RANDSEED));
+            _particleData.modeB.degreesPerSecond[i] = CC_DEGREES_TO_RADIANS(_particleData.modeB.degreesPerSecond[i]);
         }
         
         if(modeB.endRadius == START_RADIUS_EQUAL_TO_END_RADIUS)
@@ -791,10 +777,10 @@ dc[i] = (dc[i] - c[i]) / _particleData.timeToLive[i];\
         }
         else
         {
+            ParticleKernels::randomFill(_particleData.modeB.deltaRadius + start, count, modeB.endRadius, modeB.endRadiusVar, &RANDSEED);
             for (int i = start; i < _particleCount; ++i)
             {
-                float endRadius = modeB.endRadius + modeB.endRadiusVar * RANDOM_M11(&RANDSEED);
-                _particleData.modeB.deltaRadius[i] = (endRadius - _particleData.modeB.radius[i]) / _particleData.timeToLive[i];
+                _particleData.modeB.deltaRadius[i] = (_particleData.modeB.deltaRadius[i] - _particleData.modeB.radius[i]) / _particleData.timeToLive[i];
             }
         }
     }
@@ -865,6 +851,39 @@ void ParticleSystem::update(float dt)
 {
     CC_PROFILER_START_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
 
+    if (ParticleUpdateScheduler::isEnabled())
+    {
+        // updated twice in a frame, finish the first simulation here
+        if (_simulationQueued)
+        {
+            simulateUpdate();
+        }
+        prepareUpdate(dt);
+        if (!_simulationQueued)
+        {
+            _simulationQueued = true;
+            ParticleUpdateScheduler::getInstance()->scheduleSimulation(this);
+        }
+    }
+    else
+    {
+        prepareUpdate(dt);
+        simulateUpdate();
+        finishUpdate();
+    }
+
+    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
+}
+
+void ParticleSystem::prepareUpdate(float dt)
+{
+    // particles are not bounded by the content size, live particles damage the screen
+    if (_isActive || _particleCount > 0)
+    {
+        markDamaged();
+    }
+
+    _pendingDelta = dt;
     if (_isActive && _emissionRate)
     {
         float rate = 1.0f / _emissionRate;
@@ -879,7 +898,11 @@ void ParticleSystem::update(float dt)
         }
         
         int emitCount = MIN(totalParticles - _particleCount, _emitCounter / rate);
-        addParticles(emitCount);
+        if (emitCount > 0)
+        {
+            _pendingEmitCount = emitCount;
+            _pendingEmitPosition = getEmissionPosition();
+        }
         _emitCounter -= rate * emitCount;
         
         _elapsed += dt;
@@ -890,7 +913,21 @@ void ParticleSystem::update(float dt)
             this->stopSystem();
         }
     }
-    
+
+    prepareParticleQuads();
+}
+
+void ParticleSystem::simulateUpdate()
+{
+    float dt = _pendingDelta;
+    _pendingDelta = 0;
+
+    if (_pendingEmitCount > 0)
+    {
+        emitParticles(_pendingEmitCount, _pendingEmitPosition);
+        _pendingEmitCount = 0;
+    }
+
     {
         for (int i = 0; i < _particleCount; ++i)
         {
@@ -919,123 +956,56 @@ void ParticleSystem::update(float dt)
                 --_particleCount;
                 if( _particleCount == 0 && _isAutoRemoveOnFinish )
                 {
-                    this->unscheduleUpdate();
-                    _parent->removeChild(this, true);
+                    // removed from the parent by finishUpdate, on the main thread
+                    _autoRemovePending = true;
                     return;
                 }
             }
         }
         
+        //Why use so many for-loop separately instead of putting them together?
+        //When the processor needs to read from or write to a location in memory,
+        //it first checks whether a copy of that data is in the cache.
+        //And every property's memory of the particle system is continuous,
+        //for the purpose of improving cache hit rate, we should process only one property in one for-loop AFAP.
+        //ParticleKernels goes one step further and processes four particles per instruction where SIMD is available.
         if (_emitterMode == Mode::GRAVITY)
         {
-            for (int i = 0 ; i < _particleCount; ++i)
-            {
-                particle_point tmp, radial = {0.0f, 0.0f}, tangential;
-                
-                // radial acceleration
-                if (_particleData.posx[i] || _particleData.posy[i])
-                {
-                    normalize_point(_particleData.posx[i], _particleData.posy[i], &radial);
-                }
-                tangential = radial;
-                radial.x *= _particleData.modeA.radialAccel[i];
-                radial.y *= _particleData.modeA.radialAccel[i];
-                
-                // tangential acceleration
-                std::swap(tangential.x, tangential.y);
-                tangential.x *= - _particleData.modeA.tangentialAccel[i];
-                tangential.y *= _particleData.modeA.tangentialAccel[i];
-                
-                // (gravity + radial + tangential) * dt
-                tmp.x = radial.x + tangential.x + modeA.gravity.x;
-                tmp.y = radial.y + tangential.y + modeA.gravity.y;
-                tmp.x *= dt;
-                tmp.y *= dt;
-                
-                _particleData.modeA.dirX[i] += tmp.x;
-                _particleData.modeA.dirY[i] += tmp.y;
-                
-                // this is cocos2d-x v3.0
-                // if (_configName.length()>0 && _yCoordFlipped != -1)
-                
-                // this is cocos2d-x v3.0
-                tmp.x = _particleData.modeA.dirX[i] * dt * _yCoordFlipped;
-                tmp.y = _particleData.modeA.dirY[i] * dt * _yCoordFlipped;
-                _particleData.posx[i] += tmp.x;
-                _particleData.posy[i] += tmp.y;
-            }
+            ParticleKernels::updateGravity(_particleData, _particleCount, dt, modeA.gravity.x, modeA.gravity.y, _yCoordFlipped);
         }
         else
         {
-            //Why use so many for-loop separately instead of putting them together?
-            //When the processor needs to read from or write to a location in memory,
-            //it first checks whether a copy of that data is in the cache.
-            //And every property's memory of the particle system is continuous,
-            //for the purpose of improving cache hit rate, we should process only one property in one for-loop AFAP.
-            //It was proved to be effective especially for low-end machine. 
-            for (int i = 0; i < _particleCount; ++i)
-            {
-                _particleData.modeB.angle[i] += _particleData.modeB.degreesPerSecond[i] * dt;
-            }
-            
-            for (int i = 0; i < _particleCount; ++i)
-            {
-                _particleData.modeB.radius[i] += _particleData.modeB.deltaRadius[i] * dt;
-            }
-            
-            for (int i = 0; i < _particleCount; ++i)
-            {
-                _particleData.posx[i] = - cosf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i];
-            }
-            for (int i = 0; i < _particleCount; ++i)
-            {
-                _particleData.posy[i] = - sinf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i] * _yCoordFlipped;
-            }
+            ParticleKernels::updateRadius(_particleData, _particleCount, dt, _yCoordFlipped);
         }
         
-        //color r,g,b,a
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.colorR[i] += _particleData.deltaColorR[i] * dt;
-        }
-        
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.colorG[i] += _particleData.deltaColorG[i] * dt;
-        }
-        
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.colorB[i] += _particleData.deltaColorB[i] * dt;
-        }
-        
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.colorA[i] += _particleData.deltaColorA[i] * dt;
-        }
-        //size
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.size[i] += (_particleData.deltaSize[i] * dt);
-            _particleData.size[i] = MAX(0, _particleData.size[i]);
-        }
-        //angle
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.rotation[i] += _particleData.deltaRotation[i] * dt;
-        }
+        //color r,g,b,a, size and angle
+        ParticleKernels::updateColorSizeRotation(_particleData, _particleCount, dt);
         
         updateParticleQuads();
         _transformSystemDirty = false;
     }
+}
+
+void ParticleSystem::finishUpdate()
+{
+    _simulationQueued = false;
+
+    if (_autoRemovePending)
+    {
+        _autoRemovePending = false;
+        this->unscheduleUpdate();
+        if (_parent)
+        {
+            _parent->removeChild(this, true);
+        }
+        return;
+    }
 
     // only update gl buffer when visible
     if (_visible && ! _batchNode)
     {
         postStep();
     }
-
-    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
 }
 
 void ParticleSystem::updateWithNoTime(void)
@@ -1043,6 +1013,11 @@ void ParticleSystem::updateWithNoTime(void)
     this->update(0.0f);
 }
 
+void ParticleSystem::prepareParticleQuads()
+{
+    //should be overridden
+}
+
 void ParticleSystem::updateParticleQuads()
 {
     //should be overridden
@@ -483,6 +483,18 @@ public:
      * @return The Quantity of particles that are being simulated at the moment.
      */
     unsigned int getParticleCount() const { return _particleCount; }
+
+    /** Sets the seed of the random numbers of the particles.
+     * Every emission takes its random numbers from a seed derived from this one, so two systems
+     * with the same seed and settings emit the same particles, whatever thread simulates them.
+     * Defaults to rand() when the system is created.
+     * @since v3.17
+     */
+    void setRandomSeed(uint32_t seed) { _randomSeed = seed; }
+    /** Gets the seed of the next emission, @see setRandomSeed.
+     * @since v3.17
+     */
+    uint32_t getRandomSeed() const { return _randomSeed; }
     
     /** Gets how many seconds the emitter will run. -1 means 'forever'.
      *
@@ -823,9 +835,26 @@ CC_CONSTRUCTOR_ACCESS:
 
 protected:
     virtual void updateBlendFunc();
+
+    /** Emits count particles from startPosition, in world space for PositionType::FREE,
+     in parent space for PositionType::RELATIVE and ignored for PositionType::GROUPED. */
+    void emitParticles(int count, const Vec2& startPosition);
+    /** The start position addParticles gives to emitParticles. */
+    Vec2 getEmissionPosition();
+
+    // update() runs these three steps, or prepareUpdate() and queues the system in ParticleUpdateScheduler
+    /** Updates the emission counters and reads what the simulation needs from the scene graph. Main thread only. */
+    void prepareUpdate(float dt);
+    /** Emits, moves and kills the particles, then writes their quads. Only touches the system itself, may run on a worker thread. */
+    void simulateUpdate();
+    /** Removes the finished system from its parent or uploads its quads. Main thread only. */
+    void finishUpdate();
+    /** Reads the transforms used by updateParticleQuads, called by prepareUpdate on the main thread. */
+    virtual void prepareParticleQuads();
     
 private:
     friend class EngineDataManager;
+    friend class ParticleUpdateScheduler;
     /** Internal use only, it's used by EngineDataManager class for Android platform */
     static void setTotalParticleCountFactor(float factor);
     
@@ -992,6 +1021,18 @@ protected:
     /** is sourcePosition compatible */
     bool _sourcePositionCompatible;
 
+    /** seed of the next emission */
+    uint32_t _randomSeed;
+
+    // set by prepareUpdate for simulateUpdate
+    float _pendingDelta;
+    int _pendingEmitCount;
+    Vec2 _pendingEmitPosition;
+    // set by simulateUpdate for finishUpdate
+    bool _autoRemovePending;
+    // queued in ParticleUpdateScheduler, until finishUpdate
+    bool _simulationQueued;
+
     static Vector<ParticleSystem*> __allInstances;
     
 private:
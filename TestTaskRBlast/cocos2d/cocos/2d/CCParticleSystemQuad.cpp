@@ -34,6 +34,7 @@ THE SOFTWARE.
 
 #include "2d/CCSpriteFrame.h"
 #include "2d/CCParticleBatchNode.h"
+#include "2d/CCParticleKernels.h"
 #include "renderer/CCTextureAtlas.h"
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCRenderer.h"
@@ -52,6 +53,7 @@ ParticleSystemQuad::ParticleSystemQuad()
 ,_VAOname(0)
 {
     memset(_buffersVBO, 0, sizeof(_buffersVBO));
+    memset(&_quadOrigin, 0, sizeof(_quadOrigin));
 }
 
 ParticleSystemQuad::~ParticleSystemQuad()
@@ -259,53 +261,12 @@ void ParticleSystemQuad::initIndices()
     }
 }
 
-inline void updatePosWithParticle(V3F_C4B_T2F_Quad *quad, const Vec2& newPosition,float size,float rotation)
+void ParticleSystemQuad::prepareParticleQuads()
 {
-    // vertices
-    GLfloat size_2 = size/2;
-    GLfloat x1 = -size_2;
-    GLfloat y1 = -size_2;
-    
-    GLfloat x2 = size_2;
-    GLfloat y2 = size_2;
-    GLfloat x = newPosition.x;
-    GLfloat y = newPosition.y;
-    
-    GLfloat r = (GLfloat)-CC_DEGREES_TO_RADIANS(rotation);
-    GLfloat cr = cosf(r);
-    GLfloat sr = sinf(r);
-    GLfloat ax = x1 * cr - y1 * sr + x;
-    GLfloat ay = x1 * sr + y1 * cr + y;
-    GLfloat bx = x2 * cr - y1 * sr + x;
-    GLfloat by = x2 * sr + y1 * cr + y;
-    GLfloat cx = x2 * cr - y2 * sr + x;
-    GLfloat cy = x2 * sr + y2 * cr + y;
-    GLfloat dx = x1 * cr - y2 * sr + x;
-    GLfloat dy = x1 * sr + y2 * cr + y;
-    
-    // bottom-left
-    quad->bl.vertices.x = ax;
-    quad->bl.vertices.y = ay;
-    
-    // bottom-right vertex:
-    quad->br.vertices.x = bx;
-    quad->br.vertices.y = by;
-    
-    // top-left vertex:
-    quad->tl.vertices.x = dx;
-    quad->tl.vertices.y = dy;
-    
-    // top-right vertex:
-    quad->tr.vertices.x = cx;
-    quad->tr.vertices.y = cy;
-}
-
-void ParticleSystemQuad::updateParticleQuads()
-{
-    if (_particleCount <= 0) {
+    if (_particleCount <= 0 && _pendingEmitCount <= 0) {
         return;
     }
- 
+
     Vec2 currentPosition;
     if (_positionType == PositionType::FREE)
     {
@@ -315,122 +276,65 @@ void ParticleSystemQuad::updateParticleQuads()
     {
         currentPosition = _position;
     }
-    
-    V3F_C4B_T2F_Quad *startQuad;
+
     Vec2 pos = Vec2::ZERO;
     if (_batchNode)
     {
-        V3F_C4B_T2F_Quad *batchQuads = _batchNode->getTextureAtlas()->getQuads();
-        startQuad = &(batchQuads[_atlasIndex]);
         pos = _position;
     }
-    else
-    {
-        startQuad = &(_quads[0]);
-    }
     
+    // quad center = particle position + origin * start position + translation
     if( _positionType == PositionType::FREE )
     {
         Vec3 p1(currentPosition.x, currentPosition.y, 0);
         Mat4 worldToNodeTM = getWorldToNodeTransform();
         worldToNodeTM.transformPoint(&p1);
-        Vec3 p2;
-        Vec2 newPos;
-        float* startX = _particleData.startPosX;
-        float* startY = _particleData.startPosY;
-        float* x = _particleData.posx;
-        float* y = _particleData.posy;
-        float* s = _particleData.size;
-        float* r = _particleData.rotation;
-        V3F_C4B_T2F_Quad* quadStart = startQuad;
-        for (int i = 0 ; i < _particleCount; ++i, ++startX, ++startY, ++x, ++y, ++quadStart, ++s, ++r)
-        {
-            p2.set(*startX, *startY, 0);
-            worldToNodeTM.transformPoint(&p2);
-            newPos.set(*x,*y);
-            p2 = p1 - p2;
-            newPos.x -= p2.x - pos.x;
-            newPos.y -= p2.y - pos.y;
-            updatePosWithParticle(quadStart, newPos, *s, *r);
-        }
+        _quadOrigin.m00 = worldToNodeTM.m[0];
+        _quadOrigin.m01 = worldToNodeTM.m[4];
+        _quadOrigin.m10 = worldToNodeTM.m[1];
+        _quadOrigin.m11 = worldToNodeTM.m[5];
+        _quadOrigin.tx = worldToNodeTM.m[12] - p1.x + pos.x;
+        _quadOrigin.ty = worldToNodeTM.m[13] - p1.y + pos.y;
     }
     else if( _positionType == PositionType::RELATIVE )
     {
-        Vec2 newPos;
-        float* startX = _particleData.startPosX;
-        float* startY = _particleData.startPosY;
-        float* x = _particleData.posx;
-        float* y = _particleData.posy;
-        float* s = _particleData.size;
-        float* r = _particleData.rotation;
-        V3F_C4B_T2F_Quad* quadStart = startQuad;
-        for (int i = 0 ; i < _particleCount; ++i, ++startX, ++startY, ++x, ++y, ++quadStart, ++s, ++r)
-        {
-            newPos.set(*x, *y);
-            newPos.x = *x - (currentPosition.x - *startX);
-            newPos.y = *y - (currentPosition.y - *startY);
-            newPos += pos;
-            updatePosWithParticle(quadStart, newPos, *s, *r);
-        }
+        _quadOrigin.m00 = 1;
+        _quadOrigin.m01 = 0;
+        _quadOrigin.m10 = 0;
+        _quadOrigin.m11 = 1;
+        _quadOrigin.tx = pos.x - currentPosition.x;
+        _quadOrigin.ty = pos.y - currentPosition.y;
     }
     else
     {
-        Vec2 newPos;
-        float* startX = _particleData.startPosX;
-        float* startY = _particleData.startPosY;
-        float* x = _particleData.posx;
-        float* y = _particleData.posy;
-        float* s = _particleData.size;
-        float* r = _particleData.rotation;
-        V3F_C4B_T2F_Quad* quadStart = startQuad;
-        for (int i = 0 ; i < _particleCount; ++i, ++startX, ++startY, ++x, ++y, ++quadStart, ++s, ++r)
-        {
-            newPos.set(*x + pos.x, *y + pos.y);
-            updatePosWithParticle(quadStart, newPos, *s, *r);
-        }
+        _quadOrigin.m00 = 0;
+        _quadOrigin.m01 = 0;
+        _quadOrigin.m10 = 0;
+        _quadOrigin.m11 = 0;
+        _quadOrigin.tx = pos.x;
+        _quadOrigin.ty = pos.y;
+    }
+}
+
+void ParticleSystemQuad::updateParticleQuads()
+{
+    if (_particleCount <= 0) {
+        return;
     }
     
-    //set color
-    if(_opacityModifyRGB)
+    V3F_C4B_T2F_Quad *startQuad;
+    if (_batchNode)
     {
-        V3F_C4B_T2F_Quad* quad = startQuad;
-        float* r = _particleData.colorR;
-        float* g = _particleData.colorG;
-        float* b = _particleData.colorB;
-        float* a = _particleData.colorA;
-        
-        for (int i = 0; i < _particleCount; ++i,++quad,++r,++g,++b,++a)
-        {
-            GLubyte colorR = *r * *a * 255;
-            GLubyte colorG = *g * *a * 255;
-            GLubyte colorB = *b * *a * 255;
-            GLubyte colorA = *a * 255;
-            quad->bl.colors.set(colorR, colorG, colorB, colorA);
-            quad->br.colors.set(colorR, colorG, colorB, colorA);
-            quad->tl.colors.set(colorR, colorG, colorB, colorA);
-            quad->tr.colors.set(colorR, colorG, colorB, colorA);
-        }
+        V3F_C4B_T2F_Quad *batchQuads = _batchNode->getTextureAtlas()->getQuads();
+        startQuad = &(batchQuads[_atlasIndex]);
     }
     else
     {
-        V3F_C4B_T2F_Quad* quad = startQuad;
-        float* r = _particleData.colorR;
-        float* g = _particleData.colorG;
-        float* b = _particleData.colorB;
-        float* a = _particleData.colorA;
-        
-        for (int i = 0; i < _particleCount; ++i,++quad,++r,++g,++b,++a)
-        {
-            GLubyte colorR = *r * 255;
-            GLubyte colorG = *g * 255;
-            GLubyte colorB = *b * 255;
-            GLubyte colorA = *a * 255;
-            quad->bl.colors.set(colorR, colorG, colorB, colorA);
-            quad->br.colors.set(colorR, colorG, colorB, colorA);
-            quad->tl.colors.set(colorR, colorG, colorB, colorA);
-            quad->tr.colors.set(colorR, colorG, colorB, colorA);
-        }
+        startQuad = &(_quads[0]);
     }
+    
+    // vertices and colors, _quadOrigin comes from prepareParticleQuads
+    ParticleKernels::updateQuads(startQuad, _particleData, _particleCount, _quadOrigin, _opacityModifyRGB);
 }
 
 void ParticleSystemQuad::postStep()
@@ -605,6 +509,7 @@ void ParticleSystemQuad::listenRendererRecreated(EventCustom* /*event*/)
     //when comes to foreground in android, _buffersVBO and _VAOname is a wild handle
     //before recreating, we need to reset them to 0
     memset(_buffersVBO, 0, sizeof(_buffersVBO));
+    memset(&_quadOrigin, 0, sizeof(_quadOrigin));
     if (Configuration::getInstance()->supportsShareableVAO())
     {
         _VAOname = 0;
@@ -30,6 +30,7 @@ THE SOFTWARE.
 #define __CC_PARTICLE_SYSTEM_QUAD_H__
 
 #include "2d/CCParticleSystem.h"
+#include "2d/CCParticleKernels.h"
 #include "renderer/CCQuadCommand.h"
 
 NS_CC_BEGIN
@@ -166,6 +167,8 @@ CC_CONSTRUCTOR_ACCESS:
 
 
 protected:
+    virtual void prepareParticleQuads() override;
+
     /** initializes the indices for the vertices*/
     void initIndices();
     
@@ -185,6 +188,7 @@ protected:
     GLuint              _buffersVBO[2]; //0: vertex  1: indices
 
     QuadCommand _quadCommand;           // quad command
+    ParticleKernels::QuadOrigin _quadOrigin; // set by prepareParticleQuads
     
 
 
@@ -0,0 +1,212 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/CCParticleUpdateScheduler.h"
+
+#include <algorithm>
+
+#include "2d/CCParticleSystem.h"
+#include "base/CCDirector.h"
+#include "base/CCEventDispatcher.h"
+#include "base/CCEventListenerCustom.h"
+
+NS_CC_BEGIN
+
+// below this many particles in a frame, waking the threads costs more than it saves
+static const unsigned int PARALLEL_PARTICLE_THRESHOLD = 2000;
+
+static ParticleUpdateScheduler* s_sharedParticleUpdateScheduler = nullptr;
+
+bool ParticleUpdateScheduler::_enabled = false;
+
+ParticleUpdateScheduler* ParticleUpdateScheduler::getInstance()
+{
+    if (!s_sharedParticleUpdateScheduler)
+    {
+        s_sharedParticleUpdateScheduler = new (std::nothrow) ParticleUpdateScheduler();
+        CCASSERT(s_sharedParticleUpdateScheduler, "FATAL: Not enough memory");
+    }
+    return s_sharedParticleUpdateScheduler;
+}
+
+void ParticleUpdateScheduler::destroyInstance()
+{
+    CC_SAFE_DELETE(s_sharedParticleUpdateScheduler);
+}
+
+void ParticleUpdateScheduler::setEnabled(bool enabled)
+{
+    _enabled = enabled;
+    // the systems queued this frame still need their simulation
+    if (!enabled && s_sharedParticleUpdateScheduler)
+    {
+        s_sharedParticleUpdateScheduler->update();
+    }
+}
+
+ParticleUpdateScheduler::ParticleUpdateScheduler()
+: _afterUpdateListener(nullptr)
+, _threadCount(0)
+, _nextJob(0)
+, _pendingJobs(0)
+, _quit(false)
+{
+    _afterUpdateListener = Director::getInstance()->getEventDispatcher()->addCustomEventListener(Director::EVENT_AFTER_UPDATE, [this](EventCustom* /*event*/){
+        update();
+    });
+}
+
+ParticleUpdateScheduler::~ParticleUpdateScheduler()
+{
+    Director::getInstance()->getEventDispatcher()->removeEventListener(_afterUpdateListener);
+    stopThreads();
+    // the queued systems are simulated by their next update
+    for (auto system : _queuedSystems)
+    {
+        system->_simulationQueued = false;
+    }
+}
+
+void ParticleUpdateScheduler::setThreadCount(int count)
+{
+    _threadCount = std::max(count, 0);
+    stopThreads();
+}
+
+void ParticleUpdateScheduler::scheduleSimulation(ParticleSystem* system)
+{
+    _queuedSystems.pushBack(system);
+}
+
+void ParticleUpdateScheduler::update()
+{
+    if (_queuedSystems.empty())
+        return;
+
+    // the largest systems first, so the last jobs to finish are short ones
+    std::vector<ParticleSystem*> jobs(_queuedSystems.begin(), _queuedSystems.end());
+    std::stable_sort(jobs.begin(), jobs.end(), [](ParticleSystem* a, ParticleSystem* b){
+        return a->getParticleCount() + a->_pendingEmitCount > b->getParticleCount() + b->_pendingEmitCount;
+    });
+
+    unsigned int totalParticles = 0;
+    for (auto system : jobs)
+    {
+        totalParticles += system->getParticleCount() + system->_pendingEmitCount;
+    }
+
+    if (jobs.size() < 2 || totalParticles < PARALLEL_PARTICLE_THRESHOLD)
+    {
+        for (auto system : jobs)
+        {
+            system->simulateUpdate();
+        }
+    }
+    else
+    {
+        if (_threads.empty())
+        {
+            startThreads();
+        }
+
+        std::unique_lock<std::mutex> lock(_jobMutex);
+        _jobs.swap(jobs);
+        _nextJob = 0;
+        _pendingJobs = _jobs.size();
+        _jobCondition.notify_all();
+
+        // the main thread takes jobs too, then waits for the ones still running
+        while (_nextJob < _jobs.size())
+        {
+            ParticleSystem* system = _jobs[_nextJob++];
+            lock.unlock();
+            system->simulateUpdate();
+            lock.lock();
+            --_pendingJobs;
+        }
+        _doneCondition.wait(lock, [this](){ return _pendingJobs == 0; });
+        _jobs.clear();
+    }
+
+    // back to the update order for the auto removals and the buffer uploads,
+    // the queue keeps the systems alive while their parents remove them
+    Vector<ParticleSystem*> systems(std::move(_queuedSystems));
+    _queuedSystems.clear();
+    for (auto system : systems)
+    {
+        system->finishUpdate();
+    }
+}
+
+void ParticleUpdateScheduler::startThreads()
+{
+    int count = _threadCount;
+    if (count == 0)
+    {
+        int hardwareThreads = static_cast<int>(std::thread::hardware_concurrency());
+        count = std::min(std::max(hardwareThreads - 1, 1), 4);
+    }
+
+    _quit = false;
+    for (int i = 0; i < count; ++i)
+    {
+        _threads.emplace_back(&ParticleUpdateScheduler::workerLoop, this);
+    }
+}
+
+void ParticleUpdateScheduler::stopThreads()
+{
+    {
+        std::lock_guard<std::mutex> lock(_jobMutex);
+        _quit = true;
+    }
+    _jobCondition.notify_all();
+    for (auto& thread : _threads)
+    {
+        thread.join();
+    }
+    _threads.clear();
+}
+
+void ParticleUpdateScheduler::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(_jobMutex);
+    while (true)
+    {
+        _jobCondition.wait(lock, [this](){ return _quit || _nextJob < _jobs.size(); });
+        if (_quit)
+            break;
+
+        ParticleSystem* system = _jobs[_nextJob++];
+        lock.unlock();
+        system->simulateUpdate();
+        lock.lock();
+        if (--_pendingJobs == 0)
+        {
+            _doneCondition.notify_one();
+        }
+    }
+}
+
+NS_CC_END
@@ -0,0 +1,121 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCPARTICLE_UPDATE_SCHEDULER_H__
+#define __CCPARTICLE_UPDATE_SCHEDULER_H__
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "base/CCVector.h"
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+class EventListenerCustom;
+class ParticleSystem;
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/** @class ParticleUpdateScheduler
+ * @brief Simulates the particle systems of a frame in parallel.
+
+ Without it each ParticleSystem simulates its particles in its own update, one system after the other.
+ When enabled, ParticleSystem::update only does the part that touches the scene graph (emission
+ counters, transforms) and queues the system. After the scheduler update of the frame, the queued
+ systems are simulated at the same time on a pool of worker threads and the main thread, their quads
+ are written to their buffers, then the buffers are uploaded on the main thread before the scene is visited.
+
+ The systems are independent: each one only writes its own particles and quads, and draws its
+ random numbers from its own seed (ParticleSystem::setRandomSeed), so the results are the same
+ as the single threaded update.
+
+ Systems updated by a Scheduler other than the Director's are simulated after the next update of the Director.
+ @since v3.17
+ */
+class CC_DLL ParticleUpdateScheduler
+{
+public:
+    /** Returns the shared instance. */
+    static ParticleUpdateScheduler* getInstance();
+
+    /** Stops the worker threads and destroys the shared instance. */
+    static void destroyInstance();
+
+    /** Enables the parallel update of the particle systems. Disabled by default. */
+    static void setEnabled(bool enabled);
+    /** Whether the particle systems are updated in parallel, @see setEnabled. */
+    static bool isEnabled() { return _enabled; }
+
+    /** Sets the number of worker threads, besides the main thread.
+     * Takes effect when the threads are started by the next update.
+     * @param count Number of threads, 0 picks one per extra hardware thread, between 1 and 4.
+     */
+    void setThreadCount(int count);
+    /** Gets the number of worker threads, @see setThreadCount. */
+    int getThreadCount() const { return _threadCount; }
+
+    /** Queues a system prepared by ParticleSystem::update for the simulation of this frame. */
+    void scheduleSimulation(ParticleSystem* system);
+
+    /** Simulates the queued systems, then lets them upload their quads. Called after the Director's scheduler update. */
+    void update();
+
+private:
+    ParticleUpdateScheduler();
+    ~ParticleUpdateScheduler();
+
+    void startThreads();
+    void stopThreads();
+    void workerLoop();
+
+    static bool _enabled;
+
+    EventListenerCustom* _afterUpdateListener;
+    // systems queued this frame, in update order
+    Vector<ParticleSystem*> _queuedSystems;
+
+    int _threadCount;
+    std::vector<std::thread> _threads;
+    std::mutex _jobMutex;
+    std::condition_variable _jobCondition;
+    std::condition_variable _doneCondition;
+    // guarded by _jobMutex
+    std::vector<ParticleSystem*> _jobs;
+    size_t _nextJob;
+    size_t _pendingJobs;
+    bool _quit;
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
+
+#endif // __CCPARTICLE_UPDATE_SCHEDULER_H__
@@ -679,6 +679,12 @@ void RenderTexture::onBegin()
     glGetIntegerv(GL_FRAMEBUFFER_BINDING, &_oldFBO);
     glBindFramebuffer(GL_FRAMEBUFFER, _FBO);
 
+    // the damaged area of the screen doesn't apply to the texture
+    if (director->getRenderer()->isPartialRedrawActive())
+    {
+        glDisable(GL_SCISSOR_TEST);
+    }
+
     // TODO: move this to configuration, so we don't check it every time
     /*  Certain Qualcomm Adreno GPU's will retain data in memory after a frame buffer switch which corrupts the render to the texture. The solution is to clear the frame buffer before rendering to the texture. However, calling glClear has the unintended result of clearing the current texture. Create a temporary texture to overcome this. At the end of RenderTexture::begin(), switch the attached texture to the second one, call glClear, and then switch back to the original texture. This solution is unnecessary for other devices as they don't have the same issue with switching frame buffers.
      */
@@ -697,6 +703,7 @@ void RenderTexture::onEnd()
     Director *director = Director::getInstance();
 
     glBindFramebuffer(GL_FRAMEBUFFER, _oldFBO);
+    director->getRenderer()->restoreDamageScissor();
 
     // restore viewport
     director->setViewport();
@@ -800,6 +807,12 @@ void RenderTexture::begin()
 {
     Director* director = Director::getInstance();
     CCASSERT(nullptr != director, "Director is null when setting matrix stack");
+
+    // the texture content changes, so does the sprite showing it
+    if (_sprite)
+    {
+        _sprite->markDamaged();
+    }
     
     director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
     _projectionMatrix = director->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
@@ -373,6 +373,8 @@ void Sprite::setTexture(const std::string &filename)
 
 void Sprite::setTexture(Texture2D *texture)
 {
+    markDamaged();
+
     if(_glProgramState == nullptr)
     {
         setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP, texture));
@@ -424,6 +426,7 @@ void Sprite::setTextureRect(const Rect& rect)
 void Sprite::setTextureRect(const Rect& rect, bool rotated, const Size& untrimmedSize)
 {
     _rectRotated = rotated;
+    markDamaged();
 
     Node::setContentSize(untrimmedSize);
     _originalContentSize = untrimmedSize;
@@ -1438,6 +1441,7 @@ void Sprite::setFlippedX(bool flippedX)
     {
         _flippedX = flippedX;
         flipX();
+        markDamaged();
     }
 }
 
@@ -1452,6 +1456,7 @@ void Sprite::setFlippedY(bool flippedY)
     {
         _flippedY = flippedY;
         flipY();
+        markDamaged();
     }
 }
 
@@ -44,6 +44,7 @@ THE SOFTWARE.
 #include "renderer/CCTexture2D.h"
 #include "renderer/CCTextureCache.h"
 #include "base/CCNinePatchImageParser.h"
+#include "2d/SpriteAtlasBinary_generated.h"
 
 using namespace std;
 
@@ -51,6 +52,86 @@ NS_CC_BEGIN
 
 static SpriteFrameCache *_sharedSpriteFrameCache = nullptr;
 
+static bool isBinaryAtlasFile(const std::string& fullPath)
+{
+    return FileUtils::getInstance()->getFileExtension(fullPath) == ".ccsa";
+}
+
+static const spriteatlas::SpriteAtlas* getBinaryAtlas(const FileView& data)
+{
+    if (data.getSize() < (ssize_t)(sizeof(flatbuffers::uoffset_t) + flatbuffers::FlatBufferBuilder::kFileIdentifierLength)
+        || !spriteatlas::SpriteAtlasBufferHasIdentifier(data.getBytes()))
+    {
+        return nullptr;
+    }
+
+    flatbuffers::Verifier verifier(data.getBytes(), data.getSize());
+    if (!spriteatlas::VerifySpriteAtlasBuffer(verifier))
+    {
+        return nullptr;
+    }
+    return spriteatlas::GetSpriteAtlas(data.getBytes());
+}
+
+static std::string getAtlasTexturePath(const std::string& textureFileName, const std::string& plist)
+{
+    std::string texturePath;
+    if (!textureFileName.empty())
+    {
+        // build texture path relative to plist file
+        texturePath = FileUtils::getInstance()->fullPathFromRelativeFile(textureFileName, plist);
+    }
+    else
+    {
+        // build texture path by replacing file extension
+        texturePath = plist;
+
+        // remove .xxx
+        size_t startPos = texturePath.find_last_of('.');
+        texturePath = texturePath.erase(startPos);
+
+        // append .png
+        texturePath = texturePath.append(".png");
+
+        CCLOG("cocos2d: SpriteFrameCache: Trying to use file %s as texture", texturePath.c_str());
+    }
+    return texturePath;
+}
+
+static Texture2D* addAtlasTexture(const std::string& texturePath, const std::string& pixelFormatName)
+{
+    Texture2D *texture = nullptr;
+    static std::unordered_map<std::string, Texture2D::PixelFormat> pixelFormats = {
+        {"RGBA8888", Texture2D::PixelFormat::RGBA8888},
+        {"RGBA4444", Texture2D::PixelFormat::RGBA4444},
+        {"RGB5A1", Texture2D::PixelFormat::RGB5A1},
+        {"RGBA5551", Texture2D::PixelFormat::RGB5A1},
+        {"RGB565", Texture2D::PixelFormat::RGB565},
+        {"A8", Texture2D::PixelFormat::A8},
+        {"ALPHA", Texture2D::PixelFormat::A8},
+        {"I8", Texture2D::PixelFormat::I8},
+        {"AI88", Texture2D::PixelFormat::AI88},
+        {"ALPHA_INTENSITY", Texture2D::PixelFormat::AI88},
+        //{"BGRA8888", Texture2D::PixelFormat::BGRA8888}, no Image conversion RGBA -> BGRA
+        {"RGB888", Texture2D::PixelFormat::RGB888}
+    };
+
+    auto pixelFormatIt = pixelFormats.find(pixelFormatName);
+    if (pixelFormatIt != pixelFormats.end())
+    {
+        const Texture2D::PixelFormat pixelFormat = (*pixelFormatIt).second;
+        const Texture2D::PixelFormat currentPixelFormat = Texture2D::getDefaultAlphaPixelFormat();
+        Texture2D::setDefaultAlphaPixelFormat(pixelFormat);
+        texture = Director::getInstance()->getTextureCache()->addImage(texturePath);
+        Texture2D::setDefaultAlphaPixelFormat(currentPixelFormat);
+    }
+    else
+    {
+        texture = Director::getInstance()->getTextureCache()->addImage(texturePath);
+    }
+    return texture;
+}
+
 SpriteFrameCache* SpriteFrameCache::getInstance()
 {
     if (! _sharedSpriteFrameCache)
@@ -287,35 +368,7 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dict, const std::
         }
     }
     
-    Texture2D *texture = nullptr;
-    static std::unordered_map<std::string, Texture2D::PixelFormat> pixelFormats = {
-        {"RGBA8888", Texture2D::PixelFormat::RGBA8888},
-        {"RGBA4444", Texture2D::PixelFormat::RGBA4444},
-        {"RGB5A1", Texture2D::PixelFormat::RGB5A1},
-        {"RGBA5551", Texture2D::PixelFormat::RGB5A1},
-        {"RGB565", Texture2D::PixelFormat::RGB565},
-        {"A8", Texture2D::PixelFormat::A8},
-        {"ALPHA", Texture2D::PixelFormat::A8},
-        {"I8", Texture2D::PixelFormat::I8},
-        {"AI88", Texture2D::PixelFormat::AI88},
-        {"ALPHA_INTENSITY", Texture2D::PixelFormat::AI88},
-        //{"BGRA8888", Texture2D::PixelFormat::BGRA8888}, no Image conversion RGBA -> BGRA
-        {"RGB888", Texture2D::PixelFormat::RGB888}
-    };
-
-    auto pixelFormatIt = pixelFormats.find(pixelFormatName);
-    if (pixelFormatIt != pixelFormats.end())
-    {
-        const Texture2D::PixelFormat pixelFormat = (*pixelFormatIt).second;
-        const Texture2D::PixelFormat currentPixelFormat = Texture2D::getDefaultAlphaPixelFormat();
-        Texture2D::setDefaultAlphaPixelFormat(pixelFormat);
-        texture = Director::getInstance()->getTextureCache()->addImage(texturePath);
-        Texture2D::setDefaultAlphaPixelFormat(currentPixelFormat);
-    }
-    else
-    {
-        texture = Director::getInstance()->getTextureCache()->addImage(texturePath);
-    }
+    Texture2D *texture = addAtlasTexture(texturePath, pixelFormatName);
     
     if (texture)
     {
@@ -330,6 +383,11 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dict, const std::
 void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist, Texture2D *texture)
 {
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
+    if (isBinaryAtlasFile(fullPath))
+    {
+        addSpriteFramesWithBinaryFile(fullPath, texture, "", plist);
+        return;
+    }
     ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
 
     addSpriteFramesWithDictionary(dict, texture, plist);
@@ -345,6 +403,11 @@ void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist, const s
 {
     CCASSERT(textureFileName.size()>0, "texture name should not be null");
     const std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
+    if (isBinaryAtlasFile(fullPath))
+    {
+        addSpriteFramesWithBinaryFile(fullPath, nullptr, textureFileName, plist);
+        return;
+    }
     ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
     addSpriteFramesWithDictionary(dict, textureFileName, plist);
 }
@@ -366,37 +429,145 @@ void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist)
         return;
     }
 
+    if (isBinaryAtlasFile(fullPath))
+    {
+        addSpriteFramesWithBinaryFile(fullPath, nullptr, "", plist);
+        return;
+    }
+
     ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
 
-    string texturePath("");
+    string textureFileName("");
 
     if (dict.find("metadata") != dict.end())
     {
         ValueMap& metadataDict = dict["metadata"].asValueMap();
         // try to read  texture file name from meta data
-        texturePath = metadataDict["textureFileName"].asString();
+        textureFileName = metadataDict["textureFileName"].asString();
     }
 
-    if (!texturePath.empty())
+    addSpriteFramesWithDictionary(dict, getAtlasTexturePath(textureFileName, plist), plist);
+}
+
+void SpriteFrameCache::addSpriteFramesWithBinaryFile(const std::string& fullPath, Texture2D *texture, const std::string &texturePath, const std::string &plist)
+{
+    // the frames are built from the mapped file, which is released once done
+    FileView data = FileUtils::getInstance()->mapFile(fullPath);
+    const spriteatlas::SpriteAtlas* atlas = getBinaryAtlas(data);
+    if (!atlas)
     {
-        // build texture path relative to plist file
-        texturePath = FileUtils::getInstance()->fullPathFromRelativeFile(texturePath, plist);
+        CCLOG("cocos2d: SpriteFrameCache: %s isn't a valid sprite atlas", plist.c_str());
+        return;
+    }
+
+    if (!texture)
+    {
+        std::string path = texturePath;
+        if (path.empty())
+        {
+            path = getAtlasTexturePath(atlas->textureFileName() ? atlas->textureFileName()->c_str() : "", plist);
+        }
+        texture = addAtlasTexture(path, atlas->pixelFormat() ? atlas->pixelFormat()->c_str() : "");
+    }
+
+    if (texture)
+    {
+        addSpriteFramesWithBinary(atlas, texture, plist, false);
     }
     else
     {
-        // build texture path by replacing file extension
-        texturePath = plist;
+        CCLOG("cocos2d: SpriteFrameCache: Couldn't load texture");
+    }
+}
 
-        // remove .xxx
-        size_t startPos = texturePath.find_last_of('.'); 
-        texturePath = texturePath.erase(startPos);
+void SpriteFrameCache::addSpriteFramesWithBinary(const spriteatlas::SpriteAtlas* atlas, Texture2D *texture, const std::string &plist, bool reload)
+{
+    auto frames = atlas->frames();
+    if (!frames)
+        return;
 
-        // append .png
-        texturePath = texturePath.append(".png");
+    Size textureSize;
+    if (atlas->textureSize())
+    {
+        textureSize.setSize(atlas->textureSize()->width(), atlas->textureSize()->height());
+    }
 
-        CCLOG("cocos2d: SpriteFrameCache: Trying to use file %s as texture", texturePath.c_str());
+    auto textureFileName = Director::getInstance()->getTextureCache()->getTextureFilePath(texture);
+    Image* image = nullptr;
+    NinePatchImageParser parser;
+    for (flatbuffers::uoffset_t i = 0, count = frames->size(); i < count; ++i)
+    {
+        auto frameData = frames->Get(i);
+        if (!frameData->name() || !frameData->rect())
+            continue;
+
+        std::string spriteFrameName = frameData->name()->c_str();
+        if (reload)
+        {
+            _spriteFramesCache.eraseFrame(spriteFrameName);
+        }
+        else if (_spriteFramesCache.at(spriteFrameName))
+        {
+            continue;
+        }
+
+        auto rect = frameData->rect();
+        auto offset = frameData->offset();
+        auto sourceSize = frameData->sourceSize();
+        Size spriteSourceSize = sourceSize ? Size(sourceSize->width(), sourceSize->height()) : Size(rect->width(), rect->height());
+
+        SpriteFrame* spriteFrame = SpriteFrame::createWithTexture(texture,
+                                                                  Rect(rect->x(), rect->y(), rect->width(), rect->height()),
+                                                                  frameData->rotated() != 0,
+                                                                  offset ? Vec2(offset->x(), offset->y()) : Vec2::ZERO,
+                                                                  spriteSourceSize);
+
+        if (frameData->aliases())
+        {
+            for (auto alias : *frameData->aliases())
+            {
+                std::string oneAlias = alias->c_str();
+                if (_spriteFramesAliases.find(oneAlias) != _spriteFramesAliases.end())
+                {
+                    CCLOGWARN("cocos2d: WARNING: an alias with name %s already exists", oneAlias.c_str());
+                }
+
+                _spriteFramesAliases[oneAlias] = Value(spriteFrameName);
+            }
+        }
+
+        if (frameData->vertices() && frameData->verticesUV() && frameData->triangles())
+        {
+            std::vector<int> vertices(frameData->vertices()->begin(), frameData->vertices()->end());
+            std::vector<int> verticesUV(frameData->verticesUV()->begin(), frameData->verticesUV()->end());
+            std::vector<int> indices(frameData->triangles()->begin(), frameData->triangles()->end());
+
+            PolygonInfo info;
+            initializePolygonInfo(textureSize, spriteSourceSize, vertices, verticesUV, indices, info);
+            spriteFrame->setPolygonInfo(info);
+        }
+        if (frameData->anchor())
+        {
+            spriteFrame->setAnchorPoint(Vec2(frameData->anchor()->x(), frameData->anchor()->y()));
+        }
+
+        if (!reload && NinePatchImageParser::isNinePatchImage(spriteFrameName))
+        {
+            if (image == nullptr) {
+                image = new (std::nothrow) Image();
+                image->initWithImageFile(textureFileName);
+            }
+            parser.setSpriteFrameInfo(image, spriteFrame->getRectInPixels(), spriteFrame->isRotated());
+            texture->addSpriteFrameCapInset(spriteFrame, parser.parseCapInset());
+        }
+        // add sprite frame
+        _spriteFramesCache.insertFrame(plist, spriteFrameName, spriteFrame);
     }
-    addSpriteFramesWithDictionary(dict, texturePath, plist);
+    if (!reload)
+    {
+        _spriteFramesCache.markPlistFull(plist, true);
+    }
+    CC_SAFE_DELETE(image);
 }
 
 bool SpriteFrameCache::isSpriteFramesWithFileLoaded(const std::string& plist) const
@@ -462,6 +633,32 @@ void SpriteFrameCache::removeSpriteFrameByName(const std::string& name)
 void SpriteFrameCache::removeSpriteFramesFromFile(const std::string& plist)
 {
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
+    if (isBinaryAtlasFile(fullPath))
+    {
+        FileView data = FileUtils::getInstance()->mapFile(fullPath);
+        const spriteatlas::SpriteAtlas* atlas = getBinaryAtlas(data);
+        if (!atlas)
+        {
+            CCLOG("cocos2d:SpriteFrameCache:removeSpriteFramesFromFile: %s isn't a valid sprite atlas.",plist.c_str());
+            return;
+        }
+
+        std::vector<std::string> keysToRemove;
+        if (atlas->frames())
+        {
+            for (auto frameData : *atlas->frames())
+            {
+                if (frameData->name() && _spriteFramesCache.at(frameData->name()->c_str()))
+                {
+                    keysToRemove.push_back(frameData->name()->c_str());
+                }
+            }
+        }
+        _spriteFramesCache.eraseFrames(keysToRemove);
+        _spriteFramesCache.erasePlistIndex(plist);
+        return;
+    }
+
     ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
     if (dict.empty())
     {
@@ -668,40 +865,49 @@ bool SpriteFrameCache::reloadTexture(const std::string& plist)
     }
 
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
-    ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
-
-    string texturePath("");
+    FileView data;
+    const spriteatlas::SpriteAtlas* atlas = nullptr;
+    ValueMap dict;
 
-    if (dict.find("metadata") != dict.end())
-    {
-        ValueMap& metadataDict = dict["metadata"].asValueMap();
-        // try to read  texture file name from meta data
-        texturePath = metadataDict["textureFileName"].asString();
-    }
+    string textureFileName("");
 
-    if (!texturePath.empty())
+    if (isBinaryAtlasFile(fullPath))
     {
-        // build texture path relative to plist file
-        texturePath = FileUtils::getInstance()->fullPathFromRelativeFile(texturePath, plist);
+        data = FileUtils::getInstance()->mapFile(fullPath);
+        atlas = getBinaryAtlas(data);
+        if (!atlas)
+        {
+            CCLOG("cocos2d: SpriteFrameCache: %s isn't a valid sprite atlas", plist.c_str());
+            return false;
+        }
+        if (atlas->textureFileName())
+        {
+            textureFileName = atlas->textureFileName()->c_str();
+        }
     }
     else
     {
-        // build texture path by replacing file extension
-        texturePath = plist;
+        dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
 
-        // remove .xxx
-        size_t startPos = texturePath.find_last_of('.');
-        texturePath = texturePath.erase(startPos);
-
-        // append .png
-        texturePath = texturePath.append(".png");
+        if (dict.find("metadata") != dict.end())
+        {
+            ValueMap& metadataDict = dict["metadata"].asValueMap();
+            // try to read  texture file name from meta data
+            textureFileName = metadataDict["textureFileName"].asString();
+        }
     }
 
+    std::string texturePath = getAtlasTexturePath(textureFileName, plist);
+
     Texture2D *texture = nullptr;
     if (Director::getInstance()->getTextureCache()->reloadTexture(texturePath))
         texture = Director::getInstance()->getTextureCache()->getTextureForKey(texturePath);
 
-    if (texture)
+    if (texture && atlas)
+    {
+        addSpriteFramesWithBinary(atlas, texture, plist, true);
+    }
+    else if (texture)
     {
         reloadSpriteFramesWithDictionary(dict, texture, plist);
     }
@@ -45,6 +45,10 @@ class Sprite;
 class Texture2D;
 class PolygonInfo;
 
+namespace spriteatlas {
+struct SpriteAtlas;
+}
+
 /**
  * @addtogroup _2d
  * @{
@@ -82,6 +86,12 @@ class PolygonInfo;
  Use one of the following tools to create the .plist file and sprite sheet:
  - [TexturePacker](https://www.codeandweb.com/texturepacker/cocos2d)
  - [Zwoptex](https://zwopple.com/zwoptex/)
+
+ The .plist files can be converted to binary atlases (.ccsa) with tools/sprite-atlas/plist2ccsa.py.
+ They contain the same frames in a FlatBuffers file (see 2d/fbs-files/SpriteAtlasBinary.fbs) which
+ is read in place, without parsing XML. Files with the .ccsa extension are loaded as binary atlases
+ by all the methods taking a plist file name, so a plist can be replaced by its binary atlas through
+ the filename lookup dictionary of FileUtils.
  
  @since v0.9
  @js cc.spriteFrameCache
@@ -314,6 +324,14 @@ protected:
 
     void reloadSpriteFramesWithDictionary(ValueMap& dictionary, Texture2D *texture, const std::string &plist);
 
+    /** Adds the Sprite Frames of a binary atlas (.ccsa) file.
+     * The texture of the atlas is loaded when texture is nullptr and texturePath is empty.
+     */
+    void addSpriteFramesWithBinaryFile(const std::string& fullPath, Texture2D *texture, const std::string &texturePath, const std::string &plist);
+
+    /** Adds, or replaces when reload is true, the Sprite Frames of a binary atlas. */
+    void addSpriteFramesWithBinary(const spriteatlas::SpriteAtlas* atlas, Texture2D *texture, const std::string &plist, bool reload);
+
     ValueMap _spriteFramesAliases;
     PlistFramesCache _spriteFramesCache;
 };
@@ -0,0 +1,237 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/CCTMXBinaryMap.h"
+
+#include <string.h>
+#include <zlib.h>
+
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+/*
+ * Map layout, little endian:
+ *
+ * header (48 bytes)
+ *   0  char[4]  magic "CCTM"
+ *   4  uint32   version
+ *   8  uint32   chunk size, in tiles
+ *   12 uint32   layer count
+ *   16 uint64   offset of the map XML, UTF-8
+ *   24 uint32   size of the map XML
+ *   28 uint32   reserved
+ *   32 uint64   offset of the layers, layer[layer count]
+ *   40 uint64   reserved
+ *
+ * layer (32 bytes)
+ *   0  uint32   width, in tiles
+ *   4  uint32   height, in tiles
+ *   8  uint32   chunk columns
+ *   12 uint32   chunk rows
+ *   16 uint64   offset of the chunks, chunk[columns * rows] by row
+ *   24 uint32   first tile of the layer in row order, 0 if the layer is empty
+ *   28 uint32   reserved
+ *
+ * chunk (16 bytes)
+ *   0  uint64   offset of the data in the file
+ *   8  uint32   size of the data, 0 if the chunk is empty
+ *   12 uint32   reserved
+ *
+ * The data of a chunk is zlib compressed, chunk size x chunk size uint32 GIDs by row,
+ * the tiles out of the layer are 0. The layers are in the order of the <layer> elements
+ * of the XML, which have no <data>.
+ */
+namespace
+{
+    const char MAP_MAGIC[4] = { 'C', 'C', 'T', 'M' };
+    const uint32_t MAP_VERSION = 1;
+    const size_t HEADER_SIZE = 48;
+    const size_t LAYER_SIZE = 32;
+    const size_t CHUNK_SIZE = 16;
+
+    inline uint32_t readU32(const unsigned char* p)
+    {
+        uint32_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    inline uint64_t readU64(const unsigned char* p)
+    {
+        uint64_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+}
+
+TMXBinaryMap* TMXBinaryMap::create(const std::string& filename)
+{
+    TMXBinaryMap* map = new (std::nothrow) TMXBinaryMap();
+    if (map && map->initWithFile(filename))
+    {
+        map->autorelease();
+        return map;
+    }
+    CC_SAFE_DELETE(map);
+    return nullptr;
+}
+
+TMXBinaryMap::TMXBinaryMap()
+: _chunkSize(0)
+, _layerCount(0)
+, _layers(nullptr)
+, _xml(nullptr)
+, _xmlSize(0)
+{
+}
+
+TMXBinaryMap::~TMXBinaryMap()
+{
+}
+
+bool TMXBinaryMap::initWithFile(const std::string& filename)
+{
+    _path = FileUtils::getInstance()->fullPathForFilename(filename);
+    _data = FileUtils::getInstance()->mapFile(_path);
+    if (_data.getSize() < (ssize_t)HEADER_SIZE)
+    {
+        CCLOG("TMXBinaryMap: can't read %s", filename.c_str());
+        return false;
+    }
+
+    const unsigned char* bytes = _data.getBytes();
+    const uint64_t size = _data.getSize();
+    if (memcmp(bytes, MAP_MAGIC, sizeof(MAP_MAGIC)) != 0 || readU32(bytes + 4) != MAP_VERSION)
+    {
+        CCLOG("TMXBinaryMap: %s isn't a binary map of version %u", filename.c_str(), MAP_VERSION);
+        return false;
+    }
+
+    _chunkSize = readU32(bytes + 8);
+    _layerCount = readU32(bytes + 12);
+    const uint64_t xmlOffset = readU64(bytes + 16);
+    _xmlSize = readU32(bytes + 24);
+    const uint64_t layersOffset = readU64(bytes + 32);
+
+    // the layers must be in the file, the chunks are checked when read
+    if (_chunkSize == 0
+        || xmlOffset + _xmlSize > size
+        || layersOffset + (uint64_t)_layerCount * LAYER_SIZE > size)
+    {
+        CCLOG("TMXBinaryMap: %s is corrupted", filename.c_str());
+        return false;
+    }
+
+    _xml = bytes + xmlOffset;
+    _layers = bytes + layersOffset;
+    for (uint32_t i = 0; i < _layerCount; ++i)
+    {
+        const unsigned char* layer = _layers + (size_t)i * LAYER_SIZE;
+        const uint64_t columns = readU32(layer + 8);
+        const uint64_t rows = readU32(layer + 12);
+        if (columns * _chunkSize < readU32(layer) || rows * _chunkSize < readU32(layer + 4)
+            || readU64(layer + 16) + columns * rows * CHUNK_SIZE > size)
+        {
+            CCLOG("TMXBinaryMap: %s is corrupted", filename.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string TMXBinaryMap::getMapXML() const
+{
+    return std::string((const char*)_xml, _xmlSize);
+}
+
+const unsigned char* TMXBinaryMap::getLayerEntry(int layer) const
+{
+    if (layer < 0 || layer >= (int)_layerCount)
+        return nullptr;
+    return _layers + (size_t)layer * LAYER_SIZE;
+}
+
+const unsigned char* TMXBinaryMap::getChunkEntry(int layer, int column, int row) const
+{
+    const unsigned char* entry = getLayerEntry(layer);
+    if (!entry)
+        return nullptr;
+
+    const int columns = (int)readU32(entry + 8);
+    const int rows = (int)readU32(entry + 12);
+    if (column < 0 || column >= columns || row < 0 || row >= rows)
+        return nullptr;
+    return _data.getBytes() + readU64(entry + 16) + ((size_t)row * columns + column) * CHUNK_SIZE;
+}
+
+Size TMXBinaryMap::getLayerSize(int layer) const
+{
+    const unsigned char* entry = getLayerEntry(layer);
+    return entry ? Size((float)readU32(entry), (float)readU32(entry + 4)) : Size::ZERO;
+}
+
+uint32_t TMXBinaryMap::getLayerSampleGID(int layer) const
+{
+    const unsigned char* entry = getLayerEntry(layer);
+    return entry ? readU32(entry + 24) : 0;
+}
+
+bool TMXBinaryMap::isChunkEmpty(int layer, int column, int row) const
+{
+    const unsigned char* chunk = getChunkEntry(layer, column, row);
+    return !chunk || readU32(chunk + 8) == 0;
+}
+
+bool TMXBinaryMap::readChunk(int layer, int column, int row, uint32_t* tiles) const
+{
+    const size_t tilesSize = (size_t)_chunkSize * _chunkSize * sizeof(uint32_t);
+    const unsigned char* chunk = getChunkEntry(layer, column, row);
+    if (!chunk)
+    {
+        memset(tiles, 0, tilesSize);
+        return false;
+    }
+
+    const uint64_t offset = readU64(chunk);
+    const uint32_t compressedSize = readU32(chunk + 8);
+    if (compressedSize == 0)
+    {
+        memset(tiles, 0, tilesSize);
+        return true;
+    }
+
+    uLongf destLen = (uLongf)tilesSize;
+    if (offset + compressedSize > (uint64_t)_data.getSize()
+        || uncompress((Bytef*)tiles, &destLen, _data.getBytes() + offset, compressedSize) != Z_OK
+        || destLen != tilesSize)
+    {
+        CCLOG("TMXBinaryMap: chunk %d,%d of layer %d is corrupted in %s", column, row, layer, _path.c_str());
+        memset(tiles, 0, tilesSize);
+        return false;
+    }
+    return true;
+}
+
+NS_CC_END
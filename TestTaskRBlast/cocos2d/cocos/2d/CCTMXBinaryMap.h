@@ -0,0 +1,123 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCTMX_BINARY_MAP_H__
+#define __CCTMX_BINARY_MAP_H__
+
+#include <string>
+#include <cstdint>
+
+#include "base/CCRef.h"
+#include "math/CCGeometry.h"
+#include "platform/CCFileUtils.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup tilemap_parallax_nodes
+ * @{
+ */
+
+/**
+ * Binary tile map (.cctmb), built from a TMX file by tools/tmx-binary/tmx2cctmb.py.
+ *
+ * The file keeps the XML of the map without the tiles of its layers, parsed by TMXMapInfo,
+ * and the tiles of each layer split in square chunks compressed independently with zlib.
+ * The file is memory mapped and a chunk is only decompressed when it is read, so opening a
+ * map doesn't depend on its size.
+ *
+ * The methods are const and share no state, different threads can read chunks at the same time.
+ *
+ * Binary maps are usually loaded with experimental::TMXTiledMap::create(), which streams the
+ * chunks around the camera.
+ *
+ * @since v3.17
+ */
+class CC_DLL TMXBinaryMap : public Ref
+{
+public:
+    /**
+     * Opens a binary map.
+     *
+     * @param filename The path of the map, resolved with FileUtils.
+     * @return An autorelease object, or nullptr if the file can't be read.
+     */
+    static TMXBinaryMap* create(const std::string& filename);
+
+    TMXBinaryMap();
+    virtual ~TMXBinaryMap();
+
+    /** Opens a binary map, see create(). */
+    bool initWithFile(const std::string& filename);
+
+    /** Gets the full path of the map file. */
+    const std::string& getPath() const { return _path; }
+
+    /** Gets the XML of the map, its layers have no tiles. */
+    std::string getMapXML() const;
+
+    /** Gets the width and height of the chunks, in tiles. */
+    int getChunkSize() const { return (int)_chunkSize; }
+
+    /** Gets the number of tile layers, in the order of the XML. */
+    int getLayerCount() const { return (int)_layerCount; }
+
+    /** Gets the size of a layer in tiles. */
+    Size getLayerSize(int layer) const;
+
+    /** Gets the first tile of a layer in row order, 0 if the layer is empty. It gives the tileset of the layer. */
+    uint32_t getLayerSampleGID(int layer) const;
+
+    /** Whether a chunk of a layer has no tile. */
+    bool isChunkEmpty(int layer, int column, int row) const;
+
+    /**
+     * Decompresses the tiles of a chunk.
+     *
+     * @param tiles ChunkSize x ChunkSize GIDs with their flags, by row. The tiles out of the layer are 0.
+     * @return True if successful, the tiles are 0 otherwise.
+     */
+    bool readChunk(int layer, int column, int row, uint32_t* tiles) const;
+
+private:
+    /** Gets the entry of a layer, nullptr if the index is out of range. */
+    const unsigned char* getLayerEntry(int layer) const;
+    /** Gets the entry of a chunk, nullptr if it is out of the layer. */
+    const unsigned char* getChunkEntry(int layer, int column, int row) const;
+
+    FileView _data;
+    std::string _path;
+    uint32_t _chunkSize;
+    uint32_t _layerCount;
+    const unsigned char* _layers;
+    const unsigned char* _xml;
+    uint32_t _xmlSize;
+};
+
+// end of tilemap_parallax_nodes group
+/// @}
+
+NS_CC_END
+
+#endif //__CCTMX_BINARY_MAP_H__
@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include <unordered_map>
 #include <sstream>
 #include "2d/CCTMXTiledMap.h"
+#include "2d/CCTMXBinaryMap.h"
 #include "base/ZipUtils.h"
 #include "base/base64.h"
 #include "base/CCDirector.h"
@@ -45,6 +46,8 @@ TMXLayerInfo::TMXLayerInfo()
 : _name("")
 , _tiles(nullptr)
 , _ownTiles(true)
+, _binaryMap(nullptr)
+, _binaryLayerIndex(-1)
 {
 }
 
@@ -56,6 +59,7 @@ TMXLayerInfo::~TMXLayerInfo()
         free(_tiles);
         _tiles = nullptr;
     }
+    CC_SAFE_RELEASE(_binaryMap);
 }
 
 ValueMap& TMXLayerInfo::getProperties()
@@ -127,6 +131,18 @@ TMXMapInfo * TMXMapInfo::createWithXML(const std::string& tmxString, const std::
     return nullptr;
 }
 
+TMXMapInfo * TMXMapInfo::createWithBinaryFile(const std::string& binaryFile)
+{
+    TMXMapInfo *ret = new (std::nothrow) TMXMapInfo();
+    if (ret->initWithBinaryFile(binaryFile))
+    {
+        ret->autorelease();
+        return ret;
+    }
+    CC_SAFE_DELETE(ret);
+    return nullptr;
+}
+
 void TMXMapInfo::internalInit(const std::string& tmxFileName, const std::string& resourcePath)
 {
     if (!tmxFileName.empty())
@@ -161,6 +177,36 @@ bool TMXMapInfo::initWithTMXFile(const std::string& tmxFile)
     return parseXMLFile(_TMXFileName);
 }
 
+bool TMXMapInfo::initWithBinaryFile(const std::string& binaryFile)
+{
+    // the images and external tilesets are relative to the binary map
+    internalInit(binaryFile, "");
+    TMXBinaryMap* binaryMap = TMXBinaryMap::create(_TMXFileName);
+    if (!binaryMap || !parseXMLString(binaryMap->getMapXML()))
+    {
+        return false;
+    }
+
+    if ((int)_layers.size() != binaryMap->getLayerCount())
+    {
+        CCLOG("cocos2d: TMXMapInfo: %s has %d layers of tiles for %d layers", binaryFile.c_str(), binaryMap->getLayerCount(), (int)_layers.size());
+        return false;
+    }
+    for (int i = 0; i < (int)_layers.size(); ++i)
+    {
+        TMXLayerInfo* layer = _layers.at(i);
+        if (!layer->_layerSize.equals(binaryMap->getLayerSize(i)))
+        {
+            CCLOG("cocos2d: TMXMapInfo: layer '%s' of %s has a wrong size", layer->_name.c_str(), binaryFile.c_str());
+            return false;
+        }
+        layer->_binaryMap = binaryMap;
+        layer->_binaryLayerIndex = i;
+        binaryMap->retain();
+    }
+    return true;
+}
+
 TMXMapInfo::TMXMapInfo()
 : _orientation(TMXOrientationOrtho)
 , _staggerAxis(TMXStaggerAxis_Y)
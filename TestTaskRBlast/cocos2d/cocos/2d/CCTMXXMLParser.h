@@ -44,6 +44,7 @@ NS_CC_BEGIN
 
 class TMXLayerInfo;
 class TMXTilesetInfo;
+class TMXBinaryMap;
 
 /** @file
 * Internal TMX parser
@@ -117,6 +118,9 @@ public:
     unsigned char       _opacity;
     bool                _ownTiles;
     Vec2               _offset;
+    //! binary map holding the tiles when _tiles is null, see TMXMapInfo::createWithBinaryFile()
+    TMXBinaryMap        *_binaryMap;
+    int                 _binaryLayerIndex;
 };
 
 /** @brief TMXTilesetInfo contains the information about the tilesets like:
@@ -178,6 +182,12 @@ public:
     /** creates a TMX Format with an XML string and a TMX resource path */
     static TMXMapInfo * createWithXML(const std::string& tmxString, const std::string& resourcePath);
     
+    /** creates a TMX Format with a binary map (.cctmb). The layers have no tiles, they are read from the
+     * binary map of the layer info by chunks.
+     * @since v3.17
+     */
+    static TMXMapInfo * createWithBinaryFile(const std::string& binaryFile);
+    
     /** creates a TMX Format with a tmx file */
     CC_DEPRECATED_ATTRIBUTE static TMXMapInfo * formatWithTMXFile(const char *tmxFile) { return TMXMapInfo::create(tmxFile); };
     /** creates a TMX Format with an XML string and a TMX resource path */
@@ -196,6 +206,10 @@ public:
     bool initWithTMXFile(const std::string& tmxFile);
     /** initializes a TMX format with an XML string and a TMX resource path */
     bool initWithXML(const std::string& tmxString, const std::string& resourcePath);
+    /** initializes a TMX format with a binary map (.cctmb)
+     * @since v3.17
+     */
+    bool initWithBinaryFile(const std::string& binaryFile);
     /** initializes parsing of an XML file, either a tmx (Map) file or tsx (Tileset) file */
     bool parseXMLFile(const std::string& xmlFilename);
     /* initializes parsing of an XML string, either a tmx (Map) string or tsx (Tileset) string */
@@ -0,0 +1,225 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+// automatically generated by the FlatBuffers compiler, do not modify
+
+#ifndef FLATBUFFERS_GENERATED_SPRITEATLASBINARY_COCOS2D_SPRITEATLAS_H_
+#define FLATBUFFERS_GENERATED_SPRITEATLASBINARY_COCOS2D_SPRITEATLAS_H_
+
+#include "flatbuffers/flatbuffers.h"
+
+
+namespace cocos2d {
+namespace spriteatlas {
+
+struct AtlasPoint;
+struct AtlasSize;
+struct AtlasRect;
+struct AtlasFrame;
+struct SpriteAtlas;
+
+MANUALLY_ALIGNED_STRUCT(4) AtlasPoint {
+ private:
+  float x_;
+  float y_;
+
+ public:
+  AtlasPoint(float x, float y)
+    : x_(flatbuffers::EndianScalar(x)), y_(flatbuffers::EndianScalar(y)) { }
+
+  float x() const { return flatbuffers::EndianScalar(x_); }
+  float y() const { return flatbuffers::EndianScalar(y_); }
+};
+STRUCT_END(AtlasPoint, 8);
+
+MANUALLY_ALIGNED_STRUCT(4) AtlasSize {
+ private:
+  float width_;
+  float height_;
+
+ public:
+  AtlasSize(float width, float height)
+    : width_(flatbuffers::EndianScalar(width)), height_(flatbuffers::EndianScalar(height)) { }
+
+  float width() const { return flatbuffers::EndianScalar(width_); }
+  float height() const { return flatbuffers::EndianScalar(height_); }
+};
+STRUCT_END(AtlasSize, 8);
+
+MANUALLY_ALIGNED_STRUCT(4) AtlasRect {
+ private:
+  float x_;
+  float y_;
+  float width_;
+  float height_;
+
+ public:
+  AtlasRect(float x, float y, float width, float height)
+    : x_(flatbuffers::EndianScalar(x)), y_(flatbuffers::EndianScalar(y)), width_(flatbuffers::EndianScalar(width)), height_(flatbuffers::EndianScalar(height)) { }
+
+  float x() const { return flatbuffers::EndianScalar(x_); }
+  float y() const { return flatbuffers::EndianScalar(y_); }
+  float width() const { return flatbuffers::EndianScalar(width_); }
+  float height() const { return flatbuffers::EndianScalar(height_); }
+};
+STRUCT_END(AtlasRect, 16);
+
+struct AtlasFrame : private flatbuffers::Table {
+  const flatbuffers::String *name() const { return GetPointer<const flatbuffers::String *>(4); }
+  const AtlasRect *rect() const { return GetStruct<const AtlasRect *>(6); }
+  uint8_t rotated() const { return GetField<uint8_t>(8, 0); }
+  const AtlasPoint *offset() const { return GetStruct<const AtlasPoint *>(10); }
+  const AtlasSize *sourceSize() const { return GetStruct<const AtlasSize *>(12); }
+  const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *aliases() const { return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *>(14); }
+  const AtlasPoint *anchor() const { return GetStruct<const AtlasPoint *>(16); }
+  const flatbuffers::Vector<int32_t> *vertices() const { return GetPointer<const flatbuffers::Vector<int32_t> *>(18); }
+  const flatbuffers::Vector<int32_t> *verticesUV() const { return GetPointer<const flatbuffers::Vector<int32_t> *>(20); }
+  const flatbuffers::Vector<int32_t> *triangles() const { return GetPointer<const flatbuffers::Vector<int32_t> *>(22); }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 4 /* name */) &&
+           verifier.Verify(name()) &&
+           VerifyField<AtlasRect>(verifier, 6 /* rect */) &&
+           VerifyField<uint8_t>(verifier, 8 /* rotated */) &&
+           VerifyField<AtlasPoint>(verifier, 10 /* offset */) &&
+           VerifyField<AtlasSize>(verifier, 12 /* sourceSize */) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 14 /* aliases */) &&
+           verifier.Verify(aliases()) &&
+           verifier.VerifyVectorOfStrings(aliases()) &&
+           VerifyField<AtlasPoint>(verifier, 16 /* anchor */) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 18 /* vertices */) &&
+           verifier.Verify(vertices()) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 20 /* verticesUV */) &&
+           verifier.Verify(verticesUV()) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 22 /* triangles */) &&
+           verifier.Verify(triangles()) &&
+           verifier.EndTable();
+  }
+};
+
+struct AtlasFrameBuilder {
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_name(flatbuffers::Offset<flatbuffers::String> name) { fbb_.AddOffset(4, name); }
+  void add_rect(const AtlasRect *rect) { fbb_.AddStruct(6, rect); }
+  void add_rotated(uint8_t rotated) { fbb_.AddElement<uint8_t>(8, rotated, 0); }
+  void add_offset(const AtlasPoint *offset) { fbb_.AddStruct(10, offset); }
+  void add_sourceSize(const AtlasSize *sourceSize) { fbb_.AddStruct(12, sourceSize); }
+  void add_aliases(flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>> aliases) { fbb_.AddOffset(14, aliases); }
+  void add_anchor(const AtlasPoint *anchor) { fbb_.AddStruct(16, anchor); }
+  void add_vertices(flatbuffers::Offset<flatbuffers::Vector<int32_t>> vertices) { fbb_.AddOffset(18, vertices); }
+  void add_verticesUV(flatbuffers::Offset<flatbuffers::Vector<int32_t>> verticesUV) { fbb_.AddOffset(20, verticesUV); }
+  void add_triangles(flatbuffers::Offset<flatbuffers::Vector<int32_t>> triangles) { fbb_.AddOffset(22, triangles); }
+  AtlasFrameBuilder(flatbuffers::FlatBufferBuilder &_fbb) : fbb_(_fbb) { start_ = fbb_.StartTable(); }
+  AtlasFrameBuilder &operator=(const AtlasFrameBuilder &);
+  flatbuffers::Offset<AtlasFrame> Finish() {
+    auto o = flatbuffers::Offset<AtlasFrame>(fbb_.EndTable(start_, 10));
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<AtlasFrame> CreateAtlasFrame(flatbuffers::FlatBufferBuilder &_fbb,
+   flatbuffers::Offset<flatbuffers::String> name = 0,
+   const AtlasRect *rect = 0,
+   uint8_t rotated = 0,
+   const AtlasPoint *offset = 0,
+   const AtlasSize *sourceSize = 0,
+   flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>> aliases = 0,
+   const AtlasPoint *anchor = 0,
+   flatbuffers::Offset<flatbuffers::Vector<int32_t>> vertices = 0,
+   flatbuffers::Offset<flatbuffers::Vector<int32_t>> verticesUV = 0,
+   flatbuffers::Offset<flatbuffers::Vector<int32_t>> triangles = 0) {
+  AtlasFrameBuilder builder_(_fbb);
+  builder_.add_triangles(triangles);
+  builder_.add_verticesUV(verticesUV);
+  builder_.add_vertices(vertices);
+  builder_.add_anchor(anchor);
+  builder_.add_aliases(aliases);
+  builder_.add_sourceSize(sourceSize);
+  builder_.add_offset(offset);
+  builder_.add_rect(rect);
+  builder_.add_name(name);
+  builder_.add_rotated(rotated);
+  return builder_.Finish();
+}
+
+struct SpriteAtlas : private flatbuffers::Table {
+  const flatbuffers::String *textureFileName() const { return GetPointer<const flatbuffers::String *>(4); }
+  const flatbuffers::String *pixelFormat() const { return GetPointer<const flatbuffers::String *>(6); }
+  const AtlasSize *textureSize() const { return GetStruct<const AtlasSize *>(8); }
+  const flatbuffers::Vector<flatbuffers::Offset<AtlasFrame>> *frames() const { return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<AtlasFrame>> *>(10); }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 4 /* textureFileName */) &&
+           verifier.Verify(textureFileName()) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 6 /* pixelFormat */) &&
+           verifier.Verify(pixelFormat()) &&
+           VerifyField<AtlasSize>(verifier, 8 /* textureSize */) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 10 /* frames */) &&
+           verifier.Verify(frames()) &&
+           verifier.VerifyVectorOfTables(frames()) &&
+           verifier.EndTable();
+  }
+};
+
+struct SpriteAtlasBuilder {
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_textureFileName(flatbuffers::Offset<flatbuffers::String> textureFileName) { fbb_.AddOffset(4, textureFileName); }
+  void add_pixelFormat(flatbuffers::Offset<flatbuffers::String> pixelFormat) { fbb_.AddOffset(6, pixelFormat); }
+  void add_textureSize(const AtlasSize *textureSize) { fbb_.AddStruct(8, textureSize); }
+  void add_frames(flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<AtlasFrame>>> frames) { fbb_.AddOffset(10, frames); }
+  SpriteAtlasBuilder(flatbuffers::FlatBufferBuilder &_fbb) : fbb_(_fbb) { start_ = fbb_.StartTable(); }
+  SpriteAtlasBuilder &operator=(const SpriteAtlasBuilder &);
+  flatbuffers::Offset<SpriteAtlas> Finish() {
+    auto o = flatbuffers::Offset<SpriteAtlas>(fbb_.EndTable(start_, 4));
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<SpriteAtlas> CreateSpriteAtlas(flatbuffers::FlatBufferBuilder &_fbb,
+   flatbuffers::Offset<flatbuffers::String> textureFileName = 0,
+   flatbuffers::Offset<flatbuffers::String> pixelFormat = 0,
+   const AtlasSize *textureSize = 0,
+   flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<AtlasFrame>>> frames = 0) {
+  SpriteAtlasBuilder builder_(_fbb);
+  builder_.add_frames(frames);
+  builder_.add_textureSize(textureSize);
+  builder_.add_pixelFormat(pixelFormat);
+  builder_.add_textureFileName(textureFileName);
+  return builder_.Finish();
+}
+
+inline const SpriteAtlas *GetSpriteAtlas(const void *buf) { return flatbuffers::GetRoot<SpriteAtlas>(buf); }
+
+inline bool VerifySpriteAtlasBuffer(flatbuffers::Verifier &verifier) { return verifier.VerifyBuffer<SpriteAtlas>(); }
+
+inline void FinishSpriteAtlasBuffer(flatbuffers::FlatBufferBuilder &fbb, flatbuffers::Offset<SpriteAtlas> root) { fbb.Finish(root, "CCSA"); }
+
+inline bool SpriteAtlasBufferHasIdentifier(const void *buf) { return flatbuffers::BufferHasIdentifier(buf, "CCSA"); }
+
+}  // namespace spriteatlas
+}  // namespace cocos2d
+
+#endif  // FLATBUFFERS_GENERATED_SPRITEATLASBINARY_COCOS2D_SPRITEATLAS_H_
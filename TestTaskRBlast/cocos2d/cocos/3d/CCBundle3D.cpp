@@ -1081,7 +1081,7 @@ bool Bundle3D::loadBinary(const std::string& path)
     
     // get file data
     _binaryBuffer.clear();
-    _binaryBuffer = FileUtils::getInstance()->getDataFromFile(path);
+    _binaryBuffer = FileUtils::getInstance()->mapFile(path);
     if (_binaryBuffer.isNull())
     {
         clear();
@@ -1090,6 +1090,7 @@ bool Bundle3D::loadBinary(const std::string& path)
     }
     
     // Initialise bundle reader
+    // BundleReader only reads the buffer
     _binaryReader.init( (char*)_binaryBuffer.getBytes(),  _binaryBuffer.getSize() );
     
     // Read identifier info
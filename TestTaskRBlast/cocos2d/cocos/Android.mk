@@ -48,6 +48,7 @@ cocos2d.cpp \
 2d/CCFontCharMap.cpp \
 2d/CCFontFNT.cpp \
 2d/CCFontFreeType.cpp \
+2d/CCFontDistanceMap.cpp \
 2d/CCGLBufferedNode.cpp \
 2d/CCGrabber.cpp \
 2d/CCGrid.cpp \
@@ -68,6 +69,8 @@ cocos2d.cpp \
 2d/CCParticleExamples.cpp \
 2d/CCParticleSystem.cpp \
 2d/CCParticleSystemQuad.cpp \
+2d/CCParticleUpdateScheduler.cpp \
+2d/CCParticleKernels.cpp \
 2d/CCProgressTimer.cpp \
 2d/CCProtectedNode.cpp \
 2d/CCRenderTexture.cpp \
@@ -76,10 +79,12 @@ cocos2d.cpp \
 2d/CCSpriteBatchNode.cpp \
 2d/CCSpriteFrame.cpp \
 2d/CCSpriteFrameCache.cpp \
+2d/CCDynamicAtlas.cpp \
 2d/CCTMXLayer.cpp \
 2d/CCTMXObjectGroup.cpp \
 2d/CCTMXTiledMap.cpp \
 2d/CCTMXXMLParser.cpp \
+2d/CCTMXBinaryMap.cpp \
 2d/CCTextFieldTTF.cpp \
 2d/CCTileMapAtlas.cpp \
 2d/CCTransition.cpp \
@@ -120,6 +125,7 @@ base/CCEvent.cpp \
 base/CCEventAcceleration.cpp \
 base/CCEventController.cpp \
 base/CCEventCustom.cpp \
+base/CCEventChannel.cpp \
 base/CCEventDispatcher.cpp \
 base/CCEventFocus.cpp \
 base/CCEventKeyboard.cpp \
@@ -147,6 +153,7 @@ base/CCValue.cpp \
 base/ObjectFactory.cpp \
 base/TGAlib.cpp \
 base/ZipUtils.cpp \
+base/CCAssetPack.cpp \
 base/allocator/CCAllocatorDiagnostics.cpp \
 base/allocator/CCAllocatorGlobal.cpp \
 base/allocator/CCAllocatorGlobalNewDelete.cpp \
@@ -187,6 +194,7 @@ renderer/CCVertexAttribBinding.cpp \
 renderer/CCVertexIndexBuffer.cpp \
 renderer/CCVertexIndexData.cpp \
 renderer/ccGLStateCache.cpp \
+renderer/ccPixelConvert.cpp \
 renderer/CCFrameBuffer.cpp \
 renderer/ccShaders.cpp \
 vr/CCVRDistortion.cpp \
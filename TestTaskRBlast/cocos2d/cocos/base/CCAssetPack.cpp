@@ -0,0 +1,320 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "base/CCAssetPack.h"
+
+#include <string.h>
+#include <zlib.h>
+#include "xxhash.h"
+
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+/*
+ * Pack layout, little endian:
+ *
+ * header (64 bytes)
+ *   0  char[4]  magic "CCPK"
+ *   4  uint32   version
+ *   8  uint32   entry count
+ *   12 uint32   bucket count of the perfect hash
+ *   16 uint32   seed of the bucket hash
+ *   20 uint32   chunk size
+ *   24 uint32   chunk count
+ *   28 uint32   reserved
+ *   32 uint64   offset of the displacements, uint32[bucket count]
+ *   40 uint64   offset of the entries, entry[entry count] in perfect hash order
+ *   48 uint64   offset of the chunks, chunk[chunk count]
+ *   56 uint64   offset of the names, up to the end of the file
+ *
+ * entry (32 bytes)
+ *   0  uint32   name offset in the names
+ *   4  uint32   name length
+ *   8  uint32   codec
+ *   12 uint32   chunk count
+ *   16 uint64   size
+ *   24 uint32   first chunk
+ *   28 uint32   reserved
+ *
+ * chunk (16 bytes)
+ *   0  uint64   offset of the data in the file
+ *   8  uint32   size of the data, equal to the size when the chunk is stored
+ *   12 uint32   uncompressed size
+ *
+ * A name is hashed to a bucket with XXH32(name, seed) % bucket count. The displacement of
+ * the bucket gives its entry: with the high bit set, the low bits are the entry index,
+ * else the entry index is XXH32(name, displacement) % entry count.
+ */
+namespace
+{
+    const char PACK_MAGIC[4] = { 'C', 'C', 'P', 'K' };
+    const uint32_t PACK_VERSION = 1;
+    const size_t HEADER_SIZE = 64;
+    const size_t ENTRY_SIZE = 32;
+    const size_t CHUNK_SIZE = 16;
+    const uint32_t DIRECT_DISPLACEMENT = 0x80000000;
+
+    inline uint32_t readU32(const unsigned char* p)
+    {
+        uint32_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    inline uint64_t readU64(const unsigned char* p)
+    {
+        uint64_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+}
+
+AssetPack* AssetPack::createWithFile(const std::string& path)
+{
+    AssetPack* pack = new (std::nothrow) AssetPack();
+    if (pack && pack->initWithFile(path))
+    {
+        return pack;
+    }
+    CC_SAFE_DELETE(pack);
+    return nullptr;
+}
+
+AssetPack::AssetPack()
+: _entryCount(0)
+, _bucketCount(0)
+, _seed(0)
+, _chunkCount(0)
+, _displacements(nullptr)
+, _entries(nullptr)
+, _chunks(nullptr)
+, _names(nullptr)
+, _namesSize(0)
+{
+}
+
+AssetPack::~AssetPack()
+{
+}
+
+bool AssetPack::initWithFile(const std::string& path)
+{
+    _path = FileUtils::getInstance()->fullPathForFilename(path);
+    _data = FileUtils::getInstance()->mapFile(_path);
+    if (_data.getSize() < (ssize_t)HEADER_SIZE)
+    {
+        CCLOG("AssetPack: can't read %s", path.c_str());
+        return false;
+    }
+
+    const unsigned char* bytes = _data.getBytes();
+    const uint64_t size = _data.getSize();
+    if (memcmp(bytes, PACK_MAGIC, sizeof(PACK_MAGIC)) != 0 || readU32(bytes + 4) != PACK_VERSION)
+    {
+        CCLOG("AssetPack: %s isn't an asset pack of version %u", path.c_str(), PACK_VERSION);
+        return false;
+    }
+
+    _entryCount = readU32(bytes + 8);
+    _bucketCount = readU32(bytes + 12);
+    _seed = readU32(bytes + 16);
+    _chunkCount = readU32(bytes + 24);
+    const uint64_t displacementsOffset = readU64(bytes + 32);
+    const uint64_t entriesOffset = readU64(bytes + 40);
+    const uint64_t chunksOffset = readU64(bytes + 48);
+    const uint64_t namesOffset = readU64(bytes + 56);
+
+    // the directory must be in the file, the chunks and names are checked when read
+    if ((_entryCount > 0 && _bucketCount == 0)
+        || displacementsOffset + (uint64_t)_bucketCount * 4 > size
+        || entriesOffset + (uint64_t)_entryCount * ENTRY_SIZE > size
+        || chunksOffset + (uint64_t)_chunkCount * CHUNK_SIZE > size
+        || namesOffset > size)
+    {
+        CCLOG("AssetPack: %s is corrupted", path.c_str());
+        return false;
+    }
+
+    _displacements = bytes + displacementsOffset;
+    _entries = bytes + entriesOffset;
+    _chunks = bytes + chunksOffset;
+    _names = bytes + namesOffset;
+    _namesSize = (ssize_t)(size - namesOffset);
+    return true;
+}
+
+const unsigned char* AssetPack::findEntry(const std::string& name) const
+{
+    if (_entryCount == 0)
+        return nullptr;
+
+    const int length = (int)name.length();
+    const uint32_t bucket = XXH32(name.data(), length, _seed) % _bucketCount;
+    const uint32_t displacement = readU32(_displacements + bucket * 4);
+    const uint32_t index = (displacement & DIRECT_DISPLACEMENT)
+        ? (displacement & ~DIRECT_DISPLACEMENT)
+        : XXH32(name.data(), length, displacement) % _entryCount;
+    if (index >= _entryCount)
+        return nullptr;
+
+    // names which aren't in the pack hash to any entry
+    const unsigned char* entry = _entries + (size_t)index * ENTRY_SIZE;
+    const uint32_t nameOffset = readU32(entry);
+    const uint32_t nameLength = readU32(entry + 4);
+    if (nameLength != (uint32_t)length
+        || (uint64_t)nameOffset + nameLength > (uint64_t)_namesSize
+        || memcmp(_names + nameOffset, name.data(), length) != 0)
+    {
+        return nullptr;
+    }
+    return entry;
+}
+
+bool AssetPack::fileExists(const std::string& name) const
+{
+    return findEntry(name) != nullptr;
+}
+
+ssize_t AssetPack::getFileSize(const std::string& name) const
+{
+    const unsigned char* entry = findEntry(name);
+    return entry ? (ssize_t)readU64(entry + 16) : -1;
+}
+
+bool AssetPack::decompressEntry(const unsigned char* entry, unsigned char* out) const
+{
+    const uint32_t codec = readU32(entry + 8);
+    const uint32_t chunkCount = readU32(entry + 12);
+    const uint64_t size = readU64(entry + 16);
+    const uint32_t firstChunk = readU32(entry + 24);
+    if ((uint64_t)firstChunk + chunkCount > _chunkCount)
+        return false;
+
+    const uint64_t fileSize = _data.getSize();
+    uint64_t written = 0;
+    for (uint32_t i = 0; i < chunkCount; ++i)
+    {
+        const unsigned char* chunk = _chunks + (size_t)(firstChunk + i) * CHUNK_SIZE;
+        const uint64_t offset = readU64(chunk);
+        const uint32_t compressedSize = readU32(chunk + 8);
+        const uint32_t chunkSize = readU32(chunk + 12);
+        if (offset + compressedSize > fileSize || written + chunkSize > size)
+            return false;
+
+        const unsigned char* src = _data.getBytes() + offset;
+        if (compressedSize == chunkSize)
+        {
+            memcpy(out + written, src, chunkSize);
+        }
+        else if (codec == (uint32_t)Codec::ZLIB)
+        {
+            uLongf destLen = chunkSize;
+            if (uncompress(out + written, &destLen, src, compressedSize) != Z_OK || destLen != chunkSize)
+                return false;
+        }
+        else
+        {
+            CCLOG("AssetPack: unsupported codec %u in %s", codec, _path.c_str());
+            return false;
+        }
+        written += chunkSize;
+    }
+    return written == size;
+}
+
+FileView AssetPack::getFile(const std::string& name) const
+{
+    const unsigned char* entry = findEntry(name);
+    if (!entry)
+        return FileView();
+
+    const uint32_t chunkCount = readU32(entry + 12);
+    const uint64_t size = readU64(entry + 16);
+    const uint32_t firstChunk = readU32(entry + 24);
+
+    // stored files of one chunk are used in place
+    if (chunkCount == 1 && firstChunk < _chunkCount)
+    {
+        const unsigned char* chunk = _chunks + (size_t)firstChunk * CHUNK_SIZE;
+        const uint64_t offset = readU64(chunk);
+        const uint32_t compressedSize = readU32(chunk + 8);
+        if (compressedSize == size && offset + size <= (uint64_t)_data.getSize())
+        {
+            return _data.subView((ssize_t)offset, (ssize_t)size);
+        }
+    }
+
+    if (size == 0)
+        return FileView();
+
+    unsigned char* buffer = (unsigned char*)malloc((size_t)size);
+    if (!buffer)
+        return FileView();
+    if (!decompressEntry(entry, buffer))
+    {
+        CCLOG("AssetPack: %s is corrupted in %s", name.c_str(), _path.c_str());
+        free(buffer);
+        return FileView();
+    }
+    return FileView(buffer, (ssize_t)size, std::shared_ptr<const void>(buffer, free));
+}
+
+bool AssetPack::getFileData(const std::string& name, ResizableBuffer* buffer) const
+{
+    const unsigned char* entry = findEntry(name);
+    if (!entry)
+        return false;
+
+    const uint64_t size = readU64(entry + 16);
+    buffer->resize((size_t)size);
+    if (size == 0)
+        return true;
+    if (!decompressEntry(entry, (unsigned char*)buffer->buffer()))
+    {
+        CCLOG("AssetPack: %s is corrupted in %s", name.c_str(), _path.c_str());
+        buffer->resize(0);
+        return false;
+    }
+    return true;
+}
+
+std::vector<std::string> AssetPack::listFiles() const
+{
+    std::vector<std::string> files;
+    files.reserve(_entryCount);
+    for (uint32_t i = 0; i < _entryCount; ++i)
+    {
+        const unsigned char* entry = _entries + (size_t)i * ENTRY_SIZE;
+        const uint32_t nameOffset = readU32(entry);
+        const uint32_t nameLength = readU32(entry + 4);
+        if ((uint64_t)nameOffset + nameLength <= (uint64_t)_namesSize)
+        {
+            files.push_back(std::string((const char*)_names + nameOffset, nameLength));
+        }
+    }
+    return files;
+}
+
+NS_CC_END
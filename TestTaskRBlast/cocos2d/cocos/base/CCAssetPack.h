@@ -0,0 +1,134 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __BASE_CCASSETPACK_H__
+#define __BASE_CCASSETPACK_H__
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "platform/CCFileUtils.h"
+
+/**
+ * @addtogroup base
+ * @{
+ */
+
+NS_CC_BEGIN
+
+/**
+ * Read-only asset pack (.ccpk), built by tools/asset-pack/pack_assets.py.
+ *
+ * The pack file is memory mapped. Its directory is indexed by a minimal perfect hash,
+ * so a name is looked up with two hashes and one comparison. Files are split in chunks
+ * compressed independently with zlib, or stored when compression doesn't help; a stored
+ * file made of one chunk is returned in place, without copy.
+ *
+ * The methods are const and share no state, different threads can read and decompress
+ * files of the same pack at the same time.
+ *
+ * Asset packs are usually mounted with FileUtils::addAssetPack() and read through FileUtils.
+ *
+ * @since v3.17
+ */
+class CC_DLL AssetPack
+{
+public:
+    /** Compression of the chunks of a file. */
+    enum class Codec : uint32_t
+    {
+        STORED = 0,
+        ZLIB = 1,
+    };
+
+    /**
+     * Opens an asset pack.
+     *
+     * @param path The path of the pack, resolved with FileUtils.
+     * @return The pack, to delete, or nullptr if it can't be read.
+     */
+    static AssetPack* createWithFile(const std::string& path);
+
+    AssetPack();
+    virtual ~AssetPack();
+
+    /** Opens an asset pack, see createWithFile(). */
+    bool initWithFile(const std::string& path);
+
+    /** Gets the full path of the pack file. */
+    const std::string& getPath() const { return _path; }
+
+    /** Gets the number of files of the pack. */
+    uint32_t getFileCount() const { return _entryCount; }
+
+    /** Whether the pack contains a file, name is relative to the root of the pack. */
+    bool fileExists(const std::string& name) const;
+
+    /** Gets the uncompressed size of a file, -1 if it isn't in the pack. */
+    ssize_t getFileSize(const std::string& name) const;
+
+    /**
+     * Gets the contents of a file.
+     * Stored files are returned in place, compressed files are decompressed in a buffer owned by the view.
+     *
+     * @return A view of the contents, null if the file isn't in the pack or is corrupted.
+     */
+    FileView getFile(const std::string& name) const;
+
+    /**
+     * Decompresses a file in a buffer.
+     *
+     * @return True if successful.
+     */
+    bool getFileData(const std::string& name, ResizableBuffer* buffer) const;
+
+    /** Gets the names of the files of the pack. */
+    std::vector<std::string> listFiles() const;
+
+private:
+    /** Gets the directory entry of a file, nullptr if it isn't in the pack. */
+    const unsigned char* findEntry(const std::string& name) const;
+    /** Decompresses the chunks of an entry to out, which has the size of the file. */
+    bool decompressEntry(const unsigned char* entry, unsigned char* out) const;
+
+    FileView _data;
+    std::string _path;
+    uint32_t _entryCount;
+    uint32_t _bucketCount;
+    uint32_t _seed;
+    uint32_t _chunkCount;
+    const unsigned char* _displacements;
+    const unsigned char* _entries;
+    const unsigned char* _chunks;
+    const unsigned char* _names;
+    ssize_t _namesSize;
+};
+
+NS_CC_END
+
+// end group
+/// @}
+
+#endif // __BASE_CCASSETPACK_H__
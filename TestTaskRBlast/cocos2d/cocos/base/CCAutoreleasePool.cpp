@@ -26,8 +26,20 @@ THE SOFTWARE.
 #include "base/CCAutoreleasePool.h"
 #include "base/ccMacros.h"
 
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <xmmintrin.h>
+#define CC_POOL_PREFETCH(addr) _mm_prefetch(reinterpret_cast<const char*>(addr), _MM_HINT_T0)
+#elif defined(__GNUC__) || defined(__clang__)
+#define CC_POOL_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define CC_POOL_PREFETCH(addr) ((void)0)
+#endif
+
 NS_CC_BEGIN
 
+// How many objects ahead of the one being released are fetched while clearing
+static const size_t POOL_PREFETCH_DISTANCE = 8;
+
 AutoreleasePool::AutoreleasePool()
 : _name("")
 #if defined(COCOS2D_DEBUG) && (COCOS2D_DEBUG > 0)
@@ -58,20 +70,60 @@ AutoreleasePool::~AutoreleasePool()
 
 void AutoreleasePool::addObject(Ref* object)
 {
+#if CC_ENABLE_AUTORELEASE_ELISION
+    object->_autoreleaseSlot = static_cast<unsigned int>(_managedObjectArray.size());
+#endif
     _managedObjectArray.push_back(object);
 }
 
+#if CC_ENABLE_AUTORELEASE_ELISION
+bool AutoreleasePool::elideObject(Ref* object)
+{
+    const unsigned int slot = object->_autoreleaseSlot;
+    if (slot >= _managedObjectArray.size() || _managedObjectArray[slot] != object)
+        return false;
+
+    _managedObjectArray[slot] = nullptr;
+    object->_autoreleaseSlot = Ref::NO_AUTORELEASE_SLOT;
+    return true;
+}
+#endif
+
 void AutoreleasePool::clear()
 {
 #if defined(COCOS2D_DEBUG) && (COCOS2D_DEBUG > 0)
     _isClearing = true;
 #endif
-    std::vector<Ref*> releasings;
-    releasings.swap(_managedObjectArray);
-    for (const auto &obj : releasings)
+    // Release in place so the array keeps its capacity between frames. Objects autoreleased
+    // by destructors are appended after `count` and stay in the pool until the next clear.
+    // Always index the array: it may be reallocated by those appends.
+    const size_t count = _managedObjectArray.size();
+    for (size_t i = 0; i < count; ++i)
     {
+        if (i + POOL_PREFETCH_DISTANCE < count)
+        {
+            CC_POOL_PREFETCH(_managedObjectArray[i + POOL_PREFETCH_DISTANCE]);
+        }
+
+        Ref* obj = _managedObjectArray[i];
+        if (obj == nullptr)
+            continue;
+
+#if CC_ENABLE_AUTORELEASE_ELISION
+        if (obj->_autoreleaseSlot == i)
+            obj->_autoreleaseSlot = Ref::NO_AUTORELEASE_SLOT;
+#endif
         obj->release();
     }
+    _managedObjectArray.erase(_managedObjectArray.begin(), _managedObjectArray.begin() + count);
+
+#if CC_ENABLE_AUTORELEASE_ELISION
+    for (size_t i = 0, size = _managedObjectArray.size(); i < size; ++i)
+    {
+        if (Ref* obj = _managedObjectArray[i])
+            obj->_autoreleaseSlot = static_cast<unsigned int>(i);
+    }
+#endif
 #if defined(COCOS2D_DEBUG) && (COCOS2D_DEBUG > 0)
     _isClearing = false;
 #endif
@@ -93,6 +145,8 @@ void AutoreleasePool::dump()
     CCLOG("%20s%20s%20s", "Object pointer", "Object id", "reference count");
     for (const auto &obj : _managedObjectArray)
     {
+        if (obj == nullptr)
+            continue;
         CCLOG("%20p%20u\n", obj, obj->getReferenceCount());
     }
 }
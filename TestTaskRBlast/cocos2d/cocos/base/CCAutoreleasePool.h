@@ -80,10 +80,24 @@ public:
      */
     void addObject(Ref *object);
 
+#if CC_ENABLE_AUTORELEASE_ELISION
+    /**
+     * Drop the most recent pending release of an object, handing the pool's reference
+     * over to the caller. Used by `Ref::retain()` when CC_ENABLE_AUTORELEASE_ELISION is on.
+     *
+     * @param object    The object whose pending release should be dropped.
+     * @return True if the object's pending release was found in this pool and dropped.
+     * @js NA
+     * @lua NA
+     */
+    bool elideObject(Ref *object);
+#endif
+
     /**
      * Clear the autorelease pool.
      *
-     * It will invoke each element's `release()` function.
+     * It will invoke each element's `release()` function. Objects added while
+     * clearing are kept in the pool until the next call.
      *
      * @js NA
      * @lua NA
@@ -132,6 +146,7 @@ private:
      * does not affect the managed object's reference count. So an object can
      * be destructed properly by calling Ref::release() even if the object
      * is in the pool.
+     * Slots of elided objects are set to nullptr and skipped when clearing.
      */
     std::vector<Ref*> _managedObjectArray;
     std::string _name;
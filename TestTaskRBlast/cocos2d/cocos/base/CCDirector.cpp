@@ -34,6 +34,8 @@ THE SOFTWARE.
 
 #include "2d/CCDrawingPrimitives.h"
 #include "2d/CCSpriteFrameCache.h"
+#include "2d/CCDynamicAtlas.h"
+#include "2d/CCParticleUpdateScheduler.h"
 #include "platform/CCFileUtils.h"
 
 #include "2d/CCActionManager.h"
@@ -267,6 +269,7 @@ void Director::drawScene()
         _eventDispatcher->dispatchEvent(_eventAfterUpdate);
     }
 
+    _renderer->beginPartialRedraw();
     _renderer->clear();
     experimental::FrameBuffer::clearAllFBOs();
     
@@ -278,6 +281,7 @@ void Director::drawScene()
     if (_nextScene)
     {
         setNextScene();
+        _renderer->addFullDamage();
     }
 
     pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
@@ -289,6 +293,12 @@ void Director::drawScene()
 #endif
         //clear draw stats
         _renderer->clearDrawStats();
+
+        // damage can't be tracked per camera, every camera redraws the whole screen
+        if (_renderer->isPartialRedrawEnabled() && _runningScene->getCameras().size() > 1)
+        {
+            _renderer->addFullDamage();
+        }
         
         //render the scene
         if(_openGLView)
@@ -297,6 +307,9 @@ void Director::drawScene()
         _eventDispatcher->dispatchEvent(_eventAfterVisit);
     }
 
+    // the overlays below are drawn over the presented frame, not into the retained one
+    _renderer->endPartialRedraw();
+
     // draw the notifications node
     if (_notificationNode)
     {
@@ -311,6 +324,11 @@ void Director::drawScene()
         showStats();
 #endif
     }
+
+    if (_renderer->isPartialRedrawEnabled())
+    {
+        _renderer->discardDamage();
+    }
     
     _renderer->render();
 
@@ -1099,6 +1117,8 @@ void Director::reset()
 #endif
     AnimationCache::destroyInstance();
     SpriteFrameCache::destroyInstance();
+    DynamicAtlas::destroyInstance();
+    ParticleUpdateScheduler::destroyInstance();
     GLProgramCache::destroyInstance();
     GLProgramStateCache::destroyInstance();
     FileUtils::destroyInstance();
@@ -1281,7 +1301,13 @@ void Director::showStats()
             prevCalls = currentCalls;
         }
 
-        if( currentVerts != prevVerts) {
+        if (_renderer->isPartialRedrawEnabled()) {
+            // percentage of the screen redrawn, the stats font has no '%' glyph
+            sprintf(buffer, "GL verts:%6lu dmg:%3d", currentVerts, (int)(_renderer->getDamagedAreaRatio() * 100));
+            _drawnVerticesLabel->setString(buffer);
+            prevVerts = (unsigned long)-1;
+        }
+        else if( currentVerts != prevVerts) {
             sprintf(buffer, "GL verts:%6lu", currentVerts);
             _drawnVerticesLabel->setString(buffer);
             prevVerts = currentVerts;
@@ -0,0 +1,69 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "base/CCEventChannel.h"
+
+#include <atomic>
+
+NS_CC_BEGIN
+
+unsigned int EventChannelIndex::next()
+{
+    static std::atomic<unsigned int> s_channelCount(0);
+    return s_channelCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+EventChannelListener::EventChannelListener()
+: _callback(nullptr)
+, _channelIndex(0)
+, _isEnabled(true)
+, _isRegistered(false)
+{
+}
+
+EventChannelListener* EventChannelListener::create(unsigned int channelIndex, const Callback& callback)
+{
+    EventChannelListener* ret = new (std::nothrow) EventChannelListener();
+    if (ret && ret->init(channelIndex, callback))
+    {
+        ret->autorelease();
+    }
+    else
+    {
+        CC_SAFE_DELETE(ret);
+    }
+    return ret;
+}
+
+bool EventChannelListener::init(unsigned int channelIndex, const Callback& callback)
+{
+    if (callback == nullptr)
+        return false;
+
+    _channelIndex = channelIndex;
+    _callback = callback;
+    return true;
+}
+
+NS_CC_END
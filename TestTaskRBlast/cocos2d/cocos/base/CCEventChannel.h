@@ -0,0 +1,132 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __cocos2d_libs__CCEventChannel__
+#define __cocos2d_libs__CCEventChannel__
+
+#include <functional>
+
+#include "base/CCRef.h"
+
+/**
+ * @addtogroup base
+ * @{
+ */
+
+NS_CC_BEGIN
+
+/** @class EventChannelListener
+ * @brief Listener of a typed event channel, see `EventChannel`.
+ * It is created and registered by `EventDispatcher::addChannelListener`.
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL EventChannelListener : public Ref
+{
+public:
+    typedef std::function<void(const void*)> Callback;
+
+    /** Creates a listener of the channel `channelIndex`.
+     * @param channelIndex The index of the channel, see `EventChannel::getIndex()`.
+     * @param callback The callback receiving a pointer to the payload.
+     * @return An autoreleased EventChannelListener object.
+     */
+    static EventChannelListener* create(unsigned int channelIndex, const Callback& callback);
+
+    /** Gets the index of the channel this listener belongs to. */
+    unsigned int getChannelIndex() const { return _channelIndex; }
+
+    /** Enables or disables the listener, a disabled listener stays registered but is not called. */
+    void setEnabled(bool enabled) { _isEnabled = enabled; }
+    /** Checks whether the listener is enabled. */
+    bool isEnabled() const { return _isEnabled; }
+
+    /** Checks whether the listener is registered in an event dispatcher. */
+    bool isRegistered() const { return _isRegistered; }
+
+CC_CONSTRUCTOR_ACCESS:
+    EventChannelListener();
+    bool init(unsigned int channelIndex, const Callback& callback);
+
+protected:
+    Callback _callback;
+    unsigned int _channelIndex;
+    bool _isEnabled;
+    bool _isRegistered;
+
+    friend class EventDispatcher;
+};
+
+/** @cond */
+class CC_DLL EventChannelIndex
+{
+public:
+    /** Returns a new channel index, indices are consecutive and start at 0. */
+    static unsigned int next();
+};
+/** @endcond */
+
+/** @class EventChannel
+ * @brief Typed event channel.
+ * Listeners of a channel are found by an integer assigned once per payload type instead of
+ * a string listener ID, and receive the payload as `const T&` instead of `void* userData`.
+ * @code Usage:
+ *        struct ScoreChanged { int score; };
+ *        auto dispatcher = Director::getInstance()->getEventDispatcher();
+ *
+ *     Adds a listener:
+ *
+ *        auto listener = dispatcher->addChannelListener<ScoreChanged>([](const ScoreChanged& e){ show(e.score); });
+ *
+ *     Dispatches an event:
+ *
+ *        dispatcher->dispatchChannel(ScoreChanged{42});
+ *
+ *     Removes a listener:
+ *
+ *        dispatcher->removeChannelListener(listener);
+ * \endcode
+ * EventKeyboard, EventMouse and EventCustom passed to `EventDispatcher::dispatchEvent` are
+ * also dispatched to their channels.
+ * @js NA
+ * @lua NA
+ */
+template<typename T>
+class EventChannel
+{
+public:
+    /** Gets the index of the channel of `T`, assigned on first use. */
+    static unsigned int getIndex()
+    {
+        static const unsigned int index = EventChannelIndex::next();
+        return index;
+    }
+};
+
+NS_CC_END
+
+// end of base group
+/// @}
+
+#endif /* defined(__cocos2d_libs__CCEventChannel__) */
@@ -32,6 +32,8 @@
 #include "base/CCEventListenerKeyboard.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventListenerFocus.h"
+#include "base/CCEventKeyboard.h"
+#include "base/CCEventMouse.h"
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_IOS || CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX || CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
 #include "base/CCEventListenerController.h"
 #endif
@@ -200,9 +202,10 @@ void EventDispatcher::EventListenerVector::clear()
 
 
 EventDispatcher::EventDispatcher()
-: _inDispatch(0)
+: _inChannelDispatch(0)
+, _channelListenersDirty(false)
+, _inDispatch(0)
 , _isEnabled(false)
-, _nodePriorityIndex(0)
 {
     _toAddedListeners.reserve(50);
     _toRemovedListeners.reserve(50);
@@ -222,73 +225,29 @@ EventDispatcher::~EventDispatcher()
     removeAllEventListeners();
 }
 
-void EventDispatcher::visitTarget(Node* node, bool isRootNode)
+bool EventDispatcher::appendScenePath(Node* node, Node* rootNode, std::vector<std::int64_t>& path)
 {
-    node->sortAllChildren();
-    
-    int i = 0;
-    auto& children = node->getChildren();
-    
-    auto childrenCount = children.size();
-    
-    if(childrenCount > 0)
-    {
-        Node* child = nullptr;
-        // visit children zOrder < 0
-        for( ; i < childrenCount; i++ )
-        {
-            child = children.at(i);
-            
-            if ( child && child->getLocalZOrder() < 0 )
-                visitTarget(child, false);
-            else
-                break;
-        }
-        
-        if (_nodeListenersMap.find(node) != _nodeListenersMap.end())
-        {
-            _globalZOrderNodeMap[node->getGlobalZOrder()].push_back(node);
-        }
-        
-        for( ; i < childrenCount; i++ )
-        {
-            child = children.at(i);
-            if (child)
-                visitTarget(child, false);
-        }
-    }
-    else
-    {
-        if (_nodeListenersMap.find(node) != _nodeListenersMap.end())
-        {
-            _globalZOrderNodeMap[node->getGlobalZOrder()].push_back(node);
-        }
-    }
-    
-    if (isRootNode)
+    // A node is drawn after its children with a negative local Z order and before the other ones,
+    // so its own slot in the path is 0: between negative keys and keys of children with local Z order >= 0,
+    // which always have an order of arrival greater than 0.
+    const size_t begin = path.size();
+    path.push_back(0);
+
+    Node* current = node;
+    while (current != rootNode)
     {
-        std::vector<float> globalZOrders;
-        globalZOrders.reserve(_globalZOrderNodeMap.size());
-        
-        for (const auto& e : _globalZOrderNodeMap)
+        Node* parent = current->getParent();
+        if (parent == nullptr)
         {
-            globalZOrders.push_back(e.first);
-        }
-        
-        std::stable_sort(globalZOrders.begin(), globalZOrders.end(), [](const float a, const float b){
-            return a < b;
-        });
-        
-        for (const auto& globalZ : globalZOrders)
-        {
-            for (const auto& n : _globalZOrderNodeMap[globalZ])
-            {
-                _nodePriorityMap[n] = ++_nodePriorityIndex;
-            }
+            path.resize(begin);
+            return false;
         }
-        
-        _globalZOrderNodeMap.clear();
+        path.push_back(current->getLocalZOrderAndArrival());
+        current = parent;
     }
+
+    std::reverse(path.begin() + begin, path.end());
+    return true;
 }
 
 void EventDispatcher::pauseEventListenersForTarget(Node* target, bool recursive/* = false */)
@@ -357,7 +316,6 @@ void EventDispatcher::removeEventListenersForTarget(Node* target, bool recursive
 {
     // Ensure the node is removed from these immediately also.
     // Don't want any dangling pointers or the possibility of dealing with deleted objects..
-    _nodePriorityMap.erase(target);
     _dirtyNodes.erase(target);
 
     auto listenerIter = _nodeListenersMap.find(target);
@@ -552,13 +510,6 @@ void EventDispatcher::debugCheckNodeHasNoEventListenersOnDestruction(Node* node)
         }
     }
     
-    // Check the node priority map
-    for (const auto & keyValuePair : _nodePriorityMap)
-    {
-        CCASSERT(keyValuePair.first != node,
-                 "Node should have no event listeners registered for it upon destruction!");
-    }
-    
     // Check the to be added list
     for (EventListener * listener : _toAddedListeners)
     {
@@ -907,6 +858,25 @@ void EventDispatcher::dispatchEvent(Event* event)
     
     
     DispatchGuard guard(_inDispatch);
+
+    // Typed channels of the built-in events, before the listeners found by ID
+    if (!_channelListeners.empty())
+    {
+        switch (event->getType())
+        {
+            case Event::Type::KEYBOARD:
+                dispatchChannel(*static_cast<EventKeyboard*>(event));
+                break;
+            case Event::Type::MOUSE:
+                dispatchChannel(*static_cast<EventMouse*>(event));
+                break;
+            case Event::Type::CUSTOM:
+                dispatchChannel(*static_cast<EventCustom*>(event));
+                break;
+            default:
+                break;
+        }
+    }
     
     if (event->getType() == Event::Type::TOUCH)
     {
@@ -1322,22 +1292,44 @@ void EventDispatcher::sortEventListenersOfSceneGraphPriority(const EventListener
     if (sceneGraphListeners == nullptr)
         return;
 
-    // Reset priority index
-    _nodePriorityIndex = 0;
-    _nodePriorityMap.clear();
-
-    visitTarget(rootNode, true);
-    
-    // After sort: priority < 0, > 0
-    std::stable_sort(sceneGraphListeners->begin(), sceneGraphListeners->end(), [this](const EventListener* l1, const EventListener* l2) {
-        return _nodePriorityMap[l1->getAssociatedNode()] > _nodePriorityMap[l2->getAssociatedNode()];
+    // Build the draw order keys of the listener nodes from their ancestors only, instead of
+    // walking the whole scene: the draw order is the global Z order, then the scene graph order.
+    _sceneGraphPriorityKeys.clear();
+    _sceneGraphPriorityPaths.clear();
+    for (auto& l : *sceneGraphListeners)
+    {
+        SceneGraphPriorityKey key;
+        key.listener = l;
+        key.globalZOrder = l->getAssociatedNode()->getGlobalZOrder();
+        key.pathBegin = _sceneGraphPriorityPaths.size();
+        key.inScene = appendScenePath(l->getAssociatedNode(), rootNode, _sceneGraphPriorityPaths);
+        key.pathEnd = _sceneGraphPriorityPaths.size();
+        _sceneGraphPriorityKeys.push_back(key);
+    }
+
+    // After sort: nodes drawn last first, nodes not in the running scene at the end
+    const auto& paths = _sceneGraphPriorityPaths;
+    std::stable_sort(_sceneGraphPriorityKeys.begin(), _sceneGraphPriorityKeys.end(), [&paths](const SceneGraphPriorityKey& k1, const SceneGraphPriorityKey& k2) {
+        if (k1.inScene != k2.inScene)
+            return k1.inScene;
+        if (!k1.inScene)
+            return false;
+        if (k1.globalZOrder != k2.globalZOrder)
+            return k1.globalZOrder > k2.globalZOrder;
+        return std::lexicographical_compare(paths.begin() + k2.pathBegin, paths.begin() + k2.pathEnd,
+                                            paths.begin() + k1.pathBegin, paths.begin() + k1.pathEnd);
     });
+
+    for (size_t i = 0, count = _sceneGraphPriorityKeys.size(); i < count; ++i)
+    {
+        (*sceneGraphListeners)[i] = _sceneGraphPriorityKeys[i].listener;
+    }
     
 #if DUMP_LISTENER_ITEM_PRIORITY_INFO
     log("-----------------------------------");
     for (auto& l : *sceneGraphListeners)
     {
-        log("listener priority: node ([%s]%p), priority (%d)", typeid(*l->_node).name(), l->_node, _nodePriorityMap[l->_node]);
+        log("listener priority: node ([%s]%p), global z (%f)", typeid(*l->_node).name(), l->_node, l->_node->getGlobalZOrder());
     }
 #endif
 }
@@ -1515,6 +1507,114 @@ void EventDispatcher::removeAllEventListeners()
     {
         _listenerMap.clear();
     }
+
+    for (unsigned int i = 0, count = static_cast<unsigned int>(_channelListeners.size()); i < count; ++i)
+    {
+        removeChannelListeners(i);
+    }
+}
+
+void EventDispatcher::addChannelListener(EventChannelListener* listener)
+{
+    CCASSERT(listener, "Invalid parameters.");
+    CCASSERT(!listener->isRegistered(), "The listener has been registered.");
+
+    const unsigned int index = listener->getChannelIndex();
+    if (index >= _channelListeners.size())
+    {
+        _channelListeners.resize(index + 1);
+    }
+
+    listener->retain();
+    listener->_isRegistered = true;
+    _channelListeners[index].push_back(listener);
+}
+
+void EventDispatcher::removeChannelListener(EventChannelListener* listener)
+{
+    if (listener == nullptr || !listener->isRegistered())
+        return;
+
+    const unsigned int index = listener->getChannelIndex();
+    if (index >= _channelListeners.size())
+        return;
+
+    listener->_isRegistered = false;
+
+    // While dispatching, unregistered listeners are skipped and erased afterwards
+    if (_inChannelDispatch > 0)
+    {
+        _channelListenersDirty = true;
+        return;
+    }
+
+    auto& listeners = _channelListeners[index];
+    auto iter = std::find(listeners.begin(), listeners.end(), listener);
+    if (iter != listeners.end())
+    {
+        listeners.erase(iter);
+        listener->release();
+    }
+}
+
+void EventDispatcher::removeChannelListeners(unsigned int channelIndex)
+{
+    if (channelIndex >= _channelListeners.size())
+        return;
+
+    auto& listeners = _channelListeners[channelIndex];
+    for (auto& l : listeners)
+    {
+        l->_isRegistered = false;
+    }
+
+    if (_inChannelDispatch > 0)
+    {
+        _channelListenersDirty = true;
+        return;
+    }
+
+    for (auto& l : listeners)
+    {
+        l->release();
+    }
+    listeners.clear();
+}
+
+void EventDispatcher::dispatchChannel(unsigned int channelIndex, const void* payload)
+{
+    if (!_isEnabled || channelIndex >= _channelListeners.size() || _channelListeners[channelIndex].empty())
+        return;
+
+    {
+        DispatchGuard guard(_inChannelDispatch);
+
+        // Listeners added by the callbacks are only called by the next dispatch
+        const size_t count = _channelListeners[channelIndex].size();
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto l = _channelListeners[channelIndex][i];
+            if (l->_isRegistered && l->_isEnabled)
+            {
+                l->_callback(payload);
+            }
+        }
+    }
+
+    if (_inChannelDispatch == 0 && _channelListenersDirty)
+    {
+        _channelListenersDirty = false;
+        for (auto& listeners : _channelListeners)
+        {
+            auto end = std::remove_if(listeners.begin(), listeners.end(), [](EventChannelListener* l) {
+                if (l->_isRegistered)
+                    return false;
+                l->release();
+                return true;
+            });
+            listeners.erase(end, listeners.end());
+        }
+    }
 }
 
 void EventDispatcher::setEnabled(bool isEnabled)
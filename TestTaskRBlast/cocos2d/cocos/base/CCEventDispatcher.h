@@ -35,6 +35,7 @@
 #include "platform/CCPlatformMacros.h"
 #include "base/CCEventListener.h"
 #include "base/CCEvent.h"
+#include "base/CCEventChannel.h"
 #include "platform/CCStdC.h"
 
 /**
@@ -186,6 +187,70 @@ public:
      */
     bool hasEventListener(const EventListener::ListenerID& listenerID) const;
 
+    /////////////////////////////////////////////
+
+    /** Adds a listener to the typed channel of `T`, see `EventChannel`.
+     * Listeners of a channel are called in the order they were added.
+     *
+     * @param callback The callback receiving the payload.
+     * @return The registered listener, to be passed to `removeChannelListener`.
+     * @js NA
+     * @lua NA
+     */
+    template<typename T>
+    EventChannelListener* addChannelListener(const std::function<void(const T&)>& callback)
+    {
+        auto listener = EventChannelListener::create(EventChannel<T>::getIndex(), [callback](const void* payload) {
+            callback(*static_cast<const T*>(payload));
+        });
+        if (listener)
+        {
+            addChannelListener(listener);
+        }
+        return listener;
+    }
+
+    /** Adds a channel listener created by `EventChannelListener::create`.
+     * @js NA
+     * @lua NA
+     */
+    void addChannelListener(EventChannelListener* listener);
+
+    /** Removes a channel listener, it is safe to call it while dispatching.
+     * @js NA
+     * @lua NA
+     */
+    void removeChannelListener(EventChannelListener* listener);
+
+    /** Removes all listeners of the typed channel of `T`.
+     * @js NA
+     * @lua NA
+     */
+    template<typename T>
+    void removeChannelListeners() { removeChannelListeners(EventChannel<T>::getIndex()); }
+
+    /** Removes all listeners of a channel.
+     * @js NA
+     * @lua NA
+     */
+    void removeChannelListeners(unsigned int channelIndex);
+
+    /** Dispatches a payload to the listeners of the typed channel of `T`.
+     * No string or hash lookup is involved.
+     *
+     * @param payload The payload passed to the listeners.
+     * @js NA
+     * @lua NA
+     */
+    template<typename T>
+    void dispatchChannel(const T& payload) { dispatchChannel(EventChannel<T>::getIndex(), &payload); }
+
+    /** Dispatches a payload to the listeners of a channel.
+     * @js NA
+     * @lua NA
+     */
+    void dispatchChannel(unsigned int channelIndex, const void* payload);
+
     /////////////////////////////////////////////
     
     /** Constructor of EventDispatcher.
@@ -309,8 +374,11 @@ protected:
     /** Sets the dirty flag for a specified listener ID */
     void setDirty(const EventListener::ListenerID& listenerID, DirtyFlag flag);
     
-    /** Walks though scene graph to get the draw order for each node, it's called before sorting event listener with scene graph priority */
-    void visitTarget(Node* node, bool isRootNode);
+    /** Appends to `path` the sibling keys from `rootNode` down to `node`, the draw order of nodes with
+     *  the same global Z order is the lexicographic order of their paths. Returns false if `node` is not
+     *  a descendant of `rootNode`.
+     */
+    static bool appendScenePath(Node* node, Node* rootNode, std::vector<std::int64_t>& path);
 
     /** Remove all listeners in _toRemoveListeners list and cleanup */
     void cleanToRemovedListeners();
@@ -324,11 +392,17 @@ protected:
     /** The map of node and event listeners */
     std::unordered_map<Node*, std::vector<EventListener*>*> _nodeListenersMap;
     
-    /** The map of node and its event priority */
-    std::unordered_map<Node*, int> _nodePriorityMap;
-    
-    /** key: Global Z Order, value: Sorted Nodes */
-    std::unordered_map<float, std::vector<Node*>> _globalZOrderNodeMap;
+    /** Scratch buffers reused when sorting listeners by scene graph priority */
+    struct SceneGraphPriorityKey
+    {
+        EventListener* listener;
+        float globalZOrder;
+        size_t pathBegin;
+        size_t pathEnd;
+        bool inScene;
+    };
+    std::vector<SceneGraphPriorityKey> _sceneGraphPriorityKeys;
+    std::vector<std::int64_t> _sceneGraphPriorityPaths;
     
     /** The listeners to be added after dispatching event */
     std::vector<EventListener*> _toAddedListeners;
@@ -339,14 +413,21 @@ protected:
     /** The nodes were associated with scene graph based priority listeners */
     std::set<Node*> _dirtyNodes;
     
+    /** Listeners of typed channels, indexed by channel index */
+    std::vector<std::vector<EventChannelListener*>> _channelListeners;
+
+    /** Whether the dispatcher is dispatching a typed channel */
+    int _inChannelDispatch;
+
+    /** Whether channel listeners were removed while dispatching */
+    bool _channelListenersDirty;
+
     /** Whether the dispatcher is dispatching event */
     int _inDispatch;
     
     /** Whether to enable dispatching event */
     bool _isEnabled;
     
-    int _nodePriorityIndex;
-    
     std::set<std::string> _internalCustomListenerIDs;
 };
 
@@ -45,6 +45,9 @@ static void untrackRef(Ref* ref);
 
 Ref::Ref()
 : _referenceCount(1) // when the Ref is created, the reference count of it is 1
+#if CC_ENABLE_AUTORELEASE_ELISION
+, _autoreleaseSlot(NO_AUTORELEASE_SLOT)
+#endif
 #if CC_ENABLE_SCRIPT_BINDING
 , _luaID (0)
 , _scriptObject(nullptr)
@@ -91,6 +94,15 @@ Ref::~Ref()
 void Ref::retain()
 {
     CCASSERT(_referenceCount > 0, "reference count should be greater than 0");
+#if CC_ENABLE_AUTORELEASE_ELISION
+    // Take over the reference owned by the pool instead of paying for a retain now
+    // and a release at the end of the frame.
+    if (_autoreleaseSlot != NO_AUTORELEASE_SLOT
+        && PoolManager::getInstance()->getCurrentPool()->elideObject(this))
+    {
+        return;
+    }
+#endif
     ++_referenceCount;
 }
 
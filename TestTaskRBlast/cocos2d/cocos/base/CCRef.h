@@ -147,6 +147,13 @@ protected:
     /// count of references
     unsigned int _referenceCount;
 
+#if CC_ENABLE_AUTORELEASE_ELISION
+    /// index of the pending autorelease in the current pool, or NO_AUTORELEASE_SLOT
+    unsigned int _autoreleaseSlot;
+
+    static const unsigned int NO_AUTORELEASE_SLOT = 0xFFFFFFFF;
+#endif
+
     friend class AutoreleasePool;
 
 #if CC_ENABLE_SCRIPT_BINDING
@@ -27,6 +27,9 @@ THE SOFTWARE.
 ****************************************************************************/
 
 #include "base/CCScheduler.h"
+
+#include <chrono>
+
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
 #include "base/utlist.h"
@@ -68,6 +71,15 @@ typedef struct _hashSelectorEntry
     UT_hash_handle      hh;
 } tHashTimerEntry;
 
+// Node of the "perform function" queue, allocated by the posting thread and freed by the cocos2d thread
+typedef struct _performEntry
+{
+    std::atomic<struct _performEntry*>      next;
+    std::function<void()>                   function;
+    std::chrono::steady_clock::time_point   postTime;
+    unsigned int                            sequence;
+} tPerformEntry;
+
 // implementation Timer
 
 Timer::Timer()
@@ -263,14 +275,27 @@ Scheduler::Scheduler(void)
 #if CC_ENABLE_SCRIPT_BINDING
 , _scriptHandlerEntries(20)
 #endif
+, _performPending(0)
+, _performSequence(0)
+, _performDiscardBefore(0)
+, _performTimeBudget(0.0f)
 {
-    // I don't expect to have more than 30 functions to all per frame
-    _functionsToPerform.reserve(30);
+    _performStub = new tPerformEntry();
+    _performStub->next.store(nullptr, std::memory_order_relaxed);
+    _performHead.store(_performStub, std::memory_order_relaxed);
+    _performTail = _performStub;
+    _performStats = {0, 0, 0.0f, 0.0f};
 }
 
 Scheduler::~Scheduler(void)
 {
     unscheduleAll();
+
+    while (tPerformEntry *entry = popPerformEntry())
+    {
+        delete entry;
+    }
+    delete _performStub;
 }
 
 void Scheduler::removeHashElement(_hashSelectorEntry *element)
@@ -809,14 +834,121 @@ void Scheduler::resumeTargets(const std::set<void*>& targetsToResume)
 
 void Scheduler::performFunctionInCocosThread(std::function<void ()> function)
 {
-    std::lock_guard<std::mutex> lock(_performMutex);
-    _functionsToPerform.push_back(std::move(function));
+    tPerformEntry *entry = new (std::nothrow) tPerformEntry();
+    if (entry == nullptr)
+        return;
+
+    entry->function = std::move(function);
+    entry->postTime = std::chrono::steady_clock::now();
+    entry->sequence = _performSequence.fetch_add(1, std::memory_order_relaxed);
+
+    // Count before publishing, so the cocos2d thread never pops more entries than it has seen
+    _performPending.fetch_add(1, std::memory_order_release);
+    pushPerformEntry(entry);
 }
 
 void Scheduler::removeAllFunctionsToBePerformedInCocosThread()
 {
-    std::unique_lock<std::mutex> lock(_performMutex);
-    _functionsToPerform.clear();
+    // Entries are owned by the cocos2d thread once posted: mark them as dropped, they are freed when popped
+    _performDiscardBefore.store(_performSequence.load(std::memory_order_relaxed), std::memory_order_release);
+}
+
+Scheduler::PerformFunctionStats Scheduler::getPerformFunctionStats() const
+{
+    PerformFunctionStats stats = _performStats;
+    stats.pending = _performPending.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void Scheduler::pushPerformEntry(tPerformEntry *entry)
+{
+    entry->next.store(nullptr, std::memory_order_relaxed);
+    tPerformEntry *prev = _performHead.exchange(entry, std::memory_order_acq_rel);
+    prev->next.store(entry, std::memory_order_release);
+}
+
+tPerformEntry* Scheduler::popPerformEntry()
+{
+    tPerformEntry *tail = _performTail;
+    tPerformEntry *next = tail->next.load(std::memory_order_acquire);
+
+    if (tail == _performStub)
+    {
+        if (next == nullptr)
+            return nullptr;
+
+        _performTail = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next != nullptr)
+    {
+        _performTail = next;
+        return tail;
+    }
+
+    // A producer has swapped the head but not linked its entry yet, try again next frame
+    if (tail != _performHead.load(std::memory_order_acquire))
+        return nullptr;
+
+    // tail is the last entry: push the stub back so tail can be unlinked
+    pushPerformEntry(_performStub);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next != nullptr)
+    {
+        _performTail = next;
+        return tail;
+    }
+    return nullptr;
+}
+
+void Scheduler::performFunctions()
+{
+    _performStats.executedLastFrame = 0;
+    _performStats.averageLatency = 0.0f;
+    _performStats.maxLatency = 0.0f;
+
+    // Only run the functions posted before this frame: functions posted by these callbacks run next frame
+    unsigned int count = _performPending.load(std::memory_order_acquire);
+    if (count == 0)
+        return;
+
+    const auto start = std::chrono::steady_clock::now();
+    float totalLatency = 0.0f;
+
+    while (count > 0)
+    {
+        tPerformEntry *entry = popPerformEntry();
+        if (entry == nullptr)
+            break;
+
+        --count;
+        _performPending.fetch_sub(1, std::memory_order_relaxed);
+
+        const unsigned int discardBefore = _performDiscardBefore.load(std::memory_order_acquire);
+        if (static_cast<int>(entry->sequence - discardBefore) >= 0)
+        {
+            auto latency = std::chrono::duration<float>(std::chrono::steady_clock::now() - entry->postTime).count();
+            totalLatency += latency;
+            _performStats.maxLatency = std::max(_performStats.maxLatency, latency);
+            ++_performStats.executedLastFrame;
+
+            entry->function();
+        }
+        delete entry;
+
+        if (_performTimeBudget > 0.0f && _performStats.executedLastFrame > 0
+            && std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count() >= _performTimeBudget)
+        {
+            break;
+        }
+    }
+
+    if (_performStats.executedLastFrame > 0)
+    {
+        _performStats.averageLatency = totalLatency / _performStats.executedLastFrame;
+    }
 }
 
 // main loop
@@ -939,18 +1071,8 @@ void Scheduler::update(float dt)
     // Functions allocated from another thread
     //
 
-    // Testing size is faster than locking / unlocking.
-    // And almost never there will be functions scheduled to be called.
-    if( !_functionsToPerform.empty() ) {
-        _performMutex.lock();
-        // fixed #4123: Save the callback functions, they must be invoked after '_performMutex.unlock()', otherwise if new functions are added in callback, it will cause thread deadlock.
-        auto temp = std::move(_functionsToPerform);
-        _performMutex.unlock();
-        
-        for (const auto &function : temp) {
-            function();
-        }
-    }
+    // Functions are popped without locking, so callbacks may post new functions freely.
+    performFunctions();
 }
 
 void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, unsigned int repeat, float delay, bool paused)
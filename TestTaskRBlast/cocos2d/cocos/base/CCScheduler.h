@@ -29,6 +29,7 @@ THE SOFTWARE.
 #ifndef __CCSCHEDULER_H__
 #define __CCSCHEDULER_H__
 
+#include <atomic>
 #include <functional>
 #include <mutex>
 #include <set>
@@ -437,6 +438,41 @@ public:
      * @js NA
      */
     void removeAllFunctionsToBePerformedInCocosThread();
+
+    /** Limits the time spent per frame running functions queued with performFunctionInCocosThread.
+     At least one function is run per frame, the remaining ones are run in the next frames.
+     @param budget Time budget in seconds, 0 (the default) runs all the functions queued before the frame.
+     @js NA
+     */
+    void setPerformFunctionTimeBudget(float budget) { _performTimeBudget = budget; }
+    /** Gets the time budget of functions queued with performFunctionInCocosThread.
+     @see Scheduler::setPerformFunctionTimeBudget()
+     @js NA
+     */
+    float getPerformFunctionTimeBudget() const { return _performTimeBudget; }
+
+    /** Counters of the functions queued with performFunctionInCocosThread.
+     @js NA
+     @lua NA
+     */
+    struct PerformFunctionStats
+    {
+        /** Number of functions waiting to be run. */
+        unsigned int pending;
+        /** Number of functions run in the last frame. */
+        unsigned int executedLastFrame;
+        /** Average time in seconds from posting to running, for the functions run in the last frame. */
+        float averageLatency;
+        /** Longest time in seconds from posting to running, for the functions run in the last frame. */
+        float maxLatency;
+    };
+
+    /** Gets the counters of the functions queued with performFunctionInCocosThread.
+     Should be called from the cocos2d thread.
+     @js NA
+     @lua NA
+     */
+    PerformFunctionStats getPerformFunctionStats() const;
     
     /////////////////////////////////////
     
@@ -538,9 +574,20 @@ protected:
     Vector<SchedulerScriptHandlerEntry*> _scriptHandlerEntries;
 #endif
     
-    // Used for "perform Function"
-    std::vector<std::function<void()>> _functionsToPerform;
-    std::mutex _performMutex;
+    // Used for "perform Function": intrusive multi-producer single-consumer queue.
+    // Producers push at _performHead, the cocos2d thread pops at _performTail.
+    void pushPerformEntry(struct _performEntry *entry);
+    struct _performEntry* popPerformEntry();
+    void performFunctions();
+
+    std::atomic<struct _performEntry *> _performHead;
+    struct _performEntry *_performTail;
+    struct _performEntry *_performStub;
+    std::atomic<unsigned int> _performPending;
+    std::atomic<unsigned int> _performSequence;  // sequence number of the next posted function
+    std::atomic<unsigned int> _performDiscardBefore; // functions posted before this sequence number are dropped
+    float _performTimeBudget;
+    PerformFunctionStats _performStats;
 };
 
 // end of base group
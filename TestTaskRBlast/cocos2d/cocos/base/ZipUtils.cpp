@@ -515,6 +515,11 @@ public:
     // std::unordered_map is faster if available on the platform
     typedef std::unordered_map<std::string, struct ZipEntryInfo> FileListContainer;
     FileListContainer fileList;
+
+    // path of the zip file, empty for zip files in memory
+    std::string zipPath;
+    // the zip file mapped by mapFile()
+    FileView zipView;
 };
 
 ZipFile *ZipFile::createWithBuffer(const void* buffer, uLong size)
@@ -537,6 +542,7 @@ ZipFile::ZipFile()
 ZipFile::ZipFile(const std::string &zipFile, const std::string &filter)
 : _data(new ZipFilePrivate)
 {
+    _data->zipPath = zipFile;
     _data->zipFile = unzOpen(FileUtils::getInstance()->getSuitableFOpen(zipFile).c_str());
     setFilter(filter);
 }
@@ -708,6 +714,49 @@ bool ZipFile::getFileData(const std::string &fileName, ResizableBuffer* buffer)
     return res;
 }
 
+FileView ZipFile::mapFile(const std::string &fileName)
+{
+    do
+    {
+        CC_BREAK_IF(!_data->zipFile);
+        CC_BREAK_IF(_data->zipPath.empty());
+        CC_BREAK_IF(fileName.empty());
+
+        ZipFilePrivate::FileListContainer::const_iterator it = _data->fileList.find(fileName);
+        CC_BREAK_IF(it ==  _data->fileList.end());
+
+        ZipEntryInfo fileInfo = it->second;
+
+        int nRet = unzGoToFilePos(_data->zipFile, &fileInfo.pos);
+        CC_BREAK_IF(UNZ_OK != nRet);
+
+        unz_file_info64 info;
+        nRet = unzGetCurrentFileInfo64(_data->zipFile, &info, nullptr, 0, nullptr, 0, nullptr, 0);
+        CC_BREAK_IF(UNZ_OK != nRet);
+        // compressed or encrypted entries can't be used in place
+        CC_BREAK_IF(info.compression_method != 0 || (info.flag & 1) != 0);
+
+        nRet = unzOpenCurrentFile(_data->zipFile);
+        CC_BREAK_IF(UNZ_OK != nRet);
+        ZPOS64_T offset = unzGetCurrentFileZStreamPos64(_data->zipFile);
+        unzCloseCurrentFile(_data->zipFile);
+
+        if (_data->zipView.isNull())
+        {
+            _data->zipView = FileUtils::getInstance()->mapFile(_data->zipPath);
+        }
+        CC_BREAK_IF(offset + info.uncompressed_size > (ZPOS64_T)_data->zipView.getSize());
+
+        return _data->zipView.subView((ssize_t)offset, (ssize_t)info.uncompressed_size);
+    } while (0);
+
+    ssize_t size = 0;
+    unsigned char* buffer = getFileData(fileName, &size);
+    if (!buffer)
+        return FileView();
+    return FileView(buffer, size, std::shared_ptr<const void>(buffer, free));
+}
+
 std::string ZipFile::getFirstFilename()
 {
     if (unzGoToFirstFile(_data->zipFile) != UNZ_OK) return emptyFilename;
@@ -294,6 +294,15 @@ typedef struct unz_file_info_s unz_file_info;
         */
         bool getFileData(const std::string &fileName, ResizableBuffer* buffer);
 
+        /**
+        * Get a view of a file in a zip file.
+        * Stored (uncompressed) entries point directly into the memory mapped zip file,
+        * compressed entries are inflated in a buffer owned by the view.
+        * @param fileName File name
+        * @return A view of the file data, null if the file can't be read.
+        */
+        FileView mapFile(const std::string &fileName);
+
         std::string getFirstFilename();
         std::string getNextFilename();
         
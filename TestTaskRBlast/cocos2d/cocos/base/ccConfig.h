@@ -417,6 +417,27 @@ THE SOFTWARE.
 #define CC_STRIP_FPS 0
 #endif
 
+/** @def CC_ENABLE_AUTORELEASE_ELISION
+ * If enabled, retaining an object that is still waiting in the current autorelease pool
+ * takes over the pool's reference instead of incrementing the reference count, and the
+ * pending release is dropped from the pool.
+ * This saves a retain/release pair for objects created and immediately added to the scene
+ * graph (bullets, particles...), but such objects are no longer guaranteed to stay alive
+ * until the end of the frame: once retained, a matching release() destroys them immediately.
+ * Disabled by default.
+ */
+#ifndef CC_ENABLE_AUTORELEASE_ELISION
+#define CC_ENABLE_AUTORELEASE_ELISION 0
+#endif
+
+/** @def CC_MAP_FILE_MIN_SIZE
+ * Size in bytes under which FileUtils::mapFile() reads files instead of mapping them.
+ * Mapping a file costs a system call and at least a page, which isn't worth it for small files.
+ */
+#ifndef CC_MAP_FILE_MIN_SIZE
+#define CC_MAP_FILE_MIN_SIZE (16 * 1024)
+#endif
+
 #define CC_LABEL_MAX_LENGTH ((1<<16)/4)
 
 #endif // __CCCONFIG_H__
@@ -58,6 +58,7 @@ THE SOFTWARE.
 #include "base/CCValue.h"
 #include "base/CCVector.h"
 #include "base/ZipUtils.h"
+#include "base/CCAssetPack.h"
 #include "base/base64.h"
 #include "base/ccConfig.h"
 #include "base/ccMacros.h"
@@ -67,6 +68,7 @@ THE SOFTWARE.
 
 // EventDispatcher
 #include "base/CCEventAcceleration.h"
+#include "base/CCEventChannel.h"
 #include "base/CCEventCustom.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventFocus.h"
@@ -132,6 +134,8 @@ THE SOFTWARE.
 #include "2d/CCParticleExamples.h"
 #include "2d/CCParticleSystem.h"
 #include "2d/CCParticleSystemQuad.h"
+#include "2d/CCParticleKernels.h"
+#include "2d/CCParticleUpdateScheduler.h"
 #include "2d/CCProgressTimer.h"
 #include "2d/CCProtectedNode.h"
 #include "2d/CCRenderTexture.h"
@@ -176,6 +180,7 @@ THE SOFTWARE.
 #include "renderer/CCVertexIndexData.h"
 #include "renderer/CCFrameBuffer.h"
 #include "renderer/ccGLStateCache.h"
+#include "renderer/ccPixelConvert.h"
 #include "renderer/ccShaders.h"
 
 // physics
@@ -244,6 +249,7 @@ THE SOFTWARE.
 #include "2d/CCSpriteBatchNode.h"
 #include "2d/CCSpriteFrame.h"
 #include "2d/CCSpriteFrameCache.h"
+#include "2d/CCDynamicAtlas.h"
 
 // text_input_node
 #include "2d/CCTextFieldTTF.h"
@@ -257,6 +263,7 @@ THE SOFTWARE.
 #include "2d/CCTMXObjectGroup.h"
 #include "2d/CCTMXTiledMap.h"
 #include "2d/CCTMXXMLParser.h"
+#include "2d/CCTMXBinaryMap.h"
 #include "2d/CCTileMapAtlas.h"
 #include "2d/CCFastTMXLayer.h"
 #include "2d/CCFastTMXTiledMap.h"
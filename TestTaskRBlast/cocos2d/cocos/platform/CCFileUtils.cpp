@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "base/CCData.h"
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
+#include "base/CCAssetPack.h"
 #include "platform/CCSAXParser.h"
 //#include "base/ccUtils.h"
 
@@ -41,6 +42,11 @@ THE SOFTWARE.
 #include "unzip.h"
 #endif
 #include <sys/stat.h>
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_WIN32) && (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
 
 #define DECLARE_GUARD std::lock_guard<std::recursive_mutex> mutexGuard(_mutex)
 
@@ -554,7 +560,8 @@ void FileUtils::setDelegate(FileUtils *delegate)
 }
 
 FileUtils::FileUtils()
-    : _writablePath("")
+    : _resourceIndexEnabled(false)
+    , _writablePath("")
 {
 }
 
@@ -625,6 +632,7 @@ void FileUtils::purgeCachedEntries()
     DECLARE_GUARD;
     _fullPathCache.clear();
     _fullPathCacheDir.clear();
+    invalidateResourceIndex();
 }
 
 std::string FileUtils::getStringFromFile(const std::string& filename) const
@@ -670,6 +678,10 @@ FileUtils::Status FileUtils::getContents(const std::string& filename, ResizableB
     if (fullPath.empty())
         return Status::NotExists;
 
+    std::string packName;
+    if (auto pack = findAssetPack(fullPath, &packName))
+        return pack->getFileData(packName, buffer) ? Status::OK : Status::NotExists;
+
     std::string suitableFullPath = fs->getSuitableFOpen(fullPath);
 
     struct stat statBuf;
@@ -699,6 +711,59 @@ FileUtils::Status FileUtils::getContents(const std::string& filename, ResizableB
     return Status::OK;
 }
 
+FileView FileUtils::mapFile(const std::string& filename) const
+{
+    if (filename.empty())
+        return FileView();
+
+    std::string fullPath = fullPathForFilename(filename);
+    if (fullPath.empty())
+        return FileView();
+
+    std::string packName;
+    if (auto pack = findAssetPack(fullPath, &packName))
+        return pack->getFile(packName);
+
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_WIN32) && (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+    // relative paths are in the Android apk
+    if (isAbsolutePath(fullPath))
+    {
+        int fd = open(getSuitableFOpen(fullPath).c_str(), O_RDONLY);
+        if (fd >= 0)
+        {
+            struct stat statBuf;
+            void* address = MAP_FAILED;
+            size_t size = 0;
+            // reading small files is faster than mapping them
+            if (fstat(fd, &statBuf) == 0 && S_ISREG(statBuf.st_mode) && statBuf.st_size >= CC_MAP_FILE_MIN_SIZE)
+            {
+                size = statBuf.st_size;
+                address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            }
+            // the mapping stays valid once the file is closed
+            close(fd);
+
+            if (address != MAP_FAILED)
+            {
+                auto bytes = static_cast<const unsigned char*>(address);
+                std::shared_ptr<const void> owner(bytes, [size](const unsigned char* p) {
+                    munmap(const_cast<unsigned char*>(p), size);
+                });
+                return FileView(bytes, size, owner);
+            }
+        }
+    }
+#endif
+
+    Data data;
+    if (getContents(fullPath, &data) != Status::OK || data.isNull())
+        return FileView();
+
+    ssize_t size = 0;
+    unsigned char* bytes = data.takeBuffer(&size);
+    return FileView(bytes, size, std::shared_ptr<const void>(bytes, free));
+}
+
 unsigned char* FileUtils::getFileData(const std::string& filename, const char* mode, ssize_t *size) const
 {
     CCASSERT(!filename.empty() && size != nullptr && mode != nullptr, "Invalid parameters.");
@@ -814,16 +879,232 @@ std::string FileUtils::getPathForFilename(const std::string& filename, const std
     return path;
 }
 
-std::string FileUtils::fullPathForFilename(const std::string &filename) const
+struct FileUtils::ResourceIndex
 {
-    
+    // false when a search path can't be listed, the file system is checked instead
+    bool complete;
+    // file names, as passed to fullPathForFilename(), to full paths
+    std::unordered_map<std::string, std::string> fullPaths;
+};
+
+void FileUtils::setResourceIndexEnabled(bool enabled)
+{
+    DECLARE_GUARD;
+    _resourceIndexEnabled = enabled;
+    invalidateResourceIndex();
+}
+
+bool FileUtils::addAssetPack(const std::string& filename, bool front)
+{
+    std::shared_ptr<AssetPack> pack(AssetPack::createWithFile(filename));
+    if (!pack)
+        return false;
+
     DECLARE_GUARD;
+    auto assetPacks = std::atomic_load(&_assetPacks);
+    auto newAssetPacks = assetPacks ? std::make_shared<AssetPackList>(*assetPacks) : std::make_shared<AssetPackList>();
+    newAssetPacks->insert(front ? newAssetPacks->begin() : newAssetPacks->end(), pack);
+    std::atomic_store(&_assetPacks, std::shared_ptr<const AssetPackList>(newAssetPacks));
 
+    _fullPathCache.clear();
+    invalidateResourceIndex();
+    return true;
+}
+
+void FileUtils::removeAssetPack(const std::string& filename)
+{
+    DECLARE_GUARD;
+    auto assetPacks = std::atomic_load(&_assetPacks);
+    if (!assetPacks)
+        return;
+
+    const std::string fullPath = fullPathForFilename(filename);
+    auto newAssetPacks = std::make_shared<AssetPackList>();
+    for (const auto& pack : *assetPacks)
+    {
+        if (pack->getPath() != fullPath)
+            newAssetPacks->push_back(pack);
+    }
+    std::atomic_store(&_assetPacks, std::shared_ptr<const AssetPackList>(newAssetPacks));
+
+    _fullPathCache.clear();
+    invalidateResourceIndex();
+}
+
+std::shared_ptr<AssetPack> FileUtils::findAssetPack(const std::string& fullPath, std::string* name) const
+{
+    auto assetPacks = std::atomic_load(&_assetPacks);
+    if (!assetPacks)
+        return nullptr;
+
+    for (const auto& pack : *assetPacks)
+    {
+        const std::string& packPath = pack->getPath();
+        if (fullPath.length() > packPath.length() + 1
+            && fullPath[packPath.length()] == '/'
+            && fullPath.compare(0, packPath.length(), packPath) == 0)
+        {
+            name->assign(fullPath, packPath.length() + 1, std::string::npos);
+            return pack;
+        }
+    }
+    return nullptr;
+}
+
+void FileUtils::invalidateResourceIndex() const
+{
+    std::atomic_store(&_resourceIndex, std::shared_ptr<const ResourceIndex>());
+}
+
+std::shared_ptr<const FileUtils::ResourceIndex> FileUtils::getResourceIndex() const
+{
+    auto index = std::atomic_load(&_resourceIndex);
+    if (index)
+        return index;
+
+    DECLARE_GUARD;
+    // another thread may have built it while waiting for the lock
+    index = std::atomic_load(&_resourceIndex);
+    if (!index)
+    {
+        index = buildResourceIndex();
+        std::atomic_store(&_resourceIndex, index);
+    }
+    return index;
+}
+
+std::shared_ptr<const FileUtils::ResourceIndex> FileUtils::buildResourceIndex() const
+{
+    auto index = std::make_shared<ResourceIndex>();
+    index->complete = false;
+
+    // same priority as the search in fullPathForFilename(): asset packs, search paths, then resolutions
+    std::unordered_map<std::string, size_t> priorities;
+    const size_t resolutionCount = _searchResolutionsOrderArray.size();
+
+    auto assetPacks = std::atomic_load(&_assetPacks);
+    const size_t packCount = assetPacks ? assetPacks->size() : 0;
+    for (size_t packIndex = 0; packIndex < packCount; ++packIndex)
+    {
+        const auto& pack = (*assetPacks)[packIndex];
+        for (const auto& name : pack->listFiles())
+        {
+            if (priorities.emplace(name, packIndex).second)
+            {
+                index->fullPaths[name] = pack->getPath() + "/" + name;
+            }
+        }
+    }
+
+    for (size_t searchIndex = 0; searchIndex < _searchPathArray.size(); ++searchIndex)
+    {
+        const std::string& searchPath = _searchPathArray[searchIndex];
+        // relative search paths aren't directories, e.g. the apk on Android
+        if (searchPath.empty() || !isAbsolutePath(searchPath))
+            return index;
+
+        std::vector<std::string> files;
+        if (isDirectoryExistInternal(searchPath))
+        {
+            listFilesRecursively(searchPath, &files);
+            // a directory that exists but can't be listed, e.g. the assets of the apk on Android whose
+            // paths look absolute: fall back to the search of every file. An empty directory does the same.
+            if (files.empty())
+                return index;
+        }
+
+        for (const auto& path : files)
+        {
+            if (path.back() == '/')
+                continue;
+            if (path.compare(0, searchPath.length(), searchPath) != 0)
+                return index;
+
+            const size_t namePos = path.find_last_of('/') + 1;
+            const std::string directory = path.substr(searchPath.length(), namePos - searchPath.length());
+
+            for (size_t resolutionIndex = 0; resolutionIndex < resolutionCount; ++resolutionIndex)
+            {
+                // the file is searched as directory + resolution + file name
+                const std::string& resolution = _searchResolutionsOrderArray[resolutionIndex];
+                if (resolution.length() > directory.length()
+                    || directory.compare(directory.length() - resolution.length(), resolution.length(), resolution) != 0
+                    || (resolution.length() < directory.length() && directory[directory.length() - resolution.length() - 1] != '/'))
+                {
+                    continue;
+                }
+
+                std::string name = directory.substr(0, directory.length() - resolution.length());
+                name.append(path, namePos, std::string::npos);
+
+                const size_t priority = packCount + searchIndex * resolutionCount + resolutionIndex;
+                auto iter = priorities.find(name);
+                if (iter == priorities.end() || priority < iter->second)
+                {
+                    priorities[name] = priority;
+                    index->fullPaths[name] = path;
+                }
+            }
+        }
+    }
+
+    // names in the lookup dictionary are searched with their new name
+    std::vector<std::pair<std::string, std::string>> lookups;
+    for (const auto& iter : _filenameLookupDict)
+    {
+        auto found = index->fullPaths.find(iter.second.asString());
+        lookups.push_back(std::make_pair(iter.first, found != index->fullPaths.end() ? found->second : std::string()));
+    }
+    for (const auto& lookup : lookups)
+    {
+        if (lookup.second.empty())
+            index->fullPaths.erase(lookup.first);
+        else
+            index->fullPaths[lookup.first] = lookup.second;
+    }
+
+    index->complete = true;
+    return index;
+}
+
+std::string FileUtils::fullPathForFilename(const std::string &filename) const
+{
     if (filename.empty())
     {
         return "";
     }
 
+    // already resolved to a file of an asset pack
+    std::string packName;
+    if (findAssetPack(filename, &packName))
+    {
+        return filename;
+    }
+
+    if (_resourceIndexEnabled
+        && filename.find("./") == std::string::npos
+        && filename.find("//") == std::string::npos
+        && filename.find('\\') == std::string::npos
+        && !isAbsolutePath(filename))
+    {
+        auto index = getResourceIndex();
+        if (index->complete)
+        {
+            auto iter = index->fullPaths.find(filename);
+            if (iter != index->fullPaths.end())
+            {
+                return iter->second;
+            }
+
+            if(isPopupNotify()){
+                CCLOG("cocos2d: fullPathForFilename: No file found at %s. Possible missing file.", filename.c_str());
+            }
+            return "";
+        }
+    }
+
+    DECLARE_GUARD;
+
     if (isAbsolutePath(filename))
     {
         return filename;
@@ -841,6 +1122,21 @@ std::string FileUtils::fullPathForFilename(const std::string &filename) const
 
     std::string fullpath;
 
+    // the asset packs are searched first
+    auto assetPacks = std::atomic_load(&_assetPacks);
+    if (assetPacks)
+    {
+        for (const auto& pack : *assetPacks)
+        {
+            if (pack->fileExists(newFilename))
+            {
+                fullpath = pack->getPath() + "/" + newFilename;
+                _fullPathCache.emplace(filename, fullpath);
+                return fullpath;
+            }
+        }
+    }
+
     for (const auto& searchIt : _searchPathArray)
     {
         for (const auto& resolutionIt : _searchResolutionsOrderArray)
@@ -937,6 +1233,7 @@ void FileUtils::setSearchResolutionsOrder(const std::vector<std::string>& search
 
     _fullPathCache.clear();
     _fullPathCacheDir.clear();
+    invalidateResourceIndex();
     _searchResolutionsOrderArray.clear();
     for(const auto& iter : searchResolutionsOrder)
     {
@@ -964,6 +1261,7 @@ void FileUtils::addSearchResolutionsOrder(const std::string &order,const bool fr
 {
     
     DECLARE_GUARD;
+    invalidateResourceIndex();
 
     std::string resOrder = order;
     if (!resOrder.empty() && resOrder[resOrder.length()-1] != '/')
@@ -1013,6 +1311,7 @@ void FileUtils::setDefaultResourceRootPath(const std::string& path)
     {
         _fullPathCache.clear();
         _fullPathCacheDir.clear();
+        invalidateResourceIndex();
         _defaultResRootPath = path;
         if (!_defaultResRootPath.empty() && _defaultResRootPath[_defaultResRootPath.length()-1] != '/')
         {
@@ -1032,6 +1331,7 @@ void FileUtils::setSearchPaths(const std::vector<std::string>& searchPaths)
 
     _fullPathCache.clear();
     _fullPathCacheDir.clear();
+    invalidateResourceIndex();
     _searchPathArray.clear();
 
     for (const auto& path : _originalSearchPaths)
@@ -1065,6 +1365,7 @@ void FileUtils::setSearchPaths(const std::vector<std::string>& searchPaths)
 void FileUtils::addSearchPath(const std::string &searchpath,const bool front)
 {
     DECLARE_GUARD;
+    invalidateResourceIndex();
     std::string prefix;
     if (!isAbsolutePath(searchpath))
         prefix = _defaultResRootPath;
@@ -1089,6 +1390,7 @@ void FileUtils::setFilenameLookupDictionary(const ValueMap& filenameLookupDict)
     DECLARE_GUARD;
     _fullPathCache.clear();
     _fullPathCacheDir.clear();
+    invalidateResourceIndex();
     _filenameLookupDict = filenameLookupDict;
 }
 
@@ -1129,6 +1431,12 @@ std::string FileUtils::getFullPathForFilenameWithinDirectory(const std::string&
 
 bool FileUtils::isFileExist(const std::string& filename) const
 {
+    std::string packName;
+    if (auto pack = findAssetPack(filename, &packName))
+    {
+        return pack->fileExists(packName);
+    }
+
     if (isAbsolutePath(filename))
     {
         return isFileExistInternal(filename);
@@ -31,6 +31,8 @@ THE SOFTWARE.
 #include <unordered_map>
 #include <type_traits>
 #include <mutex>
+#include <memory>
+#include <atomic>
 
 #include "platform/CCPlatformMacros.h"
 #include "base/ccTypes.h"
@@ -42,6 +44,8 @@ THE SOFTWARE.
 
 NS_CC_BEGIN
 
+class AssetPack;
+
 /**
  * @addtogroup platform
  * @{
@@ -118,6 +122,36 @@ public:
     }
 };
 
+/**
+ * Read-only view of the contents of a file, returned by FileUtils::mapFile.
+ * The contents are memory mapped when possible, else read in memory.
+ * Copies share the contents, which are released with the last copy.
+ */
+class CC_DLL FileView
+{
+public:
+    FileView() : _bytes(nullptr), _size(0) {}
+    /** A view of bytes kept alive by owner. */
+    FileView(const unsigned char* bytes, ssize_t size, const std::shared_ptr<const void>& owner)
+    : _bytes(bytes), _size(size), _owner(owner) {}
+
+    /** Gets the contents, nullptr when the file couldn't be read or is empty. */
+    const unsigned char* getBytes() const { return _bytes; }
+    /** Gets the size of the contents. */
+    ssize_t getSize() const { return _size; }
+    /** Whether the view has no contents. */
+    bool isNull() const { return _bytes == nullptr || _size == 0; }
+    /** Returns a view of a part of the contents, sharing them. */
+    FileView subView(ssize_t offset, ssize_t size) const { return FileView(_bytes + offset, size, _owner); }
+    /** Releases the view. */
+    void clear() { _bytes = nullptr; _size = 0; _owner.reset(); }
+
+private:
+    const unsigned char* _bytes;
+    ssize_t _size;
+    std::shared_ptr<const void> _owner;
+};
+
 /** Helper class to handle file operations. */
 class CC_DLL FileUtils
 {
@@ -274,6 +308,18 @@ public:
     }
     virtual Status getContents(const std::string& filename, ResizableBuffer* buffer) const;
 
+    /**
+     *  Maps the contents of a file in memory, read-only, instead of copying them in a buffer.
+     *  Pages are loaded by the system as they are read and aren't counted in the heap.
+     *  Small files, files in the Android apk which are compressed, and platforms without
+     *  mapping fall back to reading the contents.
+     *
+     *  @param[in]  filename The resource file name which contains the path.
+     *  @return A view of the contents, null if the file can't be read.
+     *  @since v3.17
+     */
+    virtual FileView mapFile(const std::string& filename) const;
+
     /**
      *  Gets resource file data
      *
@@ -847,6 +893,48 @@ public:
     /** Returns the full path cache. */
     const std::unordered_map<std::string, std::string> getFullPathCache() const { return _fullPathCache; }
 
+    /**
+     *  Enables the resource index, disabled by default.
+     *  The files under the search paths are listed once, and fullPathForFilename() then resolves
+     *  found and missing files with a lookup, without checking the file system and without locking,
+     *  so it can be called from several threads.
+     *  The index is rebuilt on first use after the search paths, the resolution orders or the
+     *  filename lookup dictionary change. Call purgeCachedEntries() after adding or removing files
+     *  in the search paths.
+     *
+     *  @note The index is only used when all the search paths are absolute directories which can be
+     *        listed, it isn't on Android where the resources are in the apk. Names containing "./", "//"
+     *        or backslashes are resolved by checking the file system.
+     *  @param enabled Whether the resource index is used.
+     *  @since v3.17
+     */
+    void setResourceIndexEnabled(bool enabled);
+
+    /** Whether the resource index is used by fullPathForFilename(). */
+    bool isResourceIndexEnabled() const { return _resourceIndexEnabled; }
+
+    /**
+     *  Mounts an asset pack (.ccpk) built by tools/asset-pack/pack_assets.py, see AssetPack.
+     *  fullPathForFilename() finds the files of the mounted packs before the files of the search paths,
+     *  and returns their path in the pack: "<full path of the pack>/<name>".
+     *  getContents(), getDataFromFile(), mapFile() and isFileExist() read these paths from the pack,
+     *  from any thread, and several files can be decompressed in parallel.
+     *
+     *  @param filename The pack file name.
+     *  @param front Whether the pack is searched before the packs already mounted.
+     *  @return True if the pack was opened.
+     *  @since v3.17
+     */
+    bool addAssetPack(const std::string& filename, bool front = false);
+
+    /**
+     *  Unmounts an asset pack.
+     *  Views of its files returned by mapFile() stay valid.
+     *
+     *  @param filename The pack file name, as given to addAssetPack().
+     */
+    void removeAssetPack(const std::string& filename);
+
     /**
      *  Gets the new filename from the filename lookup dictionary.
      *  It is possible to have a override names.
@@ -920,6 +1008,27 @@ protected:
     */
     mutable std::recursive_mutex _mutex;
 
+    /** Immutable snapshot of the files under the search paths, see setResourceIndexEnabled(). */
+    struct ResourceIndex;
+
+    /** Gets the current resource index, building it if needed. */
+    std::shared_ptr<const ResourceIndex> getResourceIndex() const;
+
+    /** Lists the search paths and maps the names of the files to their full paths. */
+    std::shared_ptr<const ResourceIndex> buildResourceIndex() const;
+
+    /** Drops the resource index, it will be rebuilt on first use. */
+    void invalidateResourceIndex() const;
+
+    /**
+     *  Gets the mounted asset pack containing a full path returned by fullPathForFilename().
+     *
+     *  @param fullPath The full path.
+     *  @param[out] name The name of the file in the pack.
+     *  @return The pack, nullptr if the path isn't in a pack.
+     */
+    std::shared_ptr<AssetPack> findAssetPack(const std::string& fullPath, std::string* name) const;
+
 
     /** Dictionary used to lookup filenames based on a key.
      *  It is used internally by the following methods:
@@ -968,6 +1077,19 @@ protected:
      */
     mutable std::unordered_map<std::string, std::string> _fullPathCacheDir;
 
+    /** Whether fullPathForFilename() uses the resource index. */
+    std::atomic<bool> _resourceIndexEnabled;
+
+    /**
+     *  The resource index, read and replaced with std::atomic_load / std::atomic_store,
+     *  so readers never see a partially built index.
+     */
+    mutable std::shared_ptr<const ResourceIndex> _resourceIndex;
+
+    typedef std::vector<std::shared_ptr<AssetPack>> AssetPackList;
+    /** The mounted asset packs, replaced with std::atomic_store when a pack is added or removed. */
+    std::shared_ptr<const AssetPackList> _assetPacks;
+
     /**
      * Writable path.
      */
@@ -28,10 +28,13 @@ THE SOFTWARE.
 #include "platform/CCImage.h"
 
 #include <string>
+#include <vector>
+#include <algorithm>
 #include <ctype.h>
 
 #include "base/CCData.h"
 #include "base/ccConfig.h" // CC_USE_JPEG, CC_USE_TIFF, CC_USE_WEBP
+#include "renderer/ccPixelConvert.h"
 
 extern "C"
 {
@@ -452,6 +455,61 @@ namespace
             png_error(png_ptr, "pngReaderCallback failed");
         }
     }
+
+    // sets the transformations reading 8 bit gray, gray alpha, RGB or RGBA rows, and returns their format
+    static Texture2D::PixelFormat setPngTransforms(png_structp png_ptr, png_infop info_ptr)
+    {
+        png_byte bit_depth = png_get_bit_depth(png_ptr, info_ptr);
+        png_uint_32 color_type = png_get_color_type(png_ptr, info_ptr);
+
+        //CCLOG("color type %u", color_type);
+
+        // force palette images to be expanded to 24-bit RGB
+        // it may include alpha channel
+        if (color_type == PNG_COLOR_TYPE_PALETTE)
+        {
+            png_set_palette_to_rgb(png_ptr);
+        }
+        // low-bit-depth grayscale images are to be expanded to 8 bits
+        if (color_type == PNG_COLOR_TYPE_GRAY && bit_depth < 8)
+        {
+            bit_depth = 8;
+            png_set_expand_gray_1_2_4_to_8(png_ptr);
+        }
+        // expand any tRNS chunk data into a full alpha channel
+        if (png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS))
+        {
+            png_set_tRNS_to_alpha(png_ptr);
+        }  
+        // reduce images with 16-bit samples to 8 bits
+        if (bit_depth == 16)
+        {
+            png_set_strip_16(png_ptr);            
+        } 
+
+        // Expanded earlier for grayscale, now take care of palette and rgb
+        if (bit_depth < 8)
+        {
+            png_set_packing(png_ptr);
+        }
+        // update info
+        png_read_update_info(png_ptr, info_ptr);
+        color_type = png_get_color_type(png_ptr, info_ptr);
+
+        switch (color_type)
+        {
+        case PNG_COLOR_TYPE_GRAY:
+            return Texture2D::PixelFormat::I8;
+        case PNG_COLOR_TYPE_GRAY_ALPHA:
+            return Texture2D::PixelFormat::AI88;
+        case PNG_COLOR_TYPE_RGB:
+            return Texture2D::PixelFormat::RGB888;
+        case PNG_COLOR_TYPE_RGB_ALPHA:
+            return Texture2D::PixelFormat::RGBA8888;
+        default:
+            return Texture2D::PixelFormat::NONE;
+        }
+    }
 #endif //CC_USE_PNG
 }
 
@@ -511,7 +569,8 @@ bool Image::initWithImageFile(const std::string& path)
     bool ret = false;
     _filePath = FileUtils::getInstance()->fullPathForFilename(path);
 
-    Data data = FileUtils::getInstance()->getDataFromFile(_filePath);
+    // the decoders copy the pixels out, so the file can be read in place
+    FileView data = FileUtils::getInstance()->mapFile(_filePath);
 
     if (!data.isNull())
     {
@@ -526,7 +585,8 @@ bool Image::initWithImageFileThreadSafe(const std::string& fullpath)
     bool ret = false;
     _filePath = fullpath;
 
-    Data data = FileUtils::getInstance()->getDataFromFile(fullpath);
+    // the decoders copy the pixels out, so the file can be read in place
+    FileView data = FileUtils::getInstance()->mapFile(fullpath);
 
     if (!data.isNull())
     {
@@ -1064,61 +1124,9 @@ bool Image::initWithPngData(const unsigned char * data, ssize_t dataLen)
 
         _width = png_get_image_width(png_ptr, info_ptr);
         _height = png_get_image_height(png_ptr, info_ptr);
-        png_byte bit_depth = png_get_bit_depth(png_ptr, info_ptr);
+        _renderFormat = setPngTransforms(png_ptr, info_ptr);
         png_uint_32 color_type = png_get_color_type(png_ptr, info_ptr);
 
-        //CCLOG("color type %u", color_type);
-
-        // force palette images to be expanded to 24-bit RGB
-        // it may include alpha channel
-        if (color_type == PNG_COLOR_TYPE_PALETTE)
-        {
-            png_set_palette_to_rgb(png_ptr);
-        }
-        // low-bit-depth grayscale images are to be expanded to 8 bits
-        if (color_type == PNG_COLOR_TYPE_GRAY && bit_depth < 8)
-        {
-            bit_depth = 8;
-            png_set_expand_gray_1_2_4_to_8(png_ptr);
-        }
-        // expand any tRNS chunk data into a full alpha channel
-        if (png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS))
-        {
-            png_set_tRNS_to_alpha(png_ptr);
-        }  
-        // reduce images with 16-bit samples to 8 bits
-        if (bit_depth == 16)
-        {
-            png_set_strip_16(png_ptr);            
-        } 
-
-        // Expanded earlier for grayscale, now take care of palette and rgb
-        if (bit_depth < 8)
-        {
-            png_set_packing(png_ptr);
-        }
-        // update info
-        png_read_update_info(png_ptr, info_ptr);
-        color_type = png_get_color_type(png_ptr, info_ptr);
-
-        switch (color_type)
-        {
-        case PNG_COLOR_TYPE_GRAY:
-            _renderFormat = Texture2D::PixelFormat::I8;
-            break;
-        case PNG_COLOR_TYPE_GRAY_ALPHA:
-            _renderFormat = Texture2D::PixelFormat::AI88;
-            break;
-        case PNG_COLOR_TYPE_RGB:
-            _renderFormat = Texture2D::PixelFormat::RGB888;
-            break;
-        case PNG_COLOR_TYPE_RGB_ALPHA:
-            _renderFormat = Texture2D::PixelFormat::RGBA8888;
-            break;
-        default:
-            break;
-        }
-
         // read png data
         png_size_t rowbytes;
         png_bytep* row_pointers = (png_bytep*)malloc( sizeof(png_bytep) * _height );
@@ -1178,6 +1186,207 @@ bool Image::initWithPngData(const unsigned char * data, ssize_t dataLen)
 #endif //CC_USE_PNG
 }
 
+bool Image::canDecodeInStripes(const unsigned char * data, ssize_t dataLen)
+{
+#if CC_USE_WIC
+    return false;
+#else
+#if CC_USE_PNG
+    // the IHDR chunk comes first, its interlace method is at offset 28
+    if (isPng(data, dataLen))
+        return dataLen > 28 && data[28] == PNG_INTERLACE_NONE;
+#endif
+#if CC_USE_JPEG
+    if (isJpg(data, dataLen))
+        return true;
+#endif
+    return false;
+#endif // CC_USE_WIC
+}
+
+bool Image::initWithImageDataInStripes(const unsigned char * data, ssize_t dataLen, size_t stripeSize, const std::function<bool()>& onHeader, const StripeCallback& onStripe)
+{
+    if (!data || dataLen <= 0 || !canDecodeInStripes(data, dataLen))
+        return false;
+
+    if (isPng(data, dataLen))
+        return initWithPngDataInStripes(data, dataLen, stripeSize, onHeader, onStripe);
+    return initWithJpgDataInStripes(data, dataLen, stripeSize, onHeader, onStripe);
+}
+
+bool Image::initWithJpgDataInStripes(const unsigned char * data, ssize_t dataLen, size_t stripeSize, const std::function<bool()>& onHeader, const StripeCallback& onStripe)
+{
+#if CC_USE_JPEG && !CC_USE_WIC
+    struct jpeg_decompress_struct cinfo;
+    struct MyErrorMgr jerr;
+    std::vector<unsigned char> stripe;
+    std::vector<JSAMPROW> rowPointers;
+
+    bool ret = false;
+    do
+    {
+        cinfo.err = jpeg_std_error(&jerr.pub);
+        jerr.pub.error_exit = myErrorExit;
+        if (setjmp(jerr.setjmp_buffer))
+        {
+            jpeg_destroy_decompress(&cinfo);
+            break;
+        }
+
+        jpeg_create_decompress( &cinfo );
+
+#ifndef CC_TARGET_QT5
+        jpeg_mem_src(&cinfo, const_cast<unsigned char*>(data), dataLen);
+#endif /* CC_TARGET_QT5 */
+
+        jpeg_read_header(&cinfo, TRUE);
+
+        // we only support RGB or grayscale
+        if (cinfo.jpeg_color_space == JCS_GRAYSCALE)
+        {
+            _renderFormat = Texture2D::PixelFormat::I8;
+        }else
+        {
+            cinfo.out_color_space = JCS_RGB;
+            _renderFormat = Texture2D::PixelFormat::RGB888;
+        }
+
+        jpeg_start_decompress( &cinfo );
+
+        _fileType = Format::JPG;
+        _width  = cinfo.output_width;
+        _height = cinfo.output_height;
+        if (!onHeader())
+        {
+            jpeg_destroy_decompress( &cinfo );
+            break;
+        }
+
+        const size_t rowBytes = cinfo.output_width * cinfo.output_components;
+        const int stripeRows = std::max(1, std::min(_height, (int)(stripeSize / rowBytes)));
+        stripe.resize(rowBytes * stripeRows);
+        rowPointers.resize(stripeRows);
+        for (int row = 0; row < stripeRows; ++row)
+        {
+            rowPointers[row] = stripe.data() + row * rowBytes;
+        }
+
+        bool decoded = true;
+        while (decoded && cinfo.output_scanline < cinfo.output_height)
+        {
+            const int y = cinfo.output_scanline;
+            const int rows = std::min(stripeRows, _height - y);
+            for (int row = 0; row < rows && decoded; )
+            {
+                JDIMENSION count = jpeg_read_scanlines(&cinfo, &rowPointers[row], rows - row);
+                decoded = count > 0;
+                row += count;
+            }
+            decoded = decoded && onStripe(stripe.data(), y, rows);
+        }
+
+        // like initWithJpgData, the decompression isn't finished since broken data may cause an error
+        jpeg_destroy_decompress( &cinfo );
+        ret = decoded;
+    } while (0);
+
+    return ret;
+#else
+    CC_UNUSED_PARAM(data);
+    CC_UNUSED_PARAM(dataLen);
+    CC_UNUSED_PARAM(stripeSize);
+    CC_UNUSED_PARAM(onHeader);
+    CC_UNUSED_PARAM(onStripe);
+    return false;
+#endif // CC_USE_JPEG && !CC_USE_WIC
+}
+
+bool Image::initWithPngDataInStripes(const unsigned char * data, ssize_t dataLen, size_t stripeSize, const std::function<bool()>& onHeader, const StripeCallback& onStripe)
+{
+#if CC_USE_PNG && !CC_USE_WIC
+    bool ret = false;
+    png_structp     png_ptr     = 0;
+    png_infop       info_ptr    = 0;
+    std::vector<unsigned char> stripe;
+
+    do
+    {
+        png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, 0, 0, 0);
+        CC_BREAK_IF(! png_ptr);
+
+        info_ptr = png_create_info_struct(png_ptr);
+        CC_BREAK_IF(!info_ptr);
+
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_BADA && CC_TARGET_PLATFORM != CC_PLATFORM_NACL && CC_TARGET_PLATFORM != CC_PLATFORM_TIZEN)
+        CC_BREAK_IF(setjmp(png_jmpbuf(png_ptr)));
+#endif
+
+        tImageSource imageSource;
+        imageSource.data    = (unsigned char*)data;
+        imageSource.size    = dataLen;
+        imageSource.offset  = 0;
+        png_set_read_fn(png_ptr, &imageSource, pngReadCallback);
+
+        png_read_info(png_ptr, info_ptr);
+        // the passes of interlaced images fill the rows several times
+        CC_BREAK_IF(png_get_interlace_type(png_ptr, info_ptr) != PNG_INTERLACE_NONE);
+
+        _fileType = Format::PNG;
+        _width = png_get_image_width(png_ptr, info_ptr);
+        _height = png_get_image_height(png_ptr, info_ptr);
+        _renderFormat = setPngTransforms(png_ptr, info_ptr);
+        CC_BREAK_IF(_renderFormat == Texture2D::PixelFormat::NONE);
+
+        // premultiplied alpha for RGBA8888, like initWithPngData
+        bool premultiply = false;
+        if (_renderFormat == Texture2D::PixelFormat::RGBA8888)
+        {
+#if CC_ENABLE_PREMULTIPLIED_ALPHA != 0
+            premultiply = PNG_PREMULTIPLIED_ALPHA_ENABLED;
+            _hasPremultipliedAlpha = true;
+#endif
+        }
+        CC_BREAK_IF(!onHeader());
+
+        const size_t rowBytes = png_get_rowbytes(png_ptr, info_ptr);
+        const int stripeRows = std::max(1, std::min(_height, (int)(stripeSize / rowBytes)));
+        stripe.resize(rowBytes * stripeRows);
+
+        bool decoded = true;
+        for (int y = 0; y < _height && decoded; y += stripeRows)
+        {
+            const int rows = std::min(stripeRows, _height - y);
+            for (int row = 0; row < rows; ++row)
+            {
+                png_read_row(png_ptr, stripe.data() + row * rowBytes, nullptr);
+            }
+            if (premultiply)
+            {
+                PixelConvert::premultiplyAlphaRGBA8888(stripe.data(), (ssize_t)_width * rows);
+            }
+            decoded = onStripe(stripe.data(), y, rows);
+        }
+        CC_BREAK_IF(!decoded);
+
+        png_read_end(png_ptr, nullptr);
+        ret = true;
+    } while (0);
+
+    if (png_ptr)
+    {
+        png_destroy_read_struct(&png_ptr, (info_ptr) ? &info_ptr : 0, 0);
+    }
+    return ret;
+#else
+    CC_UNUSED_PARAM(data);
+    CC_UNUSED_PARAM(dataLen);
+    CC_UNUSED_PARAM(stripeSize);
+    CC_UNUSED_PARAM(onHeader);
+    CC_UNUSED_PARAM(onStripe);
+    return false;
+#endif // CC_USE_PNG && !CC_USE_WIC
+}
+
 #if CC_USE_TIFF
 namespace
 {
@@ -2462,12 +2671,7 @@ void Image::premultipliedAlpha()
 #else
     CCASSERT(_renderFormat == Texture2D::PixelFormat::RGBA8888, "The pixel format should be RGBA8888!");
     
-    unsigned int* fourBytes = (unsigned int*)_data;
-    for(int i = 0; i < _width * _height; i++)
-    {
-        unsigned char* p = _data + i * 4;
-        fourBytes[i] = CC_RGB_PREMULTIPLY_ALPHA(p[0], p[1], p[2], p[3]);
-    }
+    PixelConvert::premultiplyAlphaRGBA8888(_data, (ssize_t)_width * _height);
     
     _hasPremultipliedAlpha = true;
 #endif
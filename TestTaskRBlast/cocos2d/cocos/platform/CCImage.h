@@ -28,6 +28,7 @@ THE SOFTWARE.
 #define __CC_IMAGE_H__
 /// @cond DO_NOT_SHOW
 
+#include <functional>
 #include "base/CCRef.h"
 #include "renderer/CCTexture2D.h"
 
@@ -133,6 +134,32 @@ public:
     */
     bool initWithImageData(const unsigned char * data, ssize_t dataLen);
 
+    /** Receives the rows decoded by initWithImageDataInStripes.
+     @param pixels  the rows, in the render format of the image.
+     @param y  index of the first row, from the top.
+     @param rows  number of rows.
+     @return false to stop decoding.
+     */
+    typedef std::function<bool(const unsigned char* pixels, int y, int rows)> StripeCallback;
+
+    /** Whether the data is a file initWithImageDataInStripes can decode: a PNG file which isn't interlaced or a JPEG file. */
+    bool canDecodeInStripes(const unsigned char * data, ssize_t dataLen);
+
+    /**
+    @brief Decodes a PNG or JPEG file in stripes of rows, so that all its pixels are never held in memory.
+    The image gets the size, the render format and the premultiplied alpha flag of the file, but no data.
+    The rows are premultiplied like initWithImageData does.
+    @param data  stream buffer which holds the image data.
+    @param dataLen  data length expressed in (number of) bytes.
+    @param stripeSize  maximum size of a stripe in bytes, a stripe has at least one row.
+    @param onHeader  called once the size and the format are known, returns false to stop decoding.
+    @param onStripe  called for each stripe, from the top.
+    @return true if the whole image was decoded, false if it isn't supported by canDecodeInStripes or broken.
+    * @js NA
+    * @lua NA
+    */
+    bool initWithImageDataInStripes(const unsigned char * data, ssize_t dataLen, size_t stripeSize, const std::function<bool()>& onHeader, const StripeCallback& onStripe);
+
     // @warning kFmtRawData only support RGBA8888
     bool initWithRawData(const unsigned char * data, ssize_t dataLen, int width, int height, int bitsPerComponent, bool preMulti = false);
 
@@ -168,6 +195,8 @@ protected:
 #endif
     bool initWithJpgData(const unsigned char *  data, ssize_t dataLen);
     bool initWithPngData(const unsigned char * data, ssize_t dataLen);
+    bool initWithJpgDataInStripes(const unsigned char * data, ssize_t dataLen, size_t stripeSize, const std::function<bool()>& onHeader, const StripeCallback& onStripe);
+    bool initWithPngDataInStripes(const unsigned char * data, ssize_t dataLen, size_t stripeSize, const std::function<bool()>& onHeader, const StripeCallback& onStripe);
     bool initWithTiffData(const unsigned char * data, ssize_t dataLen);
     bool initWithWebpData(const unsigned char * data, ssize_t dataLen);
     bool initWithPVRData(const unsigned char * data, ssize_t dataLen);
@@ -34,6 +34,7 @@ THE SOFTWARE.
 #include "android/asset_manager.h"
 #include "android/asset_manager_jni.h"
 #include "base/ZipUtils.h"
+#include "base/CCAssetPack.h"
 
 #include <stdlib.h>
 #include <sys/stat.h>
@@ -352,6 +353,13 @@ FileUtils::Status FileUtilsAndroid::getContents(const std::string& filename, Res
 
     string fullPath = fullPathForFilename(filename);
 
+    if (fullPath.empty())
+        return FileUtils::Status::NotExists;
+
+    std::string packName;
+    if (auto pack = findAssetPack(fullPath, &packName))
+        return pack->getFileData(packName, buffer) ? FileUtils::Status::OK : FileUtils::Status::NotExists;
+
     if (fullPath[0] == '/')
         return FileUtils::getContents(fullPath, buffer);
 
@@ -396,6 +404,62 @@ FileUtils::Status FileUtilsAndroid::getContents(const std::string& filename, Res
     return FileUtils::Status::OK;
 }
 
+FileView FileUtilsAndroid::mapFile(const std::string& filename) const
+{
+    static const std::string apkprefix("assets/");
+    if (filename.empty())
+        return FileView();
+
+    string fullPath = fullPathForFilename(filename);
+
+    if (fullPath.empty() || fullPath[0] == '/')
+        return FileUtils::mapFile(fullPath);
+
+    std::string packName;
+    if (auto pack = findAssetPack(fullPath, &packName))
+        return pack->getFile(packName);
+
+    string relativePath = string();
+    size_t position = fullPath.find(apkprefix);
+    if (0 == position) {
+        // "assets/" is at the beginning of the path and we don't want it
+        relativePath += fullPath.substr(apkprefix.size());
+    } else {
+        relativePath = fullPath;
+    }
+
+    if (obbfile)
+    {
+        FileView view = obbfile->mapFile(relativePath);
+        if (!view.isNull())
+            return view;
+    }
+
+    if (nullptr == assetmanager) {
+        LOGD("... FileUtilsAndroid::assetmanager is nullptr");
+        return FileView();
+    }
+
+    // uncompressed assets are mapped from the apk, compressed ones are inflated once by the asset manager
+    AAsset* asset = AAssetManager_open(assetmanager, relativePath.data(), AASSET_MODE_BUFFER);
+    if (nullptr == asset) {
+        LOGD("asset is nullptr");
+        return FileView();
+    }
+
+    auto size = AAsset_getLength(asset);
+    auto bytes = static_cast<const unsigned char*>(AAsset_getBuffer(asset));
+    if (nullptr == bytes || size < CC_MAP_FILE_MIN_SIZE) {
+        AAsset_close(asset);
+        return FileUtils::mapFile(fullPath);
+    }
+
+    std::shared_ptr<const void> owner(asset, [](AAsset* a) {
+        AAsset_close(a);
+    });
+    return FileView(bytes, size, owner);
+}
+
 string FileUtilsAndroid::getWritablePath() const
 {
     // Fix for Nexus 10 (Android 4.2 multi-user environment)
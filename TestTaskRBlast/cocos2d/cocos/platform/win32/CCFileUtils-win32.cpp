@@ -30,6 +30,8 @@ THE SOFTWARE.
 #include "platform/win32/CCFileUtils-win32.h"
 #include "platform/win32/CCUtils-win32.h"
 #include "platform/CCCommon.h"
+#include "base/ccConfig.h"
+#include "base/CCAssetPack.h"
 #include "tinydir/tinydir.h"
 #include <Shlobj.h>
 #include <cstdlib>
@@ -180,6 +182,10 @@ FileUtils::Status FileUtilsWin32::getContents(const std::string& filename, Resiz
     // read the file from hardware
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filename);
 
+    std::string packName;
+    if (auto pack = findAssetPack(fullPath, &packName))
+        return pack->getFileData(packName, buffer) ? FileUtils::Status::OK : FileUtils::Status::NotExists;
+
     HANDLE fileHandle = ::CreateFile(StringUtf8ToWideChar(fullPath).c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, NULL, nullptr);
     if (fileHandle == INVALID_HANDLE_VALUE)
         return FileUtils::Status::OpenFailed;
@@ -211,6 +217,47 @@ FileUtils::Status FileUtilsWin32::getContents(const std::string& filename, Resiz
     return FileUtils::Status::OK;
 }
 
+FileView FileUtilsWin32::mapFile(const std::string& filename) const
+{
+    if (filename.empty())
+        return FileView();
+
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filename);
+
+    std::string packName;
+    if (auto pack = findAssetPack(fullPath, &packName))
+        return pack->getFile(packName);
+
+    HANDLE fileHandle = ::CreateFile(StringUtf8ToWideChar(fullPath).c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, NULL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+        return FileView();
+
+    DWORD hi;
+    auto size = ::GetFileSize(fileHandle, &hi);
+    if (hi > 0 || size < CC_MAP_FILE_MIN_SIZE)
+    {
+        ::CloseHandle(fileHandle);
+        return FileUtils::mapFile(filename);
+    }
+
+    HANDLE mappingHandle = ::CreateFileMapping(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    // the view keeps the file open once the handles are closed
+    ::CloseHandle(fileHandle);
+    if (mappingHandle == nullptr)
+        return FileUtils::mapFile(filename);
+
+    void* address = ::MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    ::CloseHandle(mappingHandle);
+    if (address == nullptr)
+        return FileUtils::mapFile(filename);
+
+    auto bytes = static_cast<const unsigned char*>(address);
+    std::shared_ptr<const void> owner(bytes, [](const unsigned char* p) {
+        ::UnmapViewOfFile(p);
+    });
+    return FileView(bytes, size, owner);
+}
+
 std::string FileUtilsWin32::getPathForFilename(const std::string& filename, const std::string& resolutionDirectory, const std::string& searchPath) const
 {
     std::string unixFileName = convertPathFormatToUnixStyle(filename);
@@ -112,6 +112,8 @@ protected:
 
 	virtual FileUtils::Status getContents(const std::string& filename, ResizableBuffer* buffer) const override;
 
+    virtual FileView mapFile(const std::string& filename) const override;
+
     virtual long getFileSize(const std::string &filepath) const override;
 
     /**
@@ -117,12 +117,12 @@ void UniformValue::apply()
         switch (_uniform->type) {
             case GL_SAMPLER_2D:
                 _glprogram->setUniformLocationWith1i(_uniform->location, _value.tex.textureUnit);
-                GL::bindTexture2DN(_value.tex.textureUnit, _value.tex.textureId);
+                GL::bindTexture2DN(_value.tex.textureUnit, getTextureName());
                 break;
 
             case GL_SAMPLER_CUBE:
                 _glprogram->setUniformLocationWith1i(_uniform->location, _value.tex.textureUnit);
-                GL::bindTextureN(_value.tex.textureUnit, _value.tex.textureId, GL_TEXTURE_CUBE_MAP);
+                GL::bindTextureN(_value.tex.textureUnit, getTextureName(), GL_TEXTURE_CUBE_MAP);
                 break;
 
             case GL_INT:
@@ -156,6 +156,17 @@ void UniformValue::apply()
     }
 }
 
+GLuint UniformValue::getTextureName()
+{
+    // asked at every apply: getName() marks the texture as used, and reloads it if TextureCache
+    // evicted it to stay in its memory budget
+    if (_value.tex.texture)
+    {
+        _value.tex.textureId = _value.tex.texture->getName();
+    }
+    return _value.tex.textureId;
+}
+
 void UniformValue::setCallback(const std::function<void(GLProgram*, Uniform*)> &callback)
 {
     // delete previously set callback
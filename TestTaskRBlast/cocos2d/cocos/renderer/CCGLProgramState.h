@@ -122,6 +122,8 @@ public:
     UniformValue& operator=(const UniformValue& o);
 
 protected:
+    // GL name of the sampler texture, taken from the Texture2D when there is one
+    GLuint getTextureName();
 
     enum class Type {
         VALUE,
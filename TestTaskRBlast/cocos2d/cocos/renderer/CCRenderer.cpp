@@ -206,6 +206,17 @@ Renderer::Renderer()
 ,_glViewAssigned(false)
 ,_isRendering(false)
 ,_isDepthTestFor2D(false)
+,_partialRedraw(false)
+,_partialRedrawActive(false)
+,_damageApplied(false)
+,_hasDamage(false)
+,_damagedAreaRatio(1.0f)
+,_partialFBO(0)
+,_partialTexture(0)
+,_partialDepthStencil(0)
+,_partialOldFBO(0)
+,_partialWidth(0)
+,_partialHeight(0)
 #if CC_ENABLE_CACHE_TEXTURE_DATA
 ,_cacheTextureListener(nullptr)
 #endif
@@ -235,6 +246,8 @@ Renderer::~Renderer()
 
     free(_triBatchesToDraw);
 
+    releasePartialRedrawBuffer();
+
     if (Configuration::getInstance()->supportsShareableVAO())
     {
         glDeleteVertexArrays(1, &_buffersVAO);
@@ -251,6 +264,9 @@ void Renderer::initGLView()
     _cacheTextureListener = EventListenerCustom::create(EVENT_RENDERER_RECREATED, [this](EventCustom* event){
         /** listen the event that renderer was recreated on Android/WP8 */
         this->setupBuffer();
+        // GL objects are gone with the context, the buffer is recreated by the next partial redraw
+        _partialFBO = _partialTexture = _partialDepthStencil = 0;
+        _partialWidth = _partialHeight = 0;
     });
     
     Director::getInstance()->getEventDispatcher()->addEventListenerWithFixedPriority(_cacheTextureListener, -1);
@@ -636,6 +652,12 @@ void Renderer::render()
 
     //TODO: setup camera or MVP
     _isRendering = true;
+
+    if (_partialRedrawActive && !_damageApplied)
+    {
+        applyDamage();
+    }
+
     
     if (_glViewAssigned)
     {
@@ -676,12 +698,270 @@ void Renderer::clear()
     //Enable Depth mask to make sure glClear clear the depth buffer correctly
     glDepthMask(true);
     glClearColor(_clearColor.r, _clearColor.g, _clearColor.b, _clearColor.a);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    // The color of the previous frame is kept by partial redraw, damaged areas are cleared by applyDamage()
+    glClear(_partialRedrawActive ? GL_DEPTH_BUFFER_BIT : (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
     glDepthMask(false);
 
     RenderState::StateBlock::_defaultState->setDepthWrite(false);
 }
 
+void Renderer::setPartialRedrawEnabled(bool enabled)
+{
+    if (_partialRedraw == enabled)
+        return;
+
+    CCASSERT(!_partialRedrawActive, "Can't toggle partial redraw while drawing a frame");
+    _partialRedraw = enabled;
+    _damagedAreaRatio = 1.0f;
+    discardDamage();
+
+    if (enabled)
+    {
+        addFullDamage();
+    }
+    else
+    {
+        releasePartialRedrawBuffer();
+    }
+}
+
+void Renderer::addDamage(const Rect& rect)
+{
+    if (!_partialRedraw || rect.size.width <= 0 || rect.size.height <= 0)
+        return;
+
+    if (_hasDamage)
+    {
+        _damageRect.merge(rect);
+    }
+    else
+    {
+        _damageRect = rect;
+        _hasDamage = true;
+    }
+}
+
+void Renderer::addFullDamage()
+{
+    addDamage(Rect(-1.0f, -1.0f, 2.0f, 2.0f));
+}
+
+void Renderer::discardDamage()
+{
+    _hasDamage = false;
+    _damageRect = Rect::ZERO;
+}
+
+void Renderer::setupPartialRedrawBuffer(int width, int height)
+{
+    releasePartialRedrawBuffer();
+
+    GLint oldTexture = 0;
+    GLint oldRenderBuffer = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &oldTexture);
+    glGetIntegerv(GL_RENDERBUFFER_BINDING, &oldRenderBuffer);
+
+    glGenTextures(1, &_partialTexture);
+    glBindTexture(GL_TEXTURE_2D, _partialTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindTexture(GL_TEXTURE_2D, oldTexture);
+
+    glGenRenderbuffers(1, &_partialDepthStencil);
+    glBindRenderbuffer(GL_RENDERBUFFER, _partialDepthStencil);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, oldRenderBuffer);
+
+    glGenFramebuffers(1, &_partialFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, _partialFBO);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _partialTexture, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, _partialDepthStencil);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT, GL_RENDERBUFFER, _partialDepthStencil);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        CCLOG("cocos2d: partial redraw buffer is incomplete, partial redraw disabled");
+        glBindFramebuffer(GL_FRAMEBUFFER, _partialOldFBO);
+        releasePartialRedrawBuffer();
+        _partialRedraw = false;
+        return;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, _partialOldFBO);
+
+    _partialWidth = width;
+    _partialHeight = height;
+}
+
+void Renderer::releasePartialRedrawBuffer()
+{
+    if (_partialFBO)
+        glDeleteFramebuffers(1, &_partialFBO);
+    if (_partialDepthStencil)
+        glDeleteRenderbuffers(1, &_partialDepthStencil);
+    if (_partialTexture)
+        GL::deleteTexture(_partialTexture);
+
+    _partialFBO = _partialTexture = _partialDepthStencil = 0;
+    _partialWidth = _partialHeight = 0;
+}
+
+void Renderer::beginPartialRedraw()
+{
+    auto glview = Director::getInstance()->getOpenGLView();
+    if (!_partialRedraw || !glview)
+        return;
+
+    const Size frameSize = glview->getFrameSize() * (glview->getRetinaFactor() * glview->getFrameZoomFactor());
+    const int width = static_cast<int>(frameSize.width);
+    const int height = static_cast<int>(frameSize.height);
+
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &_partialOldFBO);
+
+    if (_partialFBO == 0 || width != _partialWidth || height != _partialHeight)
+    {
+        setupPartialRedrawBuffer(width, height);
+        if (!_partialRedraw)
+            return;
+        addFullDamage();
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, _partialFBO);
+    _partialRedrawActive = true;
+    _damageApplied = false;
+}
+
+void Renderer::applyDamage()
+{
+    _damageApplied = true;
+
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    _damageScissor[0] = _damageScissor[1] = _damageScissor[2] = _damageScissor[3] = 0;
+    if (_hasDamage)
+    {
+        // One extra pixel on each side covers antialiased edges
+        const float minX = std::max(_damageRect.getMinX(), -1.0f);
+        const float minY = std::max(_damageRect.getMinY(), -1.0f);
+        const float maxX = std::min(_damageRect.getMaxX(), 1.0f);
+        const float maxY = std::min(_damageRect.getMaxY(), 1.0f);
+        GLint x0 = viewport[0] + (GLint)floorf((minX + 1.0f) * 0.5f * viewport[2]) - 1;
+        GLint y0 = viewport[1] + (GLint)floorf((minY + 1.0f) * 0.5f * viewport[3]) - 1;
+        GLint x1 = viewport[0] + (GLint)ceilf((maxX + 1.0f) * 0.5f * viewport[2]) + 1;
+        GLint y1 = viewport[1] + (GLint)ceilf((maxY + 1.0f) * 0.5f * viewport[3]) + 1;
+        x0 = std::max(x0, (GLint)0);
+        y0 = std::max(y0, (GLint)0);
+        x1 = std::min(x1, (GLint)_partialWidth);
+        y1 = std::min(y1, (GLint)_partialHeight);
+        if (x1 > x0 && y1 > y0)
+        {
+            _damageScissor[0] = x0;
+            _damageScissor[1] = y0;
+            _damageScissor[2] = x1 - x0;
+            _damageScissor[3] = y1 - y0;
+        }
+    }
+    discardDamage();
+
+    const float screenArea = (float)_partialWidth * _partialHeight;
+    _damagedAreaRatio = screenArea > 0 ? (float)_damageScissor[2] * _damageScissor[3] / screenArea : 1.0f;
+
+    // An empty box keeps the previous frame, commands still run for the offscreen targets (RenderTexture)
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(_damageScissor[0], _damageScissor[1], _damageScissor[2], _damageScissor[3]);
+    if (_damageScissor[2] > 0 && _damageScissor[3] > 0)
+    {
+        glClearColor(_clearColor.r, _clearColor.g, _clearColor.b, _clearColor.a);
+        glClear(GL_COLOR_BUFFER_BIT);
+    }
+}
+
+void Renderer::intersectScissorWithDamage()
+{
+    if (!_partialRedrawActive || !_damageApplied)
+        return;
+
+    GLint box[4];
+    glGetIntegerv(GL_SCISSOR_BOX, box);
+    GLint x0 = std::max(box[0], _damageScissor[0]);
+    GLint y0 = std::max(box[1], _damageScissor[1]);
+    GLint x1 = std::min(box[0] + box[2], _damageScissor[0] + _damageScissor[2]);
+    GLint y1 = std::min(box[1] + box[3], _damageScissor[1] + _damageScissor[3]);
+    glScissor(x0, y0, std::max(x1 - x0, (GLint)0), std::max(y1 - y0, (GLint)0));
+}
+
+bool Renderer::restoreDamageScissor()
+{
+    if (!_partialRedrawActive || !_damageApplied)
+        return false;
+
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(_damageScissor[0], _damageScissor[1], _damageScissor[2], _damageScissor[3]);
+    return true;
+}
+
+void Renderer::endPartialRedraw()
+{
+    if (!_partialRedrawActive)
+        return;
+
+    // Damage reported after the scene was rendered is drawn in the next frame
+    if (!_damageApplied)
+    {
+        applyDamage();
+    }
+
+    glDisable(GL_SCISSOR_TEST);
+    glBindFramebuffer(GL_FRAMEBUFFER, _partialOldFBO);
+    _partialRedrawActive = false;
+
+    presentPartialRedrawBuffer();
+}
+
+void Renderer::presentPartialRedrawBuffer()
+{
+    auto director = Director::getInstance();
+    auto glProgram = GLProgramCache::getInstance()->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE);
+
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    const GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+
+    glViewport(0, 0, _partialWidth, _partialHeight);
+    glDisable(GL_DEPTH_TEST);
+
+    director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
+    director->loadIdentityMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
+    glProgram->use();
+    glProgram->setUniformsForBuiltins(Mat4::IDENTITY);
+    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
+
+    static const GLfloat vertices[] = { -1.0f, -1.0f,  1.0f, -1.0f,  -1.0f, 1.0f,  1.0f, 1.0f };
+    static const GLfloat texCoords[] = { 0.0f, 0.0f,  1.0f, 0.0f,  0.0f, 1.0f,  1.0f, 1.0f };
+
+    if (Configuration::getInstance()->supportsShareableVAO())
+    {
+        GL::bindVAO(0);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GL::blendFunc(GL_ONE, GL_ZERO);
+    GL::bindTexture2D(_partialTexture);
+    GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POSITION | GL::VERTEX_ATTRIB_FLAG_TEX_COORD);
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, 0, vertices);
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, 0, texCoords);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+    if (depthTest)
+    {
+        glEnable(GL_DEPTH_TEST);
+    }
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+
+    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, 4);
+}
+
 void Renderer::setDepthTest(bool enable)
 {
     if (enable)
@@ -209,6 +209,35 @@ public:
     /** returns whether or not a rectangle is visible or not */
     bool checkVisibility(const Mat4& transform, const Size& size);
 
+    /**
+     * Enable/Disable partial redraw.
+     * The previous frame is kept in an offscreen buffer. Nodes report the screen areas they change
+     * (transform, visibility, color or content) and only these areas are cleared and redrawn.
+     * Meant for mostly static screens, disabled by default.
+     * Nodes drawing custom content that changes without any of these should call `Node::markDamaged()`.
+     */
+    void setPartialRedrawEnabled(bool enabled);
+    /** Whether partial redraw is enabled. */
+    bool isPartialRedrawEnabled() const { return _partialRedraw; }
+    /** Adds a damaged rectangle, in normalized device coordinates (-1 to 1 on both axes). */
+    void addDamage(const Rect& rect);
+    /** Damages the whole screen. */
+    void addFullDamage();
+    /** Drops the damage reported since the last frame. */
+    void discardDamage();
+    /** Returns the ratio of the screen redrawn in the last frame, 1 when partial redraw is disabled. */
+    float getDamagedAreaRatio() const { return _damagedAreaRatio; }
+    /** Restricts the current scissor box to the damaged area, called by nodes clipping with the scissor test. */
+    void intersectScissorWithDamage();
+    /** Restores the scissor test of the damaged area, called instead of disabling the scissor test. Returns false when no partial redraw is in progress. */
+    bool restoreDamageScissor();
+    /** Whether a partial redraw is in progress, the scissor test is then used for the damaged area. */
+    bool isPartialRedrawActive() const { return _partialRedrawActive; }
+
+    //This will be used by Director only.
+    void beginPartialRedraw();
+    void endPartialRedraw();
+
 protected:
 
     //Setup VBO or VAO based on OpenGL extensions
@@ -232,6 +261,12 @@ protected:
 
     void fillVerticesAndIndices(const TrianglesCommand* cmd);
 
+    //Partial redraw
+    void setupPartialRedrawBuffer(int width, int height);
+    void releasePartialRedrawBuffer();
+    void applyDamage();
+    void presentPartialRedrawBuffer();
+
 
     /* clear color set outside be used in setGLDefaultValues() */
     Color4F _clearColor;
@@ -274,6 +309,21 @@ protected:
     bool _isDepthTestFor2D;
     
     GroupCommandManager* _groupCommandManager;
+
+    // partial redraw
+    bool _partialRedraw;
+    bool _partialRedrawActive;
+    bool _damageApplied;
+    bool _hasDamage;
+    Rect _damageRect;           // in normalized device coordinates
+    GLint _damageScissor[4];    // in pixels, x y width height
+    float _damagedAreaRatio;
+    GLuint _partialFBO;
+    GLuint _partialTexture;
+    GLuint _partialDepthStencil;
+    GLint _partialOldFBO;
+    int _partialWidth;
+    int _partialHeight;
     
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     EventListenerCustom* _cacheTextureListener;
@@ -36,6 +36,7 @@ THE SOFTWARE.
 
 #include "platform/CCGL.h"
 #include "platform/CCImage.h"
+#include "platform/CCFileUtils.h"
 #include "base/ccUtils.h"
 #include "platform/CCDevice.h"
 #include "base/ccConfig.h"
@@ -46,6 +47,7 @@ THE SOFTWARE.
 #include "base/CCDirector.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/ccGLStateCache.h"
+#include "renderer/ccPixelConvert.h"
 #include "renderer/CCGLProgramCache.h"
 #include "base/CCNinePatchImageParser.h"
 
@@ -149,25 +151,13 @@ void Texture2D::convertAI88ToRGB888(const unsigned char* data, ssize_t dataLen,
 // IIIIIIII -> RRRRRRRRGGGGGGGGGBBBBBBBBAAAAAAAA
 void Texture2D::convertI8ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0; i < dataLen; ++i)
-    {
-        *outData++ = data[i];     //R
-        *outData++ = data[i];     //G
-        *outData++ = data[i];     //B
-        *outData++ = 0xFF;        //A
-    }
+    PixelConvert::convertI8ToRGBA8888(data, dataLen, outData);
 }
 
 // IIIIIIIIAAAAAAAA -> RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA
 void Texture2D::convertAI88ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 1; i < l; i += 2)
-    {
-        *outData++ = data[i];     //R
-        *outData++ = data[i];     //G
-        *outData++ = data[i];     //B
-        *outData++ = data[i + 1]; //A
-    }
+    PixelConvert::convertAI88ToRGBA8888(data, dataLen / 2, outData);
 }
 
 // IIIIIIII -> RRRRRGGGGGGBBBBB
@@ -278,13 +268,7 @@ void Texture2D::convertAI88ToI8(const unsigned char* data, ssize_t dataLen, unsi
 // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA
 void Texture2D::convertRGB888ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
-    {
-        *outData++ = data[i];         //R
-        *outData++ = data[i + 1];     //G
-        *outData++ = data[i + 2];     //B
-        *outData++ = 0xFF;            //A
-    }
+    PixelConvert::convertRGB888ToRGBA8888(data, dataLen / 3, outData);
 }
 
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRRRRGGGGGGGGBBBBBBBB
@@ -313,13 +297,7 @@ void Texture2D::convertRGB888ToRGB565(const unsigned char* data, ssize_t dataLen
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRGGGGGGBBBBB
 void Texture2D::convertRGBA8888ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
-    {
-        *out16++ = (data[i] & 0x00F8) << 8    //R
-            | (data[i + 1] & 0x00FC) << 3     //G
-            | (data[i + 2] & 0x00F8) >> 3;    //B
-    }
+    PixelConvert::convertRGBA8888ToRGB565(data, dataLen / 4, outData);
 }
 
 // RRRRRRRRGGGGGGGGBBBBBBBB -> AAAAAAAA
@@ -395,14 +373,7 @@ void Texture2D::convertRGB888ToRGBA4444(const unsigned char* data, ssize_t dataL
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRGGGGBBBBAAAA
 void Texture2D::convertRGBA8888ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
-    {
-        *out16++ = (data[i] & 0x00F0) << 8    //R
-        | (data[i + 1] & 0x00F0) << 4         //G
-        | (data[i + 2] & 0xF0)                //B
-        |  (data[i + 3] & 0xF0) >> 4;         //A
-    }
+    PixelConvert::convertRGBA8888ToRGBA4444(data, dataLen / 4, outData);
 }
 
 // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRGGGGGBBBBBA
@@ -421,14 +392,7 @@ void Texture2D::convertRGB888ToRGB5A1(const unsigned char* data, ssize_t dataLen
 // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRGGGGGBBBBBA
 void Texture2D::convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 4)
-    {
-        *out16++ = (data[i] & 0x00F8) << 8    //R
-            | (data[i + 1] & 0x00F8) << 3     //G
-            | (data[i + 2] & 0x00F8) >> 2     //B
-            |  (data[i + 3] & 0x0080) >> 7;   //A
-    }
+    PixelConvert::convertRGBA8888ToRGB5A1(data, dataLen / 4, outData);
 }
 // converter function end
 //////////////////////////////////////////////////////////////////////////
@@ -447,6 +411,9 @@ Texture2D::Texture2D()
 , _ninePatchInfo(nullptr)
 , _valid(true)
 , _alphaTexture(nullptr)
+, _evicted(false)
+, _evictedTexParams()
+, _lastUsedFrame(0)
 {
 }
 
@@ -495,9 +462,61 @@ int Texture2D::getPixelsHigh() const
 
 GLuint Texture2D::getName() const
 {
+    // the name is read by the commands drawing the texture
+    if (_evicted)
+        const_cast<Texture2D*>(this)->reloadEvictedGLTexture();
+    _lastUsedFrame = Director::getInstance()->getTotalFrames();
     return _name;
 }
 
+void Texture2D::evictGLTexture()
+{
+    if (_evicted || _name == 0 || _filePath.empty())
+        return;
+
+    GLint params[4];
+    GL::bindTexture2D(_name);
+    glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, &params[0]);
+    glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, &params[1]);
+    glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, &params[2]);
+    glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, &params[3]);
+    _evictedTexParams = { (GLuint)params[0], (GLuint)params[1], (GLuint)params[2], (GLuint)params[3] };
+
+    releaseGLTexture();
+    _evicted = true;
+
+    if (_alphaTexture)
+        _alphaTexture->evictGLTexture();
+}
+
+void Texture2D::reloadEvictedGLTexture()
+{
+    _evicted = false;
+    bool hadMipmaps = _hasMipmaps;
+
+    bool reloaded = false;
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    reloaded = VolatileTextureMgr::reloadTexture(this);
+#endif
+    if (!reloaded)
+    {
+        Image* image = new (std::nothrow) Image();
+        if (image && image->initWithImageFile(_filePath))
+            reloaded = initWithImage(image, _pixelFormat);
+        CC_SAFE_RELEASE(image);
+    }
+
+    if (!reloaded)
+    {
+        CCLOG("cocos2d: Texture2D: couldn't reload evicted texture %s", _filePath.c_str());
+        return;
+    }
+
+    if (hadMipmaps && !_hasMipmaps)
+        generateMipmap();
+    setTexParameters(_evictedTexParams);
+}
+
 GLuint Texture2D::getAlphaTextureName() const
 {
     return _alphaTexture == nullptr ? 0 : _alphaTexture->getName();
@@ -632,6 +651,8 @@ bool Texture2D::initWithMipmaps(MipmapInfo* mipmaps, int mipmapsNum, PixelFormat
 
     glGenTextures(1, &_name);
     GL::bindTexture2D(_name);
+    _evicted = false;
+    _lastUsedFrame = Director::getInstance()->getTotalFrames();
 
     if (mipmapsNum == 1)
     {
@@ -816,6 +837,60 @@ bool Texture2D::initWithImage(Image *image, PixelFormat format)
     }
 }
 
+bool Texture2D::initWithImageFileInStripes(const std::string& path, PixelFormat format, size_t stripeSize)
+{
+    FileView data = FileUtils::getInstance()->mapFile(path);
+    if (data.isNull())
+        return false;
+
+    Image image;
+    if (!image.canDecodeInStripes(data.getBytes(), data.getSize()))
+        return false;
+
+    PixelFormat renderFormat = PixelFormat::NONE;
+    PixelFormat pixelFormat = PixelFormat::NONE;
+    auto onHeader = [&]() {
+        int maxTextureSize = Configuration::getInstance()->getMaxTextureSize();
+        if (image.getWidth() > maxTextureSize || image.getHeight() > maxTextureSize)
+        {
+            CCLOG("cocos2d: WARNING: Image (%u x %u) is bigger than the supported %u x %u", image.getWidth(), image.getHeight(), maxTextureSize, maxTextureSize);
+            return false;
+        }
+        renderFormat = image.getRenderFormat();
+        pixelFormat = ((PixelFormat::NONE == format) || (PixelFormat::AUTO == format)) ? renderFormat : format;
+        return true;
+    };
+    auto onStripe = [&](const unsigned char* pixels, int y, int rows) {
+        const int width = image.getWidth();
+        const ssize_t dataLen = (ssize_t)width * rows * _pixelFormatInfoTables.at(renderFormat).bpp / 8;
+        unsigned char* outData = nullptr;
+        ssize_t outDataLen = 0;
+        PixelFormat outFormat = convertDataToFormat(pixels, dataLen, renderFormat, pixelFormat, &outData, &outDataLen);
+
+        // the texture is created with the format of the first converted stripe
+        bool uploaded = true;
+        if (y == 0)
+        {
+            const int height = image.getHeight();
+            uploaded = initWithData(nullptr, (ssize_t)width * height * _pixelFormatInfoTables.at(outFormat).bpp / 8, outFormat, width, height, Size((float)width, (float)height));
+        }
+        uploaded = uploaded && updateWithData(outData, 0, y, width, rows);
+
+        if (outData != nullptr && outData != pixels)
+        {
+            free(outData);
+        }
+        return uploaded;
+    };
+
+    if (!image.initWithImageDataInStripes(data.getBytes(), data.getSize(), stripeSize, onHeader, onStripe))
+        return false;
+
+    _filePath = path;
+    _hasPremultipliedAlpha = image.hasPremultipliedAlpha();
+    return true;
+}
+
 Texture2D::PixelFormat Texture2D::convertI8ToFormat(const unsigned char* data, ssize_t dataLen, PixelFormat format, unsigned char** outData, ssize_t* outDataLen)
 {
     switch (format)
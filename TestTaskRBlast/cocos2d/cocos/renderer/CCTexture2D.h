@@ -281,6 +281,19 @@ public:
     **/
     bool initWithImage(Image * image, PixelFormat format);
 
+    /**
+    Initializes a texture from a PNG or JPEG file decoded in stripes of rows.
+
+    Each stripe is converted to the texture format and uploaded before the next one is decoded,
+    so the memory used is bounded by the stripe size instead of the image size.
+    @param path The full path of the file.
+    @param format Texture pixel formats, like initWithImage.
+    @param stripeSize Maximum size of a decoded stripe in bytes.
+    @return false if the file isn't supported by Image::canDecodeInStripes or can't be decoded, initWithImage can load it then.
+    @since v3.17
+    **/
+    bool initWithImageFileInStripes(const std::string& path, PixelFormat format, size_t stripeSize);
+
     /** Initializes a texture from a string with dimensions, alignment, font name and font size. 
      
      @param text A null terminated string.
@@ -511,6 +524,11 @@ private:
     static void convertRGBA8888ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
     static void convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
 
+    // Releases the GL texture of a texture loaded from a file to free its memory, getName() reloads it.
+    // Used by TextureCache to stay in its memory budget.
+    void evictGLTexture();
+    void reloadEvictedGLTexture();
+
 protected:
     /** pixel format of the texture */
     Texture2D::PixelFormat _pixelFormat;
@@ -548,12 +566,20 @@ protected:
     NinePatchInfo* _ninePatchInfo;
     friend class SpriteFrameCache;
     friend class TextureCache;
+    friend class DynamicAtlas;
     friend class ui::Scale9Sprite;
 
     bool _valid;
     std::string _filePath;
 
     Texture2D* _alphaTexture;
+
+    /** whether the GL texture was evicted, @see evictGLTexture */
+    bool _evicted;
+    /** parameters of the GL texture when it was evicted, applied again when it is reloaded */
+    TexParams _evictedTexParams;
+    /** frame in which getName() was last called, the least recently used textures are evicted first */
+    mutable unsigned int _lastUsedFrame;
 };
 
 
@@ -32,6 +32,8 @@ THE SOFTWARE.
 #include <stack>
 #include <cctype>
 #include <list>
+#include <algorithm>
+#include <chrono>
 
 #include "renderer/CCTexture2D.h"
 #include "base/ccMacros.h"
@@ -41,6 +43,7 @@ THE SOFTWARE.
 #include "platform/CCFileUtils.h"
 #include "base/ccUtils.h"
 #include "base/CCNinePatchImageParser.h"
+#include "base/CCConfiguration.h"
 
 
 
@@ -68,9 +71,17 @@ TextureCache * TextureCache::getInstance()
 }
 
 TextureCache::TextureCache()
-: _loadingThread(nullptr)
+: _asyncThreadCount(0)
 , _needQuit(false)
 , _asyncRefCount(0)
+, _asyncSequence(0)
+, _uploadBytesBudget(8 * 1024 * 1024)
+, _uploadTimeBudget(0.004f)
+, _decodeStripeSize(1024 * 1024)
+, _textureMemoryBudget(0)
+, _textureEvictionCount(0)
+, _compressedVariantsEnabled(true)
+, _compressedVariantsRoot("compressed/")
 {
 }
 
@@ -81,7 +92,9 @@ TextureCache::~TextureCache()
     for (auto& texture : _textures)
         texture.second->release();
 
-    CC_SAFE_DELETE(_loadingThread);
+    waitForQuit();
+    for (auto thread : _loadingThreads)
+        delete thread;
 }
 
 void TextureCache::destroyInstance()
@@ -105,31 +118,50 @@ std::string TextureCache::getDescription() const
 struct TextureCache::AsyncStruct
 {
 public:
-    AsyncStruct
-    ( const std::string& fn,const std::function<void(Texture2D*)>& f,
-      const std::string& key )
-      : filename(fn), callback(f),callbackKey( key ),
+    typedef std::pair<std::string, std::function<void(Texture2D*)>> Callback;
+
+    AsyncStruct(const std::string& fn, const std::string& lp, int prio, unsigned int seq)
+      : filename(fn), loadPath(lp),
         pixelFormat(Texture2D::getDefaultAlphaPixelFormat()),
-        loadSuccess(false)
+        priority(prio), sequence(seq),
+        loading(false), loadSuccess(false)
     {}
 
     std::string filename;
-    std::function<void(Texture2D*)> callback;
-    std::string callbackKey;
+    std::string loadPath;   // filename or its compressed variant
+    // callback keys and callbacks, unbound ones are null
+    std::vector<Callback> callbacks;
     Image image;
     Image imageAlpha;
     Texture2D::PixelFormat pixelFormat;
+    int priority;           // changed with _requestMutex locked
+    unsigned int sequence;
+    bool loading;           // set with _requestMutex locked when a loading thread takes the request
     bool loadSuccess;
 };
 
+namespace {
+    // orders the request and response heaps: highest priority first, then first requested first
+    struct AsyncStructLess
+    {
+        template<typename T>
+        bool operator()(const T* a, const T* b) const
+        {
+            if (a->priority != b->priority)
+                return a->priority < b->priority;
+            return a->sequence > b->sequence;
+        }
+    };
+}
+
 /**
  The addImageAsync logic follow the steps:
  - find the image has been add or not, if not add an AsyncStruct to _requestQueue  (GL thread)
- - get AsyncStruct from _requestQueue, load res and fill image data to AsyncStruct.image, then add AsyncStruct to _responseQueue (Load thread)
- - on schedule callback, get AsyncStruct from _responseQueue, convert image to texture, then delete AsyncStruct (GL thread)
+ - get the AsyncStruct with the highest priority from _requestQueue, load res and fill image data to AsyncStruct.image, then add AsyncStruct to _responseQueue (Load threads)
+ - on schedule callback, get AsyncStructs from _responseQueue within the upload budget, convert image to texture, then delete AsyncStruct (GL thread)
 
  the Critical Area include these members:
- - _requestQueue: locked by _requestMutex
+ - _requestQueue, AsyncStruct::priority and AsyncStruct::loading: locked by _requestMutex
  - _responseQueue: locked by _responseMutex
 
  the object's life time:
@@ -137,20 +169,19 @@ public:
  - image data: new in Load thread, delete in GL thread(by Image instance)
 
  Note:
- - all AsyncStruct referenced in _asyncStructQueue, for unbind function use.
+ - all AsyncStruct not handled yet are referenced in _asyncStructs, for unbind function use.
 
  How to deal add image many times?
- - At first, this situation is abnormal, we only ensure the logic is correct.
  - If the image has been loaded, the after load image call will return immediately.
- - If the image request is in queue already, there will be more than one request in queue,
- - In addImageAsyncCallback, will deduplicate the request to ensure only create one texture.
+ - If the image request is in queue already, the callback is added to the queued request,
+   and its priority is raised if needed. Only one texture is created.
 
  Does process all response in addImageAsyncCallback consume more time?
- - Convert image to texture faster than load image from disk, so this isn't a
- problem.
+ - Uploading many large images in one frame causes a hitch, so the responses are processed
+   within the budget set by setAsyncUploadBudget, the others wait for the next frames.
 
  Call unbindImageAsync(path) to prevent the call to the callback when the
- texture is loaded.
+ texture is loaded. Requests without any callback left are cancelled.
  */
 void TextureCache::addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback)
 {
@@ -158,38 +189,17 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
 }
 
 /**
- The addImageAsync logic follow the steps:
- - find the image has been add or not, if not add an AsyncStruct to _requestQueue  (GL thread)
- - get AsyncStruct from _requestQueue, load res and fill image data to AsyncStruct.image, then add AsyncStruct to _responseQueue (Load thread)
- - on schedule callback, get AsyncStruct from _responseQueue, convert image to texture, then delete AsyncStruct (GL thread)
- 
- the Critical Area include these members:
- - _requestQueue: locked by _requestMutex
- - _responseQueue: locked by _responseMutex
- 
- the object's life time:
- - AsyncStruct: construct and destruct in GL thread
- - image data: new in Load thread, delete in GL thread(by Image instance)
- 
- Note:
- - all AsyncStruct referenced in _asyncStructQueue, for unbind function use.
- 
- How to deal add image many times?
- - At first, this situation is abnormal, we only ensure the logic is correct.
- - If the image has been loaded, the after load image call will return immediately.
- - If the image request is in queue already, there will be more than one request in queue,
- - In addImageAsyncCallback, will deduplicate the request to ensure only create one texture.
- 
- Does process all response in addImageAsyncCallback consume more time?
- - Convert image to texture faster than load image from disk, so this isn't a
- problem.
-
  The callbackKey allows to unbind the callback in cases where the loading of
  path is requested by several sources simultaneously. Each source can then
  unbind the callback independently as needed whilst a call to
  unbindImageAsync(path) would be ambiguous.
  */
 void TextureCache::addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback, const std::string& callbackKey)
+{
+    addImageAsync(path, callback, callbackKey, ASYNC_PRIORITY_NORMAL);
+}
+
+void TextureCache::addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback, const std::string& callbackKey, int priority)
 {
     Texture2D *texture = nullptr;
 
@@ -205,6 +215,23 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
         return;
     }
 
+    // already requested: share the load
+    auto pending = _asyncStructs.find(fullpath);
+    if (pending != _asyncStructs.end())
+    {
+        AsyncStruct* data = pending->second;
+        data->callbacks.emplace_back(callbackKey, callback);
+
+        // the priority of a loading request is left as is, it orders the response queue
+        std::unique_lock<std::mutex> ul(_requestMutex);
+        if (priority > data->priority && !data->loading)
+        {
+            data->priority = priority;
+            std::make_heap(_requestQueue.begin(), _requestQueue.end(), AsyncStructLess());
+        }
+        return;
+    }
+
     // check if file exists
     if (fullpath.empty() || !FileUtils::getInstance()->isFileExist(fullpath)) {
         if (callback) callback(nullptr);
@@ -212,11 +239,15 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
     }
 
     // lazy init
-    if (_loadingThread == nullptr)
+    if (_loadingThreads.empty())
     {
-        // create a new thread to load images
+        // create the threads to load images
         _needQuit = false;
-        _loadingThread = new (std::nothrow) std::thread(&TextureCache::loadImage, this);
+        unsigned int count = getAsyncThreadCount();
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            _loadingThreads.push_back(new (std::nothrow) std::thread(&TextureCache::loadImage, this));
+        }
     }
 
     if (0 == _asyncRefCount)
@@ -228,83 +259,151 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
 
     // generate async struct
     AsyncStruct *data =
-      new (std::nothrow) AsyncStruct(fullpath, callback, callbackKey);
+      new (std::nothrow) AsyncStruct(fullpath, getImageLoadPath(fullpath), priority, _asyncSequence++);
+    data->callbacks.emplace_back(callbackKey, callback);
     
     // add async struct into queue
-    _asyncStructQueue.push_back(data);
+    _asyncStructs.emplace(fullpath, data);
     std::unique_lock<std::mutex> ul(_requestMutex);
     _requestQueue.push_back(data);
+    std::push_heap(_requestQueue.begin(), _requestQueue.end(), AsyncStructLess());
     _sleepCondition.notify_one();
 }
 
+void TextureCache::setAsyncThreadCount(unsigned int count)
+{
+    _asyncThreadCount = count;
+}
+
+unsigned int TextureCache::getAsyncThreadCount() const
+{
+    if (_asyncThreadCount > 0)
+        return _asyncThreadCount;
+
+    // keep one hardware thread for the GL thread
+    unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    return std::min(std::max(hardwareThreads, 2u) - 1, 4u);
+}
+
+void TextureCache::setAsyncUploadBudget(size_t bytes, float seconds)
+{
+    _uploadBytesBudget = bytes;
+    _uploadTimeBudget = seconds;
+}
+
+void TextureCache::cancelImageAsyncIfUnbound(AsyncStruct* asyncStruct)
+{
+    for (const auto& callback : asyncStruct->callbacks)
+    {
+        if (callback.second)
+            return;
+    }
+
+    // a request which isn't loading yet is dropped, a loading one is dropped in addImageAsyncCallBack
+    std::unique_lock<std::mutex> ul(_requestMutex);
+    if (asyncStruct->loading)
+        return;
+
+    _requestQueue.erase(std::find(_requestQueue.begin(), _requestQueue.end(), asyncStruct));
+    std::make_heap(_requestQueue.begin(), _requestQueue.end(), AsyncStructLess());
+    ul.unlock();
+
+    _asyncStructs.erase(asyncStruct->filename);
+    delete asyncStruct;
+    --_asyncRefCount;
+}
+
 void TextureCache::unbindImageAsync(const std::string& callbackKey)
 {
-    if (_asyncStructQueue.empty())
+    if (_asyncStructs.empty())
     {
         return;
     }
 
-    for (auto& asyncStruct : _asyncStructQueue)
+    std::vector<AsyncStruct*> unbound;
+    for (auto& entry : _asyncStructs)
     {
-        if (asyncStruct->callbackKey == callbackKey)
+        AsyncStruct* asyncStruct = entry.second;
+        bool found = false;
+        for (auto& callback : asyncStruct->callbacks)
         {
-            asyncStruct->callback = nullptr;
+            if (callback.first == callbackKey)
+            {
+                callback.second = nullptr;
+                found = true;
+            }
         }
+        if (found)
+            unbound.push_back(asyncStruct);
+    }
+
+    for (auto asyncStruct : unbound)
+    {
+        cancelImageAsyncIfUnbound(asyncStruct);
     }
 }
 
 void TextureCache::unbindAllImageAsync()
 {
-    if (_asyncStructQueue.empty())
+    if (_asyncStructs.empty())
     {
         return;
 
     }
-    for (auto& asyncStruct : _asyncStructQueue)
+
+    std::vector<AsyncStruct*> unbound;
+    for (auto& entry : _asyncStructs)
     {
-        asyncStruct->callback = nullptr;
+        for (auto& callback : entry.second->callbacks)
+        {
+            callback.second = nullptr;
+        }
+        unbound.push_back(entry.second);
+    }
+
+    for (auto asyncStruct : unbound)
+    {
+        cancelImageAsyncIfUnbound(asyncStruct);
     }
 }
 
 void TextureCache::loadImage()
 {
     AsyncStruct *asyncStruct = nullptr;
-    while (!_needQuit)
+    while (true)
     {
         std::unique_lock<std::mutex> ul(_requestMutex);
-        // pop an AsyncStruct from request queue
-        if (_requestQueue.empty())
+        if (_needQuit)
         {
-            asyncStruct = nullptr;
-        }
-        else
-        {
-            asyncStruct = _requestQueue.front();
-            _requestQueue.pop_front();
+            break;
         }
 
-        if (nullptr == asyncStruct) {
-            if (_needQuit) {
-                break;
-            }
+        // pop the AsyncStruct with the highest priority from request queue
+        if (_requestQueue.empty())
+        {
             _sleepCondition.wait(ul);
             continue;
         }
+        std::pop_heap(_requestQueue.begin(), _requestQueue.end(), AsyncStructLess());
+        asyncStruct = _requestQueue.back();
+        _requestQueue.pop_back();
+        asyncStruct->loading = true;
         ul.unlock();
 
         // load image
-        asyncStruct->loadSuccess = asyncStruct->image.initWithImageFileThreadSafe(asyncStruct->filename);
+        asyncStruct->loadSuccess = asyncStruct->image.initWithImageFileThreadSafe(asyncStruct->loadPath);
 
         // ETC1 ALPHA supports.
         if (asyncStruct->loadSuccess && asyncStruct->image.getFileType() == Image::Format::ETC && !s_etc1AlphaFileSuffix.empty())
         { // check whether alpha texture exists & load it
-            auto alphaFile = asyncStruct->filename + s_etc1AlphaFileSuffix;
+            auto alphaFile = asyncStruct->loadPath + s_etc1AlphaFileSuffix;
             if (FileUtils::getInstance()->isFileExist(alphaFile))
                 asyncStruct->imageAlpha.initWithImageFileThreadSafe(alphaFile);
         }
         // push the asyncStruct to response queue
         _responseMutex.lock();
         _responseQueue.push_back(asyncStruct);
+        std::push_heap(_responseQueue.begin(), _responseQueue.end(), AsyncStructLess());
         _responseMutex.unlock();
     }
 }
@@ -313,9 +412,23 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
 {
     Texture2D *texture = nullptr;
     AsyncStruct *asyncStruct = nullptr;
+
+    const auto startTime = std::chrono::steady_clock::now();
+    size_t uploadedBytes = 0;
+    bool uploaded = false;
+
     while (true)
     {
-        // pop an AsyncStruct from response queue
+        // at least one texture is uploaded per frame
+        if (uploaded)
+        {
+            if (_uploadBytesBudget > 0 && uploadedBytes >= _uploadBytesBudget)
+                break;
+            if (_uploadTimeBudget > 0 && std::chrono::duration<float>(std::chrono::steady_clock::now() - startTime).count() >= _uploadTimeBudget)
+                break;
+        }
+
+        // pop the AsyncStruct with the highest priority from response queue
         _responseMutex.lock();
         if (_responseQueue.empty())
         {
@@ -323,12 +436,9 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
         }
         else
         {
-            asyncStruct = _responseQueue.front();
-            _responseQueue.pop_front();
-
-            // the asyncStruct's sequence order in _asyncStructQueue must equal to the order in _responseQueue
-            CC_ASSERT(asyncStruct == _asyncStructQueue.front());
-            _asyncStructQueue.pop_front();
+            std::pop_heap(_responseQueue.begin(), _responseQueue.end(), AsyncStructLess());
+            asyncStruct = _responseQueue.back();
+            _responseQueue.pop_back();
         }
         _responseMutex.unlock();
 
@@ -336,6 +446,22 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
             break;
         }
 
+        _asyncStructs.erase(asyncStruct->filename);
+
+        bool bound = false;
+        for (const auto& callback : asyncStruct->callbacks)
+        {
+            bound = bound || callback.second;
+        }
+
+        // all the callbacks were unbound while loading: cancelled
+        if (!bound)
+        {
+            delete asyncStruct;
+            --_asyncRefCount;
+            continue;
+        }
+
         // check the image has been convert to texture or not
         auto it = _textures.find(asyncStruct->filename);
         if (it != _textures.end())
@@ -348,6 +474,9 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
             if (asyncStruct->loadSuccess)
             {
                 Image* image = &(asyncStruct->image);
+                uploadedBytes += image->getDataLen() + asyncStruct->imageAlpha.getDataLen();
+                uploaded = true;
+
                 // generate texture in render thread
                 texture = new (std::nothrow) Texture2D();
 
@@ -356,7 +485,7 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
                 this->parseNinePatchImage(image, texture, asyncStruct->filename);
 #if CC_ENABLE_CACHE_TEXTURE_DATA
                 // cache the texture file name
-                VolatileTextureMgr::addImageTexture(texture, asyncStruct->filename);
+                VolatileTextureMgr::addImageTexture(texture, asyncStruct->loadPath);
 #endif
                 // cache the texture. retain it, since it is added in the map
                 _textures.emplace(asyncStruct->filename, texture);
@@ -378,10 +507,13 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
             }
         }
 
-        // call callback function
-        if (asyncStruct->callback)
+        // call callback functions, in request order
+        for (const auto& callback : asyncStruct->callbacks)
         {
-            (asyncStruct->callback)(texture);
+            if (callback.second)
+            {
+                (callback.second)(texture);
+            }
         }
 
         // release the asyncStruct
@@ -417,10 +549,29 @@ Texture2D * TextureCache::addImage(const std::string &path)
         // all images are handled by UIImage except PVR extension that is handled by our own handler
         do
         {
+            const std::string loadPath = getImageLoadPath(fullpath);
+
+            // PNG and JPEG files are uploaded while they are decoded, nine-patch information needs the whole image
+            if (_decodeStripeSize > 0 && !NinePatchImageParser::isNinePatchImage(path))
+            {
+                texture = new (std::nothrow) Texture2D();
+                if (texture && texture->initWithImageFileInStripes(loadPath, Texture2D::getDefaultAlphaPixelFormat(), _decodeStripeSize))
+                {
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+                    // cache the texture file name
+                    VolatileTextureMgr::addImageTexture(texture, loadPath);
+#endif
+                    // texture already retained, no need to re-retain it
+                    _textures.emplace(fullpath, texture);
+                    break;
+                }
+                CC_SAFE_RELEASE_NULL(texture);
+            }
+
             image = new (std::nothrow) Image();
             CC_BREAK_IF(nullptr == image);
 
-            bool bRet = image->initWithImageFile(fullpath);
+            bool bRet = image->initWithImageFile(loadPath);
             CC_BREAK_IF(!bRet);
 
             texture = new (std::nothrow) Texture2D();
@@ -429,13 +580,13 @@ Texture2D * TextureCache::addImage(const std::string &path)
             {
 #if CC_ENABLE_CACHE_TEXTURE_DATA
                 // cache the texture file name
-                VolatileTextureMgr::addImageTexture(texture, fullpath);
+                VolatileTextureMgr::addImageTexture(texture, loadPath);
 #endif
                 // texture already retained, no need to re-retain it
                 _textures.emplace(fullpath, texture);
 
                 //-- ANDROID ETC1 ALPHA SUPPORTS.
-                std::string alphaFullPath = path + s_etc1AlphaFileSuffix;
+                std::string alphaFullPath = (loadPath != fullpath ? loadPath : path) + s_etc1AlphaFileSuffix;
                 if (image->getFileType() == Image::Format::ETC && !s_etc1AlphaFileSuffix.empty() && FileUtils::getInstance()->isFileExist(alphaFullPath))
                 {
                     Image alphaImage;
@@ -548,7 +699,7 @@ bool TextureCache::reloadTexture(const std::string& fileName)
             image = new (std::nothrow) Image();
             CC_BREAK_IF(nullptr == image);
 
-            bool bRet = image->initWithImageFile(fullpath);
+            bool bRet = image->initWithImageFile(getImageLoadPath(fullpath));
             CC_BREAK_IF(!bRet);
 
             ret = texture->initWithImage(image);
@@ -560,6 +711,89 @@ bool TextureCache::reloadTexture(const std::string& fileName)
     return ret;
 }
 
+void TextureCache::setCompressedVariantsEnabled(bool enabled)
+{
+    _compressedVariantsEnabled = enabled;
+}
+
+void TextureCache::setCompressedVariantsRoot(const std::string& root)
+{
+    _compressedVariantsRoot = root;
+    if (!_compressedVariantsRoot.empty() && _compressedVariantsRoot.back() != '/')
+        _compressedVariantsRoot += '/';
+    _compressedVariantPaths.clear();
+}
+
+std::string TextureCache::getCompressedVariantPath(const std::string& path)
+{
+    if (!_compressedVariantsEnabled)
+        return "";
+
+    std::string fullpath = FileUtils::getInstance()->fullPathForFilename(path);
+    if (fullpath.empty())
+        return "";
+
+    auto it = _compressedVariantPaths.find(fullpath);
+    if (it != _compressedVariantPaths.end())
+        return it->second;
+
+    std::string& variantPath = _compressedVariantPaths[fullpath];
+
+    // the variants mirror the file path relative to the search path it was found in
+    auto fileUtils = FileUtils::getInstance();
+    std::string relativePath;
+    for (const auto& searchPath : fileUtils->getSearchPaths())
+    {
+        if (fullpath.compare(0, searchPath.size(), searchPath) == 0)
+        {
+            relativePath = fullpath.substr(searchPath.size());
+            break;
+        }
+    }
+    const size_t dot = relativePath.find_last_of('.');
+    if (relativePath.empty() || dot == std::string::npos || relativePath.find('/', dot) != std::string::npos)
+        return variantPath;
+    relativePath.erase(dot);
+    // nine-patch information is read from the pixels of the original file
+    if (relativePath.size() > 2 && relativePath.compare(relativePath.size() - 2, 2, ".9") == 0)
+        return variantPath;
+
+    // in order of preference
+    struct CompressedVariant
+    {
+        const char* directory;
+        const char* extension;
+        bool (Configuration::*isSupported)() const;
+    };
+    static const CompressedVariant variants[] = {
+        { "s3tc/", ".dds", &Configuration::supportsS3TC },
+        { "pvrtc/", ".pvr", &Configuration::supportsPVRTC },
+        { "atitc/", ".ktx", &Configuration::supportsATITC },
+        { "etc1/", ".pkm", &Configuration::supportsETC },
+    };
+
+    auto configuration = Configuration::getInstance();
+    for (const auto& variant : variants)
+    {
+        if (!(configuration->*variant.isSupported)())
+            continue;
+
+        std::string candidate = _compressedVariantsRoot + variant.directory + relativePath + variant.extension;
+        if (fileUtils->isFileExist(candidate))
+        {
+            variantPath = fileUtils->fullPathForFilename(candidate);
+            break;
+        }
+    }
+    return variantPath;
+}
+
+std::string TextureCache::getImageLoadPath(const std::string& fullpath)
+{
+    std::string variantPath = getCompressedVariantPath(fullpath);
+    return variantPath.empty() ? fullpath : variantPath;
+}
+
 // TextureCache - Remove
 
 void TextureCache::removeAllTextures()
@@ -659,12 +893,16 @@ std::string TextureCache::getTextureFilePath(cocos2d::Texture2D* texture) const
 
 void TextureCache::waitForQuit()
 {
-    // notify sub thread to quick
+    // notify sub threads to quit
     std::unique_lock<std::mutex> ul(_requestMutex);
     _needQuit = true;
-    _sleepCondition.notify_one();
+    _sleepCondition.notify_all();
     ul.unlock();
-    if (_loadingThread) _loadingThread->join();
+    for (auto thread : _loadingThreads)
+    {
+        if (thread->joinable())
+            thread->join();
+    }
 }
 
 std::string TextureCache::getCachedTextureInfo() const
@@ -686,10 +924,11 @@ std::string TextureCache::getCachedTextureInfo() const
         auto bytes = tex->getPixelsWide() * tex->getPixelsHigh() * bpp / 8;
         totalBytes += bytes;
         count++;
-        snprintf(buftmp, sizeof(buftmp) - 1, "\"%s\" rc=%lu id=%lu %lu x %lu @ %ld bpp => %lu KB\n",
+        snprintf(buftmp, sizeof(buftmp) - 1, "\"%s\"%s rc=%lu id=%lu %lu x %lu @ %ld bpp => %lu KB\n",
             texture.first.c_str(),
+            tex->_evicted ? " (evicted)" : "",
             (long)tex->getReferenceCount(),
-            (long)tex->getName(),
+            (long)tex->_name,
             (long)tex->getPixelsWide(),
             (long)tex->getPixelsHigh(),
             (long)bpp,
@@ -700,10 +939,91 @@ std::string TextureCache::getCachedTextureInfo() const
 
     snprintf(buftmp, sizeof(buftmp) - 1, "TextureCache dumpDebugInfo: %ld textures, for %lu KB (%.2f MB)\n", (long)count, (long)totalBytes / 1024, totalBytes / (1024.0f*1024.0f));
     buffer += buftmp;
+    snprintf(buftmp, sizeof(buftmp) - 1, "TextureCache memory: %lu KB resident, budget %lu KB, %u evictions\n", (long)getTextureMemoryUsage() / 1024, (long)_textureMemoryBudget / 1024, _textureEvictionCount);
+    buffer += buftmp;
 
     return buffer;
 }
 
+void TextureCache::setTextureMemoryBudget(size_t bytes)
+{
+    auto scheduler = Director::getInstance()->getScheduler();
+    if (bytes > 0 && _textureMemoryBudget == 0)
+        scheduler->schedule(CC_SCHEDULE_SELECTOR(TextureCache::evictTexturesOverBudget), this, 0, false);
+    else if (bytes == 0 && _textureMemoryBudget > 0)
+        scheduler->unschedule(CC_SCHEDULE_SELECTOR(TextureCache::evictTexturesOverBudget), this);
+    _textureMemoryBudget = bytes;
+}
+
+size_t TextureCache::getTextureMemorySize(Texture2D* texture)
+{
+    if (texture->_evicted || texture->_name == 0)
+        return 0;
+
+    size_t bytes = (size_t)texture->_pixelsWide * texture->_pixelsHigh * texture->getBitsPerPixelForFormat() / 8;
+    // the mipmaps add a third
+    if (texture->_hasMipmaps)
+        bytes += bytes / 3;
+    if (texture->_alphaTexture)
+        bytes += getTextureMemorySize(texture->_alphaTexture);
+    return bytes;
+}
+
+size_t TextureCache::getTextureMemoryUsage() const
+{
+    size_t usage = 0;
+    for (auto& texture : _textures)
+        usage += getTextureMemorySize(texture.second);
+    return usage;
+}
+
+void TextureCache::evictTexturesOverBudget(float /*dt*/)
+{
+    size_t usage = getTextureMemoryUsage();
+    if (usage <= _textureMemoryBudget)
+        return;
+
+    // the textures which are not used in the current or the last frame, from the least recently used.
+    // Only the ones loaded from a file can be reloaded once evicted
+    const unsigned int frame = Director::getInstance()->getTotalFrames();
+    std::vector<decltype(_textures)::iterator> candidates;
+    for (auto it = _textures.begin(); it != _textures.end(); ++it)
+    {
+        Texture2D* texture = it->second;
+        if (texture->_evicted || texture->_lastUsedFrame + 1 >= frame)
+            continue;
+        if (texture->getReferenceCount() == 1 || !texture->_filePath.empty())
+            candidates.push_back(it);
+    }
+    std::sort(candidates.begin(), candidates.end(), [](decltype(_textures)::iterator a, decltype(_textures)::iterator b) {
+        return a->second->_lastUsedFrame < b->second->_lastUsedFrame;
+    });
+
+    for (auto it : candidates)
+    {
+        if (usage <= _textureMemoryBudget)
+            break;
+
+        Texture2D* texture = it->second;
+        size_t bytes = getTextureMemorySize(texture);
+        if (bytes == 0)
+            continue;
+
+        if (texture->getReferenceCount() == 1)
+        {
+            CCLOG("cocos2d: TextureCache: evicting unused texture: %s", it->first.c_str());
+            texture->release();
+            _textures.erase(it);
+        }
+        else
+        {
+            texture->evictGLTexture();
+        }
+        usage -= bytes;
+        ++_textureEvictionCount;
+    }
+}
+
 void TextureCache::renameTextureWithKey(const std::string& srcName, const std::string& dstName)
 {
     std::string key = srcName;
@@ -884,49 +1204,64 @@ void VolatileTextureMgr::reloadAllTextures()
 
     for (auto& texture : _textures)
     {
-        VolatileTexture *vt = texture;
+        reloadTexture(texture);
+    }
 
-        switch (vt->_cashedImageType)
-        {
-        case VolatileTexture::kImageFile:
-        {
-            reloadTexture(vt->_texture, vt->_fileName, vt->_pixelFormat);
+    _isReloading = false;
+}
 
-            // etc1 support check whether alpha texture exists & load it
-            auto alphaFile = vt->_fileName + TextureCache::getETC1AlphaFileSuffix();
-            reloadTexture(vt->_texture->getAlphaTexture(), alphaFile, vt->_pixelFormat);
-        }
-        break;
-        case VolatileTexture::kImageData:
-        {
-            vt->_texture->initWithData(vt->_textureData,
-                vt->_dataLen,
-                vt->_pixelFormat,
-                vt->_textureSize.width,
-                vt->_textureSize.height,
-                vt->_textureSize);
-        }
-        break;
-        case VolatileTexture::kString:
-        {
-            vt->_texture->initWithString(vt->_text.c_str(), vt->_fontDefinition);
-        }
-        break;
-        case VolatileTexture::kImage:
-        {
-            vt->_texture->initWithImage(vt->_uiImage);
-        }
-        break;
-        default:
-            break;
-        }
-        if (vt->_hasMipmaps) {
-            vt->_texture->generateMipmap();
-        }
-        vt->_texture->setTexParameters(vt->_texParams);
-    }
+bool VolatileTextureMgr::reloadTexture(Texture2D* texture)
+{
+    auto it = std::find_if(_textures.begin(), _textures.end(), [texture](VolatileTexture* vt) { return vt->_texture == texture; });
+    if (it == _textures.end() || (*it)->_cashedImageType == VolatileTexture::kInvalid)
+        return false;
 
+    _isReloading = true;
+    reloadTexture(*it);
     _isReloading = false;
+    return true;
+}
+
+void VolatileTextureMgr::reloadTexture(VolatileTexture* vt)
+{
+    switch (vt->_cashedImageType)
+    {
+    case VolatileTexture::kImageFile:
+    {
+        reloadTexture(vt->_texture, vt->_fileName, vt->_pixelFormat);
+
+        // etc1 support check whether alpha texture exists & load it
+        auto alphaFile = vt->_fileName + TextureCache::getETC1AlphaFileSuffix();
+        reloadTexture(vt->_texture->getAlphaTexture(), alphaFile, vt->_pixelFormat);
+    }
+    break;
+    case VolatileTexture::kImageData:
+    {
+        vt->_texture->initWithData(vt->_textureData,
+            vt->_dataLen,
+            vt->_pixelFormat,
+            vt->_textureSize.width,
+            vt->_textureSize.height,
+            vt->_textureSize);
+    }
+    break;
+    case VolatileTexture::kString:
+    {
+        vt->_texture->initWithString(vt->_text.c_str(), vt->_fontDefinition);
+    }
+    break;
+    case VolatileTexture::kImage:
+    {
+        vt->_texture->initWithImage(vt->_uiImage);
+    }
+    break;
+    default:
+        break;
+    }
+    if (vt->_hasMipmaps) {
+        vt->_texture->generateMipmap();
+    }
+    vt->_texture->setTexParameters(vt->_texParams);
 }
 
 void VolatileTextureMgr::reloadTexture(Texture2D* texture, const std::string& filename, Texture2D::PixelFormat pixelFormat)
@@ -36,6 +36,7 @@ THE SOFTWARE.
 #include <string>
 #include <unordered_map>
 #include <functional>
+#include <vector>
 
 #include "base/CCRef.h"
 #include "renderer/CCTexture2D.h"
@@ -127,15 +128,58 @@ public:
     
     void addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback, const std::string& callbackKey );
 
+    /** Priorities of asynchronous loads, requests with a higher priority are decoded and uploaded first.
+     * Any int value can be used, these are the usual ones.
+     */
+    static const int ASYNC_PRIORITY_PREFETCH = -100;
+    static const int ASYNC_PRIORITY_NORMAL = 0;
+    static const int ASYNC_PRIORITY_VISIBLE = 100;
+
+    /** Same as addImageAsync(path, callback, callbackKey), with a load priority.
+     * Requesting a file which is already being loaded shares the load, and raises its priority if the new one is higher.
+     * @param priority Requests with a higher priority are loaded first, @see ASYNC_PRIORITY_NORMAL.
+     * @since v3.17
+     */
+    void addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback, const std::string& callbackKey, int priority);
+
+    /** Sets the number of threads decoding images for addImageAsync.
+     * Takes effect when the threads are started by the next asynchronous load.
+     * @param count Number of threads, 0 picks one per hardware thread, between 1 and 4.
+     * @since v3.17
+     */
+    void setAsyncThreadCount(unsigned int count);
+    /** Gets the number of threads decoding images, @see setAsyncThreadCount. */
+    unsigned int getAsyncThreadCount() const;
+
+    /** Sets how much texture data can be uploaded each frame by asynchronous loads.
+     * At least one texture is uploaded per frame, the others wait for the next frames.
+     * @param bytes Bytes of image data per frame, 0 for no limit.
+     * @param seconds Time spent creating textures per frame, 0 for no limit.
+     * @since v3.17
+     */
+    void setAsyncUploadBudget(size_t bytes, float seconds);
+
+    /** Sets the size of the stripes PNG and JPEG files are decoded and uploaded in by addImage.
+     * The pixels of a whole image are never held in memory then, which bounds the memory used to load large images.
+     * Nine-patch images and asynchronous loads still decode the whole images.
+     * @param bytes Maximum size of a stripe in bytes, 0 to decode the whole images. Default is 1 MB.
+     * @see Texture2D::initWithImageFileInStripes
+     * @since v3.17
+     */
+    void setDecodeStripeSize(size_t bytes) { _decodeStripeSize = bytes; }
+    /** Gets the size of the stripes images are decoded in, @see setDecodeStripeSize. */
+    size_t getDecodeStripeSize() const { return _decodeStripeSize; }
+
     /** Unbind a specified bound image asynchronous callback.
      * In the case an object who was bound to an image asynchronous callback was destroyed before the callback is invoked,
      * the object always need to unbind this callback manually.
+     * A load without any bound callback left is cancelled.
      * @param filename It's the related/absolute path of the file image.
      * @since v3.1
      */
     virtual void unbindImageAsync(const std::string &filename);
     
-    /** Unbind all bound image asynchronous load callbacks.
+    /** Unbind all bound image asynchronous load callbacks, and cancel the loads.
      * @since v3.1
      */
     virtual void unbindAllImageAsync();
@@ -196,6 +240,22 @@ public:
     */
     std::string getCachedTextureInfo() const;
 
+    /** Sets the texture memory budget.
+     * Once per frame, when the textures of the cache use more memory, the least recently drawn ones are evicted
+     * until the usage fits: the textures only retained by the cache are removed from it, the GL textures of the
+     * other ones loaded from a file are released and reloaded the next time they are drawn.
+     * The textures drawn or loaded in the current or the last frame are never evicted.
+     * @param bytes Texture memory in bytes, 0 for no limit.
+     * @since v3.17
+     */
+    void setTextureMemoryBudget(size_t bytes);
+    /** Gets the texture memory budget, @see setTextureMemoryBudget. */
+    size_t getTextureMemoryBudget() const { return _textureMemoryBudget; }
+    /** Gets the memory used by the textures of the cache, without the evicted ones. */
+    size_t getTextureMemoryUsage() const;
+    /** Gets how many times textures were evicted to stay in the memory budget. */
+    unsigned int getTextureEvictionCount() const { return _textureEvictionCount; }
+
     //Wait for texture cache to quit before destroy instance.
     /**Called by director, please do not called outside.*/
     void waitForQuit();
@@ -209,6 +269,29 @@ public:
      */
     std::string getTextureFilePath(Texture2D* texture) const;
 
+    /** Enables or disables compressed variants of image files.
+     * When enabled, addImage and addImageAsync load "a/b.png" from the variant of the best format
+     * supported by the GPU if it exists: "<root>/s3tc/a/b.dds", "<root>/pvrtc/a/b.pvr",
+     * "<root>/atitc/a/b.ktx" or "<root>/etc1/a/b.pkm", else from "a/b.png".
+     * The texture is still cached with the key of the original file.
+     * The variants are built by tools/texture-compress/compress_textures.py.
+     * Enabled by default.
+     * @since v3.17
+     */
+    void setCompressedVariantsEnabled(bool enabled);
+    /** Whether compressed variants are enabled, @see setCompressedVariantsEnabled. */
+    bool isCompressedVariantsEnabled() const { return _compressedVariantsEnabled; }
+
+    /** Sets the directory of the compressed variants, relative to the search paths. Default is "compressed/". */
+    void setCompressedVariantsRoot(const std::string& root);
+    /** Gets the directory of the compressed variants. */
+    const std::string& getCompressedVariantsRoot() const { return _compressedVariantsRoot; }
+
+    /** Returns the full path of the compressed variant used for a file, or an empty string when the file itself is used.
+     * @param path It's the related/absolute path of the file image.
+     */
+    std::string getCompressedVariantPath(const std::string& path);
+
     /** Reload texture from a new file.
     * This function is mainly for editor, won't suggest use it in game for performance reason.
     *
@@ -221,18 +304,27 @@ public:
 
 
 private:
+    struct AsyncStruct;
+
     void addImageAsyncCallBack(float dt);
     void loadImage();
     void parseNinePatchImage(Image* image, Texture2D* texture, const std::string& path);
+    void cancelImageAsyncIfUnbound(AsyncStruct* asyncStruct);
+    // full path of the file to load for a cached full path: its compressed variant or itself
+    std::string getImageLoadPath(const std::string& fullpath);
+    void evictTexturesOverBudget(float dt);
+    // memory used by a texture and its alpha texture, 0 when evicted
+    static size_t getTextureMemorySize(Texture2D* texture);
 public:
 protected:
-    struct AsyncStruct;
-    
-    std::thread* _loadingThread;
+    std::vector<std::thread*> _loadingThreads;
+    unsigned int _asyncThreadCount;
 
-    std::deque<AsyncStruct*> _asyncStructQueue;
-    std::deque<AsyncStruct*> _requestQueue;
-    std::deque<AsyncStruct*> _responseQueue;
+    // requests not loaded yet, by full path. Only used by the GL thread
+    std::unordered_map<std::string, AsyncStruct*> _asyncStructs;
+    // heaps ordered by priority
+    std::vector<AsyncStruct*> _requestQueue;
+    std::vector<AsyncStruct*> _responseQueue;
 
     std::mutex _requestMutex;
     std::mutex _responseMutex;
@@ -242,9 +334,22 @@ protected:
     bool _needQuit;
 
     int _asyncRefCount;
+    unsigned int _asyncSequence;
+
+    size_t _uploadBytesBudget;
+    float _uploadTimeBudget;
+    size_t _decodeStripeSize;
 
     std::unordered_map<std::string, Texture2D*> _textures;
 
+    size_t _textureMemoryBudget;
+    unsigned int _textureEvictionCount;
+
+    bool _compressedVariantsEnabled;
+    std::string _compressedVariantsRoot;
+    // full path of the file -> full path of its compressed variant, empty when there is none
+    std::unordered_map<std::string, std::string> _compressedVariantPaths;
+
     static std::string s_etc1AlphaFileSuffix;
 };
 
@@ -301,6 +406,8 @@ public:
     static void setTexParameters(Texture2D *t, const Texture2D::TexParams &texParams);
     static void removeTexture(Texture2D *t);
     static void reloadAllTextures();
+    // reloads a texture from its cached data, returns false when there is none
+    static bool reloadTexture(Texture2D* texture);
 public:
     static std::list<VolatileTexture*> _textures;
     static bool _isReloading;
@@ -308,6 +415,7 @@ private:
     // find VolatileTexture by Texture2D*
     // if not found, create a new one
     static VolatileTexture* findVolotileTexture(Texture2D *tt);
+    static void reloadTexture(VolatileTexture* vt);
     static void reloadTexture(Texture2D* texture, const std::string& filename, Texture2D::PixelFormat pixelFormat);
 };
 
@@ -0,0 +1,541 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "renderer/ccPixelConvert.h"
+
+#include <atomic>
+
+//#define INCLUDE_SSE2    : SSE2 code included, SSSE3 code is then included too and picked at runtime
+//#define INCLUDE_NEON    : NEON code included
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define INCLUDE_SSE2
+    #include <emmintrin.h>
+    #include <tmmintrin.h>
+    #if defined (_MSC_VER)
+        #include <intrin.h>
+        #define CC_TARGET_SSSE3
+    #else
+        #define CC_TARGET_SSSE3 __attribute__((target("ssse3")))
+    #endif
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__)
+    #define INCLUDE_NEON
+    #include <arm_neon.h>
+#endif
+
+NS_CC_BEGIN
+
+namespace PixelConvert {
+
+namespace {
+
+typedef void (*InPlaceKernel)(unsigned char* data, ssize_t pixelCount);
+typedef void (*ConvertKernel)(const unsigned char* data, ssize_t pixelCount, unsigned char* outData);
+
+struct Kernels
+{
+    const char* name;
+    InPlaceKernel premultiplyAlphaRGBA8888;
+    ConvertKernel I8ToRGBA8888;
+    ConvertKernel AI88ToRGBA8888;
+    ConvertKernel RGB888ToRGBA8888;
+    ConvertKernel RGBA8888ToRGBA4444;
+    ConvertKernel RGBA8888ToRGB565;
+    ConvertKernel RGBA8888ToRGB5A1;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// plain C, the reference for the SIMD implementations.
+// They also handle the pixels left over by the SIMD loops.
+
+void premultiplyAlphaRGBA8888_C(unsigned char* data, ssize_t pixelCount)
+{
+    for (ssize_t i = 0; i < pixelCount; ++i)
+    {
+        unsigned char* p = data + i * 4;
+        const unsigned int alpha = p[3] + 1;
+        p[0] = (unsigned char)((p[0] * alpha) >> 8);
+        p[1] = (unsigned char)((p[1] * alpha) >> 8);
+        p[2] = (unsigned char)((p[2] * alpha) >> 8);
+    }
+}
+
+// IIIIIIII -> RRRRRRRRGGGGGGGGGBBBBBBBBAAAAAAAA
+void I8ToRGBA8888_C(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    for (ssize_t i = 0; i < pixelCount; ++i)
+    {
+        *outData++ = data[i];     //R
+        *outData++ = data[i];     //G
+        *outData++ = data[i];     //B
+        *outData++ = 0xFF;        //A
+    }
+}
+
+// IIIIIIIIAAAAAAAA -> RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA
+void AI88ToRGBA8888_C(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    for (ssize_t i = 0; i < pixelCount * 2; i += 2)
+    {
+        *outData++ = data[i];     //R
+        *outData++ = data[i];     //G
+        *outData++ = data[i];     //B
+        *outData++ = data[i + 1]; //A
+    }
+}
+
+// RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA
+void RGB888ToRGBA8888_C(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    for (ssize_t i = 0; i < pixelCount * 3; i += 3)
+    {
+        *outData++ = data[i];         //R
+        *outData++ = data[i + 1];     //G
+        *outData++ = data[i + 2];     //B
+        *outData++ = 0xFF;            //A
+    }
+}
+
+// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRGGGGBBBBAAAA
+void RGBA8888ToRGBA4444_C(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    unsigned short* out16 = (unsigned short*)outData;
+    for (ssize_t i = 0; i < pixelCount * 4; i += 4)
+    {
+        *out16++ = (data[i] & 0x00F0) << 8    //R
+        | (data[i + 1] & 0x00F0) << 4         //G
+        | (data[i + 2] & 0xF0)                //B
+        |  (data[i + 3] & 0xF0) >> 4;         //A
+    }
+}
+
+// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRGGGGGGBBBBB
+void RGBA8888ToRGB565_C(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    unsigned short* out16 = (unsigned short*)outData;
+    for (ssize_t i = 0; i < pixelCount * 4; i += 4)
+    {
+        *out16++ = (data[i] & 0x00F8) << 8    //R
+            | (data[i + 1] & 0x00FC) << 3     //G
+            | (data[i + 2] & 0x00F8) >> 3;    //B
+    }
+}
+
+// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRGGGGGBBBBBA
+void RGBA8888ToRGB5A1_C(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    unsigned short* out16 = (unsigned short*)outData;
+    for (ssize_t i = 0; i < pixelCount * 4; i += 4)
+    {
+        *out16++ = (data[i] & 0x00F8) << 8    //R
+            | (data[i + 1] & 0x00F8) << 3     //G
+            | (data[i + 2] & 0x00F8) >> 2     //B
+            |  (data[i + 3] & 0x0080) >> 7;   //A
+    }
+}
+
+const Kernels s_kernelsC = {
+    "C",
+    premultiplyAlphaRGBA8888_C,
+    I8ToRGBA8888_C,
+    AI88ToRGBA8888_C,
+    RGB888ToRGBA8888_C,
+    RGBA8888ToRGBA4444_C,
+    RGBA8888ToRGB565_C,
+    RGBA8888ToRGB5A1_C,
+};
+
+#ifdef INCLUDE_SSE2
+//////////////////////////////////////////////////////////////////////////
+// SSE2, and SSSE3 where byte shuffles help
+
+// packs the low 16 bits of the 32 bits lanes, packs_epi32 saturates so the values are sign extended first
+inline __m128i packLow16(__m128i a, __m128i b)
+{
+    a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+    b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+    return _mm_packs_epi32(a, b);
+}
+
+void premultiplyAlphaRGBA8888_SSE2(unsigned char* data, ssize_t pixelCount)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i alphaMask = _mm_set1_epi32((int)0xFF000000);
+    ssize_t i = 0;
+    for (; i + 4 <= pixelCount; i += 4)
+    {
+        __m128i* p = (__m128i*)(data + i * 4);
+        const __m128i pixels = _mm_loadu_si128(p);
+        __m128i lo = _mm_unpacklo_epi8(pixels, zero);
+        __m128i hi = _mm_unpackhi_epi8(pixels, zero);
+        // alpha + 1 in every 16 bits lane of its pixel
+        const __m128i alphaLo = _mm_add_epi16(_mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3)), one);
+        const __m128i alphaHi = _mm_add_epi16(_mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3)), one);
+        // at most 255 * 256, the low 16 bits of the product are exact
+        lo = _mm_srli_epi16(_mm_mullo_epi16(lo, alphaLo), 8);
+        hi = _mm_srli_epi16(_mm_mullo_epi16(hi, alphaHi), 8);
+        const __m128i colors = _mm_andnot_si128(alphaMask, _mm_packus_epi16(lo, hi));
+        _mm_storeu_si128(p, _mm_or_si128(colors, _mm_and_si128(pixels, alphaMask)));
+    }
+    premultiplyAlphaRGBA8888_C(data + i * 4, pixelCount - i);
+}
+
+void I8ToRGBA8888_SSE2(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    const __m128i ff = _mm_set1_epi8((char)0xFF);
+    ssize_t i = 0;
+    for (; i + 16 <= pixelCount; i += 16)
+    {
+        const __m128i intensity = _mm_loadu_si128((const __m128i*)(data + i));
+        const __m128i iiLo = _mm_unpacklo_epi8(intensity, intensity);
+        const __m128i iiHi = _mm_unpackhi_epi8(intensity, intensity);
+        const __m128i iaLo = _mm_unpacklo_epi8(intensity, ff);
+        const __m128i iaHi = _mm_unpackhi_epi8(intensity, ff);
+        __m128i* out = (__m128i*)(outData + i * 4);
+        _mm_storeu_si128(out, _mm_unpacklo_epi16(iiLo, iaLo));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(iiLo, iaLo));
+        _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(iiHi, iaHi));
+        _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(iiHi, iaHi));
+    }
+    I8ToRGBA8888_C(data + i, pixelCount - i, outData + i * 4);
+}
+
+void AI88ToRGBA8888_SSE2(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    const __m128i lowByte = _mm_set1_epi16(0x00FF);
+    ssize_t i = 0;
+    for (; i + 8 <= pixelCount; i += 8)
+    {
+        const __m128i ia = _mm_loadu_si128((const __m128i*)(data + i * 2));
+        const __m128i intensity = _mm_and_si128(ia, lowByte);
+        const __m128i ii = _mm_or_si128(intensity, _mm_slli_epi16(intensity, 8));
+        __m128i* out = (__m128i*)(outData + i * 4);
+        _mm_storeu_si128(out, _mm_unpacklo_epi16(ii, ia));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(ii, ia));
+    }
+    AI88ToRGBA8888_C(data + i * 2, pixelCount - i, outData + i * 4);
+}
+
+CC_TARGET_SSSE3 void RGB888ToRGBA8888_SSSE3(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+    ssize_t i = 0;
+    // 4 pixels per loop, reading 16 bytes for 12
+    for (; i + 6 <= pixelCount; i += 4)
+    {
+        const __m128i rgb = _mm_loadu_si128((const __m128i*)(data + i * 3));
+        _mm_storeu_si128((__m128i*)(outData + i * 4), _mm_or_si128(_mm_shuffle_epi8(rgb, shuffle), alpha));
+    }
+    RGB888ToRGBA8888_C(data + i * 3, pixelCount - i, outData + i * 4);
+}
+
+void RGBA8888ToRGBA4444_SSE2(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    const __m128i maskR = _mm_set1_epi32(0xF0);
+    const __m128i maskG = _mm_set1_epi32(0xF00);
+    const __m128i maskB = _mm_set1_epi32(0xF0);
+    ssize_t i = 0;
+    for (; i + 8 <= pixelCount; i += 8)
+    {
+        __m128i result[2];
+        for (int half = 0; half < 2; ++half)
+        {
+            const __m128i p = _mm_loadu_si128((const __m128i*)(data + (i + half * 4) * 4));
+            result[half] = _mm_or_si128(
+                _mm_or_si128(_mm_slli_epi32(_mm_and_si128(p, maskR), 8),     //R
+                             _mm_and_si128(_mm_srli_epi32(p, 4), maskG)),    //G
+                _mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 16), maskB),    //B
+                             _mm_srli_epi32(p, 28)));                        //A
+        }
+        _mm_storeu_si128((__m128i*)(outData + i * 2), packLow16(result[0], result[1]));
+    }
+    RGBA8888ToRGBA4444_C(data + i * 4, pixelCount - i, outData + i * 2);
+}
+
+void RGBA8888ToRGB565_SSE2(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    const __m128i maskR = _mm_set1_epi32(0xF8);
+    const __m128i maskG = _mm_set1_epi32(0x7E0);
+    const __m128i maskB = _mm_set1_epi32(0x1F);
+    ssize_t i = 0;
+    for (; i + 8 <= pixelCount; i += 8)
+    {
+        __m128i result[2];
+        for (int half = 0; half < 2; ++half)
+        {
+            const __m128i p = _mm_loadu_si128((const __m128i*)(data + (i + half * 4) * 4));
+            result[half] = _mm_or_si128(
+                _mm_or_si128(_mm_slli_epi32(_mm_and_si128(p, maskR), 8),     //R
+                             _mm_and_si128(_mm_srli_epi32(p, 5), maskG)),    //G
+                _mm_and_si128(_mm_srli_epi32(p, 19), maskB));                //B
+        }
+        _mm_storeu_si128((__m128i*)(outData + i * 2), packLow16(result[0], result[1]));
+    }
+    RGBA8888ToRGB565_C(data + i * 4, pixelCount - i, outData + i * 2);
+}
+
+void RGBA8888ToRGB5A1_SSE2(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    const __m128i maskR = _mm_set1_epi32(0xF8);
+    const __m128i maskG = _mm_set1_epi32(0x7C0);
+    const __m128i maskB = _mm_set1_epi32(0x3E);
+    ssize_t i = 0;
+    for (; i + 8 <= pixelCount; i += 8)
+    {
+        __m128i result[2];
+        for (int half = 0; half < 2; ++half)
+        {
+            const __m128i p = _mm_loadu_si128((const __m128i*)(data + (i + half * 4) * 4));
+            result[half] = _mm_or_si128(
+                _mm_or_si128(_mm_slli_epi32(_mm_and_si128(p, maskR), 8),     //R
+                             _mm_and_si128(_mm_srli_epi32(p, 5), maskG)),    //G
+                _mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 18), maskB),    //B
+                             _mm_srli_epi32(p, 31)));                        //A
+        }
+        _mm_storeu_si128((__m128i*)(outData + i * 2), packLow16(result[0], result[1]));
+    }
+    RGBA8888ToRGB5A1_C(data + i * 4, pixelCount - i, outData + i * 2);
+}
+
+bool isSSSE3Supported()
+{
+#if defined (_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 9)) != 0;
+#else
+    return __builtin_cpu_supports("ssse3");
+#endif
+}
+
+const Kernels s_kernelsSSE2 = {
+    "SSE2",
+    premultiplyAlphaRGBA8888_SSE2,
+    I8ToRGBA8888_SSE2,
+    AI88ToRGBA8888_SSE2,
+    RGB888ToRGBA8888_C,
+    RGBA8888ToRGBA4444_SSE2,
+    RGBA8888ToRGB565_SSE2,
+    RGBA8888ToRGB5A1_SSE2,
+};
+
+const Kernels s_kernelsSSSE3 = {
+    "SSSE3",
+    premultiplyAlphaRGBA8888_SSE2,
+    I8ToRGBA8888_SSE2,
+    AI88ToRGBA8888_SSE2,
+    RGB888ToRGBA8888_SSSE3,
+    RGBA8888ToRGBA4444_SSE2,
+    RGBA8888ToRGB565_SSE2,
+    RGBA8888ToRGB5A1_SSE2,
+};
+#endif // INCLUDE_SSE2
+
+#ifdef INCLUDE_NEON
+//////////////////////////////////////////////////////////////////////////
+// NEON
+
+void premultiplyAlphaRGBA8888_NEON(unsigned char* data, ssize_t pixelCount)
+{
+    ssize_t i = 0;
+    for (; i + 8 <= pixelCount; i += 8)
+    {
+        uint8x8x4_t p = vld4_u8(data + i * 4);
+        // c * (a + 1) == c * a + c, at most 255 * 256
+        for (int c = 0; c < 3; ++c)
+        {
+            p.val[c] = vshrn_n_u16(vaddw_u8(vmull_u8(p.val[c], p.val[3]), p.val[c]), 8);
+        }
+        vst4_u8(data + i * 4, p);
+    }
+    premultiplyAlphaRGBA8888_C(data + i * 4, pixelCount - i);
+}
+
+void I8ToRGBA8888_NEON(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    const uint8x16_t ff = vdupq_n_u8(0xFF);
+    ssize_t i = 0;
+    for (; i + 16 <= pixelCount; i += 16)
+    {
+        const uint8x16_t intensity = vld1q_u8(data + i);
+        uint8x16x4_t out = { { intensity, intensity, intensity, ff } };
+        vst4q_u8(outData + i * 4, out);
+    }
+    I8ToRGBA8888_C(data + i, pixelCount - i, outData + i * 4);
+}
+
+void AI88ToRGBA8888_NEON(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    ssize_t i = 0;
+    for (; i + 16 <= pixelCount; i += 16)
+    {
+        const uint8x16x2_t ia = vld2q_u8(data + i * 2);
+        uint8x16x4_t out = { { ia.val[0], ia.val[0], ia.val[0], ia.val[1] } };
+        vst4q_u8(outData + i * 4, out);
+    }
+    AI88ToRGBA8888_C(data + i * 2, pixelCount - i, outData + i * 4);
+}
+
+void RGB888ToRGBA8888_NEON(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    const uint8x16_t ff = vdupq_n_u8(0xFF);
+    ssize_t i = 0;
+    for (; i + 16 <= pixelCount; i += 16)
+    {
+        const uint8x16x3_t rgb = vld3q_u8(data + i * 3);
+        uint8x16x4_t out = { { rgb.val[0], rgb.val[1], rgb.val[2], ff } };
+        vst4q_u8(outData + i * 4, out);
+    }
+    RGB888ToRGBA8888_C(data + i * 3, pixelCount - i, outData + i * 4);
+}
+
+void RGBA8888ToRGBA4444_NEON(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    const uint8x8_t maskHigh = vdup_n_u8(0xF0);
+    ssize_t i = 0;
+    for (; i + 8 <= pixelCount; i += 8)
+    {
+        const uint8x8x4_t p = vld4_u8(data + i * 4);
+        uint16x8_t out = vshll_n_u8(vand_u8(p.val[0], maskHigh), 8);            //R
+        out = vorrq_u16(out, vshll_n_u8(vand_u8(p.val[1], maskHigh), 4));      //G
+        out = vorrq_u16(out, vmovl_u8(vand_u8(p.val[2], maskHigh)));           //B
+        out = vorrq_u16(out, vmovl_u8(vshr_n_u8(p.val[3], 4)));                //A
+        vst1q_u16((uint16_t*)(outData + i * 2), out);
+    }
+    RGBA8888ToRGBA4444_C(data + i * 4, pixelCount - i, outData + i * 2);
+}
+
+void RGBA8888ToRGB565_NEON(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    ssize_t i = 0;
+    for (; i + 8 <= pixelCount; i += 8)
+    {
+        const uint8x8x4_t p = vld4_u8(data + i * 4);
+        uint16x8_t out = vshll_n_u8(vand_u8(p.val[0], vdup_n_u8(0xF8)), 8);            //R
+        out = vorrq_u16(out, vshll_n_u8(vand_u8(p.val[1], vdup_n_u8(0xFC)), 3));      //G
+        out = vorrq_u16(out, vmovl_u8(vshr_n_u8(p.val[2], 3)));                       //B
+        vst1q_u16((uint16_t*)(outData + i * 2), out);
+    }
+    RGBA8888ToRGB565_C(data + i * 4, pixelCount - i, outData + i * 2);
+}
+
+void RGBA8888ToRGB5A1_NEON(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    const uint8x8_t mask = vdup_n_u8(0xF8);
+    ssize_t i = 0;
+    for (; i + 8 <= pixelCount; i += 8)
+    {
+        const uint8x8x4_t p = vld4_u8(data + i * 4);
+        uint16x8_t out = vshll_n_u8(vand_u8(p.val[0], mask), 8);                       //R
+        out = vorrq_u16(out, vshll_n_u8(vand_u8(p.val[1], mask), 3));                 //G
+        out = vorrq_u16(out, vmovl_u8(vshr_n_u8(vand_u8(p.val[2], mask), 2)));        //B
+        out = vorrq_u16(out, vmovl_u8(vshr_n_u8(p.val[3], 7)));                       //A
+        vst1q_u16((uint16_t*)(outData + i * 2), out);
+    }
+    RGBA8888ToRGB5A1_C(data + i * 4, pixelCount - i, outData + i * 2);
+}
+
+const Kernels s_kernelsNEON = {
+    "NEON",
+    premultiplyAlphaRGBA8888_NEON,
+    I8ToRGBA8888_NEON,
+    AI88ToRGBA8888_NEON,
+    RGB888ToRGBA8888_NEON,
+    RGBA8888ToRGBA4444_NEON,
+    RGBA8888ToRGB565_NEON,
+    RGBA8888ToRGB5A1_NEON,
+};
+#endif // INCLUDE_NEON
+
+const Kernels* getSIMDKernels()
+{
+#if defined (INCLUDE_NEON)
+    return &s_kernelsNEON;
+#elif defined (INCLUDE_SSE2)
+    static const Kernels* kernels = isSSSE3Supported() ? &s_kernelsSSSE3 : &s_kernelsSSE2;
+    return kernels;
+#else
+    return &s_kernelsC;
+#endif
+}
+
+std::atomic<bool> s_simdEnabled(true);
+
+inline const Kernels* getKernels()
+{
+    return s_simdEnabled.load(std::memory_order_relaxed) ? getSIMDKernels() : &s_kernelsC;
+}
+
+} // namespace
+
+void setSIMDEnabled(bool enabled)
+{
+    s_simdEnabled = enabled;
+}
+
+const char* getSIMDName()
+{
+    return getKernels()->name;
+}
+
+void premultiplyAlphaRGBA8888(unsigned char* data, ssize_t pixelCount)
+{
+    getKernels()->premultiplyAlphaRGBA8888(data, pixelCount);
+}
+
+void convertI8ToRGBA8888(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    getKernels()->I8ToRGBA8888(data, pixelCount, outData);
+}
+
+void convertAI88ToRGBA8888(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    getKernels()->AI88ToRGBA8888(data, pixelCount, outData);
+}
+
+void convertRGB888ToRGBA8888(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    getKernels()->RGB888ToRGBA8888(data, pixelCount, outData);
+}
+
+void convertRGBA8888ToRGBA4444(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    getKernels()->RGBA8888ToRGBA4444(data, pixelCount, outData);
+}
+
+void convertRGBA8888ToRGB565(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    getKernels()->RGBA8888ToRGB565(data, pixelCount, outData);
+}
+
+void convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t pixelCount, unsigned char* outData)
+{
+    getKernels()->RGBA8888ToRGB5A1(data, pixelCount, outData);
+}
+
+} // namespace PixelConvert
+
+NS_CC_END
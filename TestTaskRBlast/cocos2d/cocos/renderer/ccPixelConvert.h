@@ -0,0 +1,69 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_PIXEL_CONVERT_H__
+#define __CC_PIXEL_CONVERT_H__
+
+#include "platform/CCPlatformMacros.h"
+#include "platform/CCStdC.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup renderer
+ * @{
+ */
+
+/**
+ * Pixel format conversion kernels used by Texture2D and Image.
+ *
+ * The best implementation for the CPU (SSE2, SSSE3 or NEON) is picked at runtime,
+ * all of them give the same result as the plain C one.
+ * Pixels are counted in source pixels, buffers don't need any alignment.
+ */
+namespace PixelConvert {
+
+/** Enables or disables the SIMD implementations, mainly to compare them with the plain C ones. Enabled by default. */
+void CC_DLL setSIMDEnabled(bool enabled);
+/** Returns the name of the implementation in use: "NEON", "SSSE3", "SSE2" or "C". */
+const char* CC_DLL getSIMDName();
+
+/** RGBA8888 in place, each color is multiplied by (alpha + 1) / 256, @see CC_RGB_PREMULTIPLY_ALPHA. */
+void CC_DLL premultiplyAlphaRGBA8888(unsigned char* data, ssize_t pixelCount);
+
+void CC_DLL convertI8ToRGBA8888(const unsigned char* data, ssize_t pixelCount, unsigned char* outData);
+void CC_DLL convertAI88ToRGBA8888(const unsigned char* data, ssize_t pixelCount, unsigned char* outData);
+void CC_DLL convertRGB888ToRGBA8888(const unsigned char* data, ssize_t pixelCount, unsigned char* outData);
+void CC_DLL convertRGBA8888ToRGBA4444(const unsigned char* data, ssize_t pixelCount, unsigned char* outData);
+void CC_DLL convertRGBA8888ToRGB565(const unsigned char* data, ssize_t pixelCount, unsigned char* outData);
+void CC_DLL convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t pixelCount, unsigned char* outData);
+
+} // namespace PixelConvert
+
+// end of renderer group
+/// @}
+
+NS_CC_END
+
+#endif // __CC_PIXEL_CONVERT_H__
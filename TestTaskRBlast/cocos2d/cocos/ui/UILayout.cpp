@@ -351,6 +351,7 @@ void Layout::onBeforeVisitScissor()
                                    clippingRect.size.width,
                                    clippingRect.size.height);
     }
+    Director::getInstance()->getRenderer()->intersectScissorWithDamage();
 }
 
 void Layout::onAfterVisitScissor()
@@ -0,0 +1,225 @@
+#!/usr/bin/python
+#-*- coding: UTF-8 -*-
+# ----------------------------------------------------------------------------
+# Build an asset pack (.ccpk) from a resources directory.
+#
+# License: MIT
+# ----------------------------------------------------------------------------
+'''
+Build an asset pack (.ccpk) from a resources directory.
+
+The pack is read by cocos2d::AssetPack (cocos/base/CCAssetPack.cpp), which documents
+the layout. Files are split in chunks compressed independently with zlib, a chunk is
+stored when compression saves less than 1/16 of it. The directory is indexed by a
+minimal perfect hash built with the hash and displace method, using XXH32 as the
+engine does.
+'''
+
+import os
+import sys
+import zlib
+import struct
+
+from argparse import ArgumentParser
+
+MAGIC = b'CCPK'
+VERSION = 1
+HEADER_SIZE = 64
+ENTRY_SIZE = 32
+CHUNK_SIZE = 16
+DIRECT_DISPLACEMENT = 0x80000000
+
+CODEC_STORED = 0
+CODEC_ZLIB = 1
+
+# already compressed formats, stored without trying zlib
+STORED_EXTENSIONS = set(['.png', '.jpg', '.jpeg', '.webp', '.ogg', '.mp3', '.m4a',
+                         '.pvr', '.pkm', '.ktx', '.ccz', '.gz', '.zip', '.ccpk'])
+
+PRIME32_1 = 2654435761
+PRIME32_2 = 2246822519
+PRIME32_3 = 3266489917
+PRIME32_4 = 668265263
+PRIME32_5 = 374761393
+MASK32 = 0xFFFFFFFF
+
+
+def _rotl(x, r):
+    return ((x << r) | (x >> (32 - r))) & MASK32
+
+
+def xxh32(data, seed):
+    '''XXH32 of bytes, as external/xxhash.'''
+    length = len(data)
+    p = 0
+    if length >= 16:
+        v1 = (seed + PRIME32_1 + PRIME32_2) & MASK32
+        v2 = (seed + PRIME32_2) & MASK32
+        v3 = seed & MASK32
+        v4 = (seed - PRIME32_1) & MASK32
+        limit = length - 16
+        while p <= limit:
+            a, b, c, d = struct.unpack_from('<4I', data, p)
+            v1 = (_rotl((v1 + a * PRIME32_2) & MASK32, 13) * PRIME32_1) & MASK32
+            v2 = (_rotl((v2 + b * PRIME32_2) & MASK32, 13) * PRIME32_1) & MASK32
+            v3 = (_rotl((v3 + c * PRIME32_2) & MASK32, 13) * PRIME32_1) & MASK32
+            v4 = (_rotl((v4 + d * PRIME32_2) & MASK32, 13) * PRIME32_1) & MASK32
+            p += 16
+        h = (_rotl(v1, 1) + _rotl(v2, 7) + _rotl(v3, 12) + _rotl(v4, 18)) & MASK32
+    else:
+        h = (seed + PRIME32_5) & MASK32
+
+    h = (h + length) & MASK32
+
+    while p + 4 <= length:
+        h = (h + struct.unpack_from('<I', data, p)[0] * PRIME32_3) & MASK32
+        h = (_rotl(h, 17) * PRIME32_4) & MASK32
+        p += 4
+
+    while p < length:
+        h = (h + bytearray(data[p:p + 1])[0] * PRIME32_5) & MASK32
+        h = (_rotl(h, 11) * PRIME32_1) & MASK32
+        p += 1
+
+    h ^= h >> 15
+    h = (h * PRIME32_2) & MASK32
+    h ^= h >> 13
+    h = (h * PRIME32_3) & MASK32
+    h ^= h >> 16
+    return h
+
+
+def build_perfect_hash(names):
+    '''Returns (seed, displacements, slots): names[slots[i]] is stored at entry i.'''
+    count = len(names)
+    if count == 0:
+        return 0, [0], []
+
+    bucket_count = max(1, (count + 3) // 4)
+    for seed in range(1, 1000):
+        buckets = [[] for _ in range(bucket_count)]
+        for i, name in enumerate(names):
+            buckets[xxh32(name, seed) % bucket_count].append(i)
+
+        displacements = [0] * bucket_count
+        slots = [None] * count
+        order = sorted(range(bucket_count), key=lambda b: -len(buckets[b]))
+        placed = True
+        free = None
+        for b in order:
+            bucket = buckets[b]
+            if not bucket:
+                break
+            if len(bucket) == 1:
+                # single names take any free entry
+                if free is None:
+                    free = [i for i in range(count) if slots[i] is None]
+                while slots[free[-1]] is not None:
+                    free.pop()
+                index = free.pop()
+                slots[index] = bucket[0]
+                displacements[b] = DIRECT_DISPLACEMENT | index
+                continue
+            for displacement in range(1, 1 << 20):
+                indices = [xxh32(names[i], displacement) % count for i in bucket]
+                if len(set(indices)) == len(indices) and all(slots[i] is None for i in indices):
+                    for index, name_index in zip(indices, bucket):
+                        slots[index] = name_index
+                    displacements[b] = displacement
+                    break
+            else:
+                placed = False
+                break
+        if placed:
+            return seed, displacements, slots
+    raise RuntimeError('no perfect hash found')
+
+
+def compress_chunk(chunk, stored):
+    if not stored:
+        compressed = zlib.compress(chunk, 9)
+        if len(compressed) < len(chunk) - len(chunk) // 16:
+            return compressed
+    return chunk
+
+
+def list_files(root):
+    files = []
+    for directory, dirs, names in os.walk(root):
+        dirs.sort()
+        for name in sorted(names):
+            path = os.path.join(directory, name)
+            files.append((os.path.relpath(path, root).replace(os.sep, '/'), path))
+    return files
+
+
+def build_pack(root, output, chunk_size):
+    files = list_files(root)
+    names = [name.encode('utf-8') for name, _ in files]
+    seed, displacements, slots = build_perfect_hash(names)
+
+    entries = [None] * len(files)
+    chunks = []
+    data = bytearray()
+    data_offset = HEADER_SIZE  # the data follows the header
+
+    for file_index, (name, path) in enumerate(files):
+        with open(path, 'rb') as f:
+            content = f.read()
+        stored = os.path.splitext(name)[1].lower() in STORED_EXTENSIONS
+        first_chunk = len(chunks)
+        for start in range(0, max(len(content), 1), chunk_size):
+            chunk = content[start:start + chunk_size]
+            if not chunk:
+                break
+            packed = compress_chunk(chunk, stored)
+            chunks.append((data_offset + len(data), len(packed), len(chunk)))
+            data += packed
+        entries[file_index] = (CODEC_ZLIB, len(chunks) - first_chunk, len(content), first_chunk)
+
+    names_blob = bytearray()
+    name_offsets = []
+    for name in names:
+        name_offsets.append(len(names_blob))
+        names_blob += name
+
+    displacements_offset = data_offset + len(data)
+    entries_offset = displacements_offset + 4 * len(displacements)
+    chunks_offset = entries_offset + ENTRY_SIZE * len(entries)
+    names_offset = chunks_offset + CHUNK_SIZE * len(chunks)
+
+    with open(output, 'wb') as f:
+        f.write(struct.pack('<4s7I4Q', MAGIC, VERSION, len(entries), len(displacements), seed,
+                            chunk_size, len(chunks), 0,
+                            displacements_offset, entries_offset, chunks_offset, names_offset))
+        f.write(bytes(data))
+        f.write(struct.pack('<%dI' % len(displacements), *displacements))
+        for file_index in slots:
+            codec, chunk_count, size, first_chunk = entries[file_index]
+            f.write(struct.pack('<4IQ2I', name_offsets[file_index], len(names[file_index]),
+                                codec, chunk_count, size, first_chunk, 0))
+        for offset, packed_size, size in chunks:
+            f.write(struct.pack('<Q2I', offset, packed_size, size))
+        f.write(bytes(names_blob))
+
+    return len(files), sum(e[2] for e in entries), os.path.getsize(output)
+
+
+def main():
+    parser = ArgumentParser(description='Build an asset pack (.ccpk) from a resources directory.')
+    parser.add_argument('input', help='resources directory, its files are packed with names relative to it')
+    parser.add_argument('output', help='asset pack file')
+    parser.add_argument('--chunk-size', type=int, default=64, help='size of the compressed chunks in KB (default: 64)')
+    args = parser.parse_args()
+
+    if not os.path.isdir(args.input):
+        print('%s is not a directory' % args.input)
+        return 1
+
+    count, size, packed = build_pack(args.input, args.output, args.chunk_size * 1024)
+    print('%s: %d files, %d bytes packed in %d bytes' % (args.output, count, size, packed))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,308 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+// Benchmarks cocos2d::makeDistanceMap against the edtaa3 implementation it replaced,
+// on the glyphs of a font for the ASCII, Cyrillic and common CJK ranges.
+// See README.md for the build command.
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+#include <iconv.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "2d/CCFontDistanceMap.h"
+#include "edtaa3func.h"
+
+// FontFreeType::DistanceMapSpread
+static const long DistanceMapSpread = 3;
+
+// makeDistanceMap of cocos2d-x 3.17, with computegradient and edtaa3 on doubles
+static unsigned char* edtaa3DistanceMap(const unsigned char* img, long width, long height)
+{
+    long outWidth = width + 2 * DistanceMapSpread;
+    long outHeight = height + 2 * DistanceMapSpread;
+    long pixelAmount = outWidth * outHeight;
+
+    std::vector<short> xdist(pixelAmount);
+    std::vector<short> ydist(pixelAmount);
+    std::vector<double> gx(pixelAmount);
+    std::vector<double> gy(pixelAmount);
+    std::vector<double> data(pixelAmount);
+    std::vector<double> outside(pixelAmount);
+    std::vector<double> inside(pixelAmount);
+
+    for (long i = 0; i < width; ++i)
+    {
+        for (long j = 0; j < height; ++j)
+        {
+            data[j * outWidth + DistanceMapSpread + i] = img[j * width + i] / 255.0;
+        }
+    }
+
+    computegradient(data.data(), (int)outWidth, (int)outHeight, gx.data(), gy.data());
+    edtaa3(data.data(), gx.data(), gy.data(), (int)outWidth, (int)outHeight, xdist.data(), ydist.data(), outside.data());
+    for (long i = 0; i < pixelAmount; ++i)
+    {
+        outside[i] = std::max(outside[i], 0.0);
+        data[i] = 1 - data[i];
+    }
+    computegradient(data.data(), (int)outWidth, (int)outHeight, gx.data(), gy.data());
+    edtaa3(data.data(), gx.data(), gy.data(), (int)outWidth, (int)outHeight, xdist.data(), ydist.data(), inside.data());
+
+    unsigned char* out = (unsigned char*)malloc(pixelAmount);
+    for (long i = 0; i < pixelAmount; ++i)
+    {
+        double dist = 128.0 - (outside[i] - std::max(inside[i], 0.0)) * 16;
+        out[i] = (unsigned char)std::min(std::max(dist, 0.0), 255.0);
+    }
+    return out;
+}
+
+struct GlyphRange
+{
+    std::string name;
+    std::vector<unsigned long> codes;
+};
+
+struct Glyph
+{
+    std::vector<unsigned char> coverage;
+    long width;
+    long height;
+};
+
+static GlyphRange makeRange(const std::string& name, unsigned long first, unsigned long last)
+{
+    GlyphRange range;
+    range.name = name;
+    for (unsigned long code = first; code <= last; ++code)
+    {
+        range.codes.push_back(code);
+    }
+    return range;
+}
+
+// the 3755 hanzi of GB2312 level 1, the most frequent Chinese characters
+static GlyphRange makeCommonCJKRange()
+{
+    GlyphRange range;
+    range.name = "CJK (GB2312 level 1)";
+
+    iconv_t cd = iconv_open("UTF-32LE", "GB2312");
+    if (cd == (iconv_t)-1)
+    {
+        fprintf(stderr, "iconv can't convert GB2312, the CJK range is skipped\n");
+        return range;
+    }
+    for (int row = 0xB0; row <= 0xD7; ++row)
+    {
+        for (int cell = 0xA1; cell <= 0xFE; ++cell)
+        {
+            char in[2] = { (char)row, (char)cell };
+            unsigned char out[4];
+            char* inPtr = in;
+            char* outPtr = (char*)out;
+            size_t inLeft = sizeof(in);
+            size_t outLeft = sizeof(out);
+            if (iconv(cd, &inPtr, &inLeft, &outPtr, &outLeft) != (size_t)-1 && outLeft == 0)
+            {
+                range.codes.push_back(out[0] | (out[1] << 8) | (out[2] << 16) | ((unsigned long)out[3] << 24));
+            }
+        }
+    }
+    iconv_close(cd);
+    return range;
+}
+
+// rasterizes the glyphs like FontFreeType::getGlyphBitmap does for distance field labels
+static std::vector<Glyph> rasterize(FT_Face face, const GlyphRange& range, int& missing)
+{
+    std::vector<Glyph> glyphs;
+    missing = 0;
+    for (auto code : range.codes)
+    {
+        if (FT_Get_Char_Index(face, code) == 0)
+        {
+            ++missing;
+            continue;
+        }
+        if (FT_Load_Char(face, code, FT_LOAD_RENDER | FT_LOAD_NO_HINTING | FT_LOAD_NO_AUTOHINT))
+        {
+            continue;
+        }
+        const FT_Bitmap& bitmap = face->glyph->bitmap;
+        if (bitmap.width == 0 || bitmap.rows == 0)
+        {
+            continue;
+        }
+
+        Glyph glyph;
+        glyph.width = bitmap.width;
+        glyph.height = bitmap.rows;
+        glyph.coverage.resize(glyph.width * glyph.height);
+        for (long y = 0; y < glyph.height; ++y)
+        {
+            memcpy(&glyph.coverage[y * glyph.width], bitmap.buffer + y * bitmap.pitch, glyph.width);
+        }
+        glyphs.push_back(glyph);
+    }
+    return glyphs;
+}
+
+static void benchmark(FT_Face face, const GlyphRange& range, int fontSize, int repeat)
+{
+    FT_Set_Char_Size(face, fontSize * 64, fontSize * 64, 72, 72);
+
+    int missing = 0;
+    auto glyphs = rasterize(face, range, missing);
+    if (glyphs.empty())
+    {
+        printf("%-22s %4dpx %6d glyphs, %d missing from the font\n", range.name.c_str(), fontSize, 0, missing);
+        return;
+    }
+
+    double edtaa3Time = 0;
+    double edtTime = 0;
+    double diffSum = 0;
+    long diffMax = 0;
+    long diffCount = 0;
+    for (int r = 0; r < repeat; ++r)
+    {
+        for (auto& glyph : glyphs)
+        {
+            auto t0 = std::chrono::steady_clock::now();
+            unsigned char* reference = edtaa3DistanceMap(glyph.coverage.data(), glyph.width, glyph.height);
+            auto t1 = std::chrono::steady_clock::now();
+            unsigned char* result = cocos2d::makeDistanceMap(glyph.coverage.data(), glyph.width, glyph.height, DistanceMapSpread);
+            auto t2 = std::chrono::steady_clock::now();
+            edtaa3Time += std::chrono::duration<double, std::milli>(t1 - t0).count();
+            edtTime += std::chrono::duration<double, std::milli>(t2 - t1).count();
+
+            // compared near the contour, the texels the label shader thresholds
+            if (r == 0)
+            {
+                long count = (glyph.width + 2 * DistanceMapSpread) * (glyph.height + 2 * DistanceMapSpread);
+                for (long i = 0; i < count; ++i)
+                {
+                    if (reference[i] < 96 || reference[i] > 160)
+                        continue;
+                    long diff = std::labs((long)reference[i] - (long)result[i]);
+                    diffSum += diff;
+                    diffMax = std::max(diffMax, diff);
+                    ++diffCount;
+                }
+            }
+            free(reference);
+            free(result);
+        }
+    }
+
+    printf("%-22s %4dpx %6zu glyphs  edtaa3 %9.1f ms  edt %8.1f ms  %5.1fx  contour diff mean %.2f max %ld\n",
+        range.name.c_str(), fontSize, glyphs.size(), edtaa3Time / repeat, edtTime / repeat, edtaa3Time / edtTime,
+        diffCount ? diffSum / diffCount : 0.0, diffMax);
+}
+
+static int usage(const char* program)
+{
+    fprintf(stderr, "usage: %s font-file [-s size]... [-r name:first-last]... [-n repeat]\n", program);
+    fprintf(stderr, "  -s size              font size in pixels, 32 and 64 by default\n");
+    fprintf(stderr, "  -r name:first-last   extra range of hexadecimal code points, e.g. Hangul:AC00-D7A3\n");
+    fprintf(stderr, "  -n repeat            runs over each range, 3 by default\n");
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+        return usage(argv[0]);
+
+    std::vector<int> sizes;
+    std::vector<GlyphRange> ranges;
+    ranges.push_back(makeRange("ASCII", 0x21, 0x7E));
+    ranges.push_back(makeRange("Cyrillic", 0x400, 0x4FF));
+    ranges.push_back(makeCommonCJKRange());
+    int repeat = 3;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        if (i + 1 >= argc)
+            return usage(argv[0]);
+        std::string option = argv[i];
+        std::string value = argv[++i];
+        if (option == "-s")
+        {
+            sizes.push_back(atoi(value.c_str()));
+        }
+        else if (option == "-n")
+        {
+            repeat = std::max(1, atoi(value.c_str()));
+        }
+        else if (option == "-r")
+        {
+            unsigned long first = 0;
+            unsigned long last = 0;
+            auto colon = value.find(':');
+            if (colon == std::string::npos || sscanf(value.c_str() + colon + 1, "%lx-%lx", &first, &last) != 2)
+                return usage(argv[0]);
+            ranges.push_back(makeRange(value.substr(0, colon), first, last));
+        }
+        else
+        {
+            return usage(argv[0]);
+        }
+    }
+    if (sizes.empty())
+    {
+        sizes.push_back(32);
+        sizes.push_back(64);
+    }
+
+    FT_Library library;
+    FT_Face face;
+    if (FT_Init_FreeType(&library) || FT_New_Face(library, argv[1], 0, &face))
+    {
+        fprintf(stderr, "can't open the font %s\n", argv[1]);
+        return 1;
+    }
+    printf("%s, %d runs\n", argv[1], repeat);
+    for (auto size : sizes)
+    {
+        for (auto& range : ranges)
+        {
+            benchmark(face, range, size, repeat);
+        }
+    }
+
+    FT_Done_Face(face);
+    FT_Done_FreeType(library);
+    return 0;
+}
@@ -0,0 +1,300 @@
+/****************************************************************************
+ Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+// Runs every ParticleKernels kernel with the plain C and the SIMD implementations on the same
+// particles, checks that the outputs agree, then times both on 100k particles.
+// See README.md for the build command.
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+#include "2d/CCParticleKernels.h"
+#include "2d/CCParticleSystem.h"
+
+USING_NS_CC;
+
+// ParticleData::ParticleData lives in CCParticleSystem.cpp with the rest of the engine
+ParticleData::ParticleData()
+{
+    memset(this, 0, sizeof(ParticleData));
+}
+
+static const int ParticleCount = 100003; // not a multiple of 4, so the leftover particles run too
+static const int BenchmarkRuns = 200;
+
+// the float arrays the kernels read or write
+static std::vector<float**> floatFields(ParticleData& data)
+{
+    return {
+        &data.posx, &data.posy, &data.startPosX, &data.startPosY,
+        &data.colorR, &data.colorG, &data.colorB, &data.colorA,
+        &data.deltaColorR, &data.deltaColorG, &data.deltaColorB, &data.deltaColorA,
+        &data.size, &data.deltaSize, &data.rotation, &data.deltaRotation, &data.timeToLive,
+        &data.modeA.dirX, &data.modeA.dirY, &data.modeA.radialAccel, &data.modeA.tangentialAccel,
+        &data.modeB.angle, &data.modeB.degreesPerSecond, &data.modeB.radius, &data.modeB.deltaRadius,
+    };
+}
+
+static float randomFloat(float minValue, float maxValue)
+{
+    return minValue + (maxValue - minValue) * (rand() / (float)RAND_MAX);
+}
+
+// particles in the ranges ParticleSystem produces
+static void initParticles(ParticleData& data, int count)
+{
+    for (auto field : floatFields(data))
+    {
+        *field = (float*)malloc(count * sizeof(float));
+    }
+    for (int i = 0; i < count; ++i)
+    {
+        data.posx[i] = randomFloat(-300, 300);
+        data.posy[i] = randomFloat(-300, 300);
+        data.startPosX[i] = randomFloat(-100, 100);
+        data.startPosY[i] = randomFloat(-100, 100);
+        data.colorR[i] = randomFloat(0, 1);
+        data.colorG[i] = randomFloat(0, 1);
+        data.colorB[i] = randomFloat(0, 1);
+        data.colorA[i] = randomFloat(0, 1);
+        data.deltaColorR[i] = randomFloat(-1, 1);
+        data.deltaColorG[i] = randomFloat(-1, 1);
+        data.deltaColorB[i] = randomFloat(-1, 1);
+        data.deltaColorA[i] = randomFloat(-1, 1);
+        data.size[i] = randomFloat(0, 64);
+        data.deltaSize[i] = randomFloat(-32, 32);
+        data.rotation[i] = randomFloat(-720, 720);
+        data.deltaRotation[i] = randomFloat(-360, 360);
+        data.timeToLive[i] = randomFloat(0, 2);
+        data.modeA.dirX[i] = randomFloat(-200, 200);
+        data.modeA.dirY[i] = randomFloat(-200, 200);
+        data.modeA.radialAccel[i] = randomFloat(-50, 50);
+        data.modeA.tangentialAccel[i] = randomFloat(-50, 50);
+        data.modeB.angle[i] = randomFloat(-20, 20);
+        data.modeB.degreesPerSecond[i] = randomFloat(-6, 6);
+        data.modeB.radius[i] = randomFloat(0, 300);
+        data.modeB.deltaRadius[i] = randomFloat(-100, 100);
+    }
+    // particles at the emitter, where the radial direction is undefined
+    data.posx[0] = data.posy[0] = 0;
+    data.posx[5] = data.posy[5] = 0;
+}
+
+static void copyParticles(ParticleData& dst, ParticleData& src, int count)
+{
+    auto dstFields = floatFields(dst);
+    auto srcFields = floatFields(src);
+    for (size_t i = 0; i < dstFields.size(); ++i)
+    {
+        memcpy(*dstFields[i], *srcFields[i], count * sizeof(float));
+    }
+}
+
+static void releaseParticles(ParticleData& data)
+{
+    for (auto field : floatFields(data))
+    {
+        free(*field);
+        *field = nullptr;
+    }
+}
+
+// largest difference relative to max(1, |reference|)
+static double relativeDiff(const float* reference, const float* result, int count)
+{
+    double maxDiff = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        double diff = fabs((double)reference[i] - result[i]) / std::max(1.0, fabs((double)reference[i]));
+        maxDiff = std::max(maxDiff, diff);
+    }
+    return maxDiff;
+}
+
+static int s_failures = 0;
+
+static void report(const char* name, double diff, double tolerance)
+{
+    bool passed = diff <= tolerance;
+    printf("%-24s max relative diff %-10.3g tolerance %-8.3g %s\n", name, diff, tolerance, passed ? "ok" : "FAILED");
+    if (!passed)
+        ++s_failures;
+}
+
+static double averageTime(const std::function<void()>& kernel)
+{
+    kernel();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BenchmarkRuns; ++i)
+    {
+        kernel();
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / BenchmarkRuns;
+}
+
+static void benchmark(const char* name, const std::function<void()>& kernel)
+{
+    ParticleKernels::setSIMDEnabled(false);
+    double scalarTime = averageTime(kernel);
+    ParticleKernels::setSIMDEnabled(true);
+    double simdTime = averageTime(kernel);
+    printf("%-24s C %8.3f ms  %-4s %8.3f ms  %5.2fx\n", name, scalarTime, ParticleKernels::getSIMDName(), simdTime, scalarTime / simdTime);
+}
+
+// runs the kernel on a copy of base with each implementation and compares every float array
+static void checkKernel(const char* name, ParticleData& base, double tolerance, const std::function<void(ParticleData&)>& kernel)
+{
+    ParticleData scalar;
+    ParticleData simd;
+    initParticles(scalar, ParticleCount);
+    initParticles(simd, ParticleCount);
+    copyParticles(scalar, base, ParticleCount);
+    copyParticles(simd, base, ParticleCount);
+
+    ParticleKernels::setSIMDEnabled(false);
+    kernel(scalar);
+    ParticleKernels::setSIMDEnabled(true);
+    kernel(simd);
+
+    double diff = 0;
+    auto scalarFields = floatFields(scalar);
+    auto simdFields = floatFields(simd);
+    for (size_t i = 0; i < scalarFields.size(); ++i)
+    {
+        diff = std::max(diff, relativeDiff(*scalarFields[i], *simdFields[i], ParticleCount));
+    }
+    report(name, diff, tolerance);
+
+    releaseParticles(scalar);
+    releaseParticles(simd);
+}
+
+static void checkQuads(const char* name, ParticleData& base, const ParticleKernels::QuadOrigin& origin, bool opacityModifyRGB)
+{
+    std::vector<V3F_C4B_T2F_Quad> scalar(ParticleCount);
+    std::vector<V3F_C4B_T2F_Quad> simd(ParticleCount);
+    ParticleKernels::setSIMDEnabled(false);
+    ParticleKernels::updateQuads(scalar.data(), base, ParticleCount, origin, opacityModifyRGB);
+    ParticleKernels::setSIMDEnabled(true);
+    ParticleKernels::updateQuads(simd.data(), base, ParticleCount, origin, opacityModifyRGB);
+
+    // a corner is a sum of rotated terms that can cancel out, so its error is measured
+    // against the size of the particle rather than against the corner itself
+    double diff = 0;
+    int colorDiff = 0;
+    for (int i = 0; i < ParticleCount; ++i)
+    {
+        double scale = std::max(1.0, (double)fabsf(base.posx[i]) + fabsf(base.posy[i]) + fabsf(base.size[i]));
+        const V3F_C4B_T2F* scalarCorners[] = { &scalar[i].bl, &scalar[i].br, &scalar[i].tl, &scalar[i].tr };
+        const V3F_C4B_T2F* simdCorners[] = { &simd[i].bl, &simd[i].br, &simd[i].tl, &simd[i].tr };
+        for (int k = 0; k < 4; ++k)
+        {
+            diff = std::max(diff, fabs((double)scalarCorners[k]->vertices.x - simdCorners[k]->vertices.x) / scale);
+            diff = std::max(diff, fabs((double)scalarCorners[k]->vertices.y - simdCorners[k]->vertices.y) / scale);
+            const Color4B& a = scalarCorners[k]->colors;
+            const Color4B& b = simdCorners[k]->colors;
+            colorDiff = std::max({ colorDiff, abs(a.r - b.r), abs(a.g - b.g), abs(a.b - b.b), abs(a.a - b.a) });
+        }
+    }
+    report(name, diff, 2e-6);
+    printf("%-24s max color diff %d\n", name, colorDiff);
+    if (colorDiff > 0)
+        ++s_failures;
+}
+
+int main()
+{
+    srand(1);
+    ParticleData base;
+    initParticles(base, ParticleCount);
+    printf("SIMD implementation: %s, %d particles\n\n", ParticleKernels::getSIMDName(), ParticleCount);
+
+    // the random fills must match exactly, including the seed they leave
+    std::vector<float> scalarRandom(ParticleCount);
+    std::vector<float> simdRandom(ParticleCount);
+    uint32_t scalarSeed = 12345;
+    uint32_t simdSeed = 12345;
+    ParticleKernels::setSIMDEnabled(false);
+    ParticleKernels::randomFillClamped(scalarRandom.data(), ParticleCount, 0.5f, 0.7f, 0, 1, &scalarSeed);
+    ParticleKernels::setSIMDEnabled(true);
+    ParticleKernels::randomFillClamped(simdRandom.data(), ParticleCount, 0.5f, 0.7f, 0, 1, &simdSeed);
+    report("randomFillClamped", relativeDiff(scalarRandom.data(), simdRandom.data(), ParticleCount), 0);
+    if (scalarSeed != simdSeed)
+    {
+        printf("randomFillClamped        seeds differ FAILED\n");
+        ++s_failures;
+    }
+
+    // gravity, color, size and rotation are the same arithmetic in both; the radius mode
+    // uses the Cephes polynomial sincos, about 1e-7 relative away from sinf/cosf
+    checkKernel("updateGravity", base, 1e-6, [](ParticleData& data) {
+        ParticleKernels::updateGravity(data, ParticleCount, 0.016f, 0, -98, 1);
+    });
+    checkKernel("updateRadius", base, 2e-6, [](ParticleData& data) {
+        ParticleKernels::updateRadius(data, ParticleCount, 0.016f, -1);
+    });
+    checkKernel("updateColorSizeRotation", base, 1e-6, [](ParticleData& data) {
+        ParticleKernels::updateColorSizeRotation(data, ParticleCount, 0.016f);
+    });
+    ParticleKernels::QuadOrigin origin = { 0.9f, 0.1f, -0.1f, 0.9f, 12.5f, -3.0f };
+    checkQuads("updateQuads", base, origin, false);
+    checkQuads("updateQuads premultiply", base, origin, true);
+
+    printf("\n");
+    std::vector<float> randomValues(ParticleCount);
+    benchmark("randomFill", [&]() {
+        uint32_t seed = 1;
+        ParticleKernels::randomFill(randomValues.data(), ParticleCount, 1, 2, &seed);
+    });
+    ParticleData work;
+    initParticles(work, ParticleCount);
+    copyParticles(work, base, ParticleCount);
+    benchmark("updateGravity", [&]() {
+        ParticleKernels::updateGravity(work, ParticleCount, 0.016f, 0, -98, 1);
+    });
+    copyParticles(work, base, ParticleCount);
+    benchmark("updateRadius", [&]() {
+        ParticleKernels::updateRadius(work, ParticleCount, 0.016f, -1);
+    });
+    copyParticles(work, base, ParticleCount);
+    benchmark("updateColorSizeRotation", [&]() {
+        ParticleKernels::updateColorSizeRotation(work, ParticleCount, 0.016f);
+    });
+    std::vector<V3F_C4B_T2F_Quad> quads(ParticleCount);
+    benchmark("updateQuads", [&]() {
+        ParticleKernels::updateQuads(quads.data(), base, ParticleCount, origin, true);
+    });
+    releaseParticles(work);
+    releaseParticles(base);
+
+    printf("\n%s\n", s_failures ? "FAILED" : "PASSED");
+    return s_failures ? 1 : 0;
+}
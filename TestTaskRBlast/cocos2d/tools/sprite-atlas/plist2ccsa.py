@@ -0,0 +1,194 @@
+#!/usr/bin/python
+#-*- coding: UTF-8 -*-
+# ----------------------------------------------------------------------------
+# Convert plist sprite atlases to binary sprite atlases (.ccsa).
+#
+# License: MIT
+# ----------------------------------------------------------------------------
+'''
+Convert plist sprite atlases to binary sprite atlases (.ccsa).
+
+The plist formats 0 to 3 read by SpriteFrameCache (Zwoptex, TexturePacker) are
+converted to the FlatBuffers schema cocos/2d/fbs-files/SpriteAtlasBinary.fbs,
+with the same frames, aliases, anchor points and polygon meshes. The frames are
+written to a JSON file which flatc turns into the binary atlas.
+SpriteFrameCache loads the files with the .ccsa extension as binary atlases.
+'''
+
+import os
+import re
+import sys
+import json
+import shutil
+import plistlib
+import subprocess
+import tempfile
+
+from argparse import ArgumentParser
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+SCHEMA = os.path.join(SCRIPT_DIR, '..', '..', 'cocos', '2d', 'fbs-files', 'SpriteAtlasBinary.fbs')
+
+NUMBER = re.compile(r'[-+]?(?:\d+\.?\d*|\.\d+)(?:[eE][-+]?\d+)?')
+
+
+def parse_numbers(value):
+    return [float(n) for n in NUMBER.findall(value)]
+
+
+def parse_point(value):
+    x, y = parse_numbers(value)[:2]
+    return {'x': x, 'y': y}
+
+
+def parse_size(value):
+    w, h = parse_numbers(value)[:2]
+    return {'width': w, 'height': h}
+
+
+def parse_rect(value):
+    x, y, w, h = parse_numbers(value)[:4]
+    return {'x': x, 'y': y, 'width': w, 'height': h}
+
+
+def parse_integers(value):
+    return [int(n) for n in value.split()]
+
+
+def load_plist(path):
+    with open(path, 'rb') as f:
+        if hasattr(plistlib, 'load'):
+            return plistlib.load(f)
+        return plistlib.readPlist(f)
+
+
+def convert_frame(name, frame, format):
+    '''Returns the AtlasFrame table of a frame of the plist, as SpriteFrameCache reads it.'''
+    if format == 0:
+        rect = {'x': float(frame['x']), 'y': float(frame['y']),
+                'width': float(frame['width']), 'height': float(frame['height'])}
+        data = {
+            'rect': rect,
+            'offset': {'x': float(frame.get('offsetX', 0)), 'y': float(frame.get('offsetY', 0))},
+            'sourceSize': {'width': float(abs(int(frame.get('originalWidth', 0)))),
+                           'height': float(abs(int(frame.get('originalHeight', 0))))},
+        }
+    elif format in (1, 2):
+        data = {
+            'rect': parse_rect(frame['frame']),
+            'rotated': 1 if format == 2 and frame.get('rotated', False) else 0,
+            'offset': parse_point(frame['offset']),
+            'sourceSize': parse_size(frame['sourceSize']),
+        }
+    else:
+        texture_rect = parse_rect(frame['textureRect'])
+        sprite_size = parse_size(frame['spriteSize'])
+        texture_rect['width'] = sprite_size['width']
+        texture_rect['height'] = sprite_size['height']
+        data = {
+            'rect': texture_rect,
+            'rotated': 1 if frame.get('textureRotated', False) else 0,
+            'offset': parse_point(frame['spriteOffset']),
+            'sourceSize': parse_size(frame['spriteSourceSize']),
+        }
+        if frame.get('aliases'):
+            data['aliases'] = list(frame['aliases'])
+        if 'vertices' in frame:
+            data['vertices'] = parse_integers(frame['vertices'])
+            data['verticesUV'] = parse_integers(frame['verticesUV'])
+            data['triangles'] = parse_integers(frame['triangles'])
+        if 'anchor' in frame:
+            data['anchor'] = parse_point(frame['anchor'])
+
+    data['name'] = name
+    return data
+
+
+def convert_atlas(plist):
+    '''Returns the SpriteAtlas table of a plist atlas.'''
+    frames = plist.get('frames')
+    if not isinstance(frames, dict):
+        raise ValueError('no frames')
+
+    metadata = plist.get('metadata', {})
+    format = int(metadata.get('format', 0))
+    if format < 0 or format > 3:
+        raise ValueError('format %d is not supported' % format)
+
+    atlas = {'frames': [convert_frame(name, frames[name], format) for name in sorted(frames)]}
+    if metadata.get('textureFileName'):
+        atlas['textureFileName'] = metadata['textureFileName']
+    if metadata.get('pixelFormat'):
+        atlas['pixelFormat'] = metadata['pixelFormat']
+    if metadata.get('size'):
+        atlas['textureSize'] = parse_size(metadata['size'])
+    return atlas
+
+
+def convert_file(path, output, flatc):
+    atlas = convert_atlas(load_plist(path))
+
+    tmp_dir = tempfile.mkdtemp()
+    try:
+        json_path = os.path.join(tmp_dir, 'atlas.json')
+        with open(json_path, 'w') as f:
+            json.dump(atlas, f)
+        subprocess.check_call([flatc, '-b', '-o', tmp_dir, SCHEMA, json_path])
+        out_dir = os.path.dirname(output)
+        if out_dir and not os.path.isdir(out_dir):
+            os.makedirs(out_dir)
+        shutil.move(os.path.join(tmp_dir, 'atlas.ccsa'), output)
+    finally:
+        shutil.rmtree(tmp_dir, ignore_errors=True)
+
+
+def find_plists(path):
+    if os.path.isfile(path):
+        return [path]
+    plists = []
+    for root, dirs, files in os.walk(path):
+        for name in files:
+            if name.lower().endswith('.plist'):
+                plists.append(os.path.join(root, name))
+    return sorted(plists)
+
+
+def is_atlas(path):
+    try:
+        plist = load_plist(path)
+    except Exception:
+        return False
+    return isinstance(plist, dict) and isinstance(plist.get('frames'), dict)
+
+
+def main():
+    parser = ArgumentParser(description='Convert plist sprite atlases to binary sprite atlases (.ccsa).')
+    parser.add_argument('input', help='plist file, or directory searched for plist atlases')
+    parser.add_argument('-o', '--output', help='output file or directory, next to the plist files by default')
+    parser.add_argument('--flatc', default='flatc', help='path of the flatc compiler (default: flatc in the PATH)')
+    args = parser.parse_args()
+
+    plists = [p for p in find_plists(args.input) if is_atlas(p)]
+    if not plists:
+        print('No plist atlas found in %s' % args.input)
+        return 1
+
+    failed = 0
+    for path in plists:
+        if args.output and os.path.isfile(args.input):
+            output = args.output
+        else:
+            output = os.path.splitext(path)[0] + '.ccsa'
+            if args.output:
+                output = os.path.join(args.output, os.path.relpath(output, args.input))
+        try:
+            convert_file(path, output, args.flatc)
+            print('%s -> %s' % (path, output))
+        except (ValueError, KeyError, subprocess.CalledProcessError) as e:
+            print('%s: %s' % (path, e))
+            failed += 1
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
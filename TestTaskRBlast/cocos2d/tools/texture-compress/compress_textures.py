@@ -0,0 +1,233 @@
+#!/usr/bin/python
+#-*- coding: UTF-8 -*-
+# ----------------------------------------------------------------------------
+# Build the GPU compressed variants of the PNG files of a resources tree.
+#
+# License: MIT
+# ----------------------------------------------------------------------------
+'''
+Build the GPU compressed variants of the PNG files of a resources tree.
+
+For each "a/b.png" of the resources directory, writes:
+  <output>/s3tc/a/b.dds      BC1 (DXT1) or BC3 (DXT5), PVRTexToolCLI
+  <output>/pvrtc/a/b.pvr     PVRTC 4bpp, PVRTexToolCLI, square power of two images only
+  <output>/atitc/a/b.ktx     ATC, CompressonatorCLI
+  <output>/etc1/a/b.pkm      ETC1, etc1tool (Android SDK), with b.pkm@alpha for the alpha channel
+
+TextureCache picks the variant of the best format supported by the GPU at runtime,
+and falls back to the PNG file. Nine-patch images (*.9.png) are skipped.
+Variants newer than their PNG file are kept, so the tool can be run on every build.
+'''
+
+import os
+import sys
+import struct
+import shutil
+import subprocess
+import tempfile
+
+from argparse import ArgumentParser
+from multiprocessing.pool import ThreadPool
+
+FORMATS = ['s3tc', 'pvrtc', 'atitc', 'etc1']
+
+EXTENSIONS = {
+    's3tc': '.dds',
+    'pvrtc': '.pvr',
+    'atitc': '.ktx',
+    'etc1': '.pkm',
+}
+
+ETC1_ALPHA_SUFFIX = '@alpha'
+
+
+class PngInfo(object):
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            data = f.read()
+        if data[:8] != b'\x89PNG\r\n\x1a\n':
+            raise ValueError('%s is not a PNG file' % path)
+        self.width, self.height, _, color_type = struct.unpack('>IIBB', data[16:26])
+        # color types 4 and 6 have an alpha channel, the others may have a tRNS chunk
+        self.has_alpha = color_type in (4, 6) or b'tRNS' in data[:data.find(b'IDAT')]
+
+    def is_block_aligned(self):
+        return self.width % 4 == 0 and self.height % 4 == 0
+
+    def is_square_pot(self):
+        return self.width == self.height and self.width & (self.width - 1) == 0
+
+
+def find_tool(name, override):
+    if override:
+        return override
+    for directory in os.environ.get('PATH', '').split(os.pathsep):
+        for candidate in (name, name + '.exe'):
+            path = os.path.join(directory, candidate)
+            if os.path.isfile(path) and os.access(path, os.X_OK):
+                return path
+    return None
+
+
+class Compressor(object):
+    def __init__(self, args):
+        self.dry_run = args.dry_run
+        self.verbose = args.verbose
+        self.tools = {
+            'pvrtextool': find_tool('PVRTexToolCLI', args.pvrtextool),
+            'compressonator': find_tool('CompressonatorCLI', args.compressonator),
+            'etc1tool': find_tool('etc1tool', args.etc1tool),
+        }
+        self.required = {
+            's3tc': 'pvrtextool',
+            'pvrtc': 'pvrtextool',
+            'atitc': 'compressonator',
+            'etc1': 'etc1tool',
+        }
+
+    def available_formats(self, formats):
+        result = []
+        for fmt in formats:
+            tool = self.required[fmt]
+            if self.tools[tool]:
+                result.append(fmt)
+            else:
+                print('warning: %s not found, %s variants are skipped' % (tool, fmt))
+        return result
+
+    def run(self, command):
+        if self.verbose or self.dry_run:
+            print(' '.join(command))
+        if self.dry_run:
+            return True
+        with open(os.devnull, 'w') as devnull:
+            out = None if self.verbose else devnull
+            return subprocess.call(command, stdout=out, stderr=out) == 0
+
+    def compress(self, fmt, src, dst, info):
+        if fmt == 's3tc':
+            return self.run([self.tools['pvrtextool'], '-i', src, '-o', dst,
+                             '-f', 'BC3' if info.has_alpha else 'BC1'])
+        if fmt == 'pvrtc':
+            return self.run([self.tools['pvrtextool'], '-i', src, '-o', dst,
+                             '-f', 'PVRTC1_4' if info.has_alpha else 'PVRTC1_4_RGB', '-q', 'pvrtcbest'])
+        if fmt == 'atitc':
+            return self.run([self.tools['compressonator'], '-fd',
+                             'ATC_RGBA_Interpolated' if info.has_alpha else 'ATC_RGB', src, dst])
+        if fmt == 'etc1':
+            if not self.run([self.tools['etc1tool'], src, '--encode', '-o', dst]):
+                return False
+            if info.has_alpha:
+                return self.compress_etc1_alpha(src, dst)
+            return True
+        return False
+
+    def compress_etc1_alpha(self, src, dst):
+        # ETC1 has no alpha channel, the alpha is stored as the intensity of a second texture
+        try:
+            from PIL import Image
+        except ImportError:
+            print('warning: Pillow is required for the alpha channel of %s' % src)
+            return False
+        if self.dry_run:
+            print('extract alpha of %s' % src)
+            return True
+        handle, alpha_png = tempfile.mkstemp(suffix='.png')
+        os.close(handle)
+        try:
+            alpha = Image.open(src).convert('RGBA').split()[3]
+            Image.merge('RGB', (alpha, alpha, alpha)).save(alpha_png)
+            return self.run([self.tools['etc1tool'], alpha_png, '--encode', '-o', dst + ETC1_ALPHA_SUFFIX])
+        finally:
+            os.remove(alpha_png)
+
+
+def collect_images(resources, output):
+    images = []
+    for root, dirs, files in os.walk(resources):
+        # don't compress the variants themselves
+        dirs[:] = [d for d in dirs if os.path.abspath(os.path.join(root, d)) != output]
+        for name in files:
+            if name.lower().endswith('.png') and not name.lower().endswith('.9.png'):
+                images.append(os.path.relpath(os.path.join(root, name), resources))
+    return sorted(images)
+
+
+def is_up_to_date(src, dst):
+    return os.path.isfile(dst) and os.path.getmtime(dst) >= os.path.getmtime(src)
+
+
+def main():
+    parser = ArgumentParser(description='Build the GPU compressed variants of the PNG files of a resources tree.')
+    parser.add_argument('resources', help='The resources directory.')
+    parser.add_argument('-o', '--output', help='The output directory. Default is <resources>/compressed, the default root of TextureCache.')
+    parser.add_argument('-f', '--formats', default=','.join(FORMATS), help='Comma separated formats among %s. Default is all.' % ', '.join(FORMATS))
+    parser.add_argument('-j', '--jobs', type=int, default=4, help='Number of images compressed at the same time.')
+    parser.add_argument('--force', action='store_true', help='Rebuild up to date variants.')
+    parser.add_argument('--clean', action='store_true', help='Remove the output directory first.')
+    parser.add_argument('--dry-run', action='store_true', help='Print the commands without running them.')
+    parser.add_argument('-v', '--verbose', action='store_true', help='Print the commands and their output.')
+    parser.add_argument('--pvrtextool', help='Path of PVRTexToolCLI.')
+    parser.add_argument('--compressonator', help='Path of CompressonatorCLI.')
+    parser.add_argument('--etc1tool', help='Path of etc1tool.')
+    args = parser.parse_args()
+
+    resources = os.path.abspath(args.resources)
+    output = os.path.abspath(args.output or os.path.join(resources, 'compressed'))
+    formats = [f.strip() for f in args.formats.split(',') if f.strip()]
+    for fmt in formats:
+        if fmt not in FORMATS:
+            parser.error('unknown format %s' % fmt)
+
+    if args.clean and os.path.isdir(output) and not args.dry_run:
+        shutil.rmtree(output)
+
+    compressor = Compressor(args)
+    formats = compressor.available_formats(formats)
+
+    tasks = []
+    for image in collect_images(resources, output):
+        src = os.path.join(resources, image)
+        try:
+            info = PngInfo(src)
+        except (IOError, ValueError) as e:
+            print('warning: %s' % e)
+            continue
+        for fmt in formats:
+            if not info.is_block_aligned():
+                continue
+            if fmt == 'pvrtc' and not info.is_square_pot():
+                continue
+            dst = os.path.join(output, fmt, os.path.splitext(image)[0] + EXTENSIONS[fmt])
+            if not args.force and is_up_to_date(src, dst):
+                continue
+            tasks.append((fmt, src, dst, info))
+
+    def run_task(task):
+        fmt, src, dst, info = task
+        directory = os.path.dirname(dst)
+        if not args.dry_run and not os.path.isdir(directory):
+            try:
+                os.makedirs(directory)
+            except OSError:
+                pass  # created by another job
+        if compressor.compress(fmt, src, dst, info):
+            return None
+        # a partial variant would be picked at runtime
+        for path in (dst, dst + ETC1_ALPHA_SUFFIX):
+            if os.path.isfile(path) and not args.dry_run:
+                os.remove(path)
+        return '%s (%s)' % (src, fmt)
+
+    pool = ThreadPool(max(1, args.jobs))
+    failures = [f for f in pool.map(run_task, tasks) if f]
+    pool.close()
+
+    print('%d variants built, %d failed' % (len(tasks) - len(failures), len(failures)))
+    for failure in failures:
+        print('failed: %s' % failure)
+    return 1 if failures else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,192 @@
+#!/usr/bin/python
+#-*- coding: UTF-8 -*-
+# ----------------------------------------------------------------------------
+# Convert a TMX map to a binary map (.cctmb).
+#
+# License: MIT
+# ----------------------------------------------------------------------------
+'''
+Convert a TMX map to a binary map (.cctmb).
+
+The map is read by cocos2d::TMXBinaryMap (cocos/2d/CCTMXBinaryMap.cpp), which documents
+the layout. The XML of the map is kept without the <data> of its layers, and parsed by
+TMXMapInfo as before. The tiles of each layer are split in square chunks compressed
+independently with zlib, which the FastTMX layers decompress around the camera.
+'''
+
+import os
+import sys
+import zlib
+import gzip
+import base64
+import struct
+import xml.etree.ElementTree as ET
+
+from io import BytesIO
+from argparse import ArgumentParser
+
+MAGIC = b'CCTM'
+VERSION = 1
+HEADER_SIZE = 48
+LAYER_SIZE = 32
+CHUNK_SIZE = 16
+
+# chunk size of the FastTMX layers
+DEFAULT_CHUNK_SIZE = 32
+
+
+class ConversionError(Exception):
+    pass
+
+
+def decode_tiles(layer):
+    '''GIDs of a <layer>, by row.'''
+    width = int(layer.get('width'))
+    height = int(layer.get('height'))
+    data = layer.find('data')
+    if data is None:
+        return [0] * (width * height)
+    if data.find('chunk') is not None:
+        raise ConversionError('layer "%s": infinite maps are not supported' % layer.get('name'))
+
+    encoding = data.get('encoding', '')
+    compression = data.get('compression', '')
+    if encoding == 'base64':
+        raw = base64.b64decode((data.text or '').strip())
+        if compression == 'zlib':
+            raw = zlib.decompress(raw)
+        elif compression == 'gzip':
+            raw = gzip.GzipFile(fileobj=BytesIO(raw)).read()
+        elif compression:
+            raise ConversionError('layer "%s": %s compression is not supported' % (layer.get('name'), compression))
+        tiles = list(struct.unpack('<%dI' % (len(raw) // 4), raw[:len(raw) // 4 * 4]))
+    elif encoding == 'csv':
+        tiles = [int(value) for value in (data.text or '').replace('\n', '').split(',') if value.strip()]
+    elif encoding == '':
+        tiles = [int(tile.get('gid', '0')) for tile in data.findall('tile')]
+    else:
+        raise ConversionError('layer "%s": %s encoding is not supported' % (layer.get('name'), encoding))
+
+    if len(tiles) != width * height:
+        raise ConversionError('layer "%s": %d tiles for %dx%d' % (layer.get('name'), len(tiles), width, height))
+    return tiles
+
+
+def compress_chunks(tiles, width, height, chunk_size):
+    '''The zlib data of the chunks by row, None for the empty ones.'''
+    columns = (width + chunk_size - 1) // chunk_size
+    rows = (height + chunk_size - 1) // chunk_size
+    chunks = []
+    for row in range(rows):
+        for column in range(columns):
+            x0 = column * chunk_size
+            y0 = row * chunk_size
+            x1 = min(x0 + chunk_size, width)
+            chunk = []
+            empty = True
+            for y in range(y0, y0 + chunk_size):
+                if y < height:
+                    line = tiles[y * width + x0:y * width + x1]
+                    empty = empty and not any(line)
+                    chunk.extend(line)
+                    chunk.extend([0] * (chunk_size - len(line)))
+                else:
+                    chunk.extend([0] * chunk_size)
+            chunks.append(None if empty else zlib.compress(struct.pack('<%dI' % len(chunk), *chunk), 9))
+    return columns, rows, chunks
+
+
+def relocate_sources(root, tmx_dir, output_dir):
+    '''Makes the tileset and image paths relative to the binary map.'''
+    for element in root.iter():
+        if element.tag not in ('tileset', 'image'):
+            continue
+        source = element.get('source')
+        if not source or os.path.isabs(source):
+            continue
+        path = os.path.relpath(os.path.join(tmx_dir, source), output_dir)
+        element.set('source', path.replace(os.sep, '/'))
+
+
+def convert(tmx, output, chunk_size):
+    tree = ET.parse(tmx)
+    root = tree.getroot()
+    if root.tag != 'map':
+        raise ConversionError('%s is not a TMX map' % tmx)
+    if root.get('infinite', '0') == '1':
+        raise ConversionError('infinite maps are not supported')
+
+    layers = []
+    # the layers are in document order, as TMXMapInfo reads them
+    for layer in root.iter('layer'):
+        width = int(layer.get('width'))
+        height = int(layer.get('height'))
+        tiles = decode_tiles(layer)
+        sample = next((tile for tile in tiles if tile != 0), 0)
+        layers.append((width, height, sample) + compress_chunks(tiles, width, height, chunk_size))
+        data = layer.find('data')
+        if data is not None:
+            layer.remove(data)
+
+    relocate_sources(root, os.path.dirname(os.path.abspath(tmx)),
+                     os.path.dirname(os.path.abspath(output)))
+    xml = ET.tostring(root, encoding='utf-8')
+    if not xml.startswith(b'<?xml'):
+        xml = b'<?xml version="1.0" encoding="UTF-8"?>\n' + xml
+
+    xml_offset = HEADER_SIZE
+    layers_offset = xml_offset + len(xml)
+    tables_offset = layers_offset + LAYER_SIZE * len(layers)
+    data_offset = tables_offset + sum(CHUNK_SIZE * len(layer[5]) for layer in layers)
+
+    with open(output, 'wb') as f:
+        f.write(struct.pack('<4s3IQ2I2Q', MAGIC, VERSION, chunk_size, len(layers),
+                            xml_offset, len(xml), 0, layers_offset, 0))
+        f.write(xml)
+        table_offset = tables_offset
+        for width, height, sample, columns, rows, chunks in layers:
+            f.write(struct.pack('<4IQ2I', width, height, columns, rows, table_offset, sample, 0))
+            table_offset += CHUNK_SIZE * len(chunks)
+        offset = data_offset
+        for layer in layers:
+            for chunk in layer[5]:
+                if chunk is None:
+                    f.write(struct.pack('<Q2I', 0, 0, 0))
+                else:
+                    f.write(struct.pack('<Q2I', offset, len(chunk), 0))
+                    offset += len(chunk)
+        for layer in layers:
+            for chunk in layer[5]:
+                if chunk is not None:
+                    f.write(chunk)
+
+    chunk_count = sum(len(layer[5]) for layer in layers)
+    empty_count = sum(layer[5].count(None) for layer in layers)
+    return len(layers), chunk_count, empty_count
+
+
+def main():
+    parser = ArgumentParser(description='Convert a TMX map to a binary map (.cctmb).')
+    parser.add_argument('input', help='TMX map, with tiles encoded as XML, csv or base64 (uncompressed, zlib or gzip)')
+    parser.add_argument('output', help='binary map file, the paths of the tilesets are made relative to it')
+    parser.add_argument('--chunk-size', type=int, default=DEFAULT_CHUNK_SIZE,
+                        help='width and height of the chunks in tiles (default: %d, as the FastTMX layers)' % DEFAULT_CHUNK_SIZE)
+    args = parser.parse_args()
+
+    if args.chunk_size <= 0:
+        print('the chunk size must be positive')
+        return 1
+
+    try:
+        layers, chunks, empty = convert(args.input, args.output, args.chunk_size)
+    except (ConversionError, ET.ParseError, IOError) as e:
+        print('%s: %s' % (args.input, e))
+        return 1
+
+    print('%s: %d layers, %d chunks (%d empty), %d bytes' % (args.output, layers, chunks, empty,
+                                                            os.path.getsize(args.output)))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())